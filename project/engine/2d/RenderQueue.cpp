@@ -0,0 +1,94 @@
+﻿#include "RenderQueue.h"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+namespace {
+// 1回に並べる桁の幅
+const uint32_t kRadixBits = 8;
+const uint32_t kRadixSize = 1 << kRadixBits;
+const uint32_t kRadixPassCount = 64 / kRadixBits;
+
+// floatの大小をそのまま符号なし整数の大小にする
+uint32_t ToSortableBits(float value) {
+  uint32_t bits = std::bit_cast<uint32_t>(value);
+  // 負の数は全ビット反転、正の数は符号ビットだけ立てる
+  uint32_t mask = (bits & 0x80000000u) ? 0xFFFFFFFFu : 0x80000000u;
+  return bits ^ mask;
+}
+} // namespace
+
+uint64_t RenderQueue::MakeKey(uint32_t layer, uint32_t blendMode,
+                              uint32_t pipeline, uint32_t textureIndex,
+                              float depth) {
+  assert(layer < (1u << kLayerBits));
+  assert(blendMode < (1u << kBlendModeBits));
+  assert(pipeline < (1u << kPipelineBits));
+  assert(textureIndex < (1u << kTextureBits));
+
+  uint64_t key = layer;
+  key = (key << kBlendModeBits) | blendMode;
+  key = (key << kPipelineBits) | pipeline;
+  key = (key << kTextureBits) | textureIndex;
+  key = (key << kDepthBits) | ToSortableBits(depth);
+  return key;
+}
+
+void RenderQueue::Clear() { items.clear(); }
+
+void RenderQueue::Sort() {
+  if (items.size() < kRadixSortThreshold) {
+    std::stable_sort(items.begin(), items.end(),
+                     [](const RenderItem &a, const RenderItem &b) {
+                       return a.key < b.key;
+                     });
+    return;
+  }
+
+  // 全桁のヒストグラムを1回の走査でまとめて数える
+  uint32_t counts[kRadixPassCount][kRadixSize] = {};
+  for (const RenderItem &item : items) {
+    for (uint32_t pass = 0; pass < kRadixPassCount; ++pass) {
+      counts[pass][(item.key >> (pass * kRadixBits)) & (kRadixSize - 1)]++;
+    }
+  }
+
+  scratch.resize(items.size());
+  const uint32_t itemCount = static_cast<uint32_t>(items.size());
+  // 下の桁から安定に並べる（LSD基数ソート）
+  for (uint32_t pass = 0; pass < kRadixPassCount; ++pass) {
+    uint32_t *count = counts[pass];
+    uint32_t shift = pass * kRadixBits;
+
+    // 全件が同じ値の桁は並びが変わらないので飛ばす
+    uint32_t digit = (items[0].key >> shift) & (kRadixSize - 1);
+    if (count[digit] == itemCount) {
+      continue;
+    }
+
+    // 個数を書き込み先の先頭位置にする
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < kRadixSize; ++i) {
+      uint32_t n = count[i];
+      count[i] = offset;
+      offset += n;
+    }
+    for (const RenderItem &item : items) {
+      scratch[count[(item.key >> shift) & (kRadixSize - 1)]++] = item;
+    }
+    items.swap(scratch);
+  }
+}
+
+uint32_t RenderQueue::CountStateChanges() const {
+  uint32_t changes = 0;
+  uint32_t previous = 0;
+  for (size_t i = 0; i < items.size(); ++i) {
+    uint32_t state = GetState(items[i].key);
+    if (i == 0 || state != previous) {
+      changes++;
+    }
+    previous = state;
+  }
+  return changes;
+}
@@ -0,0 +1,55 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 描画1件分。keyで並べ替え、indexで元のデータを引く
+struct RenderItem {
+  uint64_t key;
+  uint32_t index;
+};
+
+// 描画順を決める64bitキーの並べ替え（D3D12に依存しない部分）
+// 上位から レイヤー8bit | ブレンド4bit | パイプライン4bit | テクスチャ16bit |
+// 深度32bit。深度以外が同じなら描画ステートも同じ
+class RenderQueue {
+public:
+  static const uint32_t kLayerBits = 8;
+  static const uint32_t kBlendModeBits = 4;
+  static const uint32_t kPipelineBits = 4;
+  static const uint32_t kTextureBits = 16;
+  static const uint32_t kDepthBits = 32;
+  // これより少なければ比較ソート（std::stable_sort）で並べる
+  static const size_t kRadixSortThreshold = 256;
+
+  // キーを作る。深度は小さいほうが先（負の値も順序どおり）
+  static uint64_t MakeKey(uint32_t layer, uint32_t blendMode, uint32_t pipeline,
+                          uint32_t textureIndex, float depth = 0.0f);
+
+  // キーからステート部分（深度を除いた上位32bit）を取り出す
+  static uint32_t GetState(uint64_t key) {
+    return static_cast<uint32_t>(key >> kDepthBits);
+  }
+  static uint32_t GetTextureIndex(uint64_t key) {
+    return GetState(key) & ((1u << kTextureBits) - 1);
+  }
+
+  // 積んだ項目を空にする（容量は残す）
+  void Clear();
+
+  // 項目を追加する
+  void Add(uint64_t key, uint32_t index) { items.push_back({key, index}); }
+
+  // キーの昇順に並べる。同じキーは積んだ順のまま（安定）
+  void Sort();
+
+  // 今の並びで、直前とステートが変わる回数（最初の1件も1回と数える）
+  uint32_t CountStateChanges() const;
+
+  const std::vector<RenderItem> &GetItems() const { return items; }
+
+private:
+  std::vector<RenderItem> items;
+  // 基数ソートの作業領域
+  std::vector<RenderItem> scratch;
+};
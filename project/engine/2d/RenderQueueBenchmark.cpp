@@ -0,0 +1,75 @@
+﻿#include "Benchmark.h"
+#include "RenderQueue.h"
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// 10万枚のスプライトをキーで並べ替えた時に、減るステート変更の回数と
+// 並べ替えの時間（基数ソートとstd::stable_sort）
+// テクスチャの種類を変え、積んだ順（ばらばら）と並べた後の変更回数を比べる
+namespace {
+const uint32_t kSpriteCount = 100000;
+const uint32_t kLayerCount = 4;
+const uint32_t kRepeatCount = 20;
+
+void Run(uint32_t textureCount, std::mt19937 &engine) {
+  std::uniform_int_distribution<uint32_t> layer(0, kLayerCount - 1);
+  std::uniform_int_distribution<uint32_t> texture(0, textureCount - 1);
+  std::uniform_real_distribution<float> depth(-100.0f, 100.0f);
+  std::vector<RenderItem> items(kSpriteCount);
+  for (uint32_t i = 0; i < kSpriteCount; ++i) {
+    items[i] = {RenderQueue::MakeKey(layer(engine), 0, 0, texture(engine),
+                                     depth(engine)),
+                i};
+  }
+
+  RenderQueue queue;
+  auto fill = [&]() {
+    queue.Clear();
+    for (const RenderItem &item : items) {
+      queue.Add(item.key, item.index);
+    }
+  };
+  fill();
+  uint32_t unsortedChanges = queue.CountStateChanges();
+
+  // 積み直しの時間も含めて測り、後で差し引く
+  double fillMs = Benchmark::MeasureBestMs(kRepeatCount, fill);
+  double radixMs = Benchmark::MeasureBestMs(kRepeatCount, [&]() {
+    fill();
+    queue.Sort();
+  });
+  uint32_t sortedChanges = queue.CountStateChanges();
+  Benchmark::Consume(queue.GetItems()[0].index);
+
+  std::vector<RenderItem> copy;
+  double stableMs = Benchmark::MeasureBestMs(kRepeatCount, [&]() {
+    copy = items;
+    std::stable_sort(copy.begin(), copy.end(),
+                     [](const RenderItem &a, const RenderItem &b) {
+                       return a.key < b.key;
+                     });
+  });
+  double copyMs = Benchmark::MeasureBestMs(kRepeatCount, [&]() {
+    copy = items;
+    Benchmark::Consume(copy[0].index);
+  });
+  Benchmark::Consume(copy[0].index);
+
+  std::printf("%9u %10u %10u %10u %10.3f %10.3f\n", textureCount,
+              unsortedChanges, sortedChanges, unsortedChanges - sortedChanges,
+              radixMs - fillMs, stableMs - copyMs);
+}
+} // namespace
+
+int main() {
+  std::mt19937 engine(12345);
+  std::printf("%u sprites, %u layers\n", kSpriteCount, kLayerCount);
+  std::printf("%9s %10s %10s %10s %10s %10s\n", "textures", "unsorted",
+              "sorted", "eliminated", "radix ms", "stable ms");
+  for (uint32_t textureCount : {8u, 64u, 1024u}) {
+    Run(textureCount, engine);
+  }
+  return 0;
+}
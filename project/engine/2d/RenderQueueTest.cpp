@@ -0,0 +1,150 @@
+﻿#include "Check.h"
+#include "RenderQueue.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+// 深度の変換（負の値・0の符号・無限大も大小のとおりに並ぶか）と、
+// kRadixSortThreshold以上で使う基数ソートがstd::stable_sortと同じ並びになるか
+namespace {
+std::vector<RenderItem> StableSorted(std::vector<RenderItem> items) {
+  std::stable_sort(items.begin(), items.end(),
+                   [](const RenderItem &a, const RenderItem &b) {
+                     return a.key < b.key;
+                   });
+  return items;
+}
+
+bool IsSameOrder(const std::vector<RenderItem> &a,
+                 const std::vector<RenderItem> &b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (a[i].key != b[i].key || a[i].index != b[i].index) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void TestDepthOrder() {
+  // 小さい順に並べた深度。ステートが同じなら深度の順がキーの順になる
+  const float depths[] = {-INFINITY, -1e30f,  -1000.0f, -1.5f,  -1.0f,
+                          -1e-30f,   -1e-45f, -0.0f,    0.0f,   1e-45f,
+                          1e-30f,    1.0f,    1.5f,     1000.0f, 1e30f,
+                          INFINITY};
+  const size_t count = sizeof(depths) / sizeof(depths[0]);
+  for (size_t i = 0; i + 1 < count; ++i) {
+    uint64_t a = RenderQueue::MakeKey(1, 2, 3, 4, depths[i]);
+    uint64_t b = RenderQueue::MakeKey(1, 2, 3, 4, depths[i + 1]);
+    // -0と+0は別のキーになり、-0が先
+    CHECK(a < b);
+    // 深度はステート部分を変えない
+    CHECK(RenderQueue::GetState(a) == RenderQueue::GetState(b));
+  }
+  CHECK(RenderQueue::GetTextureIndex(RenderQueue::MakeKey(1, 2, 3, 4, -5.0f)) ==
+        4);
+
+  // 深度がどれだけ小さくても、上位のステートの順が先に効く
+  CHECK(RenderQueue::MakeKey(0, 0, 0, 1, INFINITY) <
+        RenderQueue::MakeKey(0, 0, 0, 2, -INFINITY));
+  CHECK(RenderQueue::MakeKey(0, 15, 15, 65535, INFINITY) <
+        RenderQueue::MakeKey(1, 0, 0, 0, -INFINITY));
+
+  // 乱数の深度でも、並べた結果の深度が昇順になる（負の値が混ざる）
+  std::mt19937 engine(12345);
+  std::uniform_real_distribution<float> distribution(-1000.0f, 1000.0f);
+  RenderQueue queue;
+  std::vector<float> values;
+  for (uint32_t i = 0; i < 1000; ++i) {
+    values.push_back(distribution(engine));
+    queue.Add(RenderQueue::MakeKey(0, 0, 0, 0, values.back()), i);
+  }
+  queue.Sort();
+  const std::vector<RenderItem> &items = queue.GetItems();
+  for (size_t i = 0; i + 1 < items.size(); ++i) {
+    CHECK(values[items[i].index] <= values[items[i + 1].index]);
+  }
+}
+
+// 同じキーが多いほど安定性の違いが出るので、ステートの種類を絞って作る
+void CheckMatchesStableSort(uint32_t count, uint32_t textureCount,
+                            std::mt19937 &engine) {
+  std::uniform_int_distribution<uint32_t> layer(0, 3);
+  std::uniform_int_distribution<uint32_t> blendMode(0, 2);
+  std::uniform_int_distribution<uint32_t> texture(0, textureCount - 1);
+  std::uniform_int_distribution<int> depth(-8, 8);
+
+  RenderQueue queue;
+  std::vector<RenderItem> expected;
+  for (uint32_t i = 0; i < count; ++i) {
+    uint64_t key = RenderQueue::MakeKey(layer(engine), blendMode(engine), 0,
+                                        texture(engine),
+                                        static_cast<float>(depth(engine)));
+    queue.Add(key, i);
+    expected.push_back({key, i});
+  }
+  queue.Sort();
+  CHECK(IsSameOrder(queue.GetItems(), StableSorted(expected)));
+}
+
+void TestRadixMatchesStableSort() {
+  std::mt19937 engine(12345);
+  // 閾値の前後と、十分大きい数
+  for (uint32_t count :
+       {uint32_t(RenderQueue::kRadixSortThreshold - 1),
+        uint32_t(RenderQueue::kRadixSortThreshold),
+        uint32_t(RenderQueue::kRadixSortThreshold + 1), 1000u, 100000u}) {
+    CheckMatchesStableSort(count, 1, engine);
+    CheckMatchesStableSort(count, 64, engine);
+    CheckMatchesStableSort(count, 65536, engine);
+  }
+
+  // 全件同じキー（全ての桁を飛ばす）なら積んだ順のまま
+  RenderQueue queue;
+  const uint32_t count = RenderQueue::kRadixSortThreshold * 4;
+  for (uint32_t i = 0; i < count; ++i) {
+    queue.Add(RenderQueue::MakeKey(2, 1, 0, 7, -3.0f), i);
+  }
+  queue.Sort();
+  bool isInOrder = true;
+  for (uint32_t i = 0; i < count; ++i) {
+    isInOrder = isInOrder && queue.GetItems()[i].index == i;
+  }
+  CHECK(isInOrder);
+
+  // Clearの後に積み直しても前の項目が残らない
+  queue.Clear();
+  queue.Add(RenderQueue::MakeKey(0, 0, 0, 2), 0);
+  queue.Add(RenderQueue::MakeKey(0, 0, 0, 1), 1);
+  queue.Sort();
+  CHECK(queue.GetItems().size() == 2);
+  CHECK(queue.GetItems()[0].index == 1);
+}
+
+void TestCountStateChanges() {
+  RenderQueue queue;
+  CHECK(queue.CountStateChanges() == 0);
+  // テクスチャ 1,2,1,2 に深度違いの同じステートを混ぜる
+  queue.Add(RenderQueue::MakeKey(0, 0, 0, 1, 3.0f), 0);
+  queue.Add(RenderQueue::MakeKey(0, 0, 0, 2, 2.0f), 1);
+  queue.Add(RenderQueue::MakeKey(0, 0, 0, 1, 1.0f), 2);
+  queue.Add(RenderQueue::MakeKey(0, 0, 0, 2, 0.0f), 3);
+  queue.Add(RenderQueue::MakeKey(0, 0, 0, 2, -1.0f), 4);
+  CHECK(queue.CountStateChanges() == 4);
+  queue.Sort();
+  CHECK(queue.CountStateChanges() == 2);
+  // 同じテクスチャの中は深度の順
+  CHECK(queue.GetItems()[0].index == 2);
+  CHECK(queue.GetItems()[1].index == 0);
+  CHECK(queue.GetItems()[2].index == 4);
+}
+} // namespace
+
+int main() {
+  TestDepthOrder();
+  TestRadixMatchesStableSort();
+  TestCountStateChanges();
+  return Test::Finish();
+}
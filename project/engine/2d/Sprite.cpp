@@ -1,8 +1,9 @@
 ﻿#include "Sprite.h"
 #include "DirectXCommon.h"
 #include "SpriteCommon.h"
-#include "WinApp.h"
 #include "TextureManager.h"
+#include <cassert>
+#include <cstring>
 
 using namespace MyMath;
 
@@ -11,176 +12,163 @@ void Sprite::Initialize(SpriteCommon *spriteCommon,
   // 引数で受け取ってメンバ変数に記録する
   this->spriteCommon_ = spriteCommon;
 
-  vertexResource = spriteCommon_->GetDxCommon()->CreateBufferResource(
-      sizeof(VertexData) * 4);
-  indexResource =
-      spriteCommon_->GetDxCommon()->CreateBufferResource(sizeof(uint32_t) * 6);
-
-  // リソースの先頭のアドレスから使う
-  vertexBufferView.BufferLocation = vertexResource->GetGPUVirtualAddress();
-  // 使用するリソースのサイズは頂点６つ分のサイズ
-  vertexBufferView.SizeInBytes = sizeof(VertexData) * 4;
-  // １頂点あたりのサイズ
-  vertexBufferView.StrideInBytes = sizeof(VertexData);
-
-  // リソースの先頭のアドレスから使う
-  indexBufferView.BufferLocation = indexResource->GetGPUVirtualAddress();
-  // 使用するリソースのサイズはインデックス６つ分のサイズ
-  indexBufferView.SizeInBytes = sizeof(uint32_t) * 6;
-  // インデックスはuint32_tとする
-  indexBufferView.Format = DXGI_FORMAT_R32_UINT;
-
-  // 書き込むためのアドレスを取得
-  vertexResource->Map(0, nullptr, reinterpret_cast<void **>(&vertexData));
-
-  vertexData[0].position = {0.0f, 360.0f, 0.0f, 1.0f};
-  vertexData[0].texcoord = {0.0f, 1.0f};
-
-  vertexData[1].position = {0.0f, 0.0f, 0.0f, 1.0f};
-  vertexData[1].texcoord = {0.0f, 0.0f};
-
-  vertexData[2].position = {640.0f, 360.0f, 0.0f, 1.0f};
-  vertexData[2].texcoord = {1.0f, 1.0f};
-
-  vertexData[3].position = {640.0f, 0.0f, 0.0f, 1.0f};
-  vertexData[3].texcoord = {1.0f, 0.0f};
-
-  indexResource->Map(0, nullptr, reinterpret_cast<void **>(&indexData));
-  indexData[0] = 0;
-  indexData[1] = 1;
-  indexData[2] = 2;
-  indexData[3] = 1;
-  indexData[4] = 3;
-  indexData[5] = 2;
-
-  // マテリアル用のリソースを作る。今回はcolor１つ分のサイズを用意する
-  materialResource =
-      spriteCommon_->GetDxCommon()->CreateBufferResource(sizeof(Material));
-  // 書き込むためのアドレスを取得
-  materialResource->Map(0, nullptr, reinterpret_cast<void **>(&materialData));
-  // 今回は白を書き込んでみる
-  materialData->color = Vector4(1.0f, 1.0f, 1.0f, 1.0f);
-
-  // Sparite用のTransformationMatrix用のリソースを作る。Matrix4x4
-  // １つ分のサイズを用意する
-  transformationMatrixResource =
-      spriteCommon_->GetDxCommon()->CreateBufferResource(
-          sizeof(TransformationMatrix));
-  // 書き込むためのアドレスを取得
-  transformationMatrixResource->Map(
-      0, nullptr, reinterpret_cast<void **>(&transformationMatrixData));
-  // 単位行列を書きこんでおく
-  transformationMatrixData->WVP = MyMath::Math::MakeIdentity4x4();
-  transformationMatrixData->World = MyMath::Math::MakeIdentity4x4();
-
-  transform = {};
-  transform.scale = {1.0f, 1.0f, 1.0f};
-
-  // テクスチャ番号を取得して記録
-  textureIndex =
-      TextureManager::GetInstance()->GetTextureIndexByFilePath(textureFilePath);
+  // アトラスに入っていれば、そのページと切り出し範囲を使う
+  TextureManager *textureManager = TextureManager::GetInstance();
+  const TextureManager::AtlasRegion *region =
+      textureManager->FindAtlasRegion(textureFilePath);
+  // 切り出し範囲は元イメージの座標のまま持ち、
+  // UVを作るときにページ内の位置を足す
+  if (region) {
+    textureIndex = region->textureIndex;
+    isInAtlas = true;
+    atlasLeftTop = region->leftTop;
+    atlasImageSize = region->size;
+    textureLeftTop = {0.0f, 0.0f};
+    textureSize = region->size;
+  } else {
+    isInAtlas = false;
+    atlasLeftTop = {0.0f, 0.0f};
+    // テクスチャ番号を取得して記録
+    textureIndex = textureManager->GetTextureIndexByFilePath(textureFilePath);
+  }
+
+  // 頂点はSpriteCommonの単位矩形を共有する
+  // アンカーとフリップはワールド行列に入れる
+  instance.localRect = {0.0f, 0.0f, 1.0f, 1.0f};
+  instance.textureIndex = textureIndex;
+
+  dirtyFlags = kDirtyAll;
 }
 
 void Sprite::Update() {
+  UpdateVertices();
 
-  // 座標
-  transform.translate = {position.x, position.y, 0.0f};
-  // 回転
-  transform.rotate = {0.0f, 0.0f, rotation};
-
-  float left = 0.0f - anchorPoint.x;
-  float right = 1.0f - anchorPoint.x;
-  float top = 0.0f - anchorPoint.y;
-  float bottom = 1.0f - anchorPoint.y;
+  if (!IsTransformDirty()) {
+    return;
+  }
+  // Sprite用のWorldViewProjectionMatrixを作る
+  MyMath::Matrix4x4 worldMatrix = TransformBatch::MakeWorldMatrix(
+      position, rotation, GetFlippedScale(), anchorPoint);
+  SetMatrices(worldMatrix,
+              MyMath::Math::Multiply(worldMatrix,
+                                     spriteCommon_->GetViewProjectionMatrix()));
+}
 
-  // 左右反転
-  if (isFlipX_) {
-    left = -left;
-    right = -right;
+void Sprite::UpdateAll(const std::vector<Sprite *> &sprites) {
+  if (sprites.empty()) {
+    return;
+  }
+  SpriteCommon *spriteCommon = sprites[0]->spriteCommon_;
+  TransformBatch &batch = spriteCommon->GetTransformBatch();
+
+  // 変更のあったスプライトだけバッチに積む
+  batch.Clear();
+  for (Sprite *sprite : sprites) {
+    assert(sprite->spriteCommon_ == spriteCommon);
+    sprite->UpdateVertices();
+    if (sprite->IsTransformDirty()) {
+      batch.Add(sprite->position, sprite->rotation, sprite->GetFlippedScale(),
+                sprite->anchorPoint);
+    }
+  }
+  if (batch.GetCount() == 0) {
+    return;
   }
 
-  // 上下反転
-  if (isFlipY_) {
-    top = -top;
-    bottom = -bottom;
+  // ビュー×射影は1回だけ。行列は変更分まとめて計算する
+  batch.Compute(spriteCommon->GetViewProjectionMatrix());
+  // 積んだ順に同じ条件で拾い直す（SetMatricesでフラグが落ちる）
+  uint32_t batchIndex = 0;
+  for (Sprite *sprite : sprites) {
+    if (sprite->IsTransformDirty()) {
+      const TransformBatch::Matrices &matrices = batch.GetMatrices(batchIndex++);
+      sprite->SetMatrices(matrices.World, matrices.WVP);
+    }
   }
+}
 
-  // テクスチャ範囲指定
-  const DirectX::TexMetadata &metadata =
-      TextureManager::GetInstance()->GetMetaData(textureIndex);
-  float tex_left = textureLeftTop.x / metadata.width;
-  float tex_right = (textureLeftTop.x + textureSize.x) / metadata.width;
-  float tex_top = textureLeftTop.y / metadata.height;
-  float tex_bottom = (textureLeftTop.y + textureSize.y) / metadata.height;
+void Sprite::UpdateVertices() {
+  // 非同期読み込み中はプレースホルダーの大きさなので、読み込み後に作り直す
+  if (!isTextureReady) {
+    dirtyFlags |= kDirtyTexcoord;
+  }
 
+  if (dirtyFlags & kDirtyTexcoord) {
+    TextureManager *textureManager = TextureManager::GetInstance();
+    isTextureReady = textureManager->IsTextureReady(textureIndex);
+
+    // テクスチャ範囲指定
+    const DirectX::TexMetadata &metadata =
+        textureManager->GetMetaData(textureIndex);
+    // アトラスならページ内の位置を足す（アトラスでなければ0）
+    MyMath::Vector2 leftTop = {atlasLeftTop.x + textureLeftTop.x,
+                               atlasLeftTop.y + textureLeftTop.y};
+    float tex_left = leftTop.x / metadata.width;
+    float tex_right = (leftTop.x + textureSize.x) / metadata.width;
+    float tex_top = leftTop.y / metadata.height;
+    float tex_bottom = (leftTop.y + textureSize.y) / metadata.height;
+
+    // UVはシェーダーで単位矩形の角から補間する
+    instance.uvRect = {tex_left, tex_top, tex_right, tex_bottom};
+  }
 
-  // サイズ
-  //  頂点リソースにデータを書き込む
-  // 左下
-  vertexData[0].position = {left, bottom, 0.0f, 1.0f};
-  vertexData[0].texcoord = {tex_left, tex_bottom};
+  if (dirtyFlags & kDirtyColor) {
+    instance.color = color;
+  }
 
-  // 左上
-  vertexData[1].position = {left, top, 0.0f, 1.0f};
-  vertexData[1].texcoord = {tex_left, tex_top};
+  dirtyFlags &= ~(kDirtyTexcoord | kDirtyColor);
+}
 
-  // 右下
-  vertexData[2].position = {right, bottom, 0.0f, 1.0f};
-  vertexData[2].texcoord = {tex_right, tex_bottom};
+bool Sprite::IsTransformDirty() const {
+  return (dirtyFlags & kDirtyTransform) ||
+         viewProjectionVersion != spriteCommon_->GetViewProjectionVersion();
+}
 
-  // 右上
-  vertexData[3].position = {right, top, 0.0f, 1.0f};
-  vertexData[3].texcoord = {tex_right, tex_top};
+void Sprite::SetMatrices(const MyMath::Matrix4x4 &worldMatrix,
+                         const MyMath::Matrix4x4 &worldViewProjectionMatrix) {
+  instance.WVP = worldViewProjectionMatrix;
+  bounds = Culling::TransformAABB({{0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 0.0f}},
+                                  worldMatrix);
 
-  transform.scale = {size.x, size.y, 1.0f};
+  dirtyFlags &= ~kDirtyTransform;
+  viewProjectionVersion = spriteCommon_->GetViewProjectionVersion();
+}
 
-  // Sprite用のWorldViewProjectionMatrixを作る
-  MyMath::Matrix4x4 worldMatrix = MyMath::Math::MakeAffineMatrix(
-      transform.scale, transform.rotate, transform.translate);
-  Matrix4x4 viewMatrix = MyMath::Math::MakeIdentity4x4();
-  Matrix4x4 projectionMatrix = MyMath::Math::MakeOrthographicMatrix(
-      0.0f, 0.0f, float(WinApp::kClientWidth), float(WinApp::kClientHeight),
-      0.0f, 100.0f);
-  // Matrix4x4 worldViewProjectionMatrixSprite = Multiply(worldMatrixSprite,
-  // Multiply(viewMatrixSprite, projectionMatrixSprite));
-  transformationMatrixData->WVP = MyMath::Math::Multiply(
-      worldMatrix, MyMath::Math::Multiply(viewMatrix, projectionMatrix));
-  transformationMatrixData->World = worldMatrix;
+MyMath::Vector2 Sprite::GetFlippedScale() const {
+  // 左右・上下反転は単位矩形をアンカーを中心に裏返すのと同じ
+  return {isFlipX_ ? -size.x : size.x, isFlipY_ ? -size.y : size.y};
 }
 
 void Sprite::Draw() {
-  // Spriteの描画。変更が必要なものだけ変更
-  spriteCommon_->GetDxCommon()->GetCommandList()->IASetVertexBuffers(
-      0, 1, &vertexBufferView);
-  spriteCommon_->GetDxCommon()->GetCommandList()->IASetIndexBuffer(
-      &indexBufferView);
-  // TransformationMatrixCBufferの場所を設定
-  spriteCommon_->GetDxCommon()
-      ->GetCommandList()
-      ->SetGraphicsRootConstantBufferView(
-          0, transformationMatrixResource->GetGPUVirtualAddress());
-  spriteCommon_->GetDxCommon()
-      ->GetCommandList()
-      ->SetGraphicsRootConstantBufferView(
-          1, materialResource->GetGPUVirtualAddress());
-  spriteCommon_->GetDxCommon()
-      ->GetCommandList()
-      ->SetGraphicsRootDescriptorTable(2, TextureManager::GetInstance()->GetSrvHandleGPU(textureIndex));
-  // 描画！（DrawInstanced(DrawCall/ドローコル）
-  // spriteCommon_->GetDxCommon()->GetCommandList()->DrawInstanced(6, 1, 0, 0);
-  ////描画!(DrawCall/ドローコル）６個のインデックスを使用し１つのインスタンスを描画。その他は当面０で良い
-  spriteCommon_->GetDxCommon()->GetCommandList()->DrawIndexedInstanced(6, 1, 0,
-                                                                       0, 0);
+  // SetupSpriteDrawingの後に呼ぶ。インスタンス1つ分だけアップロードする
+  DirectXCommon *dxCommon = spriteCommon_->GetDxCommon();
+  UploadAllocation allocation =
+      dxCommon->AllocateUpload(kUploadSizePerDraw, alignof(SpriteInstance));
+  std::memcpy(allocation.cpuAddress, &instance, sizeof(SpriteInstance));
+
+  ID3D12GraphicsCommandList *commandList = dxCommon->GetCommandList();
+  commandList->SetGraphicsRootShaderResourceView(0, allocation.gpuAddress);
+  commandList->SetGraphicsRoot32BitConstant(1, 0, 0);
+  commandList->SetGraphicsRootDescriptorTable(
+      2, TextureManager::GetInstance()->GetSrvHandleGPU(textureIndex));
+  // ６個のインデックスを使用し１つのインスタンスを描画
+  commandList->DrawIndexedInstanced(6, 1, 0, 0, 0);
 }
 
 void Sprite::AbjustTextureSize() {
-  // テクスチャメタデータ取得
-  const DirectX::TexMetadata &metadata =
-      TextureManager::GetInstance()->GetMetaData(textureIndex);
-
-  textureSize.x = static_cast<float>(metadata.width);
-  textureSize.y = static_cast<float>(metadata.height);
+  if (isInAtlas) {
+    // アトラスならページではなく元イメージの大きさ
+    textureSize = atlasImageSize;
+  } else {
+    // テクスチャメタデータ取得
+    const DirectX::TexMetadata &metadata =
+        TextureManager::GetInstance()->GetMetaData(textureIndex);
+
+    textureSize.x = static_cast<float>(metadata.width);
+    textureSize.y = static_cast<float>(metadata.height);
+  }
   // 画像サイズをテクスチャサイズに合わせる
   size = textureSize;
+  dirtyFlags |= kDirtyTransform | kDirtyTexcoord;
     
     }
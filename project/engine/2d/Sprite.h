@@ -1,9 +1,12 @@
 ﻿#pragma once
 #include "SpriteCommon.h"
 #include "MyMath.h"
+#include "Bounds.h"
+#include "SpriteBatchBuilder.h"
 #include <cmath>
 #include <cstdint>
 #include <d3d12.h>
+#include <vector>
 #include <wrl.h>
 
 using namespace Microsoft::WRL;
@@ -18,88 +21,107 @@ public: // メンバ関数
   // 更新
   void Update();
 
-  // 描画
+  // まとめて更新。行列は全件を1回で計算する（全スプライトが同じSpriteCommon）
+  static void UpdateAll(const std::vector<Sprite *> &sprites);
+
+  // 描画（SpriteCommon::SetupSpriteDrawingの後に呼ぶ）
   void Draw();
 
+  // 単体で描くときに1回あたり使うアップロード領域のバイト数
+  static const size_t kUploadSizePerDraw = sizeof(SpriteInstance);
+
   struct Transform {
     MyMath::Vector3 scale;
     MyMath::Vector3 rotate;
     MyMath::Vector3 translate;
   };
 
-  struct VertexData {
-    MyMath::Vector4 position;
-    MyMath::Vector2 texcoord;
-  };
-
-  struct Material {
-    MyMath::Vector4 color;
-  };
-
-  struct TransformationMatrix {
-    MyMath::Matrix4x4 WVP;
-    MyMath::Matrix4x4 World;
-  };
-
   // getter//
   const MyMath::Vector2 &GetPosition() const { return position; }
   float GetRotation() const { return rotation; }
-  const MyMath::Vector4 GetColor() const { return materialData->color; }
+  const MyMath::Vector4 GetColor() const { return color; }
   const MyMath::Vector2 &GetSize() const { return size; }
   const MyMath::Vector2 &GetAnchorPoint() const { return anchorPoint; }
   const bool IsFlipX() const { return isFlipX_; }
   const bool IsFlipY() const { return isFlipY_; }
   const MyMath::Vector2 &GetTextureLeftTop() const { return textureLeftTop; }
   const MyMath::Vector2 &GetTextureSize() const { return textureSize; }
-
-  // setter//
-  void SetPosition(const MyMath::Vector2 &position) { this->position = position; }
-  void SetRotation(float rotation) { this->rotation = rotation; }
-  void SetColor(const MyMath::Vector4 &color) { materialData->color = color; }
+  // SpriteBatch用のインスタンスデータ（Updateで変更分だけ更新）
+  const SpriteInstance &GetInstance() const { return instance; }
+  // 画面上の範囲（Updateで更新）
+  const MyMath::AABB &GetBounds() const { return bounds; }
+
+  // setter//（変更された項目だけ次のUpdateで作り直す）
+  void SetPosition(const MyMath::Vector2 &position) {
+    this->position = position;
+    dirtyFlags |= kDirtyTransform;
+  }
+  void SetRotation(float rotation) {
+    this->rotation = rotation;
+    dirtyFlags |= kDirtyTransform;
+  }
+  void SetColor(const MyMath::Vector4 &color) {
+    this->color = color;
+    dirtyFlags |= kDirtyColor;
+  }
   void SetAnchorPoint(const MyMath::Vector2 &anchorPoint) {
     this->anchorPoint = anchorPoint;
+    dirtyFlags |= kDirtyTransform;
+  }
+  void SetFlipX(bool isFlipX_) {
+    this->isFlipX_ = isFlipX_;
+    dirtyFlags |= kDirtyTransform;
+  }
+  void SetFlipY(bool isFlipY_) {
+    this->isFlipY_ = isFlipY_;
+    dirtyFlags |= kDirtyTransform;
+  }
+  void SetSize(const MyMath::Vector2 &size) {
+    this->size = size;
+    dirtyFlags |= kDirtyTransform;
   }
-  void SetFlipX(bool isFlipX_) { this->isFlipX_ = isFlipX_; }
-  void SetFlipY(bool isFlipY_) { this->isFlipY_ = isFlipY_; }
-  void SetSize(const MyMath::Vector2 &size) { this->size = size; }
   void SetTextureLeftTop(const MyMath::Vector2 &textureLeftTop) {
     this->textureLeftTop = textureLeftTop;
+    dirtyFlags |= kDirtyTexcoord;
   }
   void SetTextureSize(const MyMath::Vector2 &textureSize) {
     this->textureSize = textureSize;
+    dirtyFlags |= kDirtyTexcoord;
   }
 
 private:
+  // 変更フラグ
+  enum DirtyFlag : uint32_t {
+    kDirtyTransform = 1 << 0, // 座標・回転・サイズ・アンカー・フリップ
+    kDirtyTexcoord = 1 << 1,  // テクスチャ範囲
+    kDirtyColor = 1 << 2,     // 色
+    kDirtyAll = kDirtyTransform | kDirtyTexcoord | kDirtyColor,
+  };
+
   SpriteCommon *spriteCommon_ = nullptr;
 
   // テクスチャサイズをイメージに合わせる
   void AbjustTextureSize();
 
+  // 行列以外（UV・色）の更新。変更が無ければ何もしない
+  void UpdateVertices();
+  // 行列を作り直す必要があるか（自身の変更か、ビュー×射影の変更）
+  bool IsTransformDirty() const;
+  // 計算済みの行列を書き込む
+  void SetMatrices(const MyMath::Matrix4x4 &worldMatrix,
+                   const MyMath::Matrix4x4 &worldViewProjectionMatrix);
+  // TransformBatchに渡す拡縮（フリップは負の拡縮にする）
+  MyMath::Vector2 GetFlippedScale() const;
+
   // テクスチャ番号
   uint32_t textureIndex = 0;
 
-  Microsoft::WRL::ComPtr<ID3D12Resource> vertexResource;
-
-  // 頂点インデックス
-  Microsoft::WRL::ComPtr<ID3D12Resource> indexResource;
-
-  // バッファリソース内のデータを指すポインタ
-  VertexData *vertexData = nullptr;
-  uint32_t *indexData = nullptr;
-  // バッファリソースの使い道を補足するバッファビュー
-  D3D12_VERTEX_BUFFER_VIEW vertexBufferView;
-  D3D12_INDEX_BUFFER_VIEW indexBufferView;
-
-  Microsoft::WRL::ComPtr<ID3D12Resource> materialResource;
-
-  Material *materialData = nullptr;
-
-  // バッファリソース
-  Microsoft::WRL::ComPtr<ID3D12Resource> transformationMatrixResource;
-  // バッファリソース内のデータを指すポインタ
-  TransformationMatrix *transformationMatrixData = nullptr;
-
-  Transform transform;
+  // 次のUpdateで作り直すもの
+  uint32_t dirtyFlags = kDirtyAll;
+  // 行列を作ったときのビュー×射影の版
+  uint32_t viewProjectionVersion = 0;
+  // UVを作ったときにテクスチャが読み込み済みだったか
+  bool isTextureReady = false;
 
   D3D12_CPU_DESCRIPTOR_HANDLE textureSrvHandleCPU{};
   D3D12_GPU_DESCRIPTOR_HANDLE textureSrvHandleGPU{};
@@ -112,6 +134,9 @@ private:
   // 回転
   float rotation = 0.0f;
 
+  // 色
+  MyMath::Vector4 color = {1.0f, 1.0f, 1.0f, 1.0f};
+
   // サイズ
   MyMath::Vector2 size = {640.0f, 360.0f};
 
@@ -123,8 +148,19 @@ private:
   // 上下フリップ
   bool isFlipY_ = false;
 
-  // テクスチャ左上座標
+  // テクスチャ左上座標（アトラスに入っていても元イメージの座標）
   MyMath::Vector2 textureLeftTop = {0.0f, 0.0f};
   // テクスチャ切り出しサイズ
   MyMath::Vector2 textureSize = {1200.0f, 1200.0f};
+
+  // アトラスに入っているか
+  bool isInAtlas = false;
+  // アトラスのページ内での元イメージの左上座標と大きさ
+  MyMath::Vector2 atlasLeftTop = {0.0f, 0.0f};
+  MyMath::Vector2 atlasImageSize = {0.0f, 0.0f};
+
+  // SpriteBatchに渡すインスタンスデータ
+  SpriteInstance instance{};
+  // 単位矩形をワールド行列で変換した範囲
+  MyMath::AABB bounds{};
 };
\ No newline at end of file
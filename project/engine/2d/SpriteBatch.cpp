@@ -0,0 +1,84 @@
+﻿#include "SpriteBatch.h"
+#include "DirectXCommon.h"
+#include "Sprite.h"
+#include "SpriteCommon.h"
+#include "TextureManager.h"
+#include <cassert>
+#include <cstring>
+
+namespace {
+// SpriteBatchBuilderの区間をコマンドリストへ積む
+struct CommandListRecorder {
+  ID3D12GraphicsCommandList *commandList;
+
+  void SetTexture(uint32_t textureIndex) {
+    commandList->SetGraphicsRootDescriptorTable(
+        2, TextureManager::GetInstance()->GetSrvHandleGPU(textureIndex));
+  }
+  void SetInstanceOffset(uint32_t firstInstance) {
+    commandList->SetGraphicsRoot32BitConstant(1, firstInstance, 0);
+  }
+  void DrawInstances(uint32_t count) {
+    // ６個のインデックスの矩形をcount個描く
+    commandList->DrawIndexedInstanced(6, count, 0, 0, 0);
+  }
+};
+} // namespace
+
+void SpriteBatch::Initialize(SpriteCommon *spriteCommon) {
+  // 引数で受け取ってメンバ変数に記録する
+  spriteCommon_ = spriteCommon;
+}
+
+void SpriteBatch::Begin() {
+  submitted.clear();
+  queue.Clear();
+  builder.Clear();
+}
+
+void SpriteBatch::Draw(const Sprite &sprite, uint32_t layer) {
+  Draw(sprite.GetInstance(), layer);
+}
+
+void SpriteBatch::Draw(const SpriteInstance &instance, uint32_t layer) {
+  // ブレンド・パイプラインは今は1種類だけ
+  queue.Add(RenderQueue::MakeKey(layer, 0, 0, instance.textureIndex),
+            static_cast<uint32_t>(submitted.size()));
+  submitted.push_back(instance);
+}
+
+void SpriteBatch::End() {
+  // ステートの同じものが隣り合うように並べ替えてから区間にまとめる
+  unsortedDrawCallCount = queue.CountStateChanges();
+  queue.Sort();
+  for (const RenderItem &item : queue.GetItems()) {
+    builder.Add(submitted[item.index]);
+  }
+
+  const std::vector<SpriteInstance> &instances = builder.GetInstances();
+  instanceCount = static_cast<uint32_t>(instances.size());
+  drawCallCount = static_cast<uint32_t>(builder.GetRuns().size());
+  if (instances.empty()) {
+    return;
+  }
+
+  // このフレームのアップロード領域へまとめて1回で転送
+  DirectXCommon *dxCommon = spriteCommon_->GetDxCommon();
+  UploadAllocation allocation = dxCommon->AllocateUpload(
+      sizeof(SpriteInstance) * instances.size(), alignof(SpriteInstance));
+  std::memcpy(allocation.cpuAddress, instances.data(),
+              sizeof(SpriteInstance) * instances.size());
+
+  // テクスチャの区間ごとに描画。区間が多ければ記録スレッドで分担する
+  // 共通の設定はコマンドリストごとに1回だけ
+  dxCommon->RecordParallel(
+      drawCallCount, kMinRunsPerCommandList,
+      [&](ID3D12GraphicsCommandList *commandList, uint32_t firstRun,
+          uint32_t runCount) {
+        spriteCommon_->SetupSpriteDrawing(commandList);
+        commandList->SetGraphicsRootShaderResourceView(0,
+                                                       allocation.gpuAddress);
+        CommandListRecorder recorder{commandList};
+        builder.SubmitRuns(recorder, firstRun, runCount);
+      });
+}
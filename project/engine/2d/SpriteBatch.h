@@ -0,0 +1,55 @@
+﻿#pragma once
+#include "RenderQueue.h"
+#include "SpriteBatchBuilder.h"
+#include <cstdint>
+#include <d3d12.h>
+#include <wrl.h>
+
+class SpriteCommon;
+class Sprite;
+
+// 全スプライトのインスタンスデータを1本のバッファに詰め、
+// レイヤー・テクスチャ順に並べ替えて、テクスチャが切り替わるまでを
+// 1回のインスタンス描画で描く
+class SpriteBatch {
+public: // メンバ関数
+  // 初期化
+  void Initialize(SpriteCommon *spriteCommon);
+
+  // フレームの積み込み開始
+  void Begin();
+
+  // スプライトを積む（Updateで計算済みのインスタンスを使う）
+  // レイヤーの小さいものから描く。同じレイヤー内はテクスチャ順に並べ替え、
+  // 同じテクスチャの中だけ積んだ順を保つ。このため同じレイヤーで重なる
+  // 半透明のスプライトは、積んだ順（後に積んだものが手前）にならないことがある
+  // 積んだ順に重ねたいものは別のレイヤーに分けること
+  // （RenderQueueのキーは深度よりテクスチャが上位なので、深度では直らない）
+  void Draw(const Sprite &sprite, uint32_t layer = 0);
+  void Draw(const SpriteInstance &instance, uint32_t layer = 0);
+
+  // 積んだ分を並べ替え、バッファに書き込んで描画コマンドを積む
+  void End();
+
+  // 直近のEndで積んだ描画コール数
+  uint32_t GetDrawCallCount() const { return drawCallCount; }
+  // 直近のEndで積んだインスタンス数
+  uint32_t GetInstanceCount() const { return instanceCount; }
+  // 並べ替えなかった場合の描画コール数（積んだ順のステート切り替え回数）
+  uint32_t GetUnsortedDrawCallCount() const { return unsortedDrawCallCount; }
+
+  // 1つのコマンドリストに記録する最少の描画コール数（これより少なければ分けない）
+  static const uint32_t kMinRunsPerCommandList = 256;
+
+private:
+  SpriteCommon *spriteCommon_ = nullptr;
+
+  // 積んだ順のインスタンス。queueの並びでbuilderに詰め直す
+  std::vector<SpriteInstance> submitted;
+  RenderQueue queue;
+  SpriteBatchBuilder builder;
+
+  uint32_t drawCallCount = 0;
+  uint32_t instanceCount = 0;
+  uint32_t unsortedDrawCallCount = 0;
+};
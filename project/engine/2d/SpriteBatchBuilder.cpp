@@ -0,0 +1,19 @@
+﻿#include "SpriteBatchBuilder.h"
+
+void SpriteBatchBuilder::Clear() {
+  // 容量は残したまま中身だけ捨てる
+  instances.clear();
+  runs.clear();
+}
+
+void SpriteBatchBuilder::Add(const SpriteInstance &instance) {
+  uint32_t index = static_cast<uint32_t>(instances.size());
+  instances.push_back(instance);
+
+  // 直前の区間と同じテクスチャならまとめて描ける
+  if (!runs.empty() && runs.back().textureIndex == instance.textureIndex) {
+    runs.back().instanceCount++;
+    return;
+  }
+  runs.push_back({instance.textureIndex, index, 1});
+}
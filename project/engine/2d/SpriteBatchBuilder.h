@@ -0,0 +1,57 @@
+﻿#pragma once
+#include "Mymath.h"
+#include <cstdint>
+#include <vector>
+
+// スプライト1枚分のインスタンスデータ（StructuredBufferにそのまま詰める）
+struct SpriteInstance {
+  MyMath::Matrix4x4 WVP;
+  // 単位矩形を展開するローカル範囲（left, top, right, bottom）
+  MyMath::Vector4 localRect;
+  // テクスチャ座標の範囲（left, top, right, bottom）
+  MyMath::Vector4 uvRect;
+  MyMath::Vector4 color;
+  uint32_t textureIndex;
+  uint32_t padding[3];
+};
+
+// 同じテクスチャが連続する区間。1区間を1回のインスタンス描画で描く
+struct SpriteDrawRun {
+  uint32_t textureIndex;
+  uint32_t firstInstance;
+  uint32_t instanceCount;
+};
+
+// インスタンスの詰め込みと描画区間のまとめ（D3D12に依存しない部分）
+class SpriteBatchBuilder {
+public:
+  // 積んだインスタンスと描画区間を空にする
+  void Clear();
+
+  // インスタンスを追加する。直前と同じテクスチャなら区間を延ばす
+  void Add(const SpriteInstance &instance);
+
+  // 区間ごとにコマンドを積む
+  // Recorderは SetTexture / SetInstanceOffset / DrawInstances を持つこと
+  template <class Recorder> void Submit(Recorder &recorder) const {
+    SubmitRuns(recorder, 0, static_cast<uint32_t>(runs.size()));
+  }
+  // firstRun番目からrunCount個の区間だけ積む（並列記録で分担する用）
+  template <class Recorder>
+  void SubmitRuns(Recorder &recorder, uint32_t firstRun,
+                  uint32_t runCount) const {
+    for (uint32_t i = firstRun; i < firstRun + runCount; ++i) {
+      const SpriteDrawRun &run = runs[i];
+      recorder.SetTexture(run.textureIndex);
+      recorder.SetInstanceOffset(run.firstInstance);
+      recorder.DrawInstances(run.instanceCount);
+    }
+  }
+
+  const std::vector<SpriteInstance> &GetInstances() const { return instances; }
+  const std::vector<SpriteDrawRun> &GetRuns() const { return runs; }
+
+private:
+  std::vector<SpriteInstance> instances;
+  std::vector<SpriteDrawRun> runs;
+};
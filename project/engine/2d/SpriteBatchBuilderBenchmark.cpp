@@ -0,0 +1,51 @@
+﻿#include "Benchmark.h"
+#include "SpriteBatchBuilder.h"
+#include <cstdio>
+#include <vector>
+
+namespace {
+// 描画コールの数と積んだ値だけ数える（コマンドリストの代わり）
+struct CountingRecorder {
+  uint32_t drawCallCount = 0;
+  uint64_t checksum = 0;
+
+  void SetTexture(uint32_t textureIndex) { checksum += textureIndex; }
+  void SetInstanceOffset(uint32_t firstInstance) { checksum += firstInstance; }
+  void DrawInstances(uint32_t count) {
+    drawCallCount++;
+    checksum += count;
+  }
+};
+} // namespace
+
+// 1枚ずつ描く場合（スプライトの数だけ描画コール）と、
+// SpriteBatchBuilderでテクスチャの区間ごとにまとめた場合を比べる
+int main() {
+  const uint32_t kTextureCount = 8;
+  const uint32_t kRepeatCount = 20;
+
+  std::printf("%10s %14s %14s %14s\n", "sprites", "draws (each)",
+              "draws (batch)", "batch ms");
+  for (uint32_t spriteCount : {1000u, 10000u, 100000u}) {
+    // テクスチャごとにまとまって積まれる想定（テクスチャ順に並べた後）
+    std::vector<SpriteInstance> sprites(spriteCount);
+    for (uint32_t i = 0; i < spriteCount; ++i) {
+      sprites[i].textureIndex = i * kTextureCount / spriteCount;
+    }
+
+    SpriteBatchBuilder builder;
+    CountingRecorder recorder;
+    double ms = Benchmark::MeasureBestMs(kRepeatCount, [&]() {
+      builder.Clear();
+      for (const SpriteInstance &sprite : sprites) {
+        builder.Add(sprite);
+      }
+      recorder = CountingRecorder();
+      builder.Submit(recorder);
+    });
+    Benchmark::Consume(recorder.checksum);
+    std::printf("%10u %14u %14u %14.3f\n", spriteCount, spriteCount,
+                recorder.drawCallCount, ms);
+  }
+  return 0;
+}
@@ -0,0 +1,120 @@
+﻿#include "Check.h"
+#include "SpriteBatchBuilder.h"
+#include <vector>
+
+namespace {
+// コマンドリストの代わりに積まれたコマンドを記録する
+struct RecordingRecorder {
+  struct Command {
+    enum Type { kSetTexture, kSetInstanceOffset, kDrawInstances } type;
+    uint32_t value;
+  };
+  std::vector<Command> commands;
+
+  void SetTexture(uint32_t textureIndex) {
+    commands.push_back({Command::kSetTexture, textureIndex});
+  }
+  void SetInstanceOffset(uint32_t firstInstance) {
+    commands.push_back({Command::kSetInstanceOffset, firstInstance});
+  }
+  void DrawInstances(uint32_t count) {
+    commands.push_back({Command::kDrawInstances, count});
+  }
+};
+
+SpriteInstance MakeInstance(uint32_t textureIndex, float x) {
+  SpriteInstance instance{};
+  instance.textureIndex = textureIndex;
+  instance.localRect = {x, 0.0f, 1.0f, 1.0f};
+  return instance;
+}
+
+void TestRunsMergeConsecutiveTextures() {
+  SpriteBatchBuilder builder;
+  uint32_t textures[] = {3, 3, 3, 5, 5, 3, 7};
+  for (uint32_t i = 0; i < 7; ++i) {
+    builder.Add(MakeInstance(textures[i], float(i)));
+  }
+
+  // 積んだ順はそのまま。同じテクスチャが続く所だけ1区間になる
+  CHECK(builder.GetInstances().size() == 7);
+  for (uint32_t i = 0; i < 7; ++i) {
+    CHECK(builder.GetInstances()[i].localRect.x == float(i));
+  }
+  const std::vector<SpriteDrawRun> &runs = builder.GetRuns();
+  CHECK(runs.size() == 4);
+  CHECK(runs[0].textureIndex == 3 && runs[0].firstInstance == 0 &&
+        runs[0].instanceCount == 3);
+  CHECK(runs[1].textureIndex == 5 && runs[1].firstInstance == 3 &&
+        runs[1].instanceCount == 2);
+  CHECK(runs[2].textureIndex == 3 && runs[2].firstInstance == 5 &&
+        runs[2].instanceCount == 1);
+  CHECK(runs[3].textureIndex == 7 && runs[3].firstInstance == 6 &&
+        runs[3].instanceCount == 1);
+}
+
+void TestSubmitRecordsOneDrawPerRun() {
+  SpriteBatchBuilder builder;
+  for (uint32_t i = 0; i < 10; ++i) {
+    builder.Add(MakeInstance(i < 6 ? 1 : 2, 0.0f));
+  }
+  RecordingRecorder recorder;
+  builder.Submit(recorder);
+
+  using Command = RecordingRecorder::Command;
+  CHECK(recorder.commands.size() == 6);
+  CHECK(recorder.commands[0].type == Command::kSetTexture &&
+        recorder.commands[0].value == 1);
+  CHECK(recorder.commands[1].type == Command::kSetInstanceOffset &&
+        recorder.commands[1].value == 0);
+  CHECK(recorder.commands[2].type == Command::kDrawInstances &&
+        recorder.commands[2].value == 6);
+  CHECK(recorder.commands[3].value == 2);
+  CHECK(recorder.commands[4].value == 6);
+  CHECK(recorder.commands[5].value == 4);
+}
+
+void TestSubmitRunsCoversRange() {
+  SpriteBatchBuilder builder;
+  for (uint32_t i = 0; i < 8; ++i) {
+    builder.Add(MakeInstance(i, 0.0f));
+  }
+  // 範囲ごとに分けて積んでも、まとめて積んだのと同じになる
+  RecordingRecorder whole;
+  builder.Submit(whole);
+  RecordingRecorder split;
+  builder.SubmitRuns(split, 0, 3);
+  builder.SubmitRuns(split, 3, 5);
+  CHECK(whole.commands.size() == split.commands.size());
+  for (size_t i = 0; i < whole.commands.size(); ++i) {
+    CHECK(whole.commands[i].type == split.commands[i].type &&
+          whole.commands[i].value == split.commands[i].value);
+  }
+}
+
+void TestClearKeepsNothing() {
+  SpriteBatchBuilder builder;
+  builder.Add(MakeInstance(1, 0.0f));
+  builder.Clear();
+  CHECK(builder.GetInstances().empty());
+  CHECK(builder.GetRuns().empty());
+
+  // 空なら何も積まない
+  RecordingRecorder recorder;
+  builder.Submit(recorder);
+  CHECK(recorder.commands.empty());
+
+  // Clearの後の最初の1枚は前の区間とつながらない
+  builder.Add(MakeInstance(1, 0.0f));
+  CHECK(builder.GetRuns().size() == 1 &&
+        builder.GetRuns()[0].firstInstance == 0);
+}
+} // namespace
+
+int main() {
+  TestRunsMergeConsecutiveTextures();
+  TestSubmitRecordsOneDrawPerRun();
+  TestSubmitRunsCoversRange();
+  TestClearKeepsNothing();
+  return Test::Finish();
+}
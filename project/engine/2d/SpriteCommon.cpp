@@ -1,21 +1,57 @@
 ﻿#include "SpriteCommon.h"
 #include "DirectXCommon.h"
+#include "WinApp.h"
 
 void SpriteCommon::Initialize(DirectXCommon *dxCommon) {
   // 引数で受け取ってメンバ変数に記録する
   dxCommon_ = dxCommon;
 
+  SetViewport(float(WinApp::kClientWidth), float(WinApp::kClientHeight));
+
   CreateGraphicsPipelineState();
+  CreateSpriteGraphicsPipelineState();
+  CreateQuad();
+}
+
+void SpriteCommon::SetViewport(float width, float height) {
+  if (viewProjectionVersion != 0 && width == viewportWidth &&
+      height == viewportHeight) {
+    return;
+  }
+  viewportWidth = width;
+  viewportHeight = height;
+
+  // ビューは単位行列なので射影行列がそのままビュー×射影になる
+  viewProjectionMatrix = MyMath::Math::MakeOrthographicMatrix(
+      0.0f, 0.0f, width, height, 0.0f, 100.0f);
+  frustum = MyMath::Culling::MakeFrustum(viewProjectionMatrix);
+  // 全スプライトの行列が次のUpdateで作り直される
+  viewProjectionVersion++;
 }
 
 void SpriteCommon::SetupCommonDrawing() {
+  SetupCommonDrawing(dxCommon_->GetCommandList());
+}
+
+void SpriteCommon::SetupCommonDrawing(ID3D12GraphicsCommandList *commandList) {
   // RootSignatureを設定。PSOに設定しているけど別途設定が必要
-  dxCommon_->GetCommandList()->SetGraphicsRootSignature(rootSignature.Get());
-  dxCommon_->GetCommandList()->SetPipelineState(
-      graphicsPipelineState.Get()); // PSOを設定
+  commandList->SetGraphicsRootSignature(rootSignature.Get());
+  commandList->SetPipelineState(graphicsPipelineState.Get()); // PSOを設定
   // 形状を設定。PSOに設定しているものとはまた別。同じものを設定すると考えておけばいいい
-  dxCommon_->GetCommandList()->IASetPrimitiveTopology(
-      D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+  commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+}
+
+void SpriteCommon::SetupSpriteDrawing() {
+  SetupSpriteDrawing(dxCommon_->GetCommandList());
+}
+
+void SpriteCommon::SetupSpriteDrawing(ID3D12GraphicsCommandList *commandList) {
+  commandList->SetGraphicsRootSignature(spriteRootSignature.Get());
+  commandList->SetPipelineState(spriteGraphicsPipelineState.Get());
+  commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+  // 全スプライトで同じ単位矩形を使う
+  commandList->IASetVertexBuffers(0, 1, &quadVertexBufferView);
+  commandList->IASetIndexBuffer(&quadIndexBufferView);
 }
 
 void SpriteCommon::CreateRootSignature() {
@@ -170,4 +206,167 @@ void SpriteCommon::CreateGraphicsPipelineState() {
   hr = dxCommon_->GetDevice()->CreateGraphicsPipelineState(
       &graphicsPipelinStateDesc, IID_PPV_ARGS(&graphicsPipelineState));
   assert(SUCCEEDED(hr));
-}
\ No newline at end of file
+}
+
+void SpriteCommon::CreateSpriteRootSignature() {
+  HRESULT hr;
+
+  // RootSignature作成
+  D3D12_ROOT_SIGNATURE_DESC descriptionRootSignature{};
+  descriptionRootSignature.Flags =
+      D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+
+  // DescriptorRange
+  D3D12_DESCRIPTOR_RANGE descriptorRange[1] = {};
+  descriptorRange[0].BaseShaderRegister = 0; // 0から始まる
+  descriptorRange[0].NumDescriptors = 1;     // 数は１つ
+  descriptorRange[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV; // SRVを使う
+  descriptorRange[0].OffsetInDescriptorsFromTableStart =
+      D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND; // offsetを自動計算
+
+  D3D12_ROOT_PARAMETER rootParameters[3] = {};
+  // インスタンスデータのStructuredBuffer
+  rootParameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+  rootParameters[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+  rootParameters[0].Descriptor.ShaderRegister = 0;
+  // 描画区間の先頭インスタンス番号
+  rootParameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+  rootParameters[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+  rootParameters[1].Constants.ShaderRegister = 0;
+  rootParameters[1].Constants.Num32BitValues = 1;
+  // テクスチャ
+  rootParameters[2].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+  rootParameters[2].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+  rootParameters[2].DescriptorTable.pDescriptorRanges = descriptorRange;
+  rootParameters[2].DescriptorTable.NumDescriptorRanges =
+      _countof(descriptorRange);
+
+  descriptionRootSignature.pParameters = rootParameters;
+  descriptionRootSignature.NumParameters = _countof(rootParameters);
+
+  // Samplerの設定
+  D3D12_STATIC_SAMPLER_DESC staticSamplers[1] = {};
+  staticSamplers[0].Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
+  staticSamplers[0].AddressU = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+  staticSamplers[0].AddressV = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+  staticSamplers[0].AddressW = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+  staticSamplers[0].ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+  staticSamplers[0].MaxLOD = D3D12_FLOAT32_MAX;
+  staticSamplers[0].ShaderRegister = 0;
+  staticSamplers[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+  descriptionRootSignature.pStaticSamplers = staticSamplers;
+  descriptionRootSignature.NumStaticSamplers = _countof(staticSamplers);
+
+  ////シリアライズしてバイナリにする
+  Microsoft::WRL::ComPtr<ID3DBlob> signatureBlob = nullptr;
+  Microsoft::WRL::ComPtr<ID3DBlob> errorBlob = nullptr;
+  hr = D3D12SerializeRootSignature(&descriptionRootSignature,
+                                   D3D_ROOT_SIGNATURE_VERSION_1, &signatureBlob,
+                                   &errorBlob);
+  if (FAILED(hr)) {
+    assert(false);
+  }
+
+  hr = dxCommon_->GetDevice()->CreateRootSignature(
+      0, signatureBlob->GetBufferPointer(), signatureBlob->GetBufferSize(),
+      IID_PPV_ARGS(&spriteRootSignature));
+  assert(SUCCEEDED(hr));
+}
+
+void SpriteCommon::CreateSpriteGraphicsPipelineState() {
+  HRESULT hr;
+  CreateSpriteRootSignature();
+
+  // InputLayout。頂点は単位矩形の角だけ
+  D3D12_INPUT_ELEMENT_DESC inputElementDescs[1] = {};
+  inputElementDescs[0].SemanticName = "POSITION";
+  inputElementDescs[0].SemanticIndex = 0;
+  inputElementDescs[0].Format = DXGI_FORMAT_R32G32_FLOAT;
+  inputElementDescs[0].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
+
+  D3D12_INPUT_LAYOUT_DESC inputLayoutDesc{};
+  inputLayoutDesc.pInputElementDescs = inputElementDescs;
+  inputLayoutDesc.NumElements = _countof(inputElementDescs);
+
+  // BlendStateの設定
+  D3D12_BLEND_DESC blendDesc{};
+  blendDesc.RenderTarget[0].RenderTargetWriteMask =
+      D3D12_COLOR_WRITE_ENABLE_ALL;
+
+  // RasiterZerStateの設定
+  D3D12_RASTERIZER_DESC rasterizeDesc{};
+  rasterizeDesc.CullMode = D3D12_CULL_MODE_NONE;
+  rasterizeDesc.FillMode = D3D12_FILL_MODE_SOLID;
+
+  // shaderをコンバイルする
+  Microsoft::WRL::ComPtr<IDxcBlob> vertexShaderBlob =
+      dxCommon_->CompileShader(L"resources/shaders/Sprite.VS.hlsl", L"vs_6_0");
+  assert(vertexShaderBlob != nullptr);
+
+  Microsoft::WRL::ComPtr<IDxcBlob> pixelShaderBlob =
+      dxCommon_->CompileShader(L"resources/shaders/Sprite.PS.hlsl", L"ps_6_0");
+  assert(pixelShaderBlob != nullptr);
+
+  // PSOを生成する
+  D3D12_GRAPHICS_PIPELINE_STATE_DESC graphicsPipelinStateDesc{};
+  graphicsPipelinStateDesc.pRootSignature = spriteRootSignature.Get();
+  graphicsPipelinStateDesc.InputLayout = inputLayoutDesc;
+  graphicsPipelinStateDesc.VS = {vertexShaderBlob->GetBufferPointer(),
+                                 vertexShaderBlob->GetBufferSize()};
+  graphicsPipelinStateDesc.PS = {pixelShaderBlob->GetBufferPointer(),
+                                 pixelShaderBlob->GetBufferSize()};
+  graphicsPipelinStateDesc.BlendState = blendDesc;
+  graphicsPipelinStateDesc.RasterizerState = rasterizeDesc;
+  graphicsPipelinStateDesc.NumRenderTargets = 1;
+  graphicsPipelinStateDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+  graphicsPipelinStateDesc.PrimitiveTopologyType =
+      D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+  graphicsPipelinStateDesc.SampleDesc.Count = 1;
+  graphicsPipelinStateDesc.SampleMask = D3D12_DEFAULT_SAMPLE_MASK;
+
+  // スプライトは深度を使わない
+  D3D12_DEPTH_STENCIL_DESC depthStencilDesc{};
+  depthStencilDesc.DepthEnable = false;
+  depthStencilDesc.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO;
+  depthStencilDesc.DepthFunc = D3D12_COMPARISON_FUNC_LESS_EQUAL;
+
+  graphicsPipelinStateDesc.DepthStencilState = depthStencilDesc;
+  graphicsPipelinStateDesc.DSVFormat = DXGI_FORMAT_D24_UNORM_S8_UINT;
+
+  hr = dxCommon_->GetDevice()->CreateGraphicsPipelineState(
+      &graphicsPipelinStateDesc, IID_PPV_ARGS(&spriteGraphicsPipelineState));
+  assert(SUCCEEDED(hr));
+}
+
+void SpriteCommon::CreateQuad() {
+  quadVertexResource = dxCommon_->CreateBufferResource(sizeof(QuadVertex) * 4);
+  quadIndexResource = dxCommon_->CreateBufferResource(sizeof(uint32_t) * 6);
+
+  quadVertexBufferView.BufferLocation =
+      quadVertexResource->GetGPUVirtualAddress();
+  quadVertexBufferView.SizeInBytes = sizeof(QuadVertex) * 4;
+  quadVertexBufferView.StrideInBytes = sizeof(QuadVertex);
+
+  quadIndexBufferView.BufferLocation = quadIndexResource->GetGPUVirtualAddress();
+  quadIndexBufferView.SizeInBytes = sizeof(uint32_t) * 6;
+  quadIndexBufferView.Format = DXGI_FORMAT_R32_UINT;
+
+  // 並びは左下、左上、右下、右上
+  QuadVertex *vertexData = nullptr;
+  quadVertexResource->Map(0, nullptr, reinterpret_cast<void **>(&vertexData));
+  vertexData[0].corner = {0.0f, 1.0f};
+  vertexData[1].corner = {0.0f, 0.0f};
+  vertexData[2].corner = {1.0f, 1.0f};
+  vertexData[3].corner = {1.0f, 0.0f};
+  quadVertexResource->Unmap(0, nullptr);
+
+  uint32_t *indexData = nullptr;
+  quadIndexResource->Map(0, nullptr, reinterpret_cast<void **>(&indexData));
+  indexData[0] = 0;
+  indexData[1] = 1;
+  indexData[2] = 2;
+  indexData[3] = 1;
+  indexData[4] = 3;
+  indexData[5] = 2;
+  quadIndexResource->Unmap(0, nullptr);
+}
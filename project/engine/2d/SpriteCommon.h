@@ -1,4 +1,7 @@
 ﻿#pragma once
+#include "Bounds.h"
+#include "TransformBatch.h"
+#include <cstdint>
 #include <d3d12.h>
 #include <wrl.h>
 
@@ -13,10 +16,38 @@ public: // メンバ関数
 
   DirectXCommon *GetDxCommon() const { return dxCommon_; }
 
+  // 全スプライト共通のビュー×射影行列
+  const MyMath::Matrix4x4 &GetViewProjectionMatrix() const {
+    return viewProjectionMatrix;
+  }
+  // ビュー×射影を作り直すたびに増える版。スプライトはこれで行列の古さを知る
+  uint32_t GetViewProjectionVersion() const { return viewProjectionVersion; }
+  // 画面の大きさを変える。変わったときだけビュー×射影と視錐台を作り直す
+  void SetViewport(float width, float height);
+  // 画面の視錐台（スプライトの見える範囲）
+  const MyMath::Frustum &GetFrustum() const { return frustum; }
+  // スプライトの行列をまとめて計算するバッチ
+  MyMath::TransformBatch &GetTransformBatch() { return transformBatch; }
+
   // 共通描画設定
   void SetupCommonDrawing();
+  void SetupCommonDrawing(ID3D12GraphicsCommandList *commandList);
+  // スプライト描画設定（インスタンスデータ用のPSOと共有の単位矩形）
+  void SetupSpriteDrawing();
+  // 並列記録用。指定したコマンドリストに設定する
+  void SetupSpriteDrawing(ID3D12GraphicsCommandList *commandList);
+
+  // 共有の単位矩形が使うバイト数（頂点＋インデックス）
+  size_t GetQuadSizeInBytes() const {
+    return sizeof(QuadVertex) * 4 + sizeof(uint32_t) * 6;
+  }
 
 private:
+  // 単位矩形の頂点
+  struct QuadVertex {
+    MyMath::Vector2 corner;
+  };
+
   ////バイナリを元に生成
   Microsoft::WRL::ComPtr<ID3D12RootSignature> rootSignature = nullptr;
 
@@ -27,6 +58,28 @@ private:
   void CreateRootSignature();
   // グラフィックスパイプラインの生成
   void CreateGraphicsPipelineState();
+  // スプライト用（インスタンスデータを読む）のルートシグネチャとPSO
+  void CreateSpriteRootSignature();
+  void CreateSpriteGraphicsPipelineState();
+  // 全スプライトで共有する単位矩形の生成
+  void CreateQuad();
 
   DirectXCommon *dxCommon_;
+
+  Microsoft::WRL::ComPtr<ID3D12RootSignature> spriteRootSignature = nullptr;
+  Microsoft::WRL::ComPtr<ID3D12PipelineState> spriteGraphicsPipelineState =
+      nullptr;
+
+  // 単位矩形の頂点・インデックス
+  Microsoft::WRL::ComPtr<ID3D12Resource> quadVertexResource;
+  Microsoft::WRL::ComPtr<ID3D12Resource> quadIndexResource;
+  D3D12_VERTEX_BUFFER_VIEW quadVertexBufferView{};
+  D3D12_INDEX_BUFFER_VIEW quadIndexBufferView{};
+
+  MyMath::Matrix4x4 viewProjectionMatrix;
+  MyMath::Frustum frustum;
+  uint32_t viewProjectionVersion = 0;
+  float viewportWidth = 0.0f;
+  float viewportHeight = 0.0f;
+  MyMath::TransformBatch transformBatch;
 };
\ No newline at end of file
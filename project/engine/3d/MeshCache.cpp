@@ -0,0 +1,293 @@
+﻿#include "MeshCache.h"
+#include "ObjParser.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <utility>
+
+const char *const MeshCache::kExtension = ".meshcache";
+
+namespace {
+// ファイル先頭の識別子
+const char kMagic[4] = {'M', 'S', 'H', 'C'};
+// 区画の境界
+const uint64_t kSectionAlignment = 16;
+
+uint64_t AlignSection(uint64_t offset) {
+  return (offset + kSectionAlignment - 1) & ~(kSectionAlignment - 1);
+}
+
+// 区画がファイルに収まっていて、境界にそろっているか
+// countは32bitなので、elementSizeを掛けても64bitからあふれない
+bool IsSectionInFile(uint64_t offset, uint64_t count, uint64_t elementSize,
+                     uint64_t fileSize) {
+  return offset % kSectionAlignment == 0 && offset <= fileSize &&
+         count * elementSize <= fileSize - offset;
+}
+
+// FNV-1a
+uint64_t HashBytes(const char *data, size_t size) {
+  uint64_t hash = 14695981039346656037ull;
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= static_cast<uint8_t>(data[i]);
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+// 文字列を固定長に収める
+template <size_t kSize>
+void CopyString(char (&destination)[kSize], const std::string &source) {
+  assert(source.size() < sizeof(destination));
+  std::memset(destination, 0, sizeof(destination));
+  std::memcpy(destination, source.data(),
+              std::min(source.size(), sizeof(destination) - 1));
+}
+} // namespace
+
+bool MeshCache::Open(const std::string &directoryPath,
+                     const std::string &filename) {
+  Close();
+
+  std::string cacheFilePath = GetCacheFilePath(directoryPath, filename);
+  if (IsFresh(cacheFilePath) && Map(cacheFilePath)) {
+    return true;
+  }
+
+  // 古いか無いのでobjを読んで作り直す
+  ModelData modelData = ObjParser::LoadObjFile(directoryPath, filename);
+  if (!Write(cacheFilePath, directoryPath + "/" + filename, modelData)) {
+    return false;
+  }
+  return Map(cacheFilePath);
+}
+
+void MeshCache::Close() {
+  file.Close();
+  header = nullptr;
+  vertices = nullptr;
+  indices = nullptr;
+  subMeshes = nullptr;
+  materials = nullptr;
+}
+
+std::string MeshCache::GetCacheFilePath(const std::string &directoryPath,
+                                        const std::string &filename) {
+  return directoryPath + "/" + filename + kExtension;
+}
+
+bool MeshCache::IsFresh(const std::string &cacheFilePath) {
+  MappedFile cacheFile;
+  if (!cacheFile.Open(cacheFilePath) || cacheFile.GetSize() < sizeof(Header)) {
+    return false;
+  }
+  const Header *cacheHeader =
+      reinterpret_cast<const Header *>(cacheFile.GetData());
+  if (std::memcmp(cacheHeader->magic, kMagic, sizeof(kMagic)) != 0 ||
+      cacheHeader->version != kVersion) {
+    return false;
+  }
+
+  // 壊れたファイルで範囲外を読まない
+  if (!IsSectionInFile(cacheHeader->sourceOffset, cacheHeader->sourceCount,
+                       sizeof(SourceStamp), cacheFile.GetSize())) {
+    return false;
+  }
+
+  const SourceStamp *stamps = reinterpret_cast<const SourceStamp *>(
+      cacheFile.GetData() + cacheHeader->sourceOffset);
+  // 中身は同じで日時だけ変わった元ファイル（番号と新しい日時）
+  std::vector<std::pair<uint32_t, int64_t>> touchedSources;
+  for (uint32_t i = 0; i < cacheHeader->sourceCount; ++i) {
+    const SourceStamp &cached = stamps[i];
+    std::error_code ec;
+    std::filesystem::path sourcePath = cached.filePath;
+    uint64_t size = std::filesystem::file_size(sourcePath, ec);
+    if (ec || size != cached.size) {
+      return false;
+    }
+    // 更新日時が同じならそれで良しとする
+    int64_t writeTime = static_cast<int64_t>(
+        std::filesystem::last_write_time(sourcePath, ec)
+            .time_since_epoch()
+            .count());
+    if (!ec && writeTime == cached.writeTime) {
+      continue;
+    }
+    // 日時だけ変わった（チェックアウトし直した等）なら中身で比べる
+    SourceStamp current{};
+    if (!MakeSourceStamp(cached.filePath, current) ||
+        current.hash != cached.hash) {
+      return false;
+    }
+    touchedSources.emplace_back(i, current.writeTime);
+  }
+  if (touchedSources.empty()) {
+    return true;
+  }
+
+  // 次からは日時だけで済むように、記録してある日時を書き換える
+  // （マップしたままでは書けない環境があるので閉じてから）
+  uint64_t sourceOffset = cacheHeader->sourceOffset;
+  cacheFile.Close();
+  std::fstream output(cacheFilePath,
+                      std::ios::binary | std::ios::in | std::ios::out);
+  for (const std::pair<uint32_t, int64_t> &touched : touchedSources) {
+    output.seekp(static_cast<std::streamoff>(
+        sourceOffset + sizeof(SourceStamp) * touched.first +
+        offsetof(SourceStamp, writeTime)));
+    output.write(reinterpret_cast<const char *>(&touched.second),
+                 sizeof(touched.second));
+  }
+  // 書けなくても中身は同じなので使ってよい
+  return true;
+}
+
+bool MeshCache::Write(const std::string &cacheFilePath,
+                      const std::string &objFilePath,
+                      const ModelData &modelData) {
+  // 元ファイル
+  std::vector<SourceStamp> stamps(1);
+  if (!MakeSourceStamp(objFilePath, stamps[0])) {
+    return false;
+  }
+  if (!modelData.materialFilePath.empty()) {
+    stamps.emplace_back();
+    if (!MakeSourceStamp(modelData.materialFilePath, stamps.back())) {
+      return false;
+    }
+  }
+
+  // 頂点数が少なければ16bitで持つ
+  uint32_t indexSize = modelData.CanUse16BitIndices() ? 2 : 4;
+
+  // 各区画の位置を決める
+  Header fileHeader{};
+  std::memcpy(fileHeader.magic, kMagic, sizeof(kMagic));
+  fileHeader.version = kVersion;
+  fileHeader.sourceCount = static_cast<uint32_t>(stamps.size());
+  fileHeader.vertexCount = static_cast<uint32_t>(modelData.vertices.size());
+  fileHeader.indexCount = static_cast<uint32_t>(modelData.indices.size());
+  fileHeader.indexSize = indexSize;
+  fileHeader.subMeshCount = static_cast<uint32_t>(modelData.subMeshes.size());
+  fileHeader.materialCount = static_cast<uint32_t>(modelData.materials.size());
+  fileHeader.boundsMin = modelData.boundsMin;
+  fileHeader.boundsMax = modelData.boundsMax;
+  fileHeader.sourceOffset = AlignSection(sizeof(Header));
+  fileHeader.vertexOffset = AlignSection(
+      fileHeader.sourceOffset + sizeof(SourceStamp) * stamps.size());
+  fileHeader.indexOffset = AlignSection(
+      fileHeader.vertexOffset + sizeof(VertexData) * fileHeader.vertexCount);
+  fileHeader.subMeshOffset = AlignSection(
+      fileHeader.indexOffset + uint64_t(indexSize) * fileHeader.indexCount);
+  fileHeader.materialOffset = AlignSection(
+      fileHeader.subMeshOffset + sizeof(SubMesh) * fileHeader.subMeshCount);
+  uint64_t fileSize =
+      fileHeader.materialOffset + sizeof(Material) * fileHeader.materialCount;
+
+  // メモリ上で組み立ててから1回で書く
+  std::vector<char> buffer(fileSize, 0);
+  std::memcpy(buffer.data(), &fileHeader, sizeof(Header));
+  std::memcpy(buffer.data() + fileHeader.sourceOffset, stamps.data(),
+              sizeof(SourceStamp) * stamps.size());
+  std::memcpy(buffer.data() + fileHeader.vertexOffset,
+              modelData.vertices.data(),
+              sizeof(VertexData) * modelData.vertices.size());
+  if (indexSize == 2) {
+    uint16_t *indices16 =
+        reinterpret_cast<uint16_t *>(buffer.data() + fileHeader.indexOffset);
+    for (size_t i = 0; i < modelData.indices.size(); ++i) {
+      indices16[i] = static_cast<uint16_t>(modelData.indices[i]);
+    }
+  } else {
+    std::memcpy(buffer.data() + fileHeader.indexOffset,
+                modelData.indices.data(),
+                sizeof(uint32_t) * modelData.indices.size());
+  }
+  std::memcpy(buffer.data() + fileHeader.subMeshOffset,
+              modelData.subMeshes.data(),
+              sizeof(SubMesh) * modelData.subMeshes.size());
+  Material *cachedMaterials =
+      reinterpret_cast<Material *>(buffer.data() + fileHeader.materialOffset);
+  for (size_t i = 0; i < modelData.materials.size(); ++i) {
+    const MaterialData &materialData = modelData.materials[i];
+    CopyString(cachedMaterials[i].name, materialData.name);
+    cachedMaterials[i].diffuseColor = materialData.diffuseColor;
+    cachedMaterials[i].alpha = materialData.alpha;
+    CopyString(cachedMaterials[i].textureFilePath,
+               materialData.textureFilePath);
+  }
+
+  std::ofstream output(cacheFilePath, std::ios::binary | std::ios::trunc);
+  if (!output) {
+    return false;
+  }
+  output.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+  return static_cast<bool>(output);
+}
+
+MaterialData MeshCache::GetMaterialData(uint32_t materialIndex) const {
+  // 範囲外指定違反チェック
+  assert(materialIndex < GetMaterialCount());
+  const Material &material = materials[materialIndex];
+  MaterialData materialData;
+  materialData.name = material.name;
+  materialData.diffuseColor = material.diffuseColor;
+  materialData.alpha = material.alpha;
+  materialData.textureFilePath = material.textureFilePath;
+  return materialData;
+}
+
+bool MeshCache::MakeSourceStamp(const std::string &filePath,
+                                SourceStamp &stamp) {
+  MappedFile sourceFile;
+  if (!sourceFile.Open(filePath)) {
+    return false;
+  }
+  std::error_code ec;
+  int64_t writeTime = static_cast<int64_t>(
+      std::filesystem::last_write_time(filePath, ec)
+          .time_since_epoch()
+          .count());
+  if (ec) {
+    return false;
+  }
+
+  CopyString(stamp.filePath, filePath);
+  stamp.size = sourceFile.GetSize();
+  stamp.writeTime = writeTime;
+  stamp.hash = HashBytes(sourceFile.GetData(), sourceFile.GetSize());
+  return true;
+}
+
+bool MeshCache::Map(const std::string &cacheFilePath) {
+  if (!file.Open(cacheFilePath) || file.GetSize() < sizeof(Header)) {
+    return false;
+  }
+  const char *base = file.GetData();
+  header = reinterpret_cast<const Header *>(base);
+  // どの区画も範囲外を指していないか
+  uint64_t fileSize = file.GetSize();
+  if ((header->indexSize != 2 && header->indexSize != 4) ||
+      !IsSectionInFile(header->sourceOffset, header->sourceCount,
+                       sizeof(SourceStamp), fileSize) ||
+      !IsSectionInFile(header->vertexOffset, header->vertexCount,
+                       sizeof(VertexData), fileSize) ||
+      !IsSectionInFile(header->indexOffset, header->indexCount,
+                       header->indexSize, fileSize) ||
+      !IsSectionInFile(header->subMeshOffset, header->subMeshCount,
+                       sizeof(SubMesh), fileSize) ||
+      !IsSectionInFile(header->materialOffset, header->materialCount,
+                       sizeof(Material), fileSize)) {
+    Close();
+    return false;
+  }
+  vertices = reinterpret_cast<const VertexData *>(base + header->vertexOffset);
+  indices = base + header->indexOffset;
+  subMeshes = reinterpret_cast<const SubMesh *>(base + header->subMeshOffset);
+  materials = reinterpret_cast<const Material *>(base + header->materialOffset);
+  return true;
+}
@@ -0,0 +1,97 @@
+﻿#pragma once
+#include "MappedFile.h"
+#include "ModelData.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 重複除去済みの頂点・インデックス・サブメッシュ・マテリアル・囲む箱を
+// そのまま並べたバイナリファイル。メモリにマップして解析せずに使う
+// 元のobj/mtlの大きさ・更新日時・ハッシュを持ち、変わっていたら作り直す
+class MeshCache {
+public:
+  // ファイルの版。中身の並びを変えたら上げる
+  static const uint32_t kVersion = 2;
+  // キャッシュファイルの拡張子
+  static const char *const kExtension;
+
+  // キャッシュに保存するマテリアル
+  struct Material {
+    char name[64];
+    MyMath::Vector3 diffuseColor;
+    float alpha;
+    char textureFilePath[260];
+  };
+
+  // キャッシュが新しければ開き、古いか無ければobjから作り直して開く
+  bool Open(const std::string &directoryPath, const std::string &filename);
+  // 閉じる
+  void Close();
+
+  // キャッシュファイルのパス（objと同じ場所に置く）
+  static std::string GetCacheFilePath(const std::string &directoryPath,
+                                      const std::string &filename);
+  // 元ファイルが変わっていなければtrue
+  // 日時だけ変わって中身が同じなら、記録してある日時を書き換える
+  static bool IsFresh(const std::string &cacheFilePath);
+  // モデルをキャッシュファイルに書き出す
+  static bool Write(const std::string &cacheFilePath,
+                    const std::string &objFilePath,
+                    const ModelData &modelData);
+
+  const VertexData *GetVertices() const { return vertices; }
+  uint32_t GetVertexCount() const { return header->vertexCount; }
+  // インデックスの先頭。GetIndexSizeが2ならuint16_t、4ならuint32_t
+  const void *GetIndices() const { return indices; }
+  uint32_t GetIndexCount() const { return header->indexCount; }
+  uint32_t GetIndexSize() const { return header->indexSize; }
+  const SubMesh *GetSubMeshes() const { return subMeshes; }
+  uint32_t GetSubMeshCount() const { return header->subMeshCount; }
+  const Material *GetMaterials() const { return materials; }
+  uint32_t GetMaterialCount() const { return header->materialCount; }
+  // マテリアルをModelDataと同じ形で取り出す
+  MaterialData GetMaterialData(uint32_t materialIndex) const;
+  const MyMath::Vector3 &GetBoundsMin() const { return header->boundsMin; }
+  const MyMath::Vector3 &GetBoundsMax() const { return header->boundsMax; }
+
+private:
+  // 元ファイルの情報
+  struct SourceStamp {
+    char filePath[260];
+    uint64_t size;
+    int64_t writeTime;
+    uint64_t hash;
+  };
+
+  // ファイル先頭
+  struct Header {
+    char magic[4];
+    uint32_t version;
+    uint32_t sourceCount;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t indexSize;
+    uint32_t subMeshCount;
+    uint32_t materialCount;
+    MyMath::Vector3 boundsMin;
+    MyMath::Vector3 boundsMax;
+    // 各区画のファイル先頭からの位置
+    uint64_t sourceOffset;
+    uint64_t vertexOffset;
+    uint64_t indexOffset;
+    uint64_t subMeshOffset;
+    uint64_t materialOffset;
+  };
+
+  // 元ファイルの情報を集める
+  static bool MakeSourceStamp(const std::string &filePath, SourceStamp &stamp);
+  // マップしたファイルの区画を指す
+  bool Map(const std::string &cacheFilePath);
+
+  MappedFile file;
+  const Header *header = nullptr;
+  const VertexData *vertices = nullptr;
+  const void *indices = nullptr;
+  const SubMesh *subMeshes = nullptr;
+  const Material *materials = nullptr;
+};
\ No newline at end of file
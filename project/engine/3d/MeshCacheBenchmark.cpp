@@ -0,0 +1,64 @@
+﻿#include "Benchmark.h"
+#include "MeshCache.h"
+#include "ObjParser.h"
+#include "ObjTestUtility.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+// objを毎回解析する場合と、MeshCacheのバイナリをマップする場合の読み込み時間
+// resourcesのあるディレクトリ（project）で実行する
+namespace {
+void Measure(const std::string &directory, const std::string &filename) {
+  ModelData modelData;
+  double textMs = Benchmark::MeasureBestMs(
+      5, [&]() { modelData = ObjParser::LoadObjFile(directory, filename); });
+
+  // 1回目で作っておき、2回目以降は新しいキャッシュを開くだけ
+  // マップしただけでは読まれないので、頂点とインデックスは写し取る
+  MeshCache cache;
+  cache.Open(directory, filename);
+  cache.Close();
+  std::vector<char> uploadBuffer;
+  double binaryMs = Benchmark::MeasureBestMs(5, [&]() {
+    cache.Open(directory, filename);
+    const char *vertices =
+        reinterpret_cast<const char *>(cache.GetVertices());
+    const char *indices = static_cast<const char *>(cache.GetIndices());
+    uploadBuffer.assign(vertices,
+                        vertices + sizeof(VertexData) * cache.GetVertexCount());
+    uploadBuffer.insert(uploadBuffer.end(), indices,
+                        indices + size_t(cache.GetIndexSize()) *
+                                      cache.GetIndexCount());
+    Benchmark::Consume(uploadBuffer.size());
+    cache.Close();
+  });
+  std::filesystem::remove(MeshCache::GetCacheFilePath(directory, filename));
+
+  std::printf("%-22s %10zu %12.3f %12.3f %8.1fx\n", filename.c_str(),
+              modelData.indices.size() / 3, textMs, binaryMs,
+              textMs / binaryMs);
+}
+} // namespace
+
+int main() {
+  std::printf("%-22s %10s %12s %12s %9s\n", "mesh", "triangles", "text ms",
+              "binary ms", "speedup");
+  for (const char *filename : {"plane.obj", "axis.obj", "multiMaterial.obj"}) {
+    Measure("resources", filename);
+  }
+
+  // 大きな格子は一時ディレクトリに書いて測る
+  std::filesystem::path directory = std::filesystem::temp_directory_path();
+  for (uint32_t quadCount : {256u, 1024u}) {
+    std::string filename = "grid" + std::to_string(quadCount) + ".obj";
+    {
+      std::string text = ObjTest::GenerateGridObj(quadCount);
+      std::ofstream file(directory / filename, std::ios::binary);
+      file.write(text.data(), static_cast<std::streamsize>(text.size()));
+    }
+    Measure(directory.string(), filename);
+    std::filesystem::remove(directory / filename);
+  }
+  return 0;
+}
@@ -0,0 +1,116 @@
+﻿#include "Check.h"
+#include "MeshCache.h"
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace {
+std::vector<char> ReadFile(const std::filesystem::path &filePath) {
+  std::ifstream file(filePath, std::ios::binary);
+  return std::vector<char>(std::istreambuf_iterator<char>(file), {});
+}
+
+void WriteFile(const std::filesystem::path &filePath,
+               const std::vector<char> &data) {
+  std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+  file.write(data.data(), static_cast<std::streamsize>(data.size()));
+}
+
+// ヘッダの中の値を書き換える（Headerの並びに合わせた位置）
+void Patch(const std::filesystem::path &filePath, size_t offset,
+           uint64_t value, size_t size) {
+  std::vector<char> data = ReadFile(filePath);
+  std::memcpy(data.data() + offset, &value, size);
+  WriteFile(filePath, data);
+}
+
+// Header内の位置
+const size_t kSourceCountOffset = 8;
+const size_t kVertexOffsetOffset = 64;
+const size_t kMaterialCountOffset = 28;
+
+void TestOpenAndReopen(const std::string &directory) {
+  std::string cachePath = MeshCache::GetCacheFilePath(directory, "plane.obj");
+  MeshCache cache;
+  CHECK(cache.Open(directory, "plane.obj"));
+  CHECK(std::filesystem::exists(cachePath));
+  CHECK(cache.GetIndexCount() == 6);
+  CHECK(cache.GetVertexCount() == 4);
+  CHECK(cache.GetIndexSize() == 2);
+  CHECK(MeshCache::IsFresh(cachePath));
+  cache.Close();
+}
+
+void TestCorruptedOffsets(const std::string &directory) {
+  std::string cachePath = MeshCache::GetCacheFilePath(directory, "plane.obj");
+  std::vector<char> original = ReadFile(cachePath);
+
+  // 元ファイルの情報がファイルをはみ出す
+  Patch(cachePath, kSourceCountOffset, 0x10000000, 4);
+  CHECK(!MeshCache::IsFresh(cachePath));
+  WriteFile(cachePath, original);
+
+  // 頂点の区画がファイルの外を指していたら、開くときに作り直す
+  Patch(cachePath, kVertexOffsetOffset, 1ull << 40, 8);
+  MeshCache cache;
+  CHECK(cache.Open(directory, "plane.obj"));
+  CHECK(cache.GetVertexCount() == 4);
+  cache.Close();
+  CHECK(ReadFile(cachePath) == original);
+
+  // マテリアル数だけ壊れていても同じ
+  Patch(cachePath, kMaterialCountOffset, 0xffffffff, 4);
+  CHECK(cache.Open(directory, "plane.obj"));
+  CHECK(cache.GetMaterialCount() == 1);
+  cache.Close();
+}
+
+void TestTouchedSourceRefreshesStamp(const std::string &directory) {
+  std::string cachePath = MeshCache::GetCacheFilePath(directory, "plane.obj");
+  std::filesystem::path objPath = directory + "/plane.obj";
+  // 中身はそのままで日時だけ進める
+  std::filesystem::file_time_type newTime =
+      std::filesystem::last_write_time(objPath) + std::chrono::hours(1);
+  std::filesystem::last_write_time(objPath, newTime);
+  int64_t newStamp =
+      static_cast<int64_t>(newTime.time_since_epoch().count());
+
+  auto containsStamp = [&]() {
+    std::vector<char> data = ReadFile(cachePath);
+    for (size_t i = 0; i + sizeof(newStamp) <= data.size(); ++i) {
+      if (std::memcmp(data.data() + i, &newStamp, sizeof(newStamp)) == 0) {
+        return true;
+      }
+    }
+    return false;
+  };
+  CHECK(!containsStamp());
+  CHECK(MeshCache::IsFresh(cachePath));
+  // 記録してある日時が新しいものになる
+  CHECK(containsStamp());
+  CHECK(MeshCache::IsFresh(cachePath));
+
+  // 中身が変われば古い
+  std::ofstream(objPath, std::ios::app) << "# changed\n";
+  CHECK(!MeshCache::IsFresh(cachePath));
+}
+} // namespace
+
+int main() {
+  // resourcesのモデルを一時ディレクトリに写して使う
+  std::filesystem::path directory =
+      std::filesystem::temp_directory_path() / "MeshCacheTest";
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+  std::filesystem::copy_file("resources/plane.obj", directory / "plane.obj");
+  std::filesystem::copy_file("resources/plane.mtl", directory / "plane.mtl");
+
+  TestOpenAndReopen(directory.string());
+  TestCorruptedOffsets(directory.string());
+  TestTouchedSourceRefreshesStamp(directory.string());
+
+  std::filesystem::remove_all(directory);
+  return Test::Finish();
+}
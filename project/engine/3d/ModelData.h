@@ -0,0 +1,49 @@
+﻿#pragma once
+#include "Mymath.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// モデルの頂点
+struct VertexData {
+  MyMath::Vector4 position;
+  MyMath::Vector2 texcoord;
+};
+
+// モデルのマテリアル
+struct MaterialData {
+  // newmtlの名前
+  std::string name;
+  // 拡散色（Kd）
+  MyMath::Vector3 diffuseColor = {1.0f, 1.0f, 1.0f};
+  // 不透明度（d）
+  float alpha = 1.0f;
+  // テクスチャ（map_Kd）。なければ空
+  std::string textureFilePath;
+};
+
+// 同じマテリアルで描くインデックスの範囲
+struct SubMesh {
+  uint32_t indexOffset;
+  uint32_t indexCount;
+  uint32_t materialIndex;
+};
+
+// 読み込んだモデル
+struct ModelData {
+  // 重複を除いた頂点
+  std::vector<VertexData> vertices;
+  // 三角形ごとの頂点番号
+  std::vector<uint32_t> indices;
+  // インデックスの範囲ごとのマテリアル。同じマテリアルの範囲は1つにまとめる
+  std::vector<SubMesh> subMeshes;
+  std::vector<MaterialData> materials;
+  // 頂点を囲む箱
+  MyMath::Vector3 boundsMin;
+  MyMath::Vector3 boundsMax;
+  // 読み込んだmtlファイル（なければ空）
+  std::string materialFilePath;
+
+  // 16bitのインデックスで足りるか
+  bool CanUse16BitIndices() const { return vertices.size() <= UINT16_MAX; }
+};
\ No newline at end of file
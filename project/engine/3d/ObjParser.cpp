@@ -0,0 +1,351 @@
+﻿#include "ObjParser.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <cassert>
+#include <charconv>
+#include <cstdint>
+
+namespace {
+
+// 解析中の位置
+struct Cursor {
+  const char *current;
+  const char *end;
+};
+
+bool IsSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+// 行内の空白を飛ばす
+void SkipSpaces(Cursor &cursor) {
+  while (cursor.current < cursor.end && IsSpace(*cursor.current)) {
+    cursor.current++;
+  }
+}
+
+// 次の行の先頭へ
+void SkipLine(Cursor &cursor) {
+  while (cursor.current < cursor.end && *cursor.current != '\n') {
+    cursor.current++;
+  }
+  if (cursor.current < cursor.end) {
+    cursor.current++;
+  }
+}
+
+// 空白か改行までを1語として読む
+std::string_view ReadToken(Cursor &cursor) {
+  SkipSpaces(cursor);
+  const char *begin = cursor.current;
+  while (cursor.current < cursor.end && !IsSpace(*cursor.current) &&
+         *cursor.current != '\n') {
+    cursor.current++;
+  }
+  return std::string_view(begin, cursor.current - begin);
+}
+
+// 小数を1つ読む
+float ReadFloat(Cursor &cursor) {
+  SkipSpaces(cursor);
+  // from_charsは先頭の+を受け付けない
+  if (cursor.current < cursor.end && *cursor.current == '+') {
+    cursor.current++;
+  }
+  float value = 0.0f;
+  std::from_chars_result result =
+      std::from_chars(cursor.current, cursor.end, value);
+  assert(result.ec == std::errc());
+  cursor.current = result.ptr;
+  return value;
+}
+
+// 省略された要素（「1//1」のUVなど）の番号
+const uint32_t kMissingIndex = UINT32_MAX;
+
+// 1始まり（負なら末尾から）のインデックスを0始まりにする。0は省略
+uint32_t ResolveIndex(int32_t index, size_t count) {
+  if (index == 0) {
+    return kMissingIndex;
+  }
+  if (index < 0) {
+    return static_cast<uint32_t>(static_cast<int64_t>(count) + index);
+  }
+  return static_cast<uint32_t>(index - 1);
+}
+
+// 「位置/UV/法線」の組から頂点番号を引く表（オープンアドレス法）
+class CornerTable {
+public:
+  // 登録済みならその番号を返す。なければnewIndexで登録してnewIndexを返す
+  uint32_t FindOrAdd(const uint32_t key[3], uint32_t newIndex) {
+    // 埋まりが半分を超えないように広げる
+    if ((count + 1) * 2 > slots.size()) {
+      Grow();
+    }
+    size_t mask = slots.size() - 1;
+    size_t index = Hash(key) & mask;
+    while (slots[index].value != kEmpty) {
+      Slot &slot = slots[index];
+      if (slot.key[0] == key[0] && slot.key[1] == key[1] &&
+          slot.key[2] == key[2]) {
+        return slot.value;
+      }
+      index = (index + 1) & mask;
+    }
+    slots[index] = {{key[0], key[1], key[2]}, newIndex};
+    count++;
+    return newIndex;
+  }
+
+private:
+  static const uint32_t kEmpty = UINT32_MAX;
+
+  struct Slot {
+    uint32_t key[3];
+    uint32_t value = kEmpty;
+  };
+
+  static size_t Hash(const uint32_t key[3]) {
+    uint64_t hash = key[0] * 0x9E3779B97F4A7C15ull;
+    hash ^= (key[1] + 0x632BE59BD9B4E019ull) * 0xC2B2AE3D27D4EB4Full;
+    hash ^= (key[2] + 0x165667B19E3779F9ull) * 0x85EBCA77C2B2AE63ull;
+    return static_cast<size_t>(hash ^ (hash >> 29));
+  }
+
+  void Grow() {
+    std::vector<Slot> oldSlots = std::move(slots);
+    slots.assign(oldSlots.empty() ? 1024 : oldSlots.size() * 2, Slot{});
+    size_t mask = slots.size() - 1;
+    for (const Slot &slot : oldSlots) {
+      if (slot.value == kEmpty) {
+        continue;
+      }
+      size_t index = Hash(slot.key) & mask;
+      while (slots[index].value != kEmpty) {
+        index = (index + 1) & mask;
+      }
+      slots[index] = slot;
+    }
+  }
+
+  std::vector<Slot> slots;
+  size_t count = 0;
+};
+
+// 名前でマテリアルを探す。なければ既定値で足す
+uint32_t FindOrAddMaterial(std::vector<MaterialData> &materials,
+                           std::string_view name) {
+  for (size_t i = 0; i < materials.size(); ++i) {
+    if (materials[i].name == name) {
+      return static_cast<uint32_t>(i);
+    }
+  }
+  MaterialData material;
+  material.name = name;
+  materials.push_back(material);
+  return static_cast<uint32_t>(materials.size() - 1);
+}
+
+// 面の1頂点「位置/UV/法線」を読む
+void ReadFaceVertex(Cursor &cursor, int32_t elementIndices[3]) {
+  std::string_view vertexDefinition = ReadToken(cursor);
+  const char *current = vertexDefinition.data();
+  const char *end = current + vertexDefinition.size();
+  for (int32_t element = 0; element < 3; ++element) {
+    elementIndices[element] = 0;
+    std::from_chars_result result =
+        std::from_chars(current, end, elementIndices[element]);
+    current = result.ptr;
+    // 区切りでインデックスを読んでいく
+    if (current < end && *current == '/') {
+      current++;
+    }
+  }
+}
+
+} // namespace
+
+namespace ObjParser {
+
+ModelData LoadObjFile(const std::string &directoryPath,
+                      const std::string &filename) {
+  MappedFile file;
+  bool isOpened = file.Open(directoryPath + "/" + filename);
+  assert(isOpened); // とりあえず開けなかったら止める
+  (void)isOpened;
+  return ParseObj(file.GetText(), directoryPath);
+}
+
+std::vector<MaterialData>
+LoadMaterialTemplateFile(const std::string &directoryPath,
+                         const std::string &filename) {
+  MappedFile file;
+  bool isOpened = file.Open(directoryPath + "/" + filename);
+  assert(isOpened); // とりあえず開けなかったら止める
+  (void)isOpened;
+  return ParseMaterialTemplate(file.GetText(), directoryPath);
+}
+
+ModelData ParseObj(std::string_view text, const std::string &directoryPath) {
+  ModelData modelData;                    // 構築するModelData
+  std::vector<MyMath::Vector4> positions; // 位置
+  std::vector<MyMath::Vector3> normals;   // 法線
+  std::vector<MyMath::Vector2> texcoords; // テクスチャ座標
+  CornerTable corners;                    // 登録済みの頂点
+  // マテリアルごとのインデックス。最後に並べてサブメッシュにする
+  std::vector<std::vector<uint32_t>> materialIndices;
+  // 今の面のマテリアル（usemtlが来るまでは未定）
+  uint32_t currentMaterial = UINT32_MAX;
+
+  Cursor cursor{text.data(), text.data() + text.size()};
+  while (cursor.current < cursor.end) {
+    std::string_view identifier = ReadToken(cursor); // 先頭の識別子を読む
+
+    // identifierに応じた処理
+    if (identifier == "v") {
+      MyMath::Vector4 position;
+      position.x = ReadFloat(cursor);
+      position.y = ReadFloat(cursor);
+      position.z = ReadFloat(cursor);
+      position.w = 1.0f;
+      position.x *= -1.0f;
+      positions.push_back(position);
+    } else if (identifier == "vt") {
+      MyMath::Vector2 texcoord;
+      texcoord.x = ReadFloat(cursor);
+      texcoord.y = ReadFloat(cursor);
+      texcoords.push_back(texcoord);
+    } else if (identifier == "vn") {
+      MyMath::Vector3 normal;
+      normal.x = ReadFloat(cursor);
+      normal.y = ReadFloat(cursor);
+      normal.z = ReadFloat(cursor);
+      normal.x *= -1.0f;
+      normals.push_back(normal);
+    } else if (identifier == "f") {
+      uint32_t triangle[3];
+      // 面は三角形限定。その他は未対応
+      for (int32_t faceVertex = 0; faceVertex < 3; ++faceVertex) {
+        int32_t elementIndices[3];
+        ReadFaceVertex(cursor, elementIndices);
+        uint32_t key[3] = {
+            ResolveIndex(elementIndices[0], positions.size()),
+            ResolveIndex(elementIndices[1], texcoords.size()),
+            ResolveIndex(elementIndices[2], normals.size())};
+        // 位置は省略できない
+        assert(key[0] != kMissingIndex);
+        // 同じ組の頂点が既にあればそれを使う
+        uint32_t vertexIndex = static_cast<uint32_t>(modelData.vertices.size());
+        triangle[faceVertex] = corners.FindOrAdd(key, vertexIndex);
+        if (triangle[faceVertex] != vertexIndex) {
+          continue;
+        }
+        // 要素へのIndexから、実際の要素の値を所得して、頂点を構築する
+        MyMath::Vector4 position = positions[key[0]];
+        position.x *= -1.0f;
+        // UVが省略されていれば(0,0)
+        MyMath::Vector2 texcoord = {0.0f, 0.0f};
+        if (key[1] != kMissingIndex) {
+          texcoord = texcoords[key[1]];
+          texcoord.y = 1.0f - texcoord.y;
+        }
+        modelData.vertices.push_back({position, texcoord});
+      }
+      // usemtlより前の面は名前なしのマテリアルで描く
+      if (currentMaterial == UINT32_MAX) {
+        currentMaterial = FindOrAddMaterial(modelData.materials, "");
+      }
+      if (materialIndices.size() <= currentMaterial) {
+        materialIndices.resize(currentMaterial + 1);
+      }
+      // 頂点を逆順で登録することで、回り順を逆にする
+      std::vector<uint32_t> &indices = materialIndices[currentMaterial];
+      indices.push_back(triangle[2]);
+      indices.push_back(triangle[1]);
+      indices.push_back(triangle[0]);
+    } else if (identifier == "usemtl") {
+      // 以降の面のマテリアルを切り替える
+      currentMaterial =
+          FindOrAddMaterial(modelData.materials, ReadToken(cursor));
+    } else if (identifier == "mtllib") {
+      // materialTemplateLibraryファイルの名前を取得する
+      std::string materialFilename(ReadToken(cursor));
+      // 基本的にobjファイルと同一階層にmtlは存在させるので、デイレクトリ名とファイル名を渡す
+      std::vector<MaterialData> materials =
+          LoadMaterialTemplateFile(directoryPath, materialFilename);
+      modelData.materials.insert(modelData.materials.end(), materials.begin(),
+                                 materials.end());
+      modelData.materialFilePath = directoryPath + "/" + materialFilename;
+    }
+    SkipLine(cursor);
+  }
+
+  // マテリアルごとに1つの範囲としてまとめる（オブジェクトが違っても同じ範囲）
+  for (uint32_t materialIndex = 0; materialIndex < materialIndices.size();
+       ++materialIndex) {
+    const std::vector<uint32_t> &indices = materialIndices[materialIndex];
+    if (indices.empty()) {
+      continue;
+    }
+    SubMesh subMesh;
+    subMesh.indexOffset = static_cast<uint32_t>(modelData.indices.size());
+    subMesh.indexCount = static_cast<uint32_t>(indices.size());
+    subMesh.materialIndex = materialIndex;
+    modelData.subMeshes.push_back(subMesh);
+    modelData.indices.insert(modelData.indices.end(), indices.begin(),
+                             indices.end());
+  }
+
+  // 頂点を囲む箱を求める
+  modelData.boundsMin = {0.0f, 0.0f, 0.0f};
+  modelData.boundsMax = {0.0f, 0.0f, 0.0f};
+  if (!modelData.vertices.empty()) {
+    const MyMath::Vector4 &first = modelData.vertices[0].position;
+    modelData.boundsMin = {first.x, first.y, first.z};
+    modelData.boundsMax = modelData.boundsMin;
+  }
+  for (const VertexData &vertex : modelData.vertices) {
+    modelData.boundsMin.x = std::min(modelData.boundsMin.x, vertex.position.x);
+    modelData.boundsMin.y = std::min(modelData.boundsMin.y, vertex.position.y);
+    modelData.boundsMin.z = std::min(modelData.boundsMin.z, vertex.position.z);
+    modelData.boundsMax.x = std::max(modelData.boundsMax.x, vertex.position.x);
+    modelData.boundsMax.y = std::max(modelData.boundsMax.y, vertex.position.y);
+    modelData.boundsMax.z = std::max(modelData.boundsMax.z, vertex.position.z);
+  }
+
+  return modelData;
+}
+
+std::vector<MaterialData>
+ParseMaterialTemplate(std::string_view text, const std::string &directoryPath) {
+  std::vector<MaterialData> materials; // 構築するMaterialData
+
+  Cursor cursor{text.data(), text.data() + text.size()};
+  while (cursor.current < cursor.end) {
+    std::string_view identifier = ReadToken(cursor);
+
+    // identifierに応じた処理
+    if (identifier == "newmtl") {
+      materials.emplace_back();
+      materials.back().name = ReadToken(cursor);
+    } else if (materials.empty()) {
+      // newmtlより前の行は読まない
+    } else if (identifier == "Kd") {
+      MyMath::Vector3 &diffuseColor = materials.back().diffuseColor;
+      diffuseColor.x = ReadFloat(cursor);
+      diffuseColor.y = ReadFloat(cursor);
+      diffuseColor.z = ReadFloat(cursor);
+    } else if (identifier == "d") {
+      materials.back().alpha = ReadFloat(cursor);
+    } else if (identifier == "map_Kd") {
+      std::string_view textureFilename = ReadToken(cursor);
+      // 連結してファイルパスにする
+      materials.back().textureFilePath =
+          directoryPath + "/" + std::string(textureFilename);
+    }
+    SkipLine(cursor);
+  }
+
+  return materials;
+}
+
+} // namespace ObjParser
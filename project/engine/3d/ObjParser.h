@@ -0,0 +1,29 @@
+﻿#pragma once
+#include "ModelData.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+// OBJ/MTLファイルの読み込み
+// ファイルはメモリにマップし、行ごとの文字列を作らずに直接数値を読む
+// 座標系の変換（x反転・V反転・回り順の反転）は従来の読み込みと同じ
+// 「位置/UV/法線」の組が同じ頂点は1つにまとめ、インデックスで参照する
+namespace ObjParser {
+
+// OBJファイルを読み込む
+ModelData LoadObjFile(const std::string &directoryPath,
+                      const std::string &filename);
+
+// MTLファイルを読み込む
+std::vector<MaterialData>
+LoadMaterialTemplateFile(const std::string &directoryPath,
+                         const std::string &filename);
+
+// メモリ上のOBJテキストを解析する。mtllibはdirectoryPathから読む
+ModelData ParseObj(std::string_view text, const std::string &directoryPath);
+
+// メモリ上のMTLテキストを解析する
+std::vector<MaterialData>
+ParseMaterialTemplate(std::string_view text, const std::string &directoryPath);
+
+} // namespace ObjParser
\ No newline at end of file
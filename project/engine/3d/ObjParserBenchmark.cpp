@@ -0,0 +1,45 @@
+﻿#include "Benchmark.h"
+#include "ObjParser.h"
+#include "ObjTestUtility.h"
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+// 数百万三角形のOBJを書き出し、以前のistringstreamの読み込みと
+// ObjParser::LoadObjFileの時間を比べる。結果の頂点列が同じかも確かめる
+int main(int argc, char *argv[]) {
+  uint32_t quadCount = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1]))
+                                : 1100;
+  std::filesystem::path directory = std::filesystem::temp_directory_path();
+  std::string filename = "ObjParserBenchmark.obj";
+  {
+    std::string text = ObjTest::GenerateGridObj(quadCount);
+    std::ofstream file(directory / filename, std::ios::binary);
+    file.write(text.data(), static_cast<std::streamsize>(text.size()));
+    std::printf("%u triangles, %.1f MB\n", quadCount * quadCount * 2,
+                double(text.size()) / (1024.0 * 1024.0));
+  }
+
+  std::vector<VertexData> expected;
+  double legacyMs = Benchmark::MeasureBestMs(1, [&]() {
+    std::ifstream file(directory / filename);
+    expected = ObjTest::LoadObjLegacy(file);
+  });
+
+  ModelData modelData;
+  double parserMs = Benchmark::MeasureBestMs(3, [&]() {
+    modelData = ObjParser::LoadObjFile(directory.string(), filename);
+  });
+
+  std::vector<VertexData> actual = ObjTest::ExpandIndices(modelData);
+  bool isIdentical = actual.size() == expected.size() &&
+                     std::memcmp(actual.data(), expected.data(),
+                                 sizeof(VertexData) * actual.size()) == 0;
+  std::filesystem::remove(directory / filename);
+
+  std::printf("istringstream : %10.1f ms\n", legacyMs);
+  std::printf("ObjParser     : %10.1f ms\n", parserMs);
+  std::printf("output        : %s\n", isIdentical ? "identical" : "DIFFERENT");
+  return isIdentical ? 0 : 1;
+}
@@ -0,0 +1,189 @@
+﻿#include "Check.h"
+#include "ObjParser.h"
+#include "ObjTestUtility.h"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace {
+// resourcesのファイルを文字列で読む（テストはprojectで実行する）
+std::string ReadResource(const std::string &filename) {
+  std::ifstream file("resources/" + filename, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file), {});
+}
+
+// サブメッシュの頂点がすべてxの範囲に入っているか（どのオブジェクトの面か）
+bool IsSubMeshInRangeX(const ModelData &modelData, const SubMesh &subMesh,
+                       float minX, float maxX) {
+  for (uint32_t i = 0; i < subMesh.indexCount; ++i) {
+    float x =
+        modelData.vertices[modelData.indices[subMesh.indexOffset + i]]
+            .position.x;
+    if (x < minX || x > maxX) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void CheckMaterial(const MaterialData &material, const char *name,
+                   const char *textureFilePath) {
+  CHECK(material.name == name);
+  CHECK_NEAR(material.diffuseColor.x, 0.8f, 1e-6f);
+  CHECK_NEAR(material.diffuseColor.y, 0.8f, 1e-6f);
+  CHECK_NEAR(material.diffuseColor.z, 0.8f, 1e-6f);
+  CHECK(material.alpha == 1.0f);
+  CHECK(material.textureFilePath == textureFilePath);
+}
+
+// 板（2三角形）と立方体（12三角形）で別のマテリアルを使う
+void TestMultiMaterial() {
+  std::string text = ReadResource("multiMaterial.obj");
+  CHECK(!text.empty());
+  ModelData modelData = ObjParser::ParseObj(text, "resources");
+  CHECK(modelData.materialFilePath == "resources/multiMaterial.mtl");
+
+  // mtlの順に並び、usemtlは名前で引く（増えない）
+  CHECK(modelData.materials.size() == 2);
+  if (modelData.materials.size() != 2) {
+    return;
+  }
+  CheckMaterial(modelData.materials[0], "Material",
+                "resources/monsterBall.png");
+  CheckMaterial(modelData.materials[1], "Material.001",
+                "resources/uvChecker.png");
+
+  // サブメッシュはマテリアル番号順。立方体の36個、板の6個
+  CHECK(modelData.indices.size() == 42);
+  CHECK(modelData.subMeshes.size() == 2);
+  if (modelData.subMeshes.size() != 2) {
+    return;
+  }
+  const SubMesh &cube = modelData.subMeshes[0];
+  const SubMesh &plane = modelData.subMeshes[1];
+  CHECK(cube.materialIndex == 0 && cube.indexOffset == 0 &&
+        cube.indexCount == 36);
+  CHECK(plane.materialIndex == 1 && plane.indexOffset == 36 &&
+        plane.indexCount == 6);
+  // xはvと面で2回反転するので元のまま。立方体は1.5～3.5、板は-1～1
+  CHECK(IsSubMeshInRangeX(modelData, cube, 1.49f, 3.5f));
+  CHECK(IsSubMeshInRangeX(modelData, plane, -1.0f, 1.0f));
+}
+
+// 板と立方体が同じマテリアルなら1つの範囲にまとめる
+void TestMultiMesh() {
+  std::string text = ReadResource("multiMesh.obj");
+  CHECK(!text.empty());
+  ModelData modelData = ObjParser::ParseObj(text, "resources");
+
+  CHECK(modelData.materials.size() == 1);
+  if (modelData.materials.size() != 1) {
+    return;
+  }
+  CheckMaterial(modelData.materials[0], "Material.001",
+                "resources/uvChecker.png");
+
+  CHECK(modelData.subMeshes.size() == 1);
+  if (modelData.subMeshes.size() != 1) {
+    return;
+  }
+  const SubMesh &subMesh = modelData.subMeshes[0];
+  CHECK(subMesh.materialIndex == 0 && subMesh.indexOffset == 0 &&
+        subMesh.indexCount == 42);
+  // 読んだ順（板が先）に並ぶ
+  SubMesh plane{0, 6, 0};
+  SubMesh cube{6, 36, 0};
+  CHECK(IsSubMeshInRangeX(modelData, plane, -1.0f, 1.0f));
+  CHECK(IsSubMeshInRangeX(modelData, cube, 1.49f, 3.5f));
+  CHECK_NEAR(modelData.boundsMin.x, -1.0f, 1e-6f);
+  CHECK_NEAR(modelData.boundsMax.x, 3.495951f, 1e-6f);
+}
+
+// Kdとdが既定値でないマテリアル
+void TestMaterialValues() {
+  const char *text = "# comment\n"
+                     "Kd 0.1 0.1 0.1\n" // newmtlより前は読まない
+                     "newmtl Glass\n"
+                     "Kd 0.25 0.5 1.0\n"
+                     "d 0.5\n"
+                     "newmtl Plain\n";
+  std::vector<MaterialData> materials =
+      ObjParser::ParseMaterialTemplate(text, "textures");
+  CHECK(materials.size() == 2);
+  if (materials.size() != 2) {
+    return;
+  }
+  CHECK(materials[0].name == "Glass");
+  CHECK(materials[0].diffuseColor.x == 0.25f &&
+        materials[0].diffuseColor.y == 0.5f &&
+        materials[0].diffuseColor.z == 1.0f);
+  CHECK(materials[0].alpha == 0.5f);
+  CHECK(materials[0].textureFilePath.empty());
+  // 書いていない値は既定値
+  CHECK(materials[1].diffuseColor.x == 1.0f && materials[1].alpha == 1.0f);
+}
+
+// 以前の読み込みと同じ頂点列になるか（ビット単位で比べる）
+void TestMatchesLegacyLoader() {
+  std::string text = ObjTest::GenerateGridObj(32);
+  std::istringstream stream(text);
+  std::vector<VertexData> expected = ObjTest::LoadObjLegacy(stream);
+
+  ModelData modelData = ObjParser::ParseObj(text, "");
+  std::vector<VertexData> actual = ObjTest::ExpandIndices(modelData);
+  CHECK(expected.size() == 32 * 32 * 2 * 3);
+  CHECK(actual.size() == expected.size());
+  CHECK(actual.size() == expected.size() &&
+        std::memcmp(actual.data(), expected.data(),
+                    sizeof(VertexData) * actual.size()) == 0);
+  CHECK(modelData.subMeshes.size() == 1);
+}
+
+// 同じ「位置/UV/法線」の組は1つの頂点にまとめる
+void TestSharedCorners() {
+  ModelData modelData = ObjParser::ParseObj(ObjTest::GenerateGridObj(8), "");
+  CHECK(modelData.indices.size() == 8 * 8 * 2 * 3);
+  // 格子の点は9x9個。法線が2種類あるので、両方から使われる点は2つになる
+  CHECK(modelData.vertices.size() < modelData.indices.size());
+  CHECK(modelData.vertices.size() >= 9 * 9);
+  CHECK(modelData.CanUse16BitIndices());
+}
+
+// UVや法線を省略した面（f a//c、f a）
+void TestMissingElements() {
+  const char *text = "v 1 0 0\n"
+                     "v 0 1 0\n"
+                     "v 0 0 1\n"
+                     "vt 0.25 0.75\n"
+                     "vn 0 0 1\n"
+                     "f 1//1 2//1 3//1\n"
+                     "f 1 2 3\n"
+                     "f 1/1/1 2/1/1 3/1/1\n";
+  ModelData modelData = ObjParser::ParseObj(text, "");
+  CHECK(modelData.indices.size() == 9);
+  // 法線の有無が違うので、省略した面同士も別の頂点になる
+  CHECK(modelData.vertices.size() == 9);
+  if (modelData.vertices.size() != 9) {
+    return;
+  }
+  // 回り順を反転するので、最初の頂点は3番目の位置
+  const VertexData &first = modelData.vertices[modelData.indices[0]];
+  CHECK(first.position.z == 1.0f && first.position.w == 1.0f);
+  for (uint32_t i = 0; i < 6; ++i) {
+    const VertexData &vertex = modelData.vertices[modelData.indices[i]];
+    CHECK(vertex.texcoord.x == 0.0f && vertex.texcoord.y == 0.0f);
+  }
+  const VertexData &textured = modelData.vertices[modelData.indices[6]];
+  CHECK(textured.texcoord.x == 0.25f && textured.texcoord.y == 0.25f);
+}
+} // namespace
+
+int main() {
+  TestMatchesLegacyLoader();
+  TestSharedCorners();
+  TestMissingElements();
+  TestMultiMaterial();
+  TestMultiMesh();
+  TestMaterialValues();
+  return Test::Finish();
+}
@@ -0,0 +1,50 @@
+﻿#include "Benchmark.h"
+#include "ObjParser.h"
+#include "ObjTestUtility.h"
+#include <cstdio>
+
+// 「位置/UV/法線」の組で頂点をまとめた効果を出す
+// 以前は三角形ごとに頂点を3つ作っていた（頂点数 = インデックス数）
+// resourcesのあるディレクトリ（project）で実行する
+namespace {
+void Report(const char *name, const ModelData &modelData, double ms) {
+  size_t cornerCount = modelData.indices.size();
+  size_t vertexCount = modelData.vertices.size();
+  // 以前の頂点バッファと、今の頂点バッファ + インデックスバッファの大きさ
+  size_t oldBytes = cornerCount * sizeof(VertexData);
+  size_t indexSize = modelData.CanUse16BitIndices() ? 2 : 4;
+  size_t newBytes = vertexCount * sizeof(VertexData) + cornerCount * indexSize;
+  std::printf("%-22s %10zu %10zu %8.1f%% %10.2f %10.2f %10.2f\n", name,
+              cornerCount, vertexCount,
+              100.0 * (1.0 - double(vertexCount) / double(cornerCount)),
+              double(oldBytes) / (1024.0 * 1024.0),
+              double(newBytes) / (1024.0 * 1024.0), ms);
+}
+} // namespace
+
+int main() {
+  std::printf("%-22s %10s %10s %9s %10s %10s %10s\n", "mesh", "old verts",
+              "new verts", "reduced", "old MB", "new MB", "parse ms");
+
+  // リポジトリのモデル
+  for (const char *filename :
+       {"plane.obj", "axis.obj", "multiMesh.obj", "multiMaterial.obj"}) {
+    ModelData modelData;
+    double ms = Benchmark::MeasureBestMs(5, [&]() {
+      modelData = ObjParser::LoadObjFile("resources", filename);
+    });
+    Report(filename, modelData, ms);
+  }
+
+  // 大きな格子
+  for (uint32_t quadCount : {256u, 1024u}) {
+    std::string text = ObjTest::GenerateGridObj(quadCount);
+    ModelData modelData;
+    double ms = Benchmark::MeasureBestMs(
+        3, [&]() { modelData = ObjParser::ParseObj(text, ""); });
+    char name[32];
+    std::snprintf(name, sizeof(name), "grid %ux%u", quadCount, quadCount);
+    Report(name, modelData, ms);
+  }
+  return 0;
+}
@@ -0,0 +1,235 @@
+﻿#include "Bounds.h"
+#include <algorithm>
+#include <cmath>
+#if defined(MYMATH_USE_SSE2)
+#include <emmintrin.h>
+#endif
+
+using namespace MyMath;
+
+namespace {
+// 行列の列（行ベクトル×行列なのでクリップ座標の各成分は列との内積）
+Plane GetColumn(const Matrix4x4 &m, int column) {
+  return {{m.m[0][column], m.m[1][column], m.m[2][column]}, m.m[3][column]};
+}
+
+Plane Add(const Plane &a, const Plane &b) {
+  return {{a.normal.x + b.normal.x, a.normal.y + b.normal.y,
+           a.normal.z + b.normal.z},
+          a.distance + b.distance};
+}
+
+Plane Subtract(const Plane &a, const Plane &b) {
+  return {{a.normal.x - b.normal.x, a.normal.y - b.normal.y,
+           a.normal.z - b.normal.z},
+          a.distance - b.distance};
+}
+
+// 法線の長さを1にする（距離を比べられるように）
+Plane NormalizePlane(const Plane &plane) {
+  float length = std::sqrt(plane.normal.x * plane.normal.x +
+                           plane.normal.y * plane.normal.y +
+                           plane.normal.z * plane.normal.z);
+  float recpLength = length != 0.0f ? 1.0f / length : 0.0f;
+  return {{plane.normal.x * recpLength, plane.normal.y * recpLength,
+           plane.normal.z * recpLength},
+          plane.distance * recpLength};
+}
+
+float PlaneDistance(const Plane &plane, const Vector3 &point) {
+  return plane.normal.x * point.x + plane.normal.y * point.y +
+         plane.normal.z * point.z + plane.distance;
+}
+} // namespace
+
+Frustum Culling::MakeFrustum(const Matrix4x4 &viewProjection) {
+  Plane x = GetColumn(viewProjection, 0);
+  Plane y = GetColumn(viewProjection, 1);
+  Plane z = GetColumn(viewProjection, 2);
+  Plane w = GetColumn(viewProjection, 3);
+
+  // -w <= x <= w, -w <= y <= w, 0 <= z <= w
+  Frustum frustum;
+  frustum.planes[0] = NormalizePlane(Add(w, x));
+  frustum.planes[1] = NormalizePlane(Subtract(w, x));
+  frustum.planes[2] = NormalizePlane(Add(w, y));
+  frustum.planes[3] = NormalizePlane(Subtract(w, y));
+  frustum.planes[4] = NormalizePlane(z);
+  frustum.planes[5] = NormalizePlane(Subtract(w, z));
+  return frustum;
+}
+
+AABB Culling::TransformAABB(const AABB &aabb, const Matrix4x4 &matrix) {
+  // 中心は普通に変換し、広がりは行列の絶対値で変換する
+  Vector3 center = {(aabb.min.x + aabb.max.x) * 0.5f,
+                    (aabb.min.y + aabb.max.y) * 0.5f,
+                    (aabb.min.z + aabb.max.z) * 0.5f};
+  Vector3 extents = {(aabb.max.x - aabb.min.x) * 0.5f,
+                     (aabb.max.y - aabb.min.y) * 0.5f,
+                     (aabb.max.z - aabb.min.z) * 0.5f};
+
+  float newCenter[3];
+  float newExtents[3];
+  for (int j = 0; j < 3; ++j) {
+    newCenter[j] = center.x * matrix.m[0][j] + center.y * matrix.m[1][j] +
+                   center.z * matrix.m[2][j] + matrix.m[3][j];
+    newExtents[j] = extents.x * std::fabs(matrix.m[0][j]) +
+                    extents.y * std::fabs(matrix.m[1][j]) +
+                    extents.z * std::fabs(matrix.m[2][j]);
+  }
+  return {{newCenter[0] - newExtents[0], newCenter[1] - newExtents[1],
+           newCenter[2] - newExtents[2]},
+          {newCenter[0] + newExtents[0], newCenter[1] + newExtents[1],
+           newCenter[2] + newExtents[2]}};
+}
+
+Sphere Culling::MakeSphere(const AABB &aabb) {
+  Vector3 extents = {(aabb.max.x - aabb.min.x) * 0.5f,
+                     (aabb.max.y - aabb.min.y) * 0.5f,
+                     (aabb.max.z - aabb.min.z) * 0.5f};
+  return {{(aabb.min.x + aabb.max.x) * 0.5f, (aabb.min.y + aabb.max.y) * 0.5f,
+           (aabb.min.z + aabb.max.z) * 0.5f},
+          std::sqrt(extents.x * extents.x + extents.y * extents.y +
+                    extents.z * extents.z)};
+}
+
+bool Culling::IsVisible(const Frustum &frustum, const AABB &aabb) {
+  Vector3 center = {(aabb.min.x + aabb.max.x) * 0.5f,
+                    (aabb.min.y + aabb.max.y) * 0.5f,
+                    (aabb.min.z + aabb.max.z) * 0.5f};
+  Vector3 extents = {(aabb.max.x - aabb.min.x) * 0.5f,
+                     (aabb.max.y - aabb.min.y) * 0.5f,
+                     (aabb.max.z - aabb.min.z) * 0.5f};
+  for (const Plane &plane : frustum.planes) {
+    // 平面の法線方向に最も出ている点までの距離
+    float reach = extents.x * std::fabs(plane.normal.x) +
+                  extents.y * std::fabs(plane.normal.y) +
+                  extents.z * std::fabs(plane.normal.z);
+    if (PlaneDistance(plane, center) + reach < 0.0f) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool Culling::IsVisible(const Frustum &frustum, const Sphere &sphere) {
+  for (const Plane &plane : frustum.planes) {
+    if (PlaneDistance(plane, sphere.center) + sphere.radius < 0.0f) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void BoundsBatch::Clear() { count = 0; }
+
+uint32_t BoundsBatch::Add(const AABB &aabb) {
+  return Add({(aabb.min.x + aabb.max.x) * 0.5f,
+              (aabb.min.y + aabb.max.y) * 0.5f,
+              (aabb.min.z + aabb.max.z) * 0.5f},
+             {(aabb.max.x - aabb.min.x) * 0.5f,
+              (aabb.max.y - aabb.min.y) * 0.5f,
+              (aabb.max.z - aabb.min.z) * 0.5f},
+             0.0f);
+}
+
+uint32_t BoundsBatch::Add(const Sphere &sphere) {
+  return Add(sphere.center, {0.0f, 0.0f, 0.0f}, sphere.radius);
+}
+
+uint32_t BoundsBatch::Add(const Vector3 &center, const Vector3 &extents,
+                          float radius) {
+  // 4件ごとにまとめて伸ばす。余りのレーンは判定の後で捨てる
+  if (count % kLaneCount == 0 && count == centerX.size()) {
+    size_t size = count + kLaneCount;
+    centerX.resize(size);
+    centerY.resize(size);
+    centerZ.resize(size);
+    extentX.resize(size);
+    extentY.resize(size);
+    extentZ.resize(size);
+    radii.resize(size);
+  }
+
+  centerX[count] = center.x;
+  centerY[count] = center.y;
+  centerZ[count] = center.z;
+  extentX[count] = extents.x;
+  extentY[count] = extents.y;
+  extentZ[count] = extents.z;
+  radii[count] = radius;
+  return static_cast<uint32_t>(count++);
+}
+
+uint32_t BoundsBatch::Cull(const Frustum &frustum,
+                           std::vector<uint32_t> &visibleIndices) const {
+  visibleIndices.resize(count);
+  uint32_t visibleCount = 0;
+
+#if defined(MYMATH_USE_SSE2)
+  // 平面ごとの係数を4レーンに広げておく
+  __m128 normalX[6], normalY[6], normalZ[6], distance[6];
+  __m128 absNormalX[6], absNormalY[6], absNormalZ[6];
+  for (int p = 0; p < 6; ++p) {
+    const Plane &plane = frustum.planes[p];
+    normalX[p] = _mm_set1_ps(plane.normal.x);
+    normalY[p] = _mm_set1_ps(plane.normal.y);
+    normalZ[p] = _mm_set1_ps(plane.normal.z);
+    distance[p] = _mm_set1_ps(plane.distance);
+    absNormalX[p] = _mm_set1_ps(std::fabs(plane.normal.x));
+    absNormalY[p] = _mm_set1_ps(std::fabs(plane.normal.y));
+    absNormalZ[p] = _mm_set1_ps(std::fabs(plane.normal.z));
+  }
+  const __m128 zero = _mm_setzero_ps();
+
+  for (size_t i = 0; i < count; i += kLaneCount) {
+    __m128 cx = _mm_loadu_ps(&centerX[i]);
+    __m128 cy = _mm_loadu_ps(&centerY[i]);
+    __m128 cz = _mm_loadu_ps(&centerZ[i]);
+    __m128 ex = _mm_loadu_ps(&extentX[i]);
+    __m128 ey = _mm_loadu_ps(&extentY[i]);
+    __m128 ez = _mm_loadu_ps(&extentZ[i]);
+    __m128 radius = _mm_loadu_ps(&radii[i]);
+
+    // 全平面で 中心までの距離 + 届く範囲 >= 0 なら見えている
+    __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    for (int p = 0; p < 6; ++p) {
+      __m128 d = _mm_add_ps(
+          _mm_add_ps(_mm_mul_ps(normalX[p], cx), _mm_mul_ps(normalY[p], cy)),
+          _mm_add_ps(_mm_mul_ps(normalZ[p], cz), distance[p]));
+      __m128 reach = _mm_add_ps(
+          _mm_add_ps(_mm_mul_ps(absNormalX[p], ex),
+                     _mm_mul_ps(absNormalY[p], ey)),
+          _mm_add_ps(_mm_mul_ps(absNormalZ[p], ez), radius));
+      inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(d, reach), zero));
+    }
+
+    // 見えているレーンの番号だけを詰める
+    int mask = _mm_movemask_ps(inside);
+    size_t laneCount = std::min(kLaneCount, count - i);
+    for (size_t lane = 0; lane < laneCount; ++lane) {
+      visibleIndices[visibleCount] = static_cast<uint32_t>(i + lane);
+      visibleCount += (mask >> lane) & 1;
+    }
+  }
+#else
+  for (size_t i = 0; i < count; ++i) {
+    bool isVisible = true;
+    for (const Plane &plane : frustum.planes) {
+      float d = PlaneDistance(plane, {centerX[i], centerY[i], centerZ[i]});
+      float reach = extentX[i] * std::fabs(plane.normal.x) +
+                    extentY[i] * std::fabs(plane.normal.y) +
+                    extentZ[i] * std::fabs(plane.normal.z) + radii[i];
+      if (d + reach < 0.0f) {
+        isVisible = false;
+        break;
+      }
+    }
+    visibleIndices[visibleCount] = static_cast<uint32_t>(i);
+    visibleCount += isVisible ? 1 : 0;
+  }
+#endif
+
+  visibleIndices.resize(visibleCount);
+  return visibleCount;
+}
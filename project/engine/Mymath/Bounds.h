@@ -0,0 +1,80 @@
+﻿#pragma once
+#include "Mymath.h"
+#include <cstdint>
+#include <vector>
+
+namespace MyMath {
+
+// 軸に沿った箱
+struct AABB {
+  Vector3 min;
+  Vector3 max;
+};
+
+// 球
+struct Sphere {
+  Vector3 center;
+  float radius;
+};
+
+// 平面。dot(normal, p) + distance >= 0 の側を内側とする
+struct Plane {
+  Vector3 normal;
+  float distance;
+};
+
+// 視錐台（左・右・下・上・近・遠の6平面。法線は内向き）
+struct Frustum {
+  Plane planes[6];
+};
+
+class Culling {
+public:
+  // ビュー×射影行列から視錐台の平面を取り出す（z範囲は0～w）
+  static Frustum MakeFrustum(const Matrix4x4 &viewProjection);
+
+  // 行列で変換したAABB（変換後の8頂点を囲む箱）
+  static AABB TransformAABB(const AABB &aabb, const Matrix4x4 &matrix);
+  // AABBを囲む球
+  static Sphere MakeSphere(const AABB &aabb);
+
+  // 視錐台と重なるか（境界上は見えている扱い）
+  static bool IsVisible(const Frustum &frustum, const AABB &aabb);
+  static bool IsVisible(const Frustum &frustum, const Sphere &sphere);
+};
+
+// 多数の境界をまとめて視錐台と判定する
+// 中心・半分の大きさ・半径を要素ごとの配列（SoA）で持ち、SIMDで4件ずつ調べる
+class BoundsBatch {
+public:
+  // 積んだ境界を空にする（確保した領域は残す）
+  void Clear();
+
+  // 境界を追加して番号を返す
+  uint32_t Add(const AABB &aabb);
+  uint32_t Add(const Sphere &sphere);
+
+  // 見えている境界の番号を小さい順にvisibleIndicesへ詰める。戻り値は個数
+  uint32_t Cull(const Frustum &frustum,
+                std::vector<uint32_t> &visibleIndices) const;
+
+  size_t GetCount() const { return count; }
+
+private:
+  // SIMDの幅。配列はこの倍数の長さで持つ
+  static const size_t kLaneCount = 4;
+
+  uint32_t Add(const Vector3 &center, const Vector3 &extents, float radius);
+
+  size_t count = 0;
+
+  std::vector<float> centerX;
+  std::vector<float> centerY;
+  std::vector<float> centerZ;
+  std::vector<float> extentX;
+  std::vector<float> extentY;
+  std::vector<float> extentZ;
+  std::vector<float> radii;
+};
+
+} // namespace MyMath
@@ -0,0 +1,83 @@
+﻿#include "Benchmark.h"
+#include "Bounds.h"
+#include "MathTestUtility.h"
+#include <vector>
+
+using namespace MyMath;
+
+// 10万件の境界を視錐台で判定する時間
+// 1件ずつCulling::IsVisibleで調べる場合とBoundsBatch::Cullでまとめる場合を比べる
+// 境界は視錐台の周りに置き、見えるのは3割程度になる
+namespace {
+const uint32_t kCount = 100000;
+const uint32_t kRepeatCount = 50;
+const float kPi = 3.14159265358979f;
+
+void Run(const char *name, const Frustum &frustum,
+         const std::vector<AABB> &aabbs) {
+  BoundsBatch batch;
+  for (const AABB &aabb : aabbs) {
+    batch.Add(aabb);
+  }
+
+  std::vector<uint32_t> visibleIndices;
+  visibleIndices.reserve(kCount);
+  double scalarMs = Benchmark::MeasureBestMs(kRepeatCount, [&]() {
+    visibleIndices.clear();
+    for (uint32_t i = 0; i < kCount; ++i) {
+      if (Culling::IsVisible(frustum, aabbs[i])) {
+        visibleIndices.push_back(i);
+      }
+    }
+  });
+  size_t scalarVisible = visibleIndices.size();
+  Benchmark::Consume(scalarVisible);
+
+  double batchMs = Benchmark::MeasureBestMs(kRepeatCount, [&]() {
+    Benchmark::Consume(batch.Cull(frustum, visibleIndices));
+  });
+
+  std::printf("%-13s %7zu / %u visible  IsVisible %7.3f ms  Cull %7.3f ms "
+              "(%5.2fx, %.2f ns/bounds)\n",
+              name, visibleIndices.size(), kCount, scalarMs, batchMs,
+              scalarMs / batchMs, batchMs * 1e6 / kCount);
+}
+} // namespace
+
+int main() {
+#if defined(MYMATH_USE_SSE2)
+  const char *backend = "SSE2";
+#else
+  const char *backend = "scalar";
+#endif
+  std::printf("%s\n", backend);
+  MathTest::Random random;
+
+  // 画面（1280x720）の倍の範囲に置いたスプライト
+  std::vector<AABB> sprites(kCount);
+  for (AABB &aabb : sprites) {
+    Vector3 min = {random.Range(-640.0f, 1920.0f),
+                   random.Range(-360.0f, 1080.0f), 0.0f};
+    float size = random.Range(8.0f, 128.0f);
+    aabb = {min, {min.x + size, min.y + size, 0.0f}};
+  }
+  Run("orthographic", Culling::MakeFrustum(Math::MakeOrthographicMatrix(
+                          0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 100.0f)),
+      sprites);
+
+  // カメラの周りに散らばった箱
+  std::vector<AABB> boxes(kCount);
+  for (AABB &aabb : boxes) {
+    Vector3 center = {random.Range(-100.0f, 100.0f),
+                      random.Range(-100.0f, 100.0f),
+                      random.Range(-20.0f, 150.0f)};
+    Vector3 extents = random.Vector3(0.5f, 5.0f);
+    aabb = {{center.x - extents.x, center.y - extents.y, center.z - extents.z},
+            {center.x + extents.x, center.y + extents.y, center.z + extents.z}};
+  }
+  Run("perspective",
+      Culling::MakeFrustum(Math::MakePerspectiveFovMatrix(kPi * 0.5f, 1.0f,
+                                                          1.0f, 100.0f)),
+      boxes);
+  return 0;
+}
@@ -0,0 +1,201 @@
+﻿#include "Bounds.h"
+#include "Check.h"
+#include "MathTestUtility.h"
+
+using namespace MyMath;
+
+// MakeFrustumで取り出した平面と、BoundsBatch::Cull（SSE2なら4件ずつの経路）が
+// 手で置いた境界に対して期待どおりに判定するか
+// 乱数で置いた境界では1件ずつのCulling::IsVisibleと一致するかも確かめる
+namespace {
+const float kPi = 3.14159265358979f;
+const float kTolerance = 1e-6f;
+
+void CheckPlane(const Plane &plane, const Vector3 &normal, float distance) {
+  CHECK_NEAR(plane.normal.x, normal.x, kTolerance);
+  CHECK_NEAR(plane.normal.y, normal.y, kTolerance);
+  CHECK_NEAR(plane.normal.z, normal.z, kTolerance);
+  // 距離は遠平面で100程度になるので相対誤差で見る
+  CHECK_NEAR(plane.distance, distance,
+             kTolerance * 10.0f * (std::max)(1.0f, std::fabs(distance)));
+}
+
+// 原点から+zを向いた、縦横90度・近1・遠100の視錐台
+Frustum MakePerspectiveFrustum(const Matrix4x4 &view) {
+  return Culling::MakeFrustum(Math::Multiply(
+      view, Math::MakePerspectiveFovMatrix(kPi * 0.5f, 1.0f, 1.0f, 100.0f)));
+}
+
+AABB MakeBox(const Vector3 &center, float halfSize) {
+  return {{center.x - halfSize, center.y - halfSize, center.z - halfSize},
+          {center.x + halfSize, center.y + halfSize, center.z + halfSize}};
+}
+
+// 見えるはずの番号がちょうどvisibleIndicesに並ぶか
+void CheckCull(const BoundsBatch &batch, const Frustum &frustum,
+               const std::vector<uint32_t> &expected) {
+  std::vector<uint32_t> visibleIndices = {12345u};
+  uint32_t visibleCount = batch.Cull(frustum, visibleIndices);
+  CHECK(visibleCount == expected.size());
+  CHECK(visibleIndices == expected);
+}
+
+void TestMakeFrustum() {
+  const float kHalfRoot2 = 0.70710678f;
+  Frustum perspective = MakePerspectiveFrustum(Math::MakeIdentity4x4());
+  CheckPlane(perspective.planes[0], {kHalfRoot2, 0.0f, kHalfRoot2}, 0.0f);
+  CheckPlane(perspective.planes[1], {-kHalfRoot2, 0.0f, kHalfRoot2}, 0.0f);
+  CheckPlane(perspective.planes[2], {0.0f, kHalfRoot2, kHalfRoot2}, 0.0f);
+  CheckPlane(perspective.planes[3], {0.0f, -kHalfRoot2, kHalfRoot2}, 0.0f);
+  CheckPlane(perspective.planes[4], {0.0f, 0.0f, 1.0f}, -1.0f);
+  CheckPlane(perspective.planes[5], {0.0f, 0.0f, -1.0f}, 100.0f);
+
+  // スプライトで使う画面の平行投影（y下向き）
+  Frustum orthographic = Culling::MakeFrustum(
+      Math::MakeOrthographicMatrix(0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 100.0f));
+  CheckPlane(orthographic.planes[0], {1.0f, 0.0f, 0.0f}, 0.0f);
+  CheckPlane(orthographic.planes[1], {-1.0f, 0.0f, 0.0f}, 1280.0f);
+  CheckPlane(orthographic.planes[2], {0.0f, -1.0f, 0.0f}, 720.0f);
+  CheckPlane(orthographic.planes[3], {0.0f, 1.0f, 0.0f}, 0.0f);
+  CheckPlane(orthographic.planes[4], {0.0f, 0.0f, 1.0f}, 0.0f);
+  CheckPlane(orthographic.planes[5], {0.0f, 0.0f, -1.0f}, 100.0f);
+}
+
+void TestPerspectiveCull() {
+  BoundsBatch batch;
+  // 0: 正面
+  CHECK(batch.Add(MakeBox({0.0f, 0.0f, 10.0f}, 1.0f)) == 0);
+  // 1: カメラの後ろ
+  batch.Add(MakeBox({0.0f, 0.0f, -10.0f}, 1.0f));
+  // 2: 遠平面の向こう
+  batch.Add(MakeBox({0.0f, 0.0f, 200.0f}, 1.0f));
+  // 3: 左の外（左平面まで約7.07離れている）
+  batch.Add(Sphere{{-20.0f, 0.0f, 10.0f}, 1.0f});
+  // 4: 左平面にかかっている（中心は外だが半径が届く）
+  batch.Add(Sphere{{-10.5f, 0.0f, 10.0f}, 1.0f});
+  // 5: 遠平面にかかっている
+  batch.Add(MakeBox({0.0f, 0.0f, 100.5f}, 1.0f));
+  // 6: 近平面の手前
+  batch.Add(Sphere{{0.0f, 0.0f, 0.5f}, 0.4f});
+  // 7: 上の外。箱の角は平面に近いが届かない
+  batch.Add(MakeBox({0.0f, 15.0f, 10.0f}, 2.0f));
+  // 8: 右下の奥（4件目の組の余りレーン）
+  batch.Add(MakeBox({40.0f, -40.0f, 80.0f}, 1.0f));
+  CHECK(batch.GetCount() == 9);
+
+  CheckCull(batch, MakePerspectiveFrustum(Math::MakeIdentity4x4()),
+            {0, 4, 5, 8});
+
+  // y軸回りに半回転したカメラ（-zを向く）。後ろにあった1だけが見える
+  Matrix4x4 camera =
+      Math::MakeAffineMatrix({1.0f, 1.0f, 1.0f}, {0.0f, kPi, 0.0f},
+                             {0.0f, 0.0f, 0.0f});
+  CheckCull(batch, MakePerspectiveFrustum(Math::Inverse(camera)), {1});
+
+  // 右へ30動かしたカメラ。3・4は外れ、8は見えたまま
+  camera = Math::MakeAffineMatrix({1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 0.0f},
+                                  {30.0f, 0.0f, 0.0f});
+  CheckCull(batch, MakePerspectiveFrustum(Math::Inverse(camera)), {5, 8});
+}
+
+// 平行投影の平面は軸に沿うので、境界にちょうど接する箱の判定まで決まる
+void TestOrthographicCull() {
+  Frustum frustum = Culling::MakeFrustum(
+      Math::MakeOrthographicMatrix(0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 100.0f));
+  BoundsBatch batch;
+  // 0: 画面いっぱい
+  batch.Add(AABB{{0.0f, 0.0f, 0.0f}, {1280.0f, 720.0f, 0.0f}});
+  // 1: 左端に外から接している（境界上は見えている扱い）
+  batch.Add(AABB{{-10.0f, 100.0f, 0.0f}, {0.0f, 110.0f, 0.0f}});
+  // 2: 左端から少しだけ外
+  batch.Add(AABB{{-10.0f, 100.0f, 0.0f}, {-0.01f, 110.0f, 0.0f}});
+  // 3: 下端の外
+  batch.Add(AABB{{100.0f, 730.0f, 0.0f}, {110.0f, 740.0f, 0.0f}});
+  // 4: 画面より大きい（全平面をまたぐ）
+  batch.Add(AABB{{-5000.0f, -5000.0f, 0.0f}, {5000.0f, 5000.0f, 0.0f}});
+  // 5: 右上の角に半径だけかかっている球
+  batch.Add(Sphere{{1285.0f, -5.0f, 0.0f}, 6.0f});
+  // 6: zが範囲の外
+  batch.Add(AABB{{10.0f, 10.0f, 101.0f}, {20.0f, 20.0f, 102.0f}});
+  CheckCull(batch, frustum, {0, 1, 4, 5});
+
+  // Clearの後は新しく積んだ分だけを判定する（古い要素が混ざらない）
+  batch.Clear();
+  CHECK(batch.GetCount() == 0);
+  CheckCull(batch, frustum, {});
+  batch.Add(AABB{{-10.0f, 100.0f, 0.0f}, {-0.01f, 110.0f, 0.0f}});
+  CHECK(batch.Add(AABB{{10.0f, 10.0f, 0.0f}, {20.0f, 20.0f, 0.0f}}) == 1);
+  CheckCull(batch, frustum, {1});
+}
+
+// 乱数で置いた境界を1件ずつの判定と比べる
+// 計算の順が違うので、平面にほぼ接しているもの（差が丸め程度）は数えない
+void TestMatchesScalar(MathTest::Random &random) {
+  Frustum frustum = MakePerspectiveFrustum(Math::MakeIdentity4x4());
+  BoundsBatch batch;
+  std::vector<bool> expected;
+  std::vector<float> margins;
+  for (uint32_t i = 0; i < 10001; ++i) {
+    Vector3 center = random.Vector3(-150.0f, 150.0f);
+    float margin = 1e30f;
+    if (i % 2 == 0) {
+      AABB aabb = {center, center};
+      Vector3 extents = random.Vector3(0.0f, 10.0f);
+      aabb.min = {center.x - extents.x, center.y - extents.y,
+                  center.z - extents.z};
+      aabb.max = {center.x + extents.x, center.y + extents.y,
+                  center.z + extents.z};
+      batch.Add(aabb);
+      expected.push_back(Culling::IsVisible(frustum, aabb));
+      for (const Plane &plane : frustum.planes) {
+        margin = (std::min)(
+            margin, plane.normal.x * center.x + plane.normal.y * center.y +
+                        plane.normal.z * center.z + plane.distance +
+                        extents.x * std::fabs(plane.normal.x) +
+                        extents.y * std::fabs(plane.normal.y) +
+                        extents.z * std::fabs(plane.normal.z));
+      }
+    } else {
+      Sphere sphere = {center, random.Range(0.0f, 10.0f)};
+      batch.Add(sphere);
+      expected.push_back(Culling::IsVisible(frustum, sphere));
+      for (const Plane &plane : frustum.planes) {
+        margin = (std::min)(margin, plane.normal.x * center.x +
+                                        plane.normal.y * center.y +
+                                        plane.normal.z * center.z +
+                                        plane.distance + sphere.radius);
+      }
+    }
+    margins.push_back(margin);
+  }
+
+  std::vector<uint32_t> visibleIndices;
+  uint32_t visibleCount = batch.Cull(frustum, visibleIndices);
+  std::vector<bool> actual(expected.size(), false);
+  for (uint32_t i = 0; i < visibleCount; ++i) {
+    CHECK(i == 0 || visibleIndices[i - 1] < visibleIndices[i]);
+    actual[visibleIndices[i]] = true;
+  }
+  uint32_t mismatchCount = 0;
+  uint32_t expectedCount = 0;
+  for (size_t i = 0; i < expected.size(); ++i) {
+    expectedCount += expected[i] ? 1 : 0;
+    if (actual[i] != expected[i] && std::fabs(margins[i]) > 1e-3f) {
+      ++mismatchCount;
+    }
+  }
+  CHECK(mismatchCount == 0);
+  // 見える物と見えない物の両方が十分に混ざっていること
+  CHECK(expectedCount > 500 && expectedCount < 9500);
+  std::printf("random: %u of %zu visible\n", visibleCount, expected.size());
+}
+} // namespace
+
+int main() {
+  MathTest::Random random;
+  TestMakeFrustum();
+  TestPerspectiveCull();
+  TestOrthographicCull();
+  TestMatchesScalar(random);
+  return Test::Finish();
+}
@@ -0,0 +1,201 @@
+﻿#include "FastMath.h"
+#include <cstdint>
+#if defined(MYMATH_USE_AVX2)
+#include <immintrin.h>
+#endif
+
+using namespace MyMath;
+
+namespace {
+const float kTwoOverPi = 0.636619772367581343f;
+// π/2を3つに分けたもの。上の2つはkとの積が丸めなしで求まる桁数にしてある
+const float kPiOverTwo1 = 1.5703125f;
+const float kPiOverTwo2 = 4.837512969970703125e-4f;
+const float kPiOverTwo3 = 7.54978995489188216e-8f;
+
+// [-π/4, π/4]での近似多項式（係数はCephesのsinf/cosfと同じ）
+const float kSin1 = -1.6666654611e-1f;
+const float kSin2 = 8.3321608736e-3f;
+const float kSin3 = -1.9515295891e-4f;
+const float kCos1 = 4.166664568298827e-2f;
+const float kCos2 = -1.388731625493765e-3f;
+const float kCos3 = 2.443315711809948e-5f;
+
+// 範囲を縮めた値と象限を求める
+float Reduce(float radian, int *quadrant) {
+  // 四捨五入（切り捨ての変換で済ませる）
+  int k = static_cast<int>(radian * kTwoOverPi +
+                           (radian < 0.0f ? -0.5f : 0.5f));
+  float kf = static_cast<float>(k);
+  *quadrant = k & 3;
+  return ((radian - kf * kPiOverTwo1) - kf * kPiOverTwo2) - kf * kPiOverTwo3;
+}
+
+float SinPolynomial(float r) {
+  float r2 = r * r;
+  return r + r * r2 * (kSin1 + r2 * (kSin2 + r2 * kSin3));
+}
+
+float CosPolynomial(float r) {
+  float r2 = r * r;
+  return 1.0f - 0.5f * r2 + r2 * r2 * (kCos1 + r2 * (kCos2 + r2 * kCos3));
+}
+
+// 縮めた範囲の外は標準関数で求める
+void SinCosFallback(float radian, float *sinValue, float *cosValue) {
+  *sinValue = std::sin(radian);
+  *cosValue = std::cos(radian);
+}
+} // namespace
+
+void FastMath::SinCos(float radian, float *sinValue, float *cosValue) {
+  if (!(std::fabs(radian) <= kFastTrigLimit)) {
+    SinCosFallback(radian, sinValue, cosValue);
+    return;
+  }
+
+  int quadrant;
+  float r = Reduce(radian, &quadrant);
+  float s = SinPolynomial(r);
+  float c = CosPolynomial(r);
+  // 象限ごとに入れ替えと符号反転（分岐しない形にしておく）
+  float sinResult = (quadrant & 1) ? c : s;
+  float cosResult = (quadrant & 1) ? s : c;
+  *sinValue = (quadrant & 2) ? -sinResult : sinResult;
+  *cosValue = ((quadrant + 1) & 2) ? -cosResult : cosResult;
+}
+
+float FastMath::Sin(float radian) {
+  float s, c;
+  SinCos(radian, &s, &c);
+  return s;
+}
+
+float FastMath::Cos(float radian) {
+  float s, c;
+  SinCos(radian, &s, &c);
+  return c;
+}
+
+float FastMath::Tan(float radian) {
+  if (!(std::fabs(radian) <= kFastTrigLimit)) {
+    return std::tan(radian);
+  }
+  // tanは周期π。奇数の象限は -cos/sin になる
+  int quadrant;
+  float r = Reduce(radian, &quadrant);
+  float s = SinPolynomial(r);
+  float c = CosPolynomial(r);
+  return (quadrant & 1) ? -c / s : s / c;
+}
+
+void FastMath::SinCos4(const float *radians, float *sinValues,
+                       float *cosValues) {
+#if defined(MYMATH_USE_SSE2)
+  __m128 sines, cosines;
+  SinCos4(_mm_loadu_ps(radians), &sines, &cosines);
+  _mm_storeu_ps(sinValues, sines);
+  _mm_storeu_ps(cosValues, cosines);
+#else
+  for (int i = 0; i < 4; ++i) {
+    SinCos(radians[i], &sinValues[i], &cosValues[i]);
+  }
+#endif
+}
+
+#if defined(MYMATH_USE_SSE2)
+void FastMath::SinCos4(__m128 x, __m128 *sinValues, __m128 *cosValues) {
+  // 1つでも範囲外なら全部1つずつ求める
+  __m128 absX = _mm_andnot_ps(_mm_set1_ps(-0.0f), x);
+  if (_mm_movemask_ps(_mm_cmple_ps(absX, _mm_set1_ps(kFastTrigLimit))) !=
+      0xF) {
+    alignas(16) float radians[4];
+    alignas(16) float sines[4];
+    alignas(16) float cosines[4];
+    _mm_store_ps(radians, x);
+    for (int i = 0; i < 4; ++i) {
+      SinCos(radians[i], &sines[i], &cosines[i]);
+    }
+    *sinValues = _mm_load_ps(sines);
+    *cosValues = _mm_load_ps(cosines);
+    return;
+  }
+
+  // 最も近い整数に丸める（MXCSRの既定の丸め）
+  __m128i k = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(kTwoOverPi)));
+  __m128 kf = _mm_cvtepi32_ps(k);
+  __m128 r = _mm_sub_ps(x, _mm_mul_ps(kf, _mm_set1_ps(kPiOverTwo1)));
+  r = _mm_sub_ps(r, _mm_mul_ps(kf, _mm_set1_ps(kPiOverTwo2)));
+  r = _mm_sub_ps(r, _mm_mul_ps(kf, _mm_set1_ps(kPiOverTwo3)));
+
+  __m128 r2 = _mm_mul_ps(r, r);
+  __m128 s = _mm_add_ps(_mm_mul_ps(r2, _mm_set1_ps(kSin3)), _mm_set1_ps(kSin2));
+  s = _mm_add_ps(_mm_mul_ps(s, r2), _mm_set1_ps(kSin1));
+  s = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(r, r2), s));
+  __m128 c = _mm_add_ps(_mm_mul_ps(r2, _mm_set1_ps(kCos3)), _mm_set1_ps(kCos2));
+  c = _mm_add_ps(_mm_mul_ps(c, r2), _mm_set1_ps(kCos1));
+  c = _mm_add_ps(_mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(_mm_set1_ps(0.5f), r2)),
+                 _mm_mul_ps(_mm_mul_ps(r2, r2), c));
+
+  // 奇数の象限はsinとcosを入れ替える
+  __m128 swap = _mm_castsi128_ps(
+      _mm_cmpeq_epi32(_mm_and_si128(k, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+  __m128 sinResult = _mm_or_ps(_mm_and_ps(swap, c), _mm_andnot_ps(swap, s));
+  __m128 cosResult = _mm_or_ps(_mm_and_ps(swap, s), _mm_andnot_ps(swap, c));
+  // 符号。sinはkの2ビット目、cosはk+1の2ビット目が立っていれば反転
+  __m128 sinSign = _mm_castsi128_ps(
+      _mm_slli_epi32(_mm_and_si128(k, _mm_set1_epi32(2)), 30));
+  __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(
+      _mm_and_si128(_mm_add_epi32(k, _mm_set1_epi32(1)), _mm_set1_epi32(2)),
+      30));
+  *sinValues = _mm_xor_ps(sinResult, sinSign);
+  *cosValues = _mm_xor_ps(cosResult, cosSign);
+}
+#endif
+
+void FastMath::SinCos8(const float *radians, float *sinValues,
+                       float *cosValues) {
+#if defined(MYMATH_USE_AVX2)
+  __m256 x = _mm256_loadu_ps(radians);
+  __m256 absX = _mm256_andnot_ps(_mm256_set1_ps(-0.0f), x);
+  if (_mm256_movemask_ps(_mm256_cmp_ps(absX, _mm256_set1_ps(kFastTrigLimit),
+                                       _CMP_LE_OQ)) != 0xFF) {
+    for (int i = 0; i < 8; ++i) {
+      SinCos(radians[i], &sinValues[i], &cosValues[i]);
+    }
+    return;
+  }
+
+  __m256i k = _mm256_cvtps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(kTwoOverPi)));
+  __m256 kf = _mm256_cvtepi32_ps(k);
+  __m256 r = _mm256_fnmadd_ps(kf, _mm256_set1_ps(kPiOverTwo1), x);
+  r = _mm256_fnmadd_ps(kf, _mm256_set1_ps(kPiOverTwo2), r);
+  r = _mm256_fnmadd_ps(kf, _mm256_set1_ps(kPiOverTwo3), r);
+
+  __m256 r2 = _mm256_mul_ps(r, r);
+  __m256 s = _mm256_fmadd_ps(r2, _mm256_set1_ps(kSin3), _mm256_set1_ps(kSin2));
+  s = _mm256_fmadd_ps(s, r2, _mm256_set1_ps(kSin1));
+  s = _mm256_fmadd_ps(_mm256_mul_ps(r, r2), s, r);
+  __m256 c = _mm256_fmadd_ps(r2, _mm256_set1_ps(kCos3), _mm256_set1_ps(kCos2));
+  c = _mm256_fmadd_ps(c, r2, _mm256_set1_ps(kCos1));
+  c = _mm256_fmadd_ps(_mm256_mul_ps(r2, r2), c,
+                      _mm256_fnmadd_ps(_mm256_set1_ps(0.5f), r2,
+                                       _mm256_set1_ps(1.0f)));
+
+  __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(
+      _mm256_and_si256(k, _mm256_set1_epi32(1)), _mm256_set1_epi32(1)));
+  __m256 sinResult = _mm256_blendv_ps(s, c, swap);
+  __m256 cosResult = _mm256_blendv_ps(c, s, swap);
+  __m256 sinSign = _mm256_castsi256_ps(
+      _mm256_slli_epi32(_mm256_and_si256(k, _mm256_set1_epi32(2)), 30));
+  __m256 cosSign = _mm256_castsi256_ps(_mm256_slli_epi32(
+      _mm256_and_si256(_mm256_add_epi32(k, _mm256_set1_epi32(1)),
+                       _mm256_set1_epi32(2)),
+      30));
+  _mm256_storeu_ps(sinValues, _mm256_xor_ps(sinResult, sinSign));
+  _mm256_storeu_ps(cosValues, _mm256_xor_ps(cosResult, cosSign));
+#else
+  SinCos4(radians, sinValues, cosValues);
+  SinCos4(radians + 4, sinValues + 4, cosValues + 4);
+#endif
+}
@@ -0,0 +1,76 @@
+﻿#pragma once
+#include "Mymath.h"
+#include <cmath>
+#if defined(MYMATH_USE_SSE2)
+#include <emmintrin.h>
+#endif
+
+// 多項式近似の三角関数
+// π/2単位で[-π/4, π/4]に範囲を縮め、その範囲の最小最大近似多項式で求める
+// 誤差（真の値との差の絶対値）はsin/cosとも全域で最大9.4e-8程度
+// |x|がkFastTrigLimitを超えると縮約の精度が落ちるので標準関数に任せる
+namespace MyMath {
+namespace FastMath {
+
+// 近似を使う入力の範囲
+static const float kFastTrigLimit = 8192.0f;
+
+// sinとcosを同時に求める
+void SinCos(float radian, float *sinValue, float *cosValue);
+float Sin(float radian);
+float Cos(float radian);
+// tan。π/2の奇数倍の近くでは大きな値になる
+float Tan(float radian);
+
+// 4つ・8つまとめて求める（SSE2 / AVX2。無ければ1つずつ）
+void SinCos4(const float *radians, float *sinValues, float *cosValues);
+void SinCos8(const float *radians, float *sinValues, float *cosValues);
+#if defined(MYMATH_USE_SSE2)
+// レジスタのまま受け渡す版。値を1つずつ詰めた配列を読み直さずに済む
+void SinCos4(__m128 radians, __m128 *sinValues, __m128 *cosValues);
+#endif
+
+} // namespace FastMath
+
+// 変換行列の組み立てで使うsin/cos
+// MYMATH_FAST_TRIGを定義すると近似版を使う
+inline void TransformSinCos(float radian, float *sinValue, float *cosValue) {
+#if defined(MYMATH_FAST_TRIG)
+  FastMath::SinCos(radian, sinValue, cosValue);
+#else
+  *sinValue = std::sin(radian);
+  *cosValue = std::cos(radian);
+#endif
+}
+// 3軸分をまとめて求める（近似版では4つまとめて1回で計算する）
+inline void TransformSinCos3(const Vector3 &radians, Vector3 *sinValues,
+                             Vector3 *cosValues) {
+#if defined(MYMATH_FAST_TRIG) && defined(MYMATH_USE_SSE2)
+  __m128 sines, cosines;
+  FastMath::SinCos4(_mm_setr_ps(radians.x, radians.y, radians.z, 0.0f),
+                    &sines, &cosines);
+  *sinValues = {_mm_cvtss_f32(sines),
+                _mm_cvtss_f32(_mm_shuffle_ps(sines, sines, 1)),
+                _mm_cvtss_f32(_mm_shuffle_ps(sines, sines, 2))};
+  *cosValues = {_mm_cvtss_f32(cosines),
+                _mm_cvtss_f32(_mm_shuffle_ps(cosines, cosines, 1)),
+                _mm_cvtss_f32(_mm_shuffle_ps(cosines, cosines, 2))};
+#elif defined(MYMATH_FAST_TRIG)
+  FastMath::SinCos(radians.x, &sinValues->x, &cosValues->x);
+  FastMath::SinCos(radians.y, &sinValues->y, &cosValues->y);
+  FastMath::SinCos(radians.z, &sinValues->z, &cosValues->z);
+#else
+  *sinValues = {std::sin(radians.x), std::sin(radians.y), std::sin(radians.z)};
+  *cosValues = {std::cos(radians.x), std::cos(radians.y), std::cos(radians.z)};
+#endif
+}
+// 射影行列の組み立てで使うtan
+inline float TransformTan(float radian) {
+#if defined(MYMATH_FAST_TRIG)
+  return FastMath::Tan(radian);
+#else
+  return std::tan(radian);
+#endif
+}
+
+} // namespace MyMath
@@ -0,0 +1,212 @@
+﻿#include "Check.h"
+#include "FastMath.h"
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+using namespace MyMath;
+
+// FastMathの誤差がヘッダーに書いた最大誤差（9.4e-8程度）に収まるか
+// floatのビット列を一定の間隔で全域（非正規化数・kFastTrigLimitの外も含む）
+// 走査し、doubleで求めた値との差を調べる
+// 引数に full を渡すと |x| <= kFastTrigLimit のfloatを全部調べる（数分かかる）
+// 全部調べた時の最大はsinが9.38e-8（x = 2100.9021）、cosが9.3e-8
+namespace {
+// ヘッダーの値に丸めの余裕を少し足したもの
+const double kMaxError = 1e-7;
+// ビット列の走査間隔（素数にして指数・仮数の偏りを避ける）
+const uint32_t kStride = 251;
+
+float FromBits(uint32_t bits) {
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+struct ErrorStats {
+  double maxSin = 0.0;
+  double maxCos = 0.0;
+  float worstSin = 0.0f;
+  float worstCos = 0.0f;
+  uint64_t count = 0;
+
+  void Add(float x, float s, float c) {
+    double sinError = std::fabs(static_cast<double>(s) - std::sin(double(x)));
+    double cosError = std::fabs(static_cast<double>(c) - std::cos(double(x)));
+    if (sinError > maxSin) {
+      maxSin = sinError;
+      worstSin = x;
+    }
+    if (cosError > maxCos) {
+      maxCos = cosError;
+      worstCos = x;
+    }
+    ++count;
+  }
+
+  void Print(const char *name) const {
+    std::printf("%-10s %12llu samples  sin %.3g (x = %.9g)  cos %.3g (x = %.9g)\n",
+                name, static_cast<unsigned long long>(count), maxSin,
+                worstSin, maxCos, worstCos);
+  }
+};
+
+// 有限の値だけを走査する（stride = 1で全部）
+template <class Func>
+void ForEachFloat(uint32_t first, uint32_t last, uint32_t stride, Func func) {
+  for (uint64_t bits = first; bits <= last; bits += stride) {
+    float x = FromBits(static_cast<uint32_t>(bits));
+    if (std::isfinite(x)) {
+      func(x);
+    }
+  }
+}
+
+void TestSinCos() {
+  ErrorStats scalar;
+  ErrorStats separate;
+  ForEachFloat(0, UINT32_MAX, kStride, [&](float x) {
+    float s, c;
+    FastMath::SinCos(x, &s, &c);
+    scalar.Add(x, s, c);
+    separate.Add(x, FastMath::Sin(x), FastMath::Cos(x));
+  });
+  scalar.Print("SinCos");
+  separate.Print("Sin/Cos");
+  CHECK(scalar.maxSin <= kMaxError);
+  CHECK(scalar.maxCos <= kMaxError);
+  CHECK(separate.maxSin <= kMaxError);
+  CHECK(separate.maxCos <= kMaxError);
+}
+
+// まとめて求める版。AVX2/FMA版は丸めが1つ1つの版と違うので、
+// 1つずつの版と比べずに同じ誤差の上限で確かめる
+// 範囲外の値が1つでも混ざると1つずつの計算に切り替わるので、
+// 範囲内だけの組と範囲外が混ざった組の両方を作る
+void TestBatch() {
+  ErrorStats batch4;
+  ErrorStats batch8;
+  float radians[8];
+  float sines[8];
+  float cosines[8];
+  uint32_t filled = 0;
+  uint64_t groupIndex = 0;
+  ForEachFloat(0, UINT32_MAX, kStride, [&](float x) {
+    // 8組に1組は範囲外を許し、それ以外は範囲内だけにする
+    bool allowOutside = (groupIndex % 8) == 7;
+    if (!allowOutside && !(std::fabs(x) <= FastMath::kFastTrigLimit)) {
+      return;
+    }
+    radians[filled++] = x;
+    if (filled < 8) {
+      return;
+    }
+    filled = 0;
+    ++groupIndex;
+    FastMath::SinCos4(radians, sines, cosines);
+    FastMath::SinCos4(radians + 4, sines + 4, cosines + 4);
+    for (int i = 0; i < 8; ++i) {
+      batch4.Add(radians[i], sines[i], cosines[i]);
+    }
+    FastMath::SinCos8(radians, sines, cosines);
+    for (int i = 0; i < 8; ++i) {
+      batch8.Add(radians[i], sines[i], cosines[i]);
+    }
+  });
+  batch4.Print("SinCos4");
+  batch8.Print("SinCos8");
+  CHECK(batch4.maxSin <= kMaxError);
+  CHECK(batch4.maxCos <= kMaxError);
+  CHECK(batch8.maxSin <= kMaxError);
+  CHECK(batch8.maxCos <= kMaxError);
+}
+
+// 境界付近の値。縮約の切り替わり（π/4の奇数倍）とkFastTrigLimitの前後
+void TestBoundaries() {
+  ErrorStats boundary;
+  const double kQuarterPi = 0.78539816339744830962;
+  for (int n = -10431; n <= 10431; n += 2) {
+    float center = static_cast<float>(n * kQuarterPi);
+    float x = std::nextafter(center, -INFINITY);
+    for (int i = 0; i < 3; ++i, x = std::nextafter(x, INFINITY)) {
+      float s, c;
+      FastMath::SinCos(x, &s, &c);
+      boundary.Add(x, s, c);
+    }
+  }
+  for (float limit : {FastMath::kFastTrigLimit, -FastMath::kFastTrigLimit}) {
+    float x = std::nextafter(limit, 0.0f);
+    for (int i = 0; i < 3; ++i, x = std::nextafter(x, limit * 2.0f)) {
+      float s, c;
+      FastMath::SinCos(x, &s, &c);
+      boundary.Add(x, s, c);
+    }
+  }
+  boundary.Print("boundary");
+  CHECK(boundary.maxSin <= kMaxError);
+  CHECK(boundary.maxCos <= kMaxError);
+
+  // 0はちょうど0と1。無限大・NaNは標準関数と同じくNaN
+  // （-0の符号は多項式の足し算で落ちるので見ない）
+  CHECK(FastMath::Sin(0.0f) == 0.0f);
+  CHECK(FastMath::Sin(-0.0f) == 0.0f);
+  CHECK(FastMath::Cos(0.0f) == 1.0f);
+  CHECK(std::isnan(FastMath::Sin(INFINITY)));
+  CHECK(std::isnan(FastMath::Cos(-INFINITY)));
+  CHECK(std::isnan(FastMath::Sin(NAN)));
+  CHECK(std::isnan(FastMath::Tan(NAN)));
+}
+
+// tanは極の近くで値が大きくなるので相対誤差で見る
+// |cos| >= 0.01（極からおよそ0.01rad以上離れた所）に限る
+void TestTan() {
+  double maxRelative = 0.0;
+  float worst = 0.0f;
+  uint64_t count = 0;
+  ForEachFloat(0, UINT32_MAX, kStride, [&](float x) {
+    double reference = std::tan(static_cast<double>(x));
+    if (std::fabs(std::cos(static_cast<double>(x))) < 0.01) {
+      return;
+    }
+    double relative =
+        std::fabs(FastMath::Tan(x) - reference) /
+        (std::max)(std::fabs(reference), 1.0);
+    if (relative > maxRelative) {
+      maxRelative = relative;
+      worst = x;
+    }
+    ++count;
+  });
+  std::printf("%-10s %12llu samples  relative %.3g (x = %.9g)\n", "Tan",
+              static_cast<unsigned long long>(count), maxRelative, worst);
+  CHECK(maxRelative <= 1e-6);
+}
+
+// |x| <= kFastTrigLimit の全てのfloat
+void TestExhaustive() {
+  uint32_t limitBits;
+  std::memcpy(&limitBits, &FastMath::kFastTrigLimit, sizeof(limitBits));
+  ErrorStats all;
+  for (uint32_t sign : {0u, 0x80000000u}) {
+    ForEachFloat(sign, sign | limitBits, 1, [&](float x) {
+      float s, c;
+      FastMath::SinCos(x, &s, &c);
+      all.Add(x, s, c);
+    });
+  }
+  all.Print("all");
+  CHECK(all.maxSin <= kMaxError);
+  CHECK(all.maxCos <= kMaxError);
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  TestSinCos();
+  TestBatch();
+  TestBoundaries();
+  TestTan();
+  if (argc > 1 && std::string(argv[1]) == "full") {
+    TestExhaustive();
+  }
+  return Test::Finish();
+}
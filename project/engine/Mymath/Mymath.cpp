@@ -1,8 +1,61 @@
 #include "Mymath.h"
+#include "FastMath.h"
+#include "VectorMath.h"
 #include <cassert>
+#if defined(MYMATH_USE_AVX2)
+#include <immintrin.h>
+#elif defined(MYMATH_USE_SSE2)
+#include <emmintrin.h>
+#endif
 
 using namespace MyMath;
 
+#if defined(MYMATH_USE_SSE2)
+namespace {
+// _mm_shuffle_psの並べ替え指定（x,y,zは1つ目、wは2つ目の引数から）
+constexpr int Shuffle(int x, int y, int z, int w) {
+  return x | (y << 2) | (z << 4) | (w << 6);
+}
+
+// 1つのベクトル内での並べ替え
+#define Swizzle(v, x, y, z, w) _mm_shuffle_ps((v), (v), Shuffle(x, y, z, w))
+
+// 2x2行列（x,y,z,wに行優先で格納）の積 A*B
+__m128 Mat2Mul(__m128 a, __m128 b) {
+  return _mm_add_ps(_mm_mul_ps(a, Swizzle(b, 0, 3, 0, 3)),
+                    _mm_mul_ps(Swizzle(a, 1, 0, 3, 2), Swizzle(b, 2, 1, 2, 1)));
+}
+// 随伴行列との積 A#*B
+__m128 Mat2AdjMul(__m128 a, __m128 b) {
+  return _mm_sub_ps(_mm_mul_ps(Swizzle(a, 3, 3, 0, 0), b),
+                    _mm_mul_ps(Swizzle(a, 1, 1, 2, 2), Swizzle(b, 2, 3, 0, 1)));
+}
+// 随伴行列との積 A*B#
+__m128 Mat2MulAdj(__m128 a, __m128 b) {
+  return _mm_sub_ps(_mm_mul_ps(a, Swizzle(b, 3, 0, 3, 0)),
+                    _mm_mul_ps(Swizzle(a, 1, 0, 3, 2), Swizzle(b, 2, 1, 2, 1)));
+}
+
+// 3次元の外積（w成分は0になる）
+__m128 CrossProduct(__m128 a, __m128 b) {
+  __m128 r = _mm_sub_ps(_mm_mul_ps(a, Swizzle(b, 1, 2, 0, 3)),
+                        _mm_mul_ps(Swizzle(a, 1, 2, 0, 3), b));
+  return Swizzle(r, 1, 2, 0, 3);
+}
+
+// 3x3の逆行列（行）から平行移動 -t × inv3x3 を求めて4行目に書き込む
+void StoreInverseTranslation(Matrix4x4 &result, const Matrix4x4 &m,
+                             __m128 row0, __m128 row1, __m128 row2) {
+  __m128 t = _mm_mul_ps(_mm_set1_ps(m.m[3][0]), row0);
+  t = _mm_add_ps(t, _mm_mul_ps(_mm_set1_ps(m.m[3][1]), row1));
+  t = _mm_add_ps(t, _mm_mul_ps(_mm_set1_ps(m.m[3][2]), row2));
+  // 符号を反転し、wを1にする
+  t = _mm_sub_ps(_mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f), t);
+  _mm_storeu_ps(result.m[3], t);
+}
+} // namespace
+#endif
+
 Matrix4x4 Math::MakeIdentity4x4() {
   Matrix4x4 identity{};
 
@@ -15,23 +68,49 @@ Matrix4x4 Math::MakeIdentity4x4() {
 }
 
 Matrix4x4 Math::Multiply(const Matrix4x4 &m1, const Matrix4x4 &m2) {
-  Matrix4x4 result{};
-
+#if defined(MYMATH_USE_AVX2)
+  Matrix4x4 result;
+  // m2の各行を上下両方のレーンに置く
+  __m256 row0 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(m2.m[0]));
+  __m256 row1 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(m2.m[1]));
+  __m256 row2 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(m2.m[2]));
+  __m256 row3 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(m2.m[3]));
+  // m1の2行ずつ（下位レーンがi行、上位レーンがi+1行）
+  for (int i = 0; i < 4; i += 2) {
+    __m256 a = _mm256_loadu_ps(m1.m[i]);
+    __m256 r = _mm256_mul_ps(_mm256_shuffle_ps(a, a, 0x00), row0);
+    r = _mm256_fmadd_ps(_mm256_shuffle_ps(a, a, 0x55), row1, r);
+    r = _mm256_fmadd_ps(_mm256_shuffle_ps(a, a, 0xAA), row2, r);
+    r = _mm256_fmadd_ps(_mm256_shuffle_ps(a, a, 0xFF), row3, r);
+    _mm256_storeu_ps(result.m[i], r);
+  }
+  return result;
+#elif defined(MYMATH_USE_SSE2)
+  Matrix4x4 result;
+  __m128 row0 = _mm_loadu_ps(m2.m[0]);
+  __m128 row1 = _mm_loadu_ps(m2.m[1]);
+  __m128 row2 = _mm_loadu_ps(m2.m[2]);
+  __m128 row3 = _mm_loadu_ps(m2.m[3]);
+  // 結果のi行 = m1のi行の各要素でm2の各行を重み付けした和
+  // 足す順番はスカラー版と同じなので結果も一致する
   for (int i = 0; i < 4; ++i) {
-    for (int j = 0; j < 4; ++j) {
-      result.m[i][j] = m1.m[i][0] * m2.m[0][j] + m1.m[i][1] * m2.m[1][j] +
-                       m1.m[i][2] * m2.m[2][j] + m1.m[i][3] * m2.m[3][j];
-    }
+    __m128 r = _mm_mul_ps(_mm_set1_ps(m1.m[i][0]), row0);
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(m1.m[i][1]), row1));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(m1.m[i][2]), row2));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(m1.m[i][3]), row3));
+    _mm_storeu_ps(result.m[i], r);
   }
-
   return result;
+#else
+  return Scalar::Multiply(m1, m2);
+#endif
 }
 
 Matrix4x4 Math::MakeRotateXMatrix(float radian) {
   Matrix4x4 result = MakeIdentity4x4();
 
-  float c = std::cos(radian);
-  float s = std::sin(radian);
+  float c, s;
+  TransformSinCos(radian, &s, &c);
 
   result.m[1][1] = c;
   result.m[1][2] = s;
@@ -44,8 +123,8 @@ Matrix4x4 Math::MakeRotateXMatrix(float radian) {
 Matrix4x4 Math::MakeRotateYMatrix(float radian) {
   Matrix4x4 result = MakeIdentity4x4();
 
-  float c = std::cos(radian);
-  float s = std::sin(radian);
+  float c, s;
+  TransformSinCos(radian, &s, &c);
 
   result.m[0][0] = c;
   result.m[0][2] = -s;
@@ -58,8 +137,8 @@ Matrix4x4 Math::MakeRotateYMatrix(float radian) {
 Matrix4x4 Math::MakeRotateZMatrix(float radian) {
   Matrix4x4 result = MakeIdentity4x4();
 
-  float c = std::cos(radian);
-  float s = std::sin(radian);
+  float c, s;
+  TransformSinCos(radian, &s, &c);
 
   result.m[0][0] = c;
   result.m[0][1] = s;
@@ -71,76 +150,380 @@ Matrix4x4 Math::MakeRotateZMatrix(float radian) {
 
 Matrix4x4 Math::MakeAffineMatrix(const Vector3 &scale, const Vector3 &rotate,
                                  const Vector3 &translate) {
+#if defined(MYMATH_USE_SSE2)
+  Vector3 sines, cosines;
+  TransformSinCos3(rotate, &sines, &cosines);
+  float cx = cosines.x;
+  float sx = sines.x;
+  float cy = cosines.y;
+  float sy = sines.y;
+  float cz = cosines.z;
+  float sz = sines.z;
+
+  // X回転×Y回転は成分が決まっているので直接書く
+  // 各行にZ回転の行を重み付けして足すと X×Y×Z になる
+  __m128 rz0 = _mm_setr_ps(cz, sz, 0.0f, 0.0f);
+  __m128 rz1 = _mm_setr_ps(-sz, cz, 0.0f, 0.0f);
+  __m128 rz2 = _mm_setr_ps(0.0f, 0.0f, 1.0f, 0.0f);
+
+  __m128 row0 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(cy), rz0),
+                           _mm_mul_ps(_mm_set1_ps(-sy), rz2));
+  __m128 row1 = _mm_add_ps(
+      _mm_add_ps(_mm_mul_ps(_mm_set1_ps(sx * sy), rz0),
+                 _mm_mul_ps(_mm_set1_ps(cx), rz1)),
+      _mm_mul_ps(_mm_set1_ps(sx * cy), rz2));
+  __m128 row2 = _mm_add_ps(
+      _mm_add_ps(_mm_mul_ps(_mm_set1_ps(cx * sy), rz0),
+                 _mm_mul_ps(_mm_set1_ps(-sx), rz1)),
+      _mm_mul_ps(_mm_set1_ps(cx * cy), rz2));
+
+  // 拡縮は行ごとに掛ける。平行移動は最後の行
+  Matrix4x4 result;
+  _mm_storeu_ps(result.m[0], _mm_mul_ps(row0, _mm_set1_ps(scale.x)));
+  _mm_storeu_ps(result.m[1], _mm_mul_ps(row1, _mm_set1_ps(scale.y)));
+  _mm_storeu_ps(result.m[2], _mm_mul_ps(row2, _mm_set1_ps(scale.z)));
+  _mm_storeu_ps(result.m[3],
+                _mm_setr_ps(translate.x, translate.y, translate.z, 1.0f));
+  return result;
+#else
+  return Scalar::MakeAffineMatrix(scale, rotate, translate);
+#endif
+}
 
-  Matrix4x4 rx = MakeRotateXMatrix(rotate.x);
-  Matrix4x4 ry = MakeRotateYMatrix(rotate.y);
-  Matrix4x4 rz = MakeRotateZMatrix(rotate.z);
-
-  Matrix4x4 rot = Multiply(Multiply(rx, ry), rz);
+Matrix4x4 Math::MakePerspectiveFovMatrix(float fovY, float aspectRatio,
+                                         float nearClip, float farClip) {
+#if defined(MYMATH_USE_SSE2)
+  float cot = 1.0f / TransformTan(fovY / 2.0f);
 
-  rot.m[0][0] *= scale.x;
-  rot.m[0][1] *= scale.x;
-  rot.m[0][2] *= scale.x;
+  // 4つの割り算を1回で行う
+  alignas(16) float values[4];
+  _mm_store_ps(values,
+               _mm_div_ps(_mm_setr_ps(cot, cot, farClip, -(nearClip * farClip)),
+                          _mm_setr_ps(aspectRatio, 1.0f, farClip - nearClip,
+                                      farClip - nearClip)));
 
-  rot.m[1][0] *= scale.y;
-  rot.m[1][1] *= scale.y;
-  rot.m[1][2] *= scale.y;
+  Matrix4x4 result{};
+  result.m[0][0] = values[0];
+  result.m[1][1] = values[1];
+  result.m[2][2] = values[2];
+  result.m[2][3] = 1.0f;
+  result.m[3][2] = values[3];
+  return result;
+#else
+  return Scalar::MakePerspectiveFovMatrix(fovY, aspectRatio, nearClip,
+                                          farClip);
+#endif
+}
 
-  rot.m[2][0] *= scale.z;
-  rot.m[2][1] *= scale.z;
-  rot.m[2][2] *= scale.z;
+Matrix4x4 Math::MakeOrthographicMatrix(float left, float top, float right,
+                                       float bottom, float nearClip,
+                                       float farClip) {
+#if defined(MYMATH_USE_SSE2)
+  // 対角成分と平行移動成分をそれぞれ1回の割り算で求める
+  __m128 scale = _mm_div_ps(
+      _mm_setr_ps(2.0f, 2.0f, 1.0f, 1.0f),
+      _mm_setr_ps(right - left, top - bottom, farClip - nearClip, 1.0f));
+  __m128 translate = _mm_div_ps(
+      _mm_setr_ps(left + right, top + bottom, nearClip, 1.0f),
+      _mm_setr_ps(left - right, bottom - top, nearClip - farClip, 1.0f));
+  alignas(16) float scales[4];
+  _mm_store_ps(scales, scale);
 
-  rot.m[3][0] = translate.x;
-  rot.m[3][1] = translate.y;
-  rot.m[3][2] = translate.z;
-  rot.m[3][3] = 1.0f;
+  Matrix4x4 result{};
+  result.m[0][0] = scales[0];
+  result.m[1][1] = scales[1];
+  result.m[2][2] = scales[2];
+  _mm_storeu_ps(result.m[3], translate);
+  return result;
+#else
+  return Scalar::MakeOrthographicMatrix(left, top, right, bottom, nearClip,
+                                        farClip);
+#endif
+}
 
-  return rot;
+Matrix4x4 Math::Inverse(const Matrix4x4 &m) {
+#if defined(MYMATH_USE_SSE2)
+  // 2x2のブロックに分けて余因子展開する
+  //   M = | A B |   inv(M) = 1/|M| * | X# Y# |
+  //       | C D |                    | Z# W# |
+  __m128 row0 = _mm_loadu_ps(m.m[0]);
+  __m128 row1 = _mm_loadu_ps(m.m[1]);
+  __m128 row2 = _mm_loadu_ps(m.m[2]);
+  __m128 row3 = _mm_loadu_ps(m.m[3]);
+
+  __m128 a = _mm_movelh_ps(row0, row1);
+  __m128 b = _mm_movehl_ps(row1, row0);
+  __m128 c = _mm_movelh_ps(row2, row3);
+  __m128 d = _mm_movehl_ps(row3, row2);
+
+  // 各ブロックの行列式 (|A|, |B|, |C|, |D|)
+  __m128 detSub = _mm_sub_ps(
+      _mm_mul_ps(_mm_shuffle_ps(row0, row2, Shuffle(0, 2, 0, 2)),
+                 _mm_shuffle_ps(row1, row3, Shuffle(1, 3, 1, 3))),
+      _mm_mul_ps(_mm_shuffle_ps(row0, row2, Shuffle(1, 3, 1, 3)),
+                 _mm_shuffle_ps(row1, row3, Shuffle(0, 2, 0, 2))));
+  __m128 detA = Swizzle(detSub, 0, 0, 0, 0);
+  __m128 detB = Swizzle(detSub, 1, 1, 1, 1);
+  __m128 detC = Swizzle(detSub, 2, 2, 2, 2);
+  __m128 detD = Swizzle(detSub, 3, 3, 3, 3);
+
+  __m128 dc = Mat2AdjMul(d, c);
+  __m128 ab = Mat2AdjMul(a, b);
+  // X# = |D|A - B(D#C)、W# = |A|D - C(A#B)
+  __m128 x = _mm_sub_ps(_mm_mul_ps(detD, a), Mat2Mul(b, dc));
+  __m128 w = _mm_sub_ps(_mm_mul_ps(detA, d), Mat2Mul(c, ab));
+  // Y# = |B|C - D(A#B)#、Z# = |C|B - A(D#C)#
+  __m128 y = _mm_sub_ps(_mm_mul_ps(detB, c), Mat2MulAdj(d, ab));
+  __m128 z = _mm_sub_ps(_mm_mul_ps(detC, b), Mat2MulAdj(a, dc));
+
+  // |M| = |A||D| + |B||C| - tr((A#B)(D#C))
+  __m128 trace = _mm_mul_ps(ab, Swizzle(dc, 0, 2, 1, 3));
+  trace = _mm_add_ps(trace, Swizzle(trace, 2, 3, 0, 1));
+  trace = _mm_add_ps(trace, Swizzle(trace, 1, 0, 3, 2));
+  __m128 determinant = _mm_sub_ps(
+      _mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), trace);
+  assert(_mm_cvtss_f32(determinant) != 0.0f);
+
+  // 随伴行列の符号をまとめて掛ける
+  __m128 recpDeterminant =
+      _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), determinant);
+  x = _mm_mul_ps(x, recpDeterminant);
+  y = _mm_mul_ps(y, recpDeterminant);
+  z = _mm_mul_ps(z, recpDeterminant);
+  w = _mm_mul_ps(w, recpDeterminant);
+
+  // 随伴を取る並べ替えと書き戻す並べ替えを同時に行う
+  Matrix4x4 result;
+  _mm_storeu_ps(result.m[0], _mm_shuffle_ps(x, y, Shuffle(3, 1, 3, 1)));
+  _mm_storeu_ps(result.m[1], _mm_shuffle_ps(x, y, Shuffle(2, 0, 2, 0)));
+  _mm_storeu_ps(result.m[2], _mm_shuffle_ps(z, w, Shuffle(3, 1, 3, 1)));
+  _mm_storeu_ps(result.m[3], _mm_shuffle_ps(z, w, Shuffle(2, 0, 2, 0)));
+  return result;
+#else
+  return Scalar::Inverse(m);
+#endif
 }
 
-Matrix4x4 Math::MakePerspectiveFovMatrix(float fovY, float aspectRatio,
-                                         float nearClip, float farClip) {
+Matrix4x4 Math::InverseAffine(const Matrix4x4 &m) {
+#if defined(MYMATH_USE_SSE2)
+  // 4列目は0なので外積を取っても4番目の成分は0のまま
+  __m128 row0 = _mm_loadu_ps(m.m[0]);
+  __m128 row1 = _mm_loadu_ps(m.m[1]);
+  __m128 row2 = _mm_loadu_ps(m.m[2]);
+
+  // 余因子 = 行どうしの外積。逆行列の列になる
+  __m128 c0 = CrossProduct(row1, row2);
+  __m128 c1 = CrossProduct(row2, row0);
+  __m128 c2 = CrossProduct(row0, row1);
+
+  __m128 determinant = _mm_mul_ps(row0, c0);
+  determinant = _mm_add_ps(determinant, Swizzle(determinant, 1, 0, 3, 2));
+  determinant = _mm_add_ps(determinant, Swizzle(determinant, 2, 2, 0, 0));
+  assert(_mm_cvtss_f32(determinant) != 0.0f);
+  __m128 recpDeterminant =
+      _mm_div_ps(_mm_set1_ps(1.0f), Swizzle(determinant, 0, 0, 0, 0));
+
+  __m128 row3 = _mm_setzero_ps();
+  _MM_TRANSPOSE4_PS(c0, c1, c2, row3);
+  c0 = _mm_mul_ps(c0, recpDeterminant);
+  c1 = _mm_mul_ps(c1, recpDeterminant);
+  c2 = _mm_mul_ps(c2, recpDeterminant);
 
-  Matrix4x4 result{};
+  Matrix4x4 result;
+  _mm_storeu_ps(result.m[0], c0);
+  _mm_storeu_ps(result.m[1], c1);
+  _mm_storeu_ps(result.m[2], c2);
+  StoreInverseTranslation(result, m, c0, c1, c2);
+  return result;
+#else
+  return Scalar::InverseAffine(m);
+#endif
+}
 
-  float cot = 1.0f / std::tan(fovY / 2.0f);
+Matrix4x4 Math::InverseRigid(const Matrix4x4 &m) {
+#if defined(MYMATH_USE_SSE2)
+  // 回転部分は転置するだけ
+  __m128 row0 = _mm_loadu_ps(m.m[0]);
+  __m128 row1 = _mm_loadu_ps(m.m[1]);
+  __m128 row2 = _mm_loadu_ps(m.m[2]);
+  __m128 row3 = _mm_setzero_ps();
+  _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
 
-  result.m[0][0] = cot / aspectRatio;
-  result.m[1][1] = cot;
-  result.m[2][2] = farClip / (farClip - nearClip);
-  result.m[2][3] = 1.0f;
-  result.m[3][2] = -(nearClip * farClip) / (farClip - nearClip);
+  Matrix4x4 result;
+  _mm_storeu_ps(result.m[0], row0);
+  _mm_storeu_ps(result.m[1], row1);
+  _mm_storeu_ps(result.m[2], row2);
+  StoreInverseTranslation(result, m, row0, row1, row2);
+  return result;
+#else
+  return Scalar::InverseRigid(m);
+#endif
+}
 
+Vector4 Math::Transform(const Vector4 &vector, const Matrix4x4 &matrix) {
+#if defined(MYMATH_USE_SSE2)
+  // 行ベクトル×行列 = 行列の各行をベクトルの成分で重み付けした和
+  __m128 r = _mm_mul_ps(_mm_set1_ps(vector.x), _mm_loadu_ps(matrix.m[0]));
+  r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(vector.y), _mm_loadu_ps(matrix.m[1])));
+  r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(vector.z), _mm_loadu_ps(matrix.m[2])));
+  r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(vector.w), _mm_loadu_ps(matrix.m[3])));
+  Vector4 result;
+  _mm_storeu_ps(&result.x, r);
   return result;
+#else
+  return Scalar::Transform(vector, matrix);
+#endif
 }
 
-Matrix4x4 Math::MakeOrthographicMatrix(float left, float top, float right,
-                                       float bottom, float nearClip,
-                                       float farClip) {
+Vector3 Math::TransformCoord(const Vector3 &vector, const Matrix4x4 &matrix) {
+#if defined(MYMATH_USE_SSE2)
+  Vector4 result = Transform({vector.x, vector.y, vector.z, 1.0f}, matrix);
+  return {result.x / result.w, result.y / result.w, result.z / result.w};
+#else
+  return Scalar::TransformCoord(vector, matrix);
+#endif
+}
 
-  Matrix4x4 result{};
+Quaternion Math::Multiply(const Quaternion &q1, const Quaternion &q2) {
+  return q1 * q2;
+}
 
-  result.m[0][0] = 2.0f / (right - left);
-  result.m[1][1] = 2.0f / (top - bottom);
-  result.m[2][2] = 1.0f / (farClip - nearClip);
+Quaternion Math::MakeRotateAxisAngleQuaternion(const Vector3 &axis,
+                                               float angle) {
+  float s, c;
+  TransformSinCos(angle * 0.5f, &s, &c);
+  return {axis.x * s, axis.y * s, axis.z * s, c};
+}
 
-  result.m[3][0] = (left + right) / (left - right);
-  result.m[3][1] = (top + bottom) / (bottom - top);
-  result.m[3][2] = nearClip / (nearClip - farClip);
-  result.m[3][3] = 1.0f;
+Quaternion Math::MakeRotateQuaternion(const Vector3 &rotate) {
+  // 3軸の半角のsin/cosはまとめて求める
+  Vector3 sines, cosines;
+  TransformSinCos3(rotate * 0.5f, &sines, &cosines);
+  Quaternion qx = {sines.x, 0.0f, 0.0f, cosines.x};
+  Quaternion qy = {0.0f, sines.y, 0.0f, cosines.y};
+  Quaternion qz = {0.0f, 0.0f, sines.z, cosines.z};
+  return qx * qy * qz;
+}
+
+Quaternion Math::Normalize(const Quaternion &q) {
+  float length = std::sqrt(Dot(q, q));
+  assert(length != 0.0f);
+  float recpLength = 1.0f / length;
+  return {q.x * recpLength, q.y * recpLength, q.z * recpLength,
+          q.w * recpLength};
+}
 
+Quaternion Math::Slerp(const Quaternion &q0, const Quaternion &q1, float t) {
+  // 反対向きなら符号を反転して短い方の弧を通る
+  Quaternion end = q1;
+  float dot = Dot(q0, q1);
+  if (dot < 0.0f) {
+    end = {-q1.x, -q1.y, -q1.z, -q1.w};
+    dot = -dot;
+  }
+  // ほぼ同じ向きならsinθが0に近いので線形補間で済ませる
+  if (dot > 0.9995f) {
+    return Nlerp(q0, end, t);
+  }
+
+  float theta = std::acos(dot);
+  float recpSin = 1.0f / std::sin(theta);
+  float scale0 = std::sin((1.0f - t) * theta) * recpSin;
+  float scale1 = std::sin(t * theta) * recpSin;
+  return {scale0 * q0.x + scale1 * end.x, scale0 * q0.y + scale1 * end.y,
+          scale0 * q0.z + scale1 * end.z, scale0 * q0.w + scale1 * end.w};
+}
+
+Quaternion Math::Nlerp(const Quaternion &q0, const Quaternion &q1, float t) {
+#if defined(MYMATH_USE_SSE2)
+  __m128 a = _mm_loadu_ps(&q0.x);
+  __m128 b = _mm_loadu_ps(&q1.x);
+  // 反対向きならq1の符号を反転する（符号ビットだけ入れ替える）
+  __m128 dot = _mm_mul_ps(a, b);
+  dot = _mm_add_ps(dot, Swizzle(dot, 1, 0, 3, 2));
+  dot = _mm_add_ps(dot, Swizzle(dot, 2, 3, 0, 1));
+  __m128 sign = _mm_and_ps(dot, _mm_set1_ps(-0.0f));
+  b = _mm_xor_ps(b, sign);
+
+  __m128 r = _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), _mm_set1_ps(t)));
+  __m128 lengthSquared = _mm_mul_ps(r, r);
+  lengthSquared =
+      _mm_add_ps(lengthSquared, Swizzle(lengthSquared, 1, 0, 3, 2));
+  lengthSquared =
+      _mm_add_ps(lengthSquared, Swizzle(lengthSquared, 2, 3, 0, 1));
+  r = _mm_div_ps(r, _mm_sqrt_ps(lengthSquared));
+
+  Quaternion result;
+  _mm_storeu_ps(&result.x, r);
   return result;
+#else
+  return Scalar::Nlerp(q0, q1, t);
+#endif
 }
 
-Matrix4x4 MyMath::Math::Inverse(const Matrix4x4 &m) {
-  float determinant = +m.m[0][0] * m.m[1][1] * m.m[2][2] * m.m[3][3] +
-                      m.m[0][0] * m.m[1][2] * m.m[2][3] * m.m[3][1] +
-                      m.m[0][0] * m.m[1][3] * m.m[2][1] * m.m[3][2];
+Vector3 Math::RotateVector(const Vector3 &vector, const Quaternion &q) {
+  // v' = v + 2w(u×v) + 2u×(u×v)（uはqの虚部）
+  Vector3 u = {q.x, q.y, q.z};
+  Vector3 t = Cross(u, vector) * 2.0f;
+  return vector + t * q.w + Cross(u, t);
+}
 
-  assert(determinant != 0.0f);
+Matrix4x4 Math::MakeRotateMatrix(const Quaternion &q) {
+  return MakeAffineMatrixFromQuaternion({1.0f, 1.0f, 1.0f}, q,
+                                        {0.0f, 0.0f, 0.0f});
+}
 
-  Matrix4x4 result;
-  float recpDeterminant = 1.0f / determinant;
+Matrix4x4 Math::MakeAffineMatrixFromQuaternion(const Vector3 &scale,
+                                               const Quaternion &rotate,
+                                               const Vector3 &translate) {
+#if defined(MYMATH_USE_SSE2)
+  __m128 q = _mm_loadu_ps(&rotate.x);
+  __m128 q2 = _mm_add_ps(q, q);
+  const __m128 maskXYZ =
+      _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+
+  // 対角成分 (1-2(yy+zz), 1-2(xx+zz), 1-2(xx+yy), 0)
+  __m128 square = _mm_mul_ps(q, q2);
+  __m128 diagonal = _mm_sub_ps(
+      _mm_set1_ps(1.0f), _mm_add_ps(Swizzle(square, 1, 0, 0, 3),
+                                    Swizzle(square, 2, 2, 1, 3)));
+  diagonal = _mm_and_ps(diagonal, maskXYZ);
+  // (2xy, 2xz, 2yz) と (2wz, 2wy, 2wx) の和と差
+  // 4番目はどちらも2wwなので差は0になる
+  __m128 p1 = _mm_mul_ps(Swizzle(q, 0, 0, 1, 3), Swizzle(q2, 1, 2, 2, 3));
+  __m128 p2 = _mm_mul_ps(Swizzle(q, 3, 3, 3, 3), Swizzle(q2, 2, 1, 0, 3));
+  __m128 sum = _mm_and_ps(_mm_add_ps(p1, p2), maskXYZ);
+  __m128 difference = _mm_sub_ps(p1, p2);
+
+  // 行に並べ替える
+  //   0行目 (diagonal.x, sum.x, difference.y, 0)
+  //   1行目 (difference.x, diagonal.y, sum.z, 0)
+  //   2行目 (sum.y, difference.z, diagonal.z, 0)
+  __m128 row0 = _mm_shuffle_ps(
+      _mm_shuffle_ps(diagonal, sum, Shuffle(0, 0, 0, 0)), difference,
+      Shuffle(0, 2, 1, 3));
+  __m128 row1 = _mm_shuffle_ps(
+      _mm_shuffle_ps(difference, diagonal, Shuffle(0, 0, 1, 1)), sum,
+      Shuffle(0, 2, 2, 3));
+  __m128 row2 = _mm_shuffle_ps(_mm_shuffle_ps(sum, difference, Shuffle(1, 1, 2, 2)),
+                               diagonal, Shuffle(0, 2, 2, 3));
 
+  Matrix4x4 result;
+  _mm_storeu_ps(result.m[0], _mm_mul_ps(row0, _mm_set1_ps(scale.x)));
+  _mm_storeu_ps(result.m[1], _mm_mul_ps(row1, _mm_set1_ps(scale.y)));
+  _mm_storeu_ps(result.m[2], _mm_mul_ps(row2, _mm_set1_ps(scale.z)));
+  _mm_storeu_ps(result.m[3],
+                _mm_setr_ps(translate.x, translate.y, translate.z, 1.0f));
   return result;
+#else
+  return Scalar::MakeAffineMatrixFromQuaternion(scale, rotate, translate);
+#endif
+}
+
+const Quaternion &RotationCache::Get(const Vector3 &rotate) {
+  if (rotate != rotate_) {
+    rotate_ = rotate;
+    rotation_ = Math::MakeRotateQuaternion(rotate);
+  }
+  return rotation_;
 }
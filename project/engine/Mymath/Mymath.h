@@ -3,6 +3,18 @@
 #include <string>
 #include <vector>
 
+// SIMDの実装を使うかどうか（コンパイル時に決める）
+// MYMATH_NO_SIMDを定義すると常にスカラーの実装を使う
+#if !defined(MYMATH_NO_SIMD) &&                                                \
+    (defined(__SSE2__) || defined(_M_X64) ||                                   \
+     (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define MYMATH_USE_SSE2 1
+// AVX2/FMAは/arch:AVX2（-mavx2 -mfma）でビルドしたときだけ
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#define MYMATH_USE_AVX2 1
+#endif
+#endif
+
 namespace MyMath {
 
 struct Vector2 {
@@ -23,6 +35,14 @@ struct Vector4 {
   float w;
 };
 
+// 回転を表すクォータニオン（x,y,zが虚部、wが実部）
+struct Quaternion {
+  float x;
+  float y;
+  float z;
+  float w;
+};
+
 struct Matrix4x4 {
   float m[4][4];
 };
@@ -58,8 +78,72 @@ public:
                                           float bottom, float nearClip,
                                           float farClip);
 
-  // 逆行列
+  // 逆行列（一般の4x4）
   static Matrix4x4 Inverse(const Matrix4x4 &m);
+  // アフィン行列の逆行列（4列目が(0,0,0,1)であること）
+  static Matrix4x4 InverseAffine(const Matrix4x4 &m);
+  // 回転と平行移動だけの行列の逆行列（拡縮が入っていないこと）
+  static Matrix4x4 InverseRigid(const Matrix4x4 &m);
+
+  // ベクトルと行列の積（行ベクトル）
+  static Vector4 Transform(const Vector4 &vector, const Matrix4x4 &matrix);
+  // 座標変換（w=1として変換し、wで割る）
+  static Vector3 TransformCoord(const Vector3 &vector,
+                                const Matrix4x4 &matrix);
+
+  // クォータニオン
+  // 合成の順番は行列と同じ（Multiply(q1, q2)はq1で回してからq2で回す）
+  static Quaternion Multiply(const Quaternion &q1, const Quaternion &q2);
+  // 任意軸回転（axisは正規化済み）
+  static Quaternion MakeRotateAxisAngleQuaternion(const Vector3 &axis,
+                                                  float angle);
+  // オイラー角から（MakeAffineMatrixと同じX→Y→Zの順）
+  static Quaternion MakeRotateQuaternion(const Vector3 &rotate);
+  static Quaternion Normalize(const Quaternion &q);
+  // 球面線形補間。短い方の弧を通る
+  static Quaternion Slerp(const Quaternion &q0, const Quaternion &q1, float t);
+  // 線形補間して正規化（Slerpより速い近似）
+  static Quaternion Nlerp(const Quaternion &q0, const Quaternion &q1, float t);
+  // ベクトルを回転させる
+  static Vector3 RotateVector(const Vector3 &vector, const Quaternion &q);
+  // 回転行列（qは正規化済み）
+  static Matrix4x4 MakeRotateMatrix(const Quaternion &q);
+  // 回転をクォータニオンで渡すアフィン変換。三角関数を使わない
+  // 波括弧で渡したときに曖昧にならないよう名前を分けてある
+  static Matrix4x4 MakeAffineMatrixFromQuaternion(const Vector3 &scale,
+                                                  const Quaternion &rotate,
+                                                  const Vector3 &translate);
 };
 
+// オイラー角から作ったクォータニオンを覚えておき、
+// 角度が変わったときだけ作り直す（三角関数はそのときだけ）
+class RotationCache {
+public:
+  const Quaternion &Get(const Vector3 &rotate);
+
+private:
+  Vector3 rotate_ = {0.0f, 0.0f, 0.0f};
+  Quaternion rotation_ = {0.0f, 0.0f, 0.0f, 1.0f};
+};
+
+// スカラーの実装。SIMD版の答え合わせ用に残しておく
+namespace Scalar {
+Matrix4x4 Multiply(const Matrix4x4 &m1, const Matrix4x4 &m2);
+Matrix4x4 MakeAffineMatrix(const Vector3 &scale, const Vector3 &rotate,
+                           const Vector3 &translate);
+Matrix4x4 MakePerspectiveFovMatrix(float fovY, float aspectRatio,
+                                   float nearClip, float farClip);
+Matrix4x4 MakeOrthographicMatrix(float left, float top, float right,
+                                 float bottom, float nearClip, float farClip);
+Matrix4x4 Inverse(const Matrix4x4 &m);
+Matrix4x4 InverseAffine(const Matrix4x4 &m);
+Matrix4x4 InverseRigid(const Matrix4x4 &m);
+Vector4 Transform(const Vector4 &vector, const Matrix4x4 &matrix);
+Vector3 TransformCoord(const Vector3 &vector, const Matrix4x4 &matrix);
+Quaternion Nlerp(const Quaternion &q0, const Quaternion &q1, float t);
+Matrix4x4 MakeAffineMatrixFromQuaternion(const Vector3 &scale,
+                                         const Quaternion &rotate,
+                                         const Vector3 &translate);
+} // namespace Scalar
+
 } 
\ No newline at end of file
@@ -0,0 +1,53 @@
+﻿#include "Benchmark.h"
+#include "MathTestUtility.h"
+#include "Mymath.h"
+#include <cstdio>
+#include <vector>
+
+using namespace MyMath;
+
+// 逆行列3種類の1回あたりの時間（ns）。入力はどれでも使える回転+平行移動の行列
+namespace {
+const uint32_t kCount = 4096;
+const uint32_t kRepeatCount = 200;
+
+template <class Func> double MeasureNs(Func func) {
+  return Benchmark::MeasureBestMs(kRepeatCount, [&]() {
+           for (uint32_t i = 0; i < kCount; ++i) {
+             func(i);
+           }
+         }) *
+         1e6 / kCount;
+}
+} // namespace
+
+int main() {
+  MathTest::Random random;
+  std::vector<Matrix4x4> matrices(kCount), results(kCount);
+  for (Matrix4x4 &matrix : matrices) {
+    matrix = Math::MakeAffineMatrixFromQuaternion(
+        {1.0f, 1.0f, 1.0f}, random.Rotation(), random.Vector3(-100.0f, 100.0f));
+  }
+
+  std::printf("%-14s %10s %10s\n", "", "simd ns", "scalar ns");
+  double inverse = MeasureNs(
+      [&](uint32_t i) { results[i] = Math::Inverse(matrices[i]); });
+  double inverseScalar = MeasureNs(
+      [&](uint32_t i) { results[i] = Scalar::Inverse(matrices[i]); });
+  std::printf("%-14s %10.2f %10.2f\n", "Inverse", inverse, inverseScalar);
+
+  double affine = MeasureNs(
+      [&](uint32_t i) { results[i] = Math::InverseAffine(matrices[i]); });
+  double affineScalar = MeasureNs(
+      [&](uint32_t i) { results[i] = Scalar::InverseAffine(matrices[i]); });
+  std::printf("%-14s %10.2f %10.2f\n", "InverseAffine", affine, affineScalar);
+
+  double rigid = MeasureNs(
+      [&](uint32_t i) { results[i] = Math::InverseRigid(matrices[i]); });
+  double rigidScalar = MeasureNs(
+      [&](uint32_t i) { results[i] = Scalar::InverseRigid(matrices[i]); });
+  std::printf("%-14s %10.2f %10.2f\n", "InverseRigid", rigid, rigidScalar);
+
+  Benchmark::Consume(static_cast<uint64_t>(results[kCount - 1].m[3][0]));
+  return 0;
+}
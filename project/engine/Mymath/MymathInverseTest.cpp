@@ -0,0 +1,166 @@
+﻿#include "Check.h"
+#include "MathTestUtility.h"
+#include "Mymath.h"
+
+using namespace MyMath;
+
+// Inverse/InverseAffine/InverseRigidで、M・inv(M)が単位行列になるか
+namespace {
+const uint32_t kSampleCount = 10000;
+
+// doubleで求めた逆行列（掃き出し法、部分ピボット選択）
+Matrix4x4 InverseInDouble(const Matrix4x4 &m) {
+  double a[4][8];
+  for (int row = 0; row < 4; ++row) {
+    for (int column = 0; column < 4; ++column) {
+      a[row][column] = m.m[row][column];
+      a[row][column + 4] = row == column ? 1.0 : 0.0;
+    }
+  }
+  for (int column = 0; column < 4; ++column) {
+    int pivot = column;
+    for (int row = column + 1; row < 4; ++row) {
+      if (std::fabs(a[row][column]) > std::fabs(a[pivot][column])) {
+        pivot = row;
+      }
+    }
+    std::swap(a[column], a[pivot]);
+    double scale = 1.0 / a[column][column];
+    for (double &value : a[column]) {
+      value *= scale;
+    }
+    for (int row = 0; row < 4; ++row) {
+      if (row == column) {
+        continue;
+      }
+      double factor = a[row][column];
+      for (int k = 0; k < 8; ++k) {
+        a[row][k] -= factor * a[column][k];
+      }
+    }
+  }
+  Matrix4x4 result;
+  for (int row = 0; row < 4; ++row) {
+    for (int column = 0; column < 4; ++column) {
+      result.m[row][column] = static_cast<float>(a[row][column + 4]);
+    }
+  }
+  return result;
+}
+
+// 単位行列との差の最大
+float DifferenceFromIdentity(const Matrix4x4 &m) {
+  return MathTest::MaxDifference(m, Math::MakeIdentity4x4());
+}
+
+// 回転と平行移動だけの行列
+Matrix4x4 MakeRigid(MathTest::Random &random) {
+  return Math::MakeAffineMatrixFromQuaternion(
+      {1.0f, 1.0f, 1.0f}, random.Rotation(), random.Vector3(-100.0f, 100.0f));
+}
+
+// 拡縮も入ったアフィン行列（拡縮は極端にしない）
+Matrix4x4 MakeAffine(MathTest::Random &random) {
+  return Math::MakeAffineMatrixFromQuaternion(random.Vector3(0.1f, 10.0f),
+                                              random.Rotation(),
+                                              random.Vector3(-100.0f, 100.0f));
+}
+
+void TestInverse(MathTest::Random &random) {
+  float general = 0.0f;
+  float projection = 0.0f;
+  for (uint32_t i = 0; i < kSampleCount; ++i) {
+    // 対角を大きくして、逆行列が安定して求まる一般の行列にする
+    Matrix4x4 m = random.Matrix(-1.0f, 1.0f);
+    for (int j = 0; j < 4; ++j) {
+      m.m[j][j] += random.Range(0.0f, 1.0f) < 0.5f ? -4.0f : 4.0f;
+    }
+    general = (std::max)(
+        general, DifferenceFromIdentity(Math::Multiply(m, Math::Inverse(m))));
+
+    // ビュー射影行列（4列目が(0,0,0,1)でない）
+    // nearとfarの比が大きく条件が悪いので、M・inv(M)ではなく
+    // doubleで求めた逆行列と比べる
+    Matrix4x4 camera = Math::MakeAffineMatrixFromQuaternion(
+        {1.0f, 1.0f, 1.0f}, random.Rotation(), random.Vector3(-20.0f, 20.0f));
+    Matrix4x4 viewProjection = Math::Multiply(
+        Math::InverseRigid(camera),
+        Math::MakePerspectiveFovMatrix(random.Range(0.3f, 1.5f), 16.0f / 9.0f,
+                                       0.1f, 100.0f));
+    projection = (std::max)(projection, MathTest::NormwiseDifference(
+                                            Math::Inverse(viewProjection),
+                                            InverseInDouble(viewProjection)));
+  }
+  CHECK_NEAR(general, 0.0f, 1e-5f);
+  CHECK_NEAR(projection, 0.0f, 1e-4f);
+  std::printf("Inverse (general)       max difference %.3g\n", general);
+  std::printf("Inverse (projection)    max difference %.3g\n", projection);
+}
+
+void TestInverseAffine(MathTest::Random &random) {
+  float maxDifference = 0.0f;
+  float againstInverse = 0.0f;
+  for (uint32_t i = 0; i < kSampleCount; ++i) {
+    Matrix4x4 m = MakeAffine(random);
+    Matrix4x4 inverse = Math::InverseAffine(m);
+    maxDifference = (std::max)(
+        maxDifference, DifferenceFromIdentity(Math::Multiply(m, inverse)));
+    againstInverse = (std::max)(
+        againstInverse, MathTest::MaxDifference(inverse, Math::Inverse(m)));
+    // 4列目は(0,0,0,1)のまま
+    CHECK(inverse.m[0][3] == 0.0f && inverse.m[1][3] == 0.0f &&
+          inverse.m[2][3] == 0.0f && inverse.m[3][3] == 1.0f);
+  }
+  CHECK_NEAR(maxDifference, 0.0f, 1e-4f);
+  CHECK_NEAR(againstInverse, 0.0f, 1e-4f);
+  std::printf("InverseAffine           max difference %.3g (vs Inverse %.3g)\n",
+              maxDifference, againstInverse);
+}
+
+void TestInverseRigid(MathTest::Random &random) {
+  float maxDifference = 0.0f;
+  float againstInverse = 0.0f;
+  for (uint32_t i = 0; i < kSampleCount; ++i) {
+    Matrix4x4 m = MakeRigid(random);
+    Matrix4x4 inverse = Math::InverseRigid(m);
+    maxDifference = (std::max)(
+        maxDifference, DifferenceFromIdentity(Math::Multiply(m, inverse)));
+    againstInverse = (std::max)(
+        againstInverse, MathTest::MaxDifference(inverse, Math::Inverse(m)));
+  }
+  CHECK_NEAR(maxDifference, 0.0f, 1e-4f);
+  CHECK_NEAR(againstInverse, 0.0f, 1e-4f);
+  std::printf("InverseRigid            max difference %.3g (vs Inverse %.3g)\n",
+              maxDifference, againstInverse);
+}
+
+// SIMD版とスカラー版が同じ答えになるか
+void TestMatchesScalar(MathTest::Random &random) {
+  float general = 0.0f;
+  float affine = 0.0f;
+  float rigid = 0.0f;
+  for (uint32_t i = 0; i < kSampleCount; ++i) {
+    Matrix4x4 m = MakeAffine(random);
+    Matrix4x4 r = MakeRigid(random);
+    general = (std::max)(general, MathTest::MaxDifference(Math::Inverse(m),
+                                                          Scalar::Inverse(m)));
+    affine = (std::max)(affine, MathTest::MaxDifference(
+                                    Math::InverseAffine(m),
+                                    Scalar::InverseAffine(m)));
+    rigid = (std::max)(rigid, MathTest::MaxDifference(Math::InverseRigid(r),
+                                                      Scalar::InverseRigid(r)));
+  }
+  CHECK_NEAR(general, 0.0f, 1e-5f);
+  CHECK_NEAR(affine, 0.0f, 1e-5f);
+  CHECK_NEAR(rigid, 0.0f, 1e-5f);
+}
+} // namespace
+
+int main() {
+  MathTest::Random random;
+  TestInverse(random);
+  TestInverseAffine(random);
+  TestInverseRigid(random);
+  TestMatchesScalar(random);
+  return Test::Finish();
+}
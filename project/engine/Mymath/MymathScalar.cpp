@@ -0,0 +1,247 @@
+﻿#include "Mymath.h"
+#include <cassert>
+#include <cmath>
+
+namespace MyMath {
+namespace Scalar {
+
+Matrix4x4 Multiply(const Matrix4x4 &m1, const Matrix4x4 &m2) {
+  Matrix4x4 result{};
+
+  for (int i = 0; i < 4; ++i) {
+    for (int j = 0; j < 4; ++j) {
+      result.m[i][j] = m1.m[i][0] * m2.m[0][j] + m1.m[i][1] * m2.m[1][j] +
+                       m1.m[i][2] * m2.m[2][j] + m1.m[i][3] * m2.m[3][j];
+    }
+  }
+
+  return result;
+}
+
+Matrix4x4 MakeAffineMatrix(const Vector3 &scale, const Vector3 &rotate,
+                           const Vector3 &translate) {
+
+  Matrix4x4 rx = Math::MakeRotateXMatrix(rotate.x);
+  Matrix4x4 ry = Math::MakeRotateYMatrix(rotate.y);
+  Matrix4x4 rz = Math::MakeRotateZMatrix(rotate.z);
+
+  Matrix4x4 rot = Multiply(Multiply(rx, ry), rz);
+
+  rot.m[0][0] *= scale.x;
+  rot.m[0][1] *= scale.x;
+  rot.m[0][2] *= scale.x;
+
+  rot.m[1][0] *= scale.y;
+  rot.m[1][1] *= scale.y;
+  rot.m[1][2] *= scale.y;
+
+  rot.m[2][0] *= scale.z;
+  rot.m[2][1] *= scale.z;
+  rot.m[2][2] *= scale.z;
+
+  rot.m[3][0] = translate.x;
+  rot.m[3][1] = translate.y;
+  rot.m[3][2] = translate.z;
+  rot.m[3][3] = 1.0f;
+
+  return rot;
+}
+
+Matrix4x4 MakePerspectiveFovMatrix(float fovY, float aspectRatio,
+                                   float nearClip, float farClip) {
+
+  Matrix4x4 result{};
+
+  float cot = 1.0f / std::tan(fovY / 2.0f);
+
+  result.m[0][0] = cot / aspectRatio;
+  result.m[1][1] = cot;
+  result.m[2][2] = farClip / (farClip - nearClip);
+  result.m[2][3] = 1.0f;
+  result.m[3][2] = -(nearClip * farClip) / (farClip - nearClip);
+
+  return result;
+}
+
+Matrix4x4 MakeOrthographicMatrix(float left, float top, float right,
+                                 float bottom, float nearClip, float farClip) {
+
+  Matrix4x4 result{};
+
+  result.m[0][0] = 2.0f / (right - left);
+  result.m[1][1] = 2.0f / (top - bottom);
+  result.m[2][2] = 1.0f / (farClip - nearClip);
+
+  result.m[3][0] = (left + right) / (left - right);
+  result.m[3][1] = (top + bottom) / (bottom - top);
+  result.m[3][2] = nearClip / (nearClip - farClip);
+  result.m[3][3] = 1.0f;
+
+  return result;
+}
+
+Matrix4x4 Inverse(const Matrix4x4 &m) {
+  // 上2行と下2行から取った2x2小行列式
+  float s0 = m.m[0][0] * m.m[1][1] - m.m[1][0] * m.m[0][1];
+  float s1 = m.m[0][0] * m.m[1][2] - m.m[1][0] * m.m[0][2];
+  float s2 = m.m[0][0] * m.m[1][3] - m.m[1][0] * m.m[0][3];
+  float s3 = m.m[0][1] * m.m[1][2] - m.m[1][1] * m.m[0][2];
+  float s4 = m.m[0][1] * m.m[1][3] - m.m[1][1] * m.m[0][3];
+  float s5 = m.m[0][2] * m.m[1][3] - m.m[1][2] * m.m[0][3];
+
+  float c5 = m.m[2][2] * m.m[3][3] - m.m[3][2] * m.m[2][3];
+  float c4 = m.m[2][1] * m.m[3][3] - m.m[3][1] * m.m[2][3];
+  float c3 = m.m[2][1] * m.m[3][2] - m.m[3][1] * m.m[2][2];
+  float c2 = m.m[2][0] * m.m[3][3] - m.m[3][0] * m.m[2][3];
+  float c1 = m.m[2][0] * m.m[3][2] - m.m[3][0] * m.m[2][2];
+  float c0 = m.m[2][0] * m.m[3][1] - m.m[3][0] * m.m[2][1];
+
+  float determinant = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+  assert(determinant != 0.0f);
+  float recpDeterminant = 1.0f / determinant;
+
+  // 余因子行列の転置を行列式で割る
+  Matrix4x4 result;
+  result.m[0][0] = (m.m[1][1] * c5 - m.m[1][2] * c4 + m.m[1][3] * c3) * recpDeterminant;
+  result.m[0][1] = (-m.m[0][1] * c5 + m.m[0][2] * c4 - m.m[0][3] * c3) * recpDeterminant;
+  result.m[0][2] = (m.m[3][1] * s5 - m.m[3][2] * s4 + m.m[3][3] * s3) * recpDeterminant;
+  result.m[0][3] = (-m.m[2][1] * s5 + m.m[2][2] * s4 - m.m[2][3] * s3) * recpDeterminant;
+
+  result.m[1][0] = (-m.m[1][0] * c5 + m.m[1][2] * c2 - m.m[1][3] * c1) * recpDeterminant;
+  result.m[1][1] = (m.m[0][0] * c5 - m.m[0][2] * c2 + m.m[0][3] * c1) * recpDeterminant;
+  result.m[1][2] = (-m.m[3][0] * s5 + m.m[3][2] * s2 - m.m[3][3] * s1) * recpDeterminant;
+  result.m[1][3] = (m.m[2][0] * s5 - m.m[2][2] * s2 + m.m[2][3] * s1) * recpDeterminant;
+
+  result.m[2][0] = (m.m[1][0] * c4 - m.m[1][1] * c2 + m.m[1][3] * c0) * recpDeterminant;
+  result.m[2][1] = (-m.m[0][0] * c4 + m.m[0][1] * c2 - m.m[0][3] * c0) * recpDeterminant;
+  result.m[2][2] = (m.m[3][0] * s4 - m.m[3][1] * s2 + m.m[3][3] * s0) * recpDeterminant;
+  result.m[2][3] = (-m.m[2][0] * s4 + m.m[2][1] * s2 - m.m[2][3] * s0) * recpDeterminant;
+
+  result.m[3][0] = (-m.m[1][0] * c3 + m.m[1][1] * c1 - m.m[1][2] * c0) * recpDeterminant;
+  result.m[3][1] = (m.m[0][0] * c3 - m.m[0][1] * c1 + m.m[0][2] * c0) * recpDeterminant;
+  result.m[3][2] = (-m.m[3][0] * s3 + m.m[3][1] * s1 - m.m[3][2] * s0) * recpDeterminant;
+  result.m[3][3] = (m.m[2][0] * s3 - m.m[2][1] * s1 + m.m[2][2] * s0) * recpDeterminant;
+
+  return result;
+}
+
+Matrix4x4 InverseAffine(const Matrix4x4 &m) {
+  // 左上3x3の余因子（行どうしの外積）
+  float c00 = m.m[1][1] * m.m[2][2] - m.m[1][2] * m.m[2][1];
+  float c01 = m.m[1][2] * m.m[2][0] - m.m[1][0] * m.m[2][2];
+  float c02 = m.m[1][0] * m.m[2][1] - m.m[1][1] * m.m[2][0];
+  float c10 = m.m[2][1] * m.m[0][2] - m.m[2][2] * m.m[0][1];
+  float c11 = m.m[2][2] * m.m[0][0] - m.m[2][0] * m.m[0][2];
+  float c12 = m.m[2][0] * m.m[0][1] - m.m[2][1] * m.m[0][0];
+  float c20 = m.m[0][1] * m.m[1][2] - m.m[0][2] * m.m[1][1];
+  float c21 = m.m[0][2] * m.m[1][0] - m.m[0][0] * m.m[1][2];
+  float c22 = m.m[0][0] * m.m[1][1] - m.m[0][1] * m.m[1][0];
+
+  float determinant = m.m[0][0] * c00 + m.m[0][1] * c01 + m.m[0][2] * c02;
+  assert(determinant != 0.0f);
+  float recpDeterminant = 1.0f / determinant;
+
+  Matrix4x4 result;
+  result.m[0][0] = c00 * recpDeterminant;
+  result.m[0][1] = c10 * recpDeterminant;
+  result.m[0][2] = c20 * recpDeterminant;
+  result.m[0][3] = 0.0f;
+  result.m[1][0] = c01 * recpDeterminant;
+  result.m[1][1] = c11 * recpDeterminant;
+  result.m[1][2] = c21 * recpDeterminant;
+  result.m[1][3] = 0.0f;
+  result.m[2][0] = c02 * recpDeterminant;
+  result.m[2][1] = c12 * recpDeterminant;
+  result.m[2][2] = c22 * recpDeterminant;
+  result.m[2][3] = 0.0f;
+
+  // 平行移動は -t × (3x3の逆行列)
+  for (int j = 0; j < 3; ++j) {
+    result.m[3][j] = -(m.m[3][0] * result.m[0][j] + m.m[3][1] * result.m[1][j] +
+                       m.m[3][2] * result.m[2][j]);
+  }
+  result.m[3][3] = 1.0f;
+  return result;
+}
+
+Matrix4x4 InverseRigid(const Matrix4x4 &m) {
+  // 回転部分は転置するだけ
+  Matrix4x4 result;
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      result.m[i][j] = m.m[j][i];
+    }
+    result.m[i][3] = 0.0f;
+  }
+  for (int j = 0; j < 3; ++j) {
+    result.m[3][j] = -(m.m[3][0] * m.m[j][0] + m.m[3][1] * m.m[j][1] +
+                       m.m[3][2] * m.m[j][2]);
+  }
+  result.m[3][3] = 1.0f;
+  return result;
+}
+
+Vector4 Transform(const Vector4 &vector, const Matrix4x4 &matrix) {
+  Vector4 result;
+  result.x = vector.x * matrix.m[0][0] + vector.y * matrix.m[1][0] +
+             vector.z * matrix.m[2][0] + vector.w * matrix.m[3][0];
+  result.y = vector.x * matrix.m[0][1] + vector.y * matrix.m[1][1] +
+             vector.z * matrix.m[2][1] + vector.w * matrix.m[3][1];
+  result.z = vector.x * matrix.m[0][2] + vector.y * matrix.m[1][2] +
+             vector.z * matrix.m[2][2] + vector.w * matrix.m[3][2];
+  result.w = vector.x * matrix.m[0][3] + vector.y * matrix.m[1][3] +
+             vector.z * matrix.m[2][3] + vector.w * matrix.m[3][3];
+  return result;
+}
+
+Vector3 TransformCoord(const Vector3 &vector, const Matrix4x4 &matrix) {
+  Vector4 result = Transform({vector.x, vector.y, vector.z, 1.0f}, matrix);
+  return {result.x / result.w, result.y / result.w, result.z / result.w};
+}
+
+Quaternion Nlerp(const Quaternion &q0, const Quaternion &q1, float t) {
+  // 反対向きなら符号を反転して短い方の弧を通る
+  float sign = (q0.x * q1.x + q0.y * q1.y + q0.z * q1.z + q0.w * q1.w) < 0.0f
+                   ? -1.0f
+                   : 1.0f;
+  Quaternion result = {q0.x + (q1.x * sign - q0.x) * t,
+                       q0.y + (q1.y * sign - q0.y) * t,
+                       q0.z + (q1.z * sign - q0.z) * t,
+                       q0.w + (q1.w * sign - q0.w) * t};
+  float recpLength =
+      1.0f / std::sqrt(result.x * result.x + result.y * result.y +
+                       result.z * result.z + result.w * result.w);
+  result.x *= recpLength;
+  result.y *= recpLength;
+  result.z *= recpLength;
+  result.w *= recpLength;
+  return result;
+}
+
+Matrix4x4 MakeAffineMatrixFromQuaternion(const Vector3 &scale,
+                                         const Quaternion &rotate,
+                                         const Vector3 &translate) {
+  float x = rotate.x, y = rotate.y, z = rotate.z, w = rotate.w;
+
+  Matrix4x4 result;
+  result.m[0][0] = (1.0f - 2.0f * (y * y + z * z)) * scale.x;
+  result.m[0][1] = 2.0f * (x * y + w * z) * scale.x;
+  result.m[0][2] = 2.0f * (x * z - w * y) * scale.x;
+  result.m[0][3] = 0.0f;
+  result.m[1][0] = 2.0f * (x * y - w * z) * scale.y;
+  result.m[1][1] = (1.0f - 2.0f * (x * x + z * z)) * scale.y;
+  result.m[1][2] = 2.0f * (y * z + w * x) * scale.y;
+  result.m[1][3] = 0.0f;
+  result.m[2][0] = 2.0f * (x * z + w * y) * scale.z;
+  result.m[2][1] = 2.0f * (y * z - w * x) * scale.z;
+  result.m[2][2] = (1.0f - 2.0f * (x * x + y * y)) * scale.z;
+  result.m[2][3] = 0.0f;
+  result.m[3][0] = translate.x;
+  result.m[3][1] = translate.y;
+  result.m[3][2] = translate.z;
+  result.m[3][3] = 1.0f;
+  return result;
+}
+
+} // namespace Scalar
+} // namespace MyMath
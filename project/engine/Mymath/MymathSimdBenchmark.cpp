@@ -0,0 +1,109 @@
+﻿#include "Benchmark.h"
+#include "MathTestUtility.h"
+#include "Mymath.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace MyMath;
+
+// SIMD版（Math）とスカラー版（Scalar）の1回あたりの時間（ns）
+// スカラー版も同じフラグでビルドするので、コンパイラが自動でベクトル化した分は
+// スカラー版も速くなる（AVX2版で特に差が縮む）
+namespace {
+const uint32_t kCount = 4096;
+const uint32_t kRepeatCount = 200;
+
+// 結果を捨てられないように混ぜる
+uint64_t Fold(const void *data, size_t size) {
+  uint32_t value = 0;
+  std::memcpy(&value, data, sizeof(value) < size ? sizeof(value) : size);
+  return value;
+}
+
+template <class Func> double MeasureNs(Func func) {
+  return Benchmark::MeasureBestMs(kRepeatCount, [&]() {
+           for (uint32_t i = 0; i < kCount; ++i) {
+             func(i);
+           }
+         }) *
+         1e6 / kCount;
+}
+
+void Print(const char *name, double simdNs, double scalarNs) {
+  std::printf("%-26s %10.2f %10.2f %8.2fx\n", name, simdNs, scalarNs,
+              scalarNs / simdNs);
+}
+} // namespace
+
+int main() {
+#if defined(MYMATH_USE_AVX2)
+  const char *backend = "AVX2/FMA";
+#elif defined(MYMATH_USE_SSE2)
+  const char *backend = "SSE2";
+#else
+  const char *backend = "scalar";
+#endif
+  MathTest::Random random;
+  std::vector<Matrix4x4> a(kCount), b(kCount), results(kCount);
+  std::vector<Vector3> scales(kCount), rotates(kCount), translates(kCount),
+      coords(kCount);
+  std::vector<Vector4> vectors(kCount);
+  for (uint32_t i = 0; i < kCount; ++i) {
+    a[i] = random.Matrix(-10.0f, 10.0f);
+    b[i] = random.Matrix(-10.0f, 10.0f);
+    scales[i] = random.Vector3(0.1f, 10.0f);
+    rotates[i] = random.Vector3(-3.2f, 3.2f);
+    translates[i] = random.Vector3(-100.0f, 100.0f);
+    coords[i] = random.Vector3(-10.0f, 10.0f);
+    vectors[i] = random.Vector4(-10.0f, 10.0f);
+  }
+
+  std::printf("%-26s %10s %10s %9s\n", backend, "simd ns", "scalar ns",
+              "speedup");
+
+  Print("Multiply",
+        MeasureNs([&](uint32_t i) { results[i] = Math::Multiply(a[i], b[i]); }),
+        MeasureNs(
+            [&](uint32_t i) { results[i] = Scalar::Multiply(a[i], b[i]); }));
+  Benchmark::Consume(Fold(results.data(), sizeof(Matrix4x4)));
+
+  Print("MakeAffineMatrix", MeasureNs([&](uint32_t i) {
+          results[i] =
+              Math::MakeAffineMatrix(scales[i], rotates[i], translates[i]);
+        }),
+        MeasureNs([&](uint32_t i) {
+          results[i] =
+              Scalar::MakeAffineMatrix(scales[i], rotates[i], translates[i]);
+        }));
+  Benchmark::Consume(Fold(results.data(), sizeof(Matrix4x4)));
+
+  Print("MakePerspectiveFovMatrix", MeasureNs([&](uint32_t i) {
+          results[i] = Math::MakePerspectiveFovMatrix(
+              0.45f + scales[i].x * 0.1f, 1.7f, 0.1f, 100.0f);
+        }),
+        MeasureNs([&](uint32_t i) {
+          results[i] = Scalar::MakePerspectiveFovMatrix(
+              0.45f + scales[i].x * 0.1f, 1.7f, 0.1f, 100.0f);
+        }));
+  Benchmark::Consume(Fold(results.data(), sizeof(Matrix4x4)));
+
+  std::vector<Vector4> transformed(kCount);
+  Print("Transform", MeasureNs([&](uint32_t i) {
+          transformed[i] = Math::Transform(vectors[i], a[i]);
+        }),
+        MeasureNs([&](uint32_t i) {
+          transformed[i] = Scalar::Transform(vectors[i], a[i]);
+        }));
+  Benchmark::Consume(Fold(transformed.data(), sizeof(Vector4)));
+
+  std::vector<Vector3> transformedCoords(kCount);
+  Print("TransformCoord", MeasureNs([&](uint32_t i) {
+          transformedCoords[i] = Math::TransformCoord(coords[i], a[i]);
+        }),
+        MeasureNs([&](uint32_t i) {
+          transformedCoords[i] = Scalar::TransformCoord(coords[i], a[i]);
+        }));
+  Benchmark::Consume(Fold(transformedCoords.data(), sizeof(Vector3)));
+  return 0;
+}
@@ -0,0 +1,117 @@
+﻿#include "Check.h"
+#include "MathTestUtility.h"
+#include "Mymath.h"
+
+using namespace MyMath;
+
+// SIMD版（Math）とスカラー版（Scalar）が許容誤差内で一致するか
+// SSE2は同じ順で計算するのでほぼ一致する。AVX2/FMAは積和を丸めずに
+// 計算するので、1e-6程度の差が出る
+namespace {
+const uint32_t kSampleCount = 10000;
+const float kTolerance = 1e-5f;
+
+void TestMultiply(MathTest::Random &random) {
+  float maxDifference = 0.0f;
+  for (uint32_t i = 0; i < kSampleCount; ++i) {
+    Matrix4x4 a = random.Matrix(-10.0f, 10.0f);
+    Matrix4x4 b = random.Matrix(-10.0f, 10.0f);
+    maxDifference = (std::max)(
+        maxDifference,
+        MathTest::MaxDifference(Math::Multiply(a, b), Scalar::Multiply(a, b)));
+  }
+  CHECK_NEAR(maxDifference, 0.0f, kTolerance);
+  std::printf("Multiply                 max difference %.3g\n", maxDifference);
+}
+
+void TestMakeMatrices(MathTest::Random &random) {
+  float affine = 0.0f;
+  float perspective = 0.0f;
+  float orthographic = 0.0f;
+  for (uint32_t i = 0; i < kSampleCount; ++i) {
+    Vector3 scale = random.Vector3(0.1f, 10.0f);
+    Vector3 rotate = random.Vector3(-6.3f, 6.3f);
+    Vector3 translate = random.Vector3(-100.0f, 100.0f);
+    affine = (std::max)(
+        affine,
+        MathTest::MaxDifference(Math::MakeAffineMatrix(scale, rotate, translate),
+                                Scalar::MakeAffineMatrix(scale, rotate,
+                                                         translate)));
+
+    float fovY = random.Range(0.2f, 2.5f);
+    float aspectRatio = random.Range(0.5f, 2.5f);
+    float nearClip = random.Range(0.01f, 1.0f);
+    float farClip = nearClip + random.Range(10.0f, 1000.0f);
+    perspective = (std::max)(
+        perspective,
+        MathTest::MaxDifference(
+            Math::MakePerspectiveFovMatrix(fovY, aspectRatio, nearClip,
+                                           farClip),
+            Scalar::MakePerspectiveFovMatrix(fovY, aspectRatio, nearClip,
+                                             farClip)));
+
+    float left = random.Range(-100.0f, 0.0f);
+    float top = random.Range(0.0f, 100.0f);
+    float right = left + random.Range(1.0f, 1280.0f);
+    float bottom = top + random.Range(1.0f, 720.0f);
+    orthographic = (std::max)(
+        orthographic,
+        MathTest::MaxDifference(
+            Math::MakeOrthographicMatrix(left, top, right, bottom, 0.0f,
+                                         100.0f),
+            Scalar::MakeOrthographicMatrix(left, top, right, bottom, 0.0f,
+                                           100.0f)));
+  }
+  CHECK_NEAR(affine, 0.0f, kTolerance);
+  CHECK_NEAR(perspective, 0.0f, kTolerance);
+  CHECK_NEAR(orthographic, 0.0f, kTolerance);
+  std::printf("MakeAffineMatrix         max difference %.3g\n", affine);
+  std::printf("MakePerspectiveFovMatrix max difference %.3g\n", perspective);
+  std::printf("MakeOrthographicMatrix   max difference %.3g\n", orthographic);
+}
+
+void TestTransform(MathTest::Random &random) {
+  float transform = 0.0f;
+  float transformCoord = 0.0f;
+  for (uint32_t i = 0; i < kSampleCount; ++i) {
+    Matrix4x4 matrix = Math::MakeAffineMatrix(random.Vector3(0.1f, 10.0f),
+                                              random.Vector3(-3.2f, 3.2f),
+                                              random.Vector3(-100.0f, 100.0f));
+    Vector4 vector = random.Vector4(-100.0f, 100.0f);
+    transform = (std::max)(
+        transform, MathTest::MaxDifference(Math::Transform(vector, matrix),
+                                           Scalar::Transform(vector, matrix)));
+
+    // 射影込みの行列でwで割る
+    Matrix4x4 viewProjection = Math::Multiply(
+        matrix, Math::MakePerspectiveFovMatrix(0.45f, 16.0f / 9.0f, 0.1f,
+                                               100.0f));
+    Vector3 coord = random.Vector3(-10.0f, 10.0f);
+    Vector3 a = Math::TransformCoord(coord, viewProjection);
+    Vector3 b = Scalar::TransformCoord(coord, viewProjection);
+    // wが0に近いと誤差が増えるので、画面に入る範囲だけ比べる
+    if (std::fabs(b.x) < 10.0f && std::fabs(b.y) < 10.0f) {
+      transformCoord = (std::max)(transformCoord, MathTest::MaxDifference(a, b));
+    }
+  }
+  CHECK_NEAR(transform, 0.0f, kTolerance);
+  CHECK_NEAR(transformCoord, 0.0f, kTolerance);
+  std::printf("Transform                max difference %.3g\n", transform);
+  std::printf("TransformCoord           max difference %.3g\n", transformCoord);
+}
+} // namespace
+
+int main() {
+#if defined(MYMATH_USE_AVX2)
+  std::printf("backend: AVX2/FMA\n");
+#elif defined(MYMATH_USE_SSE2)
+  std::printf("backend: SSE2\n");
+#else
+  std::printf("backend: scalar\n");
+#endif
+  MathTest::Random random;
+  TestMultiply(random);
+  TestMakeMatrices(random);
+  TestTransform(random);
+  return Test::Finish();
+}
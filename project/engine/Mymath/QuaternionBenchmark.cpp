@@ -0,0 +1,64 @@
+﻿#include "Benchmark.h"
+#include "MathTestUtility.h"
+#include "Mymath.h"
+#include <cstdio>
+#include <vector>
+
+using namespace MyMath;
+
+// ワールド行列を毎フレーム作るときの1回あたりの時間（ns）
+// ・オイラー角：MakeAffineMatrix（三角関数6回）
+// ・クォータニオン：MakeAffineMatrixFromQuaternion（三角関数なし）
+// ・角度から毎回作る：MakeRotateQuaternion + MakeAffineMatrixFromQuaternion
+// ・角度をRotationCacheで覚える（角度が変わらないフレーム）
+namespace {
+const uint32_t kCount = 4096;
+const uint32_t kRepeatCount = 200;
+
+template <class Func> double MeasureNs(Func func) {
+  return Benchmark::MeasureBestMs(kRepeatCount, [&]() {
+           for (uint32_t i = 0; i < kCount; ++i) {
+             func(i);
+           }
+         }) *
+         1e6 / kCount;
+}
+} // namespace
+
+int main() {
+  MathTest::Random random;
+  std::vector<Vector3> scales(kCount), rotates(kCount), translates(kCount);
+  std::vector<Quaternion> rotations(kCount);
+  std::vector<RotationCache> caches(kCount);
+  for (uint32_t i = 0; i < kCount; ++i) {
+    scales[i] = random.Vector3(0.5f, 2.0f);
+    rotates[i] = random.Vector3(-3.2f, 3.2f);
+    translates[i] = random.Vector3(-100.0f, 100.0f);
+    rotations[i] = Math::MakeRotateQuaternion(rotates[i]);
+    caches[i].Get(rotates[i]);
+  }
+  std::vector<Matrix4x4> results(kCount);
+
+  double euler = MeasureNs([&](uint32_t i) {
+    results[i] = Math::MakeAffineMatrix(scales[i], rotates[i], translates[i]);
+  });
+  double quaternion = MeasureNs([&](uint32_t i) {
+    results[i] = Math::MakeAffineMatrixFromQuaternion(scales[i], rotations[i],
+                                                      translates[i]);
+  });
+  double fromAngles = MeasureNs([&](uint32_t i) {
+    results[i] = Math::MakeAffineMatrixFromQuaternion(
+        scales[i], Math::MakeRotateQuaternion(rotates[i]), translates[i]);
+  });
+  double cached = MeasureNs([&](uint32_t i) {
+    results[i] = Math::MakeAffineMatrixFromQuaternion(
+        scales[i], caches[i].Get(rotates[i]), translates[i]);
+  });
+  Benchmark::Consume(static_cast<uint64_t>(results[0].m[3][0]));
+
+  std::printf("MakeAffineMatrix (euler)            : %8.2f ns\n", euler);
+  std::printf("FromQuaternion                      : %8.2f ns\n", quaternion);
+  std::printf("MakeRotateQuaternion+FromQuaternion : %8.2f ns\n", fromAngles);
+  std::printf("RotationCache+FromQuaternion        : %8.2f ns\n", cached);
+  return 0;
+}
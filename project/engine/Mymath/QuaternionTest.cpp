@@ -0,0 +1,129 @@
+﻿#include "Check.h"
+#include "MathTestUtility.h"
+#include "Mymath.h"
+
+using namespace MyMath;
+
+// クォータニオンで回転を渡すアフィン変換が、オイラー角の経路と一致するか
+namespace {
+const uint32_t kSampleCount = 10000;
+
+void TestMatchesEulerPath(MathTest::Random &random) {
+  float maxDifference = 0.0f;
+  for (uint32_t i = 0; i < kSampleCount; ++i) {
+    Vector3 scale = random.Vector3(0.1f, 10.0f);
+    Vector3 rotate = random.Vector3(-6.3f, 6.3f);
+    Vector3 translate = random.Vector3(-100.0f, 100.0f);
+    Matrix4x4 euler = Math::MakeAffineMatrix(scale, rotate, translate);
+    Matrix4x4 quaternion = Math::MakeAffineMatrixFromQuaternion(
+        scale, Math::MakeRotateQuaternion(rotate), translate);
+    maxDifference = (std::max)(maxDifference,
+                               MathTest::NormwiseDifference(quaternion, euler));
+  }
+  CHECK_NEAR(maxDifference, 0.0f, 1e-5f);
+  std::printf("quaternion vs euler      max difference %.3g\n", maxDifference);
+}
+
+void TestMatchesScalar(MathTest::Random &random) {
+  float affine = 0.0f;
+  float nlerp = 0.0f;
+  for (uint32_t i = 0; i < kSampleCount; ++i) {
+    Vector3 scale = random.Vector3(0.1f, 10.0f);
+    Quaternion rotate = random.Rotation();
+    Vector3 translate = random.Vector3(-100.0f, 100.0f);
+    affine = (std::max)(
+        affine, MathTest::MaxDifference(
+                    Math::MakeAffineMatrixFromQuaternion(scale, rotate,
+                                                         translate),
+                    Scalar::MakeAffineMatrixFromQuaternion(scale, rotate,
+                                                           translate)));
+    Quaternion q1 = random.Rotation();
+    float t = random.Range(0.0f, 1.0f);
+    Quaternion a = Math::Nlerp(rotate, q1, t);
+    Quaternion b = Scalar::Nlerp(rotate, q1, t);
+    nlerp = (std::max)(nlerp,
+                       MathTest::MaxDifference(Vector4{a.x, a.y, a.z, a.w},
+                                               Vector4{b.x, b.y, b.z, b.w}));
+  }
+  CHECK_NEAR(affine, 0.0f, 1e-5f);
+  CHECK_NEAR(nlerp, 0.0f, 1e-5f);
+}
+
+// 合成の順番は行列と同じ（q1で回してからq2で回す）
+void TestMultiplyOrder(MathTest::Random &random) {
+  float maxDifference = 0.0f;
+  for (uint32_t i = 0; i < kSampleCount; ++i) {
+    Quaternion q1 = random.Rotation();
+    Quaternion q2 = random.Rotation();
+    Matrix4x4 expected =
+        Math::Multiply(Math::MakeRotateMatrix(q1), Math::MakeRotateMatrix(q2));
+    Matrix4x4 actual = Math::MakeRotateMatrix(Math::Multiply(q1, q2));
+    maxDifference =
+        (std::max)(maxDifference, MathTest::MaxDifference(actual, expected));
+
+    // RotateVectorは行列で変換したのと同じ
+    Vector3 vector = random.Vector3(-10.0f, 10.0f);
+    Vector3 rotated = Math::RotateVector(vector, q1);
+    Vector3 transformed =
+        Math::TransformCoord(vector, Math::MakeRotateMatrix(q1));
+    CHECK_NEAR(MathTest::MaxDifference(rotated, transformed), 0.0f, 1e-5f);
+  }
+  CHECK_NEAR(maxDifference, 0.0f, 1e-5f);
+}
+
+void TestInterpolation(MathTest::Random &random) {
+  for (uint32_t i = 0; i < 1000; ++i) {
+    Quaternion q0 = random.Rotation();
+    Quaternion q1 = random.Rotation();
+    // 端点はそのまま（符号を反転した同じ回転でもよい）
+    Matrix4x4 start = Math::MakeRotateMatrix(Math::Slerp(q0, q1, 0.0f));
+    Matrix4x4 end = Math::MakeRotateMatrix(Math::Slerp(q0, q1, 1.0f));
+    CHECK_NEAR(MathTest::MaxDifference(start, Math::MakeRotateMatrix(q0)),
+               0.0f, 1e-5f);
+    CHECK_NEAR(MathTest::MaxDifference(end, Math::MakeRotateMatrix(q1)), 0.0f,
+               1e-5f);
+    // 途中も正規化されている
+    Quaternion middle = Math::Slerp(q0, q1, 0.5f);
+    float length = std::sqrt(middle.x * middle.x + middle.y * middle.y +
+                             middle.z * middle.z + middle.w * middle.w);
+    CHECK_NEAR(length, 1.0f, 1e-5f);
+    Quaternion approximate = Math::Nlerp(q0, q1, 0.5f);
+    // t=0.5ならNlerpとSlerpは同じ回転
+    CHECK_NEAR(MathTest::MaxDifference(Math::MakeRotateMatrix(approximate),
+                                       Math::MakeRotateMatrix(middle)),
+               0.0f, 1e-5f);
+  }
+}
+
+// 角度が変わったときだけ作り直す
+void TestRotationCache() {
+  RotationCache cache;
+  Vector3 rotate = {0.3f, -1.2f, 2.5f};
+  Quaternion expected = Math::MakeRotateQuaternion(rotate);
+  const Quaternion &first = cache.Get(rotate);
+  CHECK(first.x == expected.x && first.y == expected.y &&
+        first.z == expected.z && first.w == expected.w);
+  // 同じ角度ならそのまま
+  const Quaternion &second = cache.Get(rotate);
+  CHECK(&second == &first && second.w == expected.w);
+  // 変われば作り直す
+  Vector3 changed = {0.3f, -1.2f, 2.6f};
+  Quaternion expectedChanged = Math::MakeRotateQuaternion(changed);
+  const Quaternion &third = cache.Get(changed);
+  CHECK(third.x == expectedChanged.x && third.w == expectedChanged.w);
+  // 0回転は単位クォータニオン
+  RotationCache identity;
+  const Quaternion &zero = identity.Get({0.0f, 0.0f, 0.0f});
+  CHECK(zero.x == 0.0f && zero.y == 0.0f && zero.z == 0.0f && zero.w == 1.0f);
+}
+} // namespace
+
+int main() {
+  MathTest::Random random;
+  TestMatchesEulerPath(random);
+  TestMatchesScalar(random);
+  TestMultiplyOrder(random);
+  TestInterpolation(random);
+  TestRotationCache();
+  return Test::Finish();
+}
@@ -0,0 +1,151 @@
+﻿#include "TransformBatch.h"
+#include "FastMath.h"
+#include <cmath>
+#if defined(MYMATH_USE_SSE2)
+#include <emmintrin.h>
+#endif
+
+using namespace MyMath;
+
+void TransformBatch::Clear() { count = 0; }
+
+uint32_t TransformBatch::Add(const Vector2 &position, float rotation,
+                             const Vector2 &scale, const Vector2 &anchor) {
+  // 4件ごとにまとめて伸ばす。余りのレーンは0のまま計算して捨てる
+  if (count % kLaneCount == 0 && count == positionX.size()) {
+    size_t size = count + kLaneCount;
+    positionX.resize(size);
+    positionY.resize(size);
+    rotations.resize(size);
+    scaleX.resize(size);
+    scaleY.resize(size);
+    anchorX.resize(size);
+    anchorY.resize(size);
+    matrices.resize(size);
+  }
+
+  positionX[count] = position.x;
+  positionY[count] = position.y;
+  rotations[count] = rotation;
+  scaleX[count] = scale.x;
+  scaleY[count] = scale.y;
+  anchorX[count] = anchor.x;
+  anchorY[count] = anchor.y;
+  return static_cast<uint32_t>(count++);
+}
+
+Matrix4x4 TransformBatch::MakeWorldMatrix(const Vector2 &position,
+                                          float rotation, const Vector2 &scale,
+                                          const Vector2 &anchor) {
+  float c, s;
+  TransformSinCos(rotation, &s, &c);
+
+  Matrix4x4 result{};
+  result.m[0][0] = scale.x * c;
+  result.m[0][1] = scale.x * s;
+  result.m[1][0] = -scale.y * s;
+  result.m[1][1] = scale.y * c;
+  result.m[2][2] = 1.0f;
+  // アンカー分ずらしてから拡縮・回転・移動する
+  result.m[3][0] =
+      position.x - anchor.x * result.m[0][0] - anchor.y * result.m[1][0];
+  result.m[3][1] =
+      position.y - anchor.x * result.m[0][1] - anchor.y * result.m[1][1];
+  result.m[3][3] = 1.0f;
+  return result;
+}
+
+void TransformBatch::Compute(const Matrix4x4 &viewProjection) {
+#if defined(MYMATH_USE_SSE2)
+  // ワールド行列の0,1行目と4行目の2要素以外は全件で同じなので、
+  // WVPはviewProjectionの各行を重み付けして足すだけで求まる
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 row2 = _mm_setr_ps(0.0f, 0.0f, 1.0f, 0.0f);
+  const __m128 vpRow2 = _mm_loadu_ps(viewProjection.m[2]);
+
+  for (size_t i = 0; i < count; i += kLaneCount) {
+#if defined(MYMATH_FAST_TRIG)
+    // 近似版なら4件まとめて求める
+    __m128 s, c;
+    FastMath::SinCos4(_mm_loadu_ps(&rotations[i]), &s, &c);
+#else
+    alignas(16) float cosines[kLaneCount];
+    alignas(16) float sines[kLaneCount];
+    for (size_t lane = 0; lane < kLaneCount; ++lane) {
+      cosines[lane] = std::cos(rotations[i + lane]);
+      sines[lane] = std::sin(rotations[i + lane]);
+    }
+    __m128 c = _mm_load_ps(cosines);
+    __m128 s = _mm_load_ps(sines);
+#endif
+    __m128 sx = _mm_loadu_ps(&scaleX[i]);
+    __m128 sy = _mm_loadu_ps(&scaleY[i]);
+    __m128 ax = _mm_loadu_ps(&anchorX[i]);
+    __m128 ay = _mm_loadu_ps(&anchorY[i]);
+
+    // 4件分のワールド行列の要素（レーンが1件）
+    __m128 w00 = _mm_mul_ps(sx, c);
+    __m128 w01 = _mm_mul_ps(sx, s);
+    __m128 w10 = _mm_sub_ps(zero, _mm_mul_ps(sy, s));
+    __m128 w11 = _mm_mul_ps(sy, c);
+    __m128 w30 = _mm_sub_ps(
+        _mm_loadu_ps(&positionX[i]),
+        _mm_add_ps(_mm_mul_ps(ax, w00), _mm_mul_ps(ay, w10)));
+    __m128 w31 = _mm_sub_ps(
+        _mm_loadu_ps(&positionY[i]),
+        _mm_add_ps(_mm_mul_ps(ax, w01), _mm_mul_ps(ay, w11)));
+
+    Matrices *out = &matrices[i];
+
+    // World。要素ごとの並びを1件ごとの行に並べ替えて書く
+    __m128 r0 = w00, r1 = w01, r2 = zero, r3 = zero;
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    _mm_storeu_ps(out[0].World.m[0], r0);
+    _mm_storeu_ps(out[1].World.m[0], r1);
+    _mm_storeu_ps(out[2].World.m[0], r2);
+    _mm_storeu_ps(out[3].World.m[0], r3);
+    r0 = w10, r1 = w11, r2 = zero, r3 = zero;
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    _mm_storeu_ps(out[0].World.m[1], r0);
+    _mm_storeu_ps(out[1].World.m[1], r1);
+    _mm_storeu_ps(out[2].World.m[1], r2);
+    _mm_storeu_ps(out[3].World.m[1], r3);
+    r0 = w30, r1 = w31, r2 = zero, r3 = _mm_set1_ps(1.0f);
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    _mm_storeu_ps(out[0].World.m[3], r0);
+    _mm_storeu_ps(out[1].World.m[3], r1);
+    _mm_storeu_ps(out[2].World.m[3], r2);
+    _mm_storeu_ps(out[3].World.m[3], r3);
+
+    // WVPの0,1行目 = w?0 * vp[0] + w?1 * vp[1]、3行目はさらに + vp[3]
+    __m128 wvp0[4], wvp1[4], wvp3[4];
+    for (int j = 0; j < 4; ++j) {
+      __m128 vp0 = _mm_set1_ps(viewProjection.m[0][j]);
+      __m128 vp1 = _mm_set1_ps(viewProjection.m[1][j]);
+      wvp0[j] = _mm_add_ps(_mm_mul_ps(w00, vp0), _mm_mul_ps(w01, vp1));
+      wvp1[j] = _mm_add_ps(_mm_mul_ps(w10, vp0), _mm_mul_ps(w11, vp1));
+      wvp3[j] = _mm_add_ps(
+          _mm_add_ps(_mm_mul_ps(w30, vp0), _mm_mul_ps(w31, vp1)),
+          _mm_set1_ps(viewProjection.m[3][j]));
+    }
+    _MM_TRANSPOSE4_PS(wvp0[0], wvp0[1], wvp0[2], wvp0[3]);
+    _MM_TRANSPOSE4_PS(wvp1[0], wvp1[1], wvp1[2], wvp1[3]);
+    _MM_TRANSPOSE4_PS(wvp3[0], wvp3[1], wvp3[2], wvp3[3]);
+    for (size_t lane = 0; lane < kLaneCount; ++lane) {
+      _mm_storeu_ps(out[lane].World.m[2], row2);
+      _mm_storeu_ps(out[lane].WVP.m[0], wvp0[lane]);
+      _mm_storeu_ps(out[lane].WVP.m[1], wvp1[lane]);
+      _mm_storeu_ps(out[lane].WVP.m[2], vpRow2);
+      _mm_storeu_ps(out[lane].WVP.m[3], wvp3[lane]);
+    }
+  }
+#else
+  for (size_t i = 0; i < count; ++i) {
+    Matrices &out = matrices[i];
+    out.World =
+        MakeWorldMatrix({positionX[i], positionY[i]}, rotations[i],
+                        {scaleX[i], scaleY[i]}, {anchorX[i], anchorY[i]});
+    out.WVP = Math::Multiply(out.World, viewProjection);
+  }
+#endif
+}
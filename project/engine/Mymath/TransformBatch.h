@@ -0,0 +1,55 @@
+﻿#pragma once
+#include "Mymath.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace MyMath {
+
+// XY平面上の変換（移動・Z軸回転・拡縮・アンカー）をまとめて行列にする
+// 入力は要素ごとの配列（SoA）で持ち、SIMDで4件ずつ計算する
+class TransformBatch {
+public:
+  // 1件分の出力（スプライトの定数バッファと同じ並び）
+  struct Matrices {
+    Matrix4x4 WVP;
+    Matrix4x4 World;
+  };
+
+  // 積んだ入力を空にする（確保した領域は残す）
+  void Clear();
+
+  // 1件追加して番号を返す。anchorは拡縮前の単位矩形上の原点
+  uint32_t Add(const Vector2 &position, float rotation, const Vector2 &scale,
+               const Vector2 &anchor);
+
+  // 積んだ全件のWorldとWVPを計算する。viewProjectionは全件で共通
+  void Compute(const Matrix4x4 &viewProjection);
+
+  size_t GetCount() const { return count; }
+  // Computeの結果。番号はAddの戻り値
+  const Matrices &GetMatrices(uint32_t index) const { return matrices[index]; }
+  const Matrices *GetMatrices() const { return matrices.data(); }
+
+  // 1件分のワールド行列（T(-anchor) * S * Rz * T(position)）
+  static Matrix4x4 MakeWorldMatrix(const Vector2 &position, float rotation,
+                                   const Vector2 &scale, const Vector2 &anchor);
+
+private:
+  // SIMDの幅。配列はこの倍数の長さで持つ
+  static const size_t kLaneCount = 4;
+
+  size_t count = 0;
+
+  std::vector<float> positionX;
+  std::vector<float> positionY;
+  std::vector<float> rotations;
+  std::vector<float> scaleX;
+  std::vector<float> scaleY;
+  std::vector<float> anchorX;
+  std::vector<float> anchorY;
+
+  std::vector<Matrices> matrices;
+};
+
+} // namespace MyMath
@@ -0,0 +1,72 @@
+﻿#include "Benchmark.h"
+#include "MathTestUtility.h"
+#include "TransformBatch.h"
+#include <cstdio>
+#include <vector>
+
+using namespace MyMath;
+
+// 100k件のスプライトの行列を求める時間
+// 以前のSprite::Updateは1枚ごとにMakeAffineMatrix・単位行列のビュー・
+// MakeOrthographicMatrixを作り、Multiplyを2回していた
+int main() {
+  const uint32_t kSpriteCount = 100000;
+  const uint32_t kRepeatCount = 20;
+
+  MathTest::Random random;
+  std::vector<Vector2> positions(kSpriteCount), scales(kSpriteCount),
+      anchors(kSpriteCount);
+  std::vector<float> rotations(kSpriteCount);
+  for (uint32_t i = 0; i < kSpriteCount; ++i) {
+    positions[i] = {random.Range(0.0f, 1280.0f), random.Range(0.0f, 720.0f)};
+    rotations[i] = random.Range(-3.2f, 3.2f);
+    scales[i] = {random.Range(16.0f, 256.0f), random.Range(16.0f, 256.0f)};
+    anchors[i] = {0.5f, 0.5f};
+  }
+
+  std::vector<TransformBatch::Matrices> results(kSpriteCount);
+  double perSpriteMs = Benchmark::MeasureBestMs(kRepeatCount, [&]() {
+    for (uint32_t i = 0; i < kSpriteCount; ++i) {
+      Matrix4x4 worldMatrix = Math::MakeAffineMatrix(
+          {scales[i].x, scales[i].y, 1.0f}, {0.0f, 0.0f, rotations[i]},
+          {positions[i].x, positions[i].y, 0.0f});
+      Matrix4x4 viewMatrix = Math::MakeIdentity4x4();
+      Matrix4x4 projectionMatrix = Math::MakeOrthographicMatrix(
+          0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 100.0f);
+      results[i].WVP = Math::Multiply(
+          worldMatrix, Math::Multiply(viewMatrix, projectionMatrix));
+      results[i].World = worldMatrix;
+    }
+  });
+  Benchmark::Consume(static_cast<uint64_t>(results[0].WVP.m[3][0] * 1000.0f));
+
+  // 今のSprite::Updateと同じ、1枚ずつMakeWorldMatrixとMultiply
+  Matrix4x4 viewProjection =
+      Math::MakeOrthographicMatrix(0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 100.0f);
+  double worldMatrixMs = Benchmark::MeasureBestMs(kRepeatCount, [&]() {
+    for (uint32_t i = 0; i < kSpriteCount; ++i) {
+      results[i].World = TransformBatch::MakeWorldMatrix(
+          positions[i], rotations[i], scales[i], anchors[i]);
+      results[i].WVP = Math::Multiply(results[i].World, viewProjection);
+    }
+  });
+  Benchmark::Consume(static_cast<uint64_t>(results[0].WVP.m[3][0] * 1000.0f));
+
+  // まとめて（Sprite::UpdateAllと同じく毎回積み直す）
+  TransformBatch batch;
+  double batchMs = Benchmark::MeasureBestMs(kRepeatCount, [&]() {
+    batch.Clear();
+    for (uint32_t i = 0; i < kSpriteCount; ++i) {
+      batch.Add(positions[i], rotations[i], scales[i], anchors[i]);
+    }
+    batch.Compute(viewProjection);
+  });
+  Benchmark::Consume(
+      static_cast<uint64_t>(batch.GetMatrices(0).WVP.m[3][0] * 1000.0f));
+
+  std::printf("%u transforms\n", kSpriteCount);
+  std::printf("per-sprite (old Update)  : %8.3f ms\n", perSpriteMs);
+  std::printf("per-sprite (world+mul)   : %8.3f ms\n", worldMatrixMs);
+  std::printf("TransformBatch           : %8.3f ms\n", batchMs);
+  return 0;
+}
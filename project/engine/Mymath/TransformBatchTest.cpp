@@ -0,0 +1,108 @@
+﻿#include "Check.h"
+#include "MathTestUtility.h"
+#include "TransformBatch.h"
+
+using namespace MyMath;
+
+// Computeの結果（SSE2なら4件ずつ転置して書く経路）が、
+// 1件ずつMakeWorldMatrixとスカラーのMultiplyで求めたものと一致するか
+namespace {
+const Matrix4x4 kViewProjection =
+    Math::MakeOrthographicMatrix(0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 100.0f);
+
+struct Input {
+  Vector2 position;
+  float rotation;
+  Vector2 scale;
+  Vector2 anchor;
+};
+
+Input MakeInput(MathTest::Random &random) {
+  Input input;
+  input.position = {random.Range(0.0f, 1280.0f), random.Range(0.0f, 720.0f)};
+  input.rotation = random.Range(-6.3f, 6.3f);
+  // 反転（負の拡縮）も混ぜる
+  input.scale = {random.Range(-512.0f, 512.0f), random.Range(-512.0f, 512.0f)};
+  input.anchor = {random.Range(0.0f, 1.0f), random.Range(0.0f, 1.0f)};
+  return input;
+}
+
+void CheckBatch(TransformBatch &batch, const std::vector<Input> &inputs) {
+  batch.Clear();
+  for (uint32_t i = 0; i < inputs.size(); ++i) {
+    const Input &input = inputs[i];
+    CHECK(batch.Add(input.position, input.rotation, input.scale,
+                    input.anchor) == i);
+  }
+  CHECK(batch.GetCount() == inputs.size());
+  batch.Compute(kViewProjection);
+
+  float world = 0.0f;
+  float wvp = 0.0f;
+  for (uint32_t i = 0; i < inputs.size(); ++i) {
+    const Input &input = inputs[i];
+    Matrix4x4 expectedWorld = TransformBatch::MakeWorldMatrix(
+        input.position, input.rotation, input.scale, input.anchor);
+    Matrix4x4 expectedWVP = Scalar::Multiply(expectedWorld, kViewProjection);
+    const TransformBatch::Matrices &matrices = batch.GetMatrices(i);
+    // 平行移動は打ち消し合う項の足し算の順が違うので、行列全体の大きさで比べる
+    world = (std::max)(world, MathTest::NormwiseDifference(matrices.World,
+                                                           expectedWorld));
+    wvp = (std::max)(wvp,
+                     MathTest::NormwiseDifference(matrices.WVP, expectedWVP));
+  }
+  CHECK_NEAR(world, 0.0f, 1e-6f);
+  CHECK_NEAR(wvp, 0.0f, 1e-6f);
+}
+
+void TestMatchesScalar() {
+  MathTest::Random random;
+  std::vector<Input> inputs;
+  for (uint32_t i = 0; i < 1001; ++i) {
+    inputs.push_back(MakeInput(random));
+  }
+  TransformBatch batch;
+  // 4の倍数でない件数（余りのレーン）も含めて確かめる
+  CheckBatch(batch, inputs);
+  // Clearして少ない件数で使い直しても前の結果が混ざらない
+  inputs.resize(7);
+  CheckBatch(batch, inputs);
+}
+
+// 回転0・拡縮1・アンカー0なら平行移動だけの行列
+void TestSimpleTranslation() {
+  TransformBatch batch;
+  batch.Add({100.0f, 50.0f}, 0.0f, {1.0f, 1.0f}, {0.0f, 0.0f});
+  batch.Compute(Math::MakeIdentity4x4());
+  const Matrix4x4 &world = batch.GetMatrices(0).World;
+  CHECK(world.m[0][0] == 1.0f && world.m[1][1] == 1.0f &&
+        world.m[2][2] == 1.0f && world.m[3][3] == 1.0f);
+  CHECK(world.m[3][0] == 100.0f && world.m[3][1] == 50.0f);
+  CHECK(world.m[0][1] == 0.0f && world.m[1][0] == 0.0f);
+  // viewProjectionが単位行列ならWVPもWorldと同じ
+  CHECK(MathTest::MaxDifference(batch.GetMatrices(0).WVP, world) == 0.0f);
+}
+
+// アンカーは拡縮前の単位矩形上の点。(0.5,0.5)なら中心が位置に来る
+void TestAnchor() {
+  TransformBatch batch;
+  batch.Add({640.0f, 360.0f}, 0.0f, {200.0f, 100.0f}, {0.5f, 0.5f});
+  batch.Compute(Math::MakeIdentity4x4());
+  Vector3 center = Math::TransformCoord({0.5f, 0.5f, 0.0f},
+                                        batch.GetMatrices(0).World);
+  CHECK_NEAR(center.x, 640.0f, 1e-4f);
+  CHECK_NEAR(center.y, 360.0f, 1e-4f);
+}
+} // namespace
+
+int main() {
+#if defined(MYMATH_USE_SSE2)
+  std::printf("backend: SSE2\n");
+#else
+  std::printf("backend: scalar\n");
+#endif
+  TestMatchesScalar();
+  TestSimpleTranslation();
+  TestAnchor();
+  return Test::Finish();
+}
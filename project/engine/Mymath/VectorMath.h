@@ -0,0 +1,122 @@
+﻿#pragma once
+#include "Mymath.h"
+#include <cmath>
+
+// ベクトル・クォータニオンの演算子と基本の関数
+// 定数式でも使えるものはconstexprにしてある
+namespace MyMath {
+
+// Vector2
+constexpr Vector2 operator+(const Vector2 &a, const Vector2 &b) {
+  return {a.x + b.x, a.y + b.y};
+}
+constexpr Vector2 operator-(const Vector2 &a, const Vector2 &b) {
+  return {a.x - b.x, a.y - b.y};
+}
+constexpr Vector2 operator-(const Vector2 &v) { return {-v.x, -v.y}; }
+constexpr Vector2 operator*(const Vector2 &v, float s) {
+  return {v.x * s, v.y * s};
+}
+constexpr Vector2 operator*(float s, const Vector2 &v) { return v * s; }
+constexpr Vector2 operator/(const Vector2 &v, float s) {
+  return {v.x / s, v.y / s};
+}
+constexpr Vector2 &operator+=(Vector2 &a, const Vector2 &b) {
+  return a = a + b;
+}
+constexpr Vector2 &operator-=(Vector2 &a, const Vector2 &b) {
+  return a = a - b;
+}
+constexpr Vector2 &operator*=(Vector2 &v, float s) { return v = v * s; }
+constexpr float Dot(const Vector2 &a, const Vector2 &b) {
+  return a.x * b.x + a.y * b.y;
+}
+// 2次元の外積（z成分）
+constexpr float Cross(const Vector2 &a, const Vector2 &b) {
+  return a.x * b.y - a.y * b.x;
+}
+
+// Vector3
+constexpr Vector3 operator+(const Vector3 &a, const Vector3 &b) {
+  return {a.x + b.x, a.y + b.y, a.z + b.z};
+}
+constexpr Vector3 operator-(const Vector3 &a, const Vector3 &b) {
+  return {a.x - b.x, a.y - b.y, a.z - b.z};
+}
+constexpr Vector3 operator-(const Vector3 &v) { return {-v.x, -v.y, -v.z}; }
+constexpr Vector3 operator*(const Vector3 &v, float s) {
+  return {v.x * s, v.y * s, v.z * s};
+}
+constexpr Vector3 operator*(float s, const Vector3 &v) { return v * s; }
+constexpr Vector3 operator/(const Vector3 &v, float s) {
+  return {v.x / s, v.y / s, v.z / s};
+}
+constexpr Vector3 &operator+=(Vector3 &a, const Vector3 &b) {
+  return a = a + b;
+}
+constexpr Vector3 &operator-=(Vector3 &a, const Vector3 &b) {
+  return a = a - b;
+}
+constexpr Vector3 &operator*=(Vector3 &v, float s) { return v = v * s; }
+constexpr bool operator==(const Vector3 &a, const Vector3 &b) {
+  return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+constexpr bool operator!=(const Vector3 &a, const Vector3 &b) {
+  return !(a == b);
+}
+constexpr float Dot(const Vector3 &a, const Vector3 &b) {
+  return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+constexpr Vector3 Cross(const Vector3 &a, const Vector3 &b) {
+  return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z,
+          a.x * b.y - a.y * b.x};
+}
+
+// Vector4
+constexpr Vector4 operator+(const Vector4 &a, const Vector4 &b) {
+  return {a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w};
+}
+constexpr Vector4 operator-(const Vector4 &a, const Vector4 &b) {
+  return {a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w};
+}
+constexpr Vector4 operator*(const Vector4 &v, float s) {
+  return {v.x * s, v.y * s, v.z * s, v.w * s};
+}
+constexpr Vector4 operator*(float s, const Vector4 &v) { return v * s; }
+constexpr float Dot(const Vector4 &a, const Vector4 &b) {
+  return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+}
+
+// 長さ・正規化・補間
+template <class T> constexpr float LengthSquared(const T &v) {
+  return Dot(v, v);
+}
+template <class T> inline float Length(const T &v) {
+  return std::sqrt(LengthSquared(v));
+}
+// 長さ0のベクトルはそのまま返す
+template <class T> inline T Normalize(const T &v) {
+  float length = Length(v);
+  return length != 0.0f ? v * (1.0f / length) : v;
+}
+template <class T> constexpr T Lerp(const T &a, const T &b, float t) {
+  return a + (b - a) * t;
+}
+
+// Quaternion
+constexpr Quaternion IdentityQuaternion() { return {0.0f, 0.0f, 0.0f, 1.0f}; }
+// 合成の順番は行列と同じ（q1 * q2はq1で回してからq2で回す）
+constexpr Quaternion operator*(const Quaternion &q1, const Quaternion &q2) {
+  return {q2.w * q1.x + q2.x * q1.w + q2.y * q1.z - q2.z * q1.y,
+          q2.w * q1.y - q2.x * q1.z + q2.y * q1.w + q2.z * q1.x,
+          q2.w * q1.z + q2.x * q1.y - q2.y * q1.x + q2.z * q1.w,
+          q2.w * q1.w - q2.x * q1.x - q2.y * q1.y - q2.z * q1.z};
+}
+constexpr Quaternion Conjugate(const Quaternion &q) {
+  return {-q.x, -q.y, -q.z, q.w};
+}
+constexpr float Dot(const Quaternion &a, const Quaternion &b) {
+  return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+}
+
+} // namespace MyMath
@@ -0,0 +1,186 @@
+﻿#include "AtlasPacker.h"
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+
+namespace {
+// aがbに含まれるか
+bool IsContained(const AtlasPacker::Rect &a, const AtlasPacker::Rect &b) {
+  return a.x >= b.x && a.y >= b.y && a.x + a.width <= b.x + b.width &&
+         a.y + a.height <= b.y + b.height;
+}
+
+// aとbが重なるか
+bool IsOverlapped(const AtlasPacker::Rect &a, const AtlasPacker::Rect &b) {
+  return a.x < b.x + b.width && b.x < a.x + a.width &&
+         a.y < b.y + b.height && b.y < a.y + a.height;
+}
+} // namespace
+
+void AtlasPacker::Initialize(uint32_t pageWidth, uint32_t pageHeight,
+                             uint32_t padding) {
+  assert(pageWidth > padding * 2 && pageHeight > padding * 2);
+  this->pageWidth = pageWidth;
+  this->pageHeight = pageHeight;
+  this->padding = padding;
+  pages.clear();
+}
+
+AtlasPacker::Placement AtlasPacker::Insert(uint32_t width, uint32_t height) {
+  Placement placement;
+  // 右と下に余白を付けて置く（左上の余白はページの空き矩形で取ってある）
+  uint32_t paddedWidth = width + padding;
+  uint32_t paddedHeight = height + padding;
+  if (width == 0 || height == 0 || paddedWidth > pageWidth - padding ||
+      paddedHeight > pageHeight - padding) {
+    return placement;
+  }
+
+  // 全ページから一番ぴったり合う場所を探す
+  Rect bestRect{};
+  uint64_t bestScore = UINT64_MAX;
+  uint32_t bestPage = kInvalidPage;
+  for (uint32_t i = 0; i < pages.size(); ++i) {
+    if (FindPosition(pages[i], paddedWidth, paddedHeight, bestRect,
+                     bestScore)) {
+      bestPage = i;
+    }
+  }
+  if (bestPage == kInvalidPage) {
+    AddPage();
+    bestPage = static_cast<uint32_t>(pages.size() - 1);
+    bool isFound = FindPosition(pages[bestPage], paddedWidth, paddedHeight,
+                                bestRect, bestScore);
+    assert(isFound);
+    (void)isFound;
+  }
+
+  Page &page = pages[bestPage];
+  PlaceRect(page, bestRect);
+  page.usedArea += uint64_t(width) * height;
+
+  placement.page = bestPage;
+  placement.rect = {bestRect.x, bestRect.y, width, height};
+  return placement;
+}
+
+std::vector<AtlasPacker::Placement>
+AtlasPacker::Pack(const std::vector<Size> &sizes) {
+  // 長辺の長いものから詰めると隙間が少ない
+  std::vector<uint32_t> order(sizes.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+    uint32_t longA = std::max(sizes[a].width, sizes[a].height);
+    uint32_t longB = std::max(sizes[b].width, sizes[b].height);
+    if (longA != longB) {
+      return longA > longB;
+    }
+    return uint64_t(sizes[a].width) * sizes[a].height >
+           uint64_t(sizes[b].width) * sizes[b].height;
+  });
+
+  std::vector<Placement> placements(sizes.size());
+  for (uint32_t index : order) {
+    placements[index] = Insert(sizes[index].width, sizes[index].height);
+  }
+  return placements;
+}
+
+double AtlasPacker::GetOccupancy() const {
+  if (pages.empty()) {
+    return 0.0;
+  }
+  uint64_t usedArea = 0;
+  for (const Page &page : pages) {
+    usedArea += page.usedArea;
+  }
+  return double(usedArea) /
+         (double(pageWidth) * double(pageHeight) * double(pages.size()));
+}
+
+bool AtlasPacker::FindPosition(const Page &page, uint32_t width,
+                               uint32_t height, Rect &bestRect,
+                               uint64_t &bestScore) {
+  bool isFound = false;
+  for (const Rect &freeRect : page.freeRects) {
+    if (freeRect.width < width || freeRect.height < height) {
+      continue;
+    }
+    // 余る短辺が小さいほど良い。同点なら余る長辺で比べる
+    uint32_t leftoverX = freeRect.width - width;
+    uint32_t leftoverY = freeRect.height - height;
+    uint64_t shortSide = std::min(leftoverX, leftoverY);
+    uint64_t longSide = std::max(leftoverX, leftoverY);
+    uint64_t score = (shortSide << 32) | longSide;
+    if (score < bestScore) {
+      bestScore = score;
+      bestRect = {freeRect.x, freeRect.y, width, height};
+      isFound = true;
+    }
+  }
+  return isFound;
+}
+
+void AtlasPacker::PlaceRect(Page &page, const Rect &usedRect) {
+  // 重なる空き矩形を、置いた矩形の上下左右の残りに分ける
+  std::vector<Rect> &freeRects = page.freeRects;
+  size_t keptCount = 0;
+  size_t oldCount = freeRects.size();
+  std::vector<Rect> &splitRects = newFreeRects;
+  splitRects.clear();
+  for (size_t i = 0; i < oldCount; ++i) {
+    const Rect freeRect = freeRects[i];
+    if (!IsOverlapped(freeRect, usedRect)) {
+      freeRects[keptCount++] = freeRect;
+      continue;
+    }
+    uint32_t freeRight = freeRect.x + freeRect.width;
+    uint32_t freeBottom = freeRect.y + freeRect.height;
+    uint32_t usedRight = usedRect.x + usedRect.width;
+    uint32_t usedBottom = usedRect.y + usedRect.height;
+    if (usedRect.x > freeRect.x) {
+      splitRects.push_back(
+          {freeRect.x, freeRect.y, usedRect.x - freeRect.x, freeRect.height});
+    }
+    if (usedRight < freeRight) {
+      splitRects.push_back(
+          {usedRight, freeRect.y, freeRight - usedRight, freeRect.height});
+    }
+    if (usedRect.y > freeRect.y) {
+      splitRects.push_back(
+          {freeRect.x, freeRect.y, freeRect.width, usedRect.y - freeRect.y});
+    }
+    if (usedBottom < freeBottom) {
+      splitRects.push_back(
+          {freeRect.x, usedBottom, freeRect.width, freeBottom - usedBottom});
+    }
+  }
+  freeRects.resize(keptCount);
+
+  // 分割でできた矩形のうち、他に含まれるものは要らない
+  // 元からある矩形同士は包含関係にないので、新しいものとだけ比べればよい
+  for (size_t i = 0; i < splitRects.size(); ++i) {
+    bool isRedundant = false;
+    for (size_t j = 0; j < splitRects.size() && !isRedundant; ++j) {
+      if (i == j || !IsContained(splitRects[i], splitRects[j])) {
+        continue;
+      }
+      // 同じ矩形が2つあれば番号の小さいほうを残す
+      isRedundant = !IsContained(splitRects[j], splitRects[i]) || j < i;
+    }
+    for (size_t j = 0; j < keptCount && !isRedundant; ++j) {
+      isRedundant = IsContained(splitRects[i], freeRects[j]);
+    }
+    if (!isRedundant) {
+      freeRects.push_back(splitRects[i]);
+    }
+  }
+}
+
+void AtlasPacker::AddPage() {
+  Page page;
+  // 左と上の余白を除いた全体が最初の空き矩形
+  page.freeRects.push_back(
+      {padding, padding, pageWidth - padding, pageHeight - padding});
+  pages.push_back(std::move(page));
+}
@@ -0,0 +1,71 @@
+﻿#pragma once
+#include <cstdint>
+#include <vector>
+
+// 小さなイメージを大きなページに詰める（D3D12に依存しない部分）
+// MaxRects法（空き矩形の短辺が一番ぴったり合う場所に置く）で詰める
+// オフラインでまとめて詰めるPackと、読み込み時に1枚ずつ足すInsertがある
+class AtlasPacker {
+public:
+  // 入らなかったときのページ番号
+  static const uint32_t kInvalidPage = UINT32_MAX;
+
+  struct Size {
+    uint32_t width;
+    uint32_t height;
+  };
+
+  struct Rect {
+    uint32_t x;
+    uint32_t y;
+    uint32_t width;
+    uint32_t height;
+  };
+
+  // 置いた場所。rectは余白を含まないイメージの範囲
+  struct Placement {
+    uint32_t page = kInvalidPage;
+    Rect rect{};
+  };
+
+  // ページの大きさとイメージ間の余白（ミップマップのにじみ止め）を決めて空にする
+  // ミップマップを作るなら、余白は2^(段数-1)ピクセル以上にする
+  // （既定の2ピクセルで守れるのは2段目まで）
+  void Initialize(uint32_t pageWidth, uint32_t pageHeight,
+                  uint32_t padding = 2);
+
+  // 1枚詰める。どのページにも入らなければページを足す
+  // ページより大きいイメージはkInvalidPage
+  Placement Insert(uint32_t width, uint32_t height);
+
+  // まとめて詰める。大きいものから詰め、結果は入力と同じ順で返す
+  std::vector<Placement> Pack(const std::vector<Size> &sizes);
+
+  uint32_t GetPageCount() const { return static_cast<uint32_t>(pages.size()); }
+  uint32_t GetPageWidth() const { return pageWidth; }
+  uint32_t GetPageHeight() const { return pageHeight; }
+  // 使ったページの面積のうちイメージが占める割合（余白は含まない）
+  double GetOccupancy() const;
+
+private:
+  struct Page {
+    // 重なりを許す空き矩形の一覧
+    std::vector<Rect> freeRects;
+    uint64_t usedArea = 0;
+  };
+
+  // ページの中で一番合う空き矩形を探す。見つかればtrue
+  static bool FindPosition(const Page &page, uint32_t width, uint32_t height,
+                           Rect &bestRect, uint64_t &bestScore);
+  // 置いた矩形と重なる空き矩形を分割し、包含されるものを消す
+  void PlaceRect(Page &page, const Rect &usedRect);
+  // 空のページを足す
+  void AddPage();
+
+  uint32_t pageWidth = 0;
+  uint32_t pageHeight = 0;
+  uint32_t padding = 0;
+  std::vector<Page> pages;
+  // 分割で増えた空き矩形の作業領域
+  std::vector<Rect> newFreeRects;
+};
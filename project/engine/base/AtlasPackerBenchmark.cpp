@@ -0,0 +1,99 @@
+﻿#include "AtlasPacker.h"
+#include "Benchmark.h"
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// 乱数の大きさのイメージ（RGBA8）をアトラスに詰める時の、詰める時間・
+// ページ数・占有率と、ページへ書き写す時間
+// Pack（大きい順にまとめて詰める）とInsert（積んだ順に1枚ずつ）を比べる
+namespace {
+const uint32_t kPageSize = 2048;
+const uint32_t kRepeatCount = 5;
+
+struct Image {
+  uint32_t width;
+  uint32_t height;
+  std::vector<uint32_t> pixels;
+};
+
+std::vector<Image> MakeImages(uint32_t count, uint32_t minSize,
+                              uint32_t maxSize, std::mt19937 &engine) {
+  std::uniform_int_distribution<uint32_t> size(minSize, maxSize);
+  std::vector<Image> images(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    images[i].width = size(engine);
+    images[i].height = size(engine);
+    images[i].pixels.assign(size_t(images[i].width) * images[i].height,
+                            0xFF000000u | i);
+  }
+  return images;
+}
+
+// 置いた場所へ1行ずつ書き写す（TextureManager::LoadTextureAtlasと同じ）
+void CopyToPages(const std::vector<Image> &images,
+                 const std::vector<AtlasPacker::Placement> &placements,
+                 std::vector<std::vector<uint32_t>> &pages) {
+  for (std::vector<uint32_t> &page : pages) {
+    std::memset(page.data(), 0, page.size() * sizeof(uint32_t));
+  }
+  for (size_t i = 0; i < images.size(); ++i) {
+    const AtlasPacker::Rect &rect = placements[i].rect;
+    uint32_t *destination = pages[placements[i].page].data();
+    for (uint32_t y = 0; y < rect.height; ++y) {
+      std::memcpy(destination + size_t(rect.y + y) * kPageSize + rect.x,
+                  images[i].pixels.data() + size_t(y) * images[i].width,
+                  rect.width * sizeof(uint32_t));
+    }
+  }
+}
+
+void Run(const char *name, uint32_t count, uint32_t minSize, uint32_t maxSize,
+         std::mt19937 &engine) {
+  std::vector<Image> images = MakeImages(count, minSize, maxSize, engine);
+  std::vector<AtlasPacker::Size> sizes(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    sizes[i] = {images[i].width, images[i].height};
+  }
+
+  AtlasPacker packer;
+  std::vector<AtlasPacker::Placement> placements;
+  double packMs = Benchmark::MeasureBestMs(kRepeatCount, [&]() {
+    packer.Initialize(kPageSize, kPageSize);
+    placements = packer.Pack(sizes);
+  });
+  uint32_t packPages = packer.GetPageCount();
+  double packOccupancy = packer.GetOccupancy();
+
+  std::vector<std::vector<uint32_t>> pages(
+      packPages, std::vector<uint32_t>(size_t(kPageSize) * kPageSize));
+  double copyMs = Benchmark::MeasureBestMs(
+      kRepeatCount, [&]() { CopyToPages(images, placements, pages); });
+  Benchmark::Consume(pages[0][kPageSize + 2]);
+
+  double insertMs = Benchmark::MeasureBestMs(kRepeatCount, [&]() {
+    packer.Initialize(kPageSize, kPageSize);
+    for (const AtlasPacker::Size &size : sizes) {
+      Benchmark::Consume(packer.Insert(size.width, size.height).page);
+    }
+  });
+
+  std::printf("%-14s %6u %9.2f %6u %8.1f%% %10.2f %6u %8.1f%% %9.2f\n", name,
+              count, packMs, packPages, packOccupancy * 100.0, insertMs,
+              packer.GetPageCount(), packer.GetOccupancy() * 100.0, copyMs);
+}
+} // namespace
+
+int main() {
+  std::mt19937 engine(12345);
+  std::printf("%u x %u pages\n", kPageSize, kPageSize);
+  std::printf("%-14s %6s %9s %6s %9s %10s %6s %9s %9s\n", "images", "count",
+              "Pack ms", "pages", "occupancy", "Insert ms", "pages",
+              "occupancy", "copy ms");
+  Run("icons 16-64", 5000, 16, 64, engine);
+  Run("sprites 32-256", 500, 32, 256, engine);
+  Run("mixed 8-512", 300, 8, 512, engine);
+  Run("sprites 32-256", 2000, 32, 256, engine);
+  return 0;
+}
@@ -0,0 +1,67 @@
+﻿#include "DescriptorAllocator.h"
+#include <cassert>
+
+void DescriptorAllocator::Initialize(uint32_t persistentCount,
+                                     uint32_t frameCount) {
+  assert(frameCount > 0);
+  this->persistentCount = persistentCount;
+  this->frameCount = frameCount;
+
+  generations.assign(persistentCount, 0);
+  freeIndices.clear();
+  nextUnusedIndex = 0;
+  pendingFrees.clear();
+  pendingFrees.resize(frameCount);
+  persistentUsedCount = 0;
+
+  frameIndex = 0;
+}
+
+void DescriptorAllocator::BeginFrame(uint32_t frameIndex) {
+  assert(frameIndex < frameCount);
+  this->frameIndex = frameIndex;
+
+  // 前回このスロットで解放した番号はもうGPUが参照していない
+  std::vector<uint32_t> &pending = pendingFrees[frameIndex];
+  freeIndices.insert(freeIndices.end(), pending.begin(), pending.end());
+  pending.clear();
+}
+
+DescriptorHandle DescriptorAllocator::Allocate() {
+  uint32_t index;
+  if (!freeIndices.empty()) {
+    index = freeIndices.back();
+    freeIndices.pop_back();
+  } else {
+    // 永続領域を使い切った
+    assert(nextUnusedIndex < persistentCount);
+    index = nextUnusedIndex++;
+  }
+  // 偶数（空き）から奇数（確保中）へ
+  uint32_t &generation = generations[index];
+  assert((generation & 1) == 0);
+  generation++;
+  persistentUsedCount++;
+  return {index, generation};
+}
+
+void DescriptorAllocator::Free(DescriptorHandle handle) {
+  // 二重解放・古いハンドルの解放
+  assert(IsValid(handle));
+  // 奇数から偶数へ。同じハンドルはもう有効にならない
+  generations[handle.index]++;
+  pendingFrees[frameIndex].push_back(handle.index);
+  persistentUsedCount--;
+}
+
+bool DescriptorAllocator::IsValid(DescriptorHandle handle) const {
+  return handle.index < persistentCount &&
+         generations[handle.index] == handle.generation &&
+         (handle.generation & 1) == 1;
+}
+
+uint32_t DescriptorAllocator::GetIndex(DescriptorHandle handle) const {
+  // 解放済みのハンドルを使っている
+  assert(IsValid(handle));
+  return handle.index;
+}
@@ -0,0 +1,54 @@
+﻿#pragma once
+#include <cstdint>
+#include <vector>
+
+// デスクリプタ1つ分のハンドル。番号と世代を持ち、解放後に使うと検出できる
+struct DescriptorHandle {
+  uint32_t index = UINT32_MAX;
+  uint32_t generation = 0;
+
+  bool IsNull() const { return index == UINT32_MAX; }
+};
+
+// シェーダーから見えるデスクリプタヒープの番号の割り当て（D3D12に依存しない部分）
+// 空きリストで確保・解放し、解放した番号はGPUが使い終わってから再利用する
+class DescriptorAllocator {
+public:
+  // 初期化。ヒープ全体はpersistentCount個
+  void Initialize(uint32_t persistentCount, uint32_t frameCount);
+
+  // スロットの使用開始。前回そのスロットで積んだ分をGPUが終えていること
+  // そのスロットで解放された番号もここで再利用できるようになる
+  void BeginFrame(uint32_t frameIndex);
+
+  // 永続的な番号を1つ確保する
+  DescriptorHandle Allocate();
+  // 永続的な番号を解放する。GPUが使い終わるまで（同じスロットの次の
+  // BeginFrameまで）は再利用しない。ハンドルはすぐ無効になる
+  void Free(DescriptorHandle handle);
+  // 確保中のハンドルか（解放済み・別の世代ならfalse）
+  bool IsValid(DescriptorHandle handle) const;
+  // ハンドルのヒープ内の番号。無効なハンドルならassert
+  uint32_t GetIndex(DescriptorHandle handle) const;
+
+  // ヒープ全体の数
+  uint32_t GetHeapSize() const { return persistentCount; }
+  // 確保中の永続番号の数
+  uint32_t GetPersistentUsedCount() const { return persistentUsedCount; }
+
+private:
+  uint32_t persistentCount = 0;
+  uint32_t frameCount = 0;
+
+  // 番号ごとの世代。奇数なら確保中
+  std::vector<uint32_t> generations;
+  // 再利用できる番号（後ろから取る）
+  std::vector<uint32_t> freeIndices;
+  // まだ一度も使っていない番号の先頭
+  uint32_t nextUnusedIndex = 0;
+  // スロットごとの、GPUが使い終わるのを待っている番号
+  std::vector<std::vector<uint32_t>> pendingFrees;
+  uint32_t persistentUsedCount = 0;
+
+  uint32_t frameIndex = 0;
+};
@@ -0,0 +1,91 @@
+﻿#include "Benchmark.h"
+#include "DescriptorAllocator.h"
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+const uint32_t kFrameCount = 2;
+const uint32_t kFramesPerRun = 20;
+const uint32_t kRepeatCount = 5;
+// 線形探索は遅いので短く測る
+const uint32_t kLinearFramesPerRun = 2;
+const uint32_t kLinearRepeatCount = 1;
+
+// 比べる相手：使用中フラグの配列を先頭から探して空きを見つける確保
+struct LinearScanAllocator {
+  std::vector<bool> isUsed;
+  uint32_t Allocate() {
+    for (uint32_t i = 0; i < isUsed.size(); ++i) {
+      if (!isUsed[i]) {
+        isUsed[i] = true;
+        return i;
+      }
+    }
+    return UINT32_MAX;
+  }
+  void Free(uint32_t index) { isUsed[index] = false; }
+};
+} // namespace
+
+// 生きている番号がliveCount個ある状態で、フレームごとに
+// churn個解放してchurn個確保する。1回の解放＋確保の時間（ns）
+// 解放は乱数で選ぶので、空きは永続領域のあちこちに散らばる
+// 最初に埋める分は測らず、入れ替えだけを測る
+int main() {
+  std::printf("%10s %8s %14s %14s\n", "live", "churn", "allocator ns",
+              "linear scan ns");
+  for (uint32_t liveCount : {1000u, 30000u, 100000u}) {
+    const uint32_t capacity = liveCount * 2;
+    const uint32_t churn = liveCount / 10;
+    // 解放する位置は先に決めておき、繰り返しのたびに同じ列を使う
+    std::mt19937 engine(12345);
+    std::vector<uint32_t> picks(kFramesPerRun * churn);
+    for (uint32_t &pick : picks) {
+      pick = engine() % liveCount;
+    }
+
+    std::vector<DescriptorHandle> handles(liveCount);
+    DescriptorAllocator allocator;
+    allocator.Initialize(capacity, kFrameCount);
+    allocator.BeginFrame(0);
+    for (DescriptorHandle &handle : handles) {
+      handle = allocator.Allocate();
+    }
+    uint32_t frameIndex = 0;
+    double allocatorMs = Benchmark::MeasureBestMs(kRepeatCount, [&]() {
+      const uint32_t *pick = picks.data();
+      for (uint32_t frame = 0; frame < kFramesPerRun; ++frame) {
+        frameIndex = (frameIndex + 1) % kFrameCount;
+        allocator.BeginFrame(frameIndex);
+        for (uint32_t i = 0; i < churn; ++i, ++pick) {
+          allocator.Free(handles[*pick]);
+          handles[*pick] = allocator.Allocate();
+        }
+      }
+    });
+    Benchmark::Consume(allocator.GetIndex(handles[0]));
+
+    std::vector<uint32_t> indices(liveCount);
+    LinearScanAllocator linear;
+    linear.isUsed.assign(capacity, false);
+    for (uint32_t &index : indices) {
+      index = linear.Allocate();
+    }
+    double linearMs = Benchmark::MeasureBestMs(kLinearRepeatCount, [&]() {
+      const uint32_t *pick = picks.data();
+      for (uint32_t frame = 0; frame < kLinearFramesPerRun; ++frame) {
+        for (uint32_t i = 0; i < churn; ++i, ++pick) {
+          linear.Free(indices[*pick]);
+          indices[*pick] = linear.Allocate();
+        }
+      }
+    });
+    Benchmark::Consume(indices[0]);
+
+    std::printf("%10u %8u %14.2f %14.2f\n", liveCount, churn,
+                allocatorMs * 1e6 / (double(kFramesPerRun) * churn),
+                linearMs * 1e6 / (double(kLinearFramesPerRun) * churn));
+  }
+  return 0;
+}
@@ -0,0 +1,158 @@
+﻿#include "Check.h"
+#include "DescriptorAllocator.h"
+#include <random>
+#include <set>
+#include <vector>
+
+namespace {
+const uint32_t kPersistentCount = 64;
+const uint32_t kFrameCount = 3;
+
+// 解放した番号は、解放したスロットの次のBeginFrameまで再利用しない
+void TestDeferredReuse() {
+  DescriptorAllocator allocator;
+  allocator.Initialize(kPersistentCount, kFrameCount);
+  allocator.BeginFrame(0);
+
+  DescriptorHandle a = allocator.Allocate();
+  DescriptorHandle b = allocator.Allocate();
+  CHECK(a.index == 0 && b.index == 1);
+  CHECK(allocator.GetPersistentUsedCount() == 2);
+  allocator.Free(a);
+  CHECK(allocator.GetPersistentUsedCount() == 1);
+
+  // 同じフレームや、他のスロットのフレームではaの番号は出てこない
+  std::set<uint32_t> seen;
+  std::vector<DescriptorHandle> others;
+  for (uint32_t frame : {0u, 1u, 2u}) {
+    if (frame != 0) {
+      allocator.BeginFrame(frame);
+    }
+    DescriptorHandle handle = allocator.Allocate();
+    CHECK(handle.index != a.index);
+    seen.insert(handle.index);
+    others.push_back(handle);
+  }
+  CHECK(seen.size() == 3);
+
+  // スロット0が一周して戻ってきたら再利用される
+  allocator.BeginFrame(0);
+  DescriptorHandle c = allocator.Allocate();
+  CHECK(c.index == a.index);
+  CHECK(c.generation == a.generation + 2);
+
+  // スロット1・2で解放した分はそれぞれのスロットに戻った時に使える
+  allocator.BeginFrame(1);
+  allocator.Free(others[0]);
+  allocator.BeginFrame(2);
+  allocator.Free(others[1]);
+  allocator.BeginFrame(0);
+  CHECK(allocator.Allocate().index == 5);
+  allocator.BeginFrame(1);
+  CHECK(allocator.Allocate().index == others[0].index);
+  allocator.BeginFrame(2);
+  CHECK(allocator.Allocate().index == others[1].index);
+}
+
+// 解放したハンドルは、同じ番号が再び確保されても無効のまま
+void TestGeneration() {
+  DescriptorAllocator allocator;
+  allocator.Initialize(kPersistentCount, 1);
+  allocator.BeginFrame(0);
+
+  DescriptorHandle null;
+  CHECK(null.IsNull());
+  CHECK(!allocator.IsValid(null));
+
+  DescriptorHandle a = allocator.Allocate();
+  CHECK(!a.IsNull());
+  CHECK(allocator.IsValid(a));
+  CHECK(allocator.GetIndex(a) == a.index);
+  CHECK((a.generation & 1) == 1);
+
+  allocator.Free(a);
+  CHECK(!allocator.IsValid(a));
+
+  // スロットが1つなら次のBeginFrameで戻る
+  allocator.BeginFrame(0);
+  DescriptorHandle b = allocator.Allocate();
+  CHECK(b.index == a.index);
+  CHECK(allocator.IsValid(b));
+  CHECK(!allocator.IsValid(a));
+  // 偶数（空き）の世代や、範囲外の番号は無効
+  CHECK(!allocator.IsValid({b.index, b.generation + 1}));
+  CHECK(!allocator.IsValid({kPersistentCount, 1}));
+
+  // 永続領域を全部使える
+  for (uint32_t i = 1; i < kPersistentCount; ++i) {
+    CHECK(allocator.IsValid(allocator.Allocate()));
+  }
+  CHECK(allocator.GetPersistentUsedCount() == kPersistentCount);
+}
+
+// 乱数で確保・解放を繰り返し、生きている番号が重ならないこと、
+// 解放した番号がスロットが一周する前に再利用されないことを確かめる
+void TestRandomized() {
+  const uint32_t kCapacity = 1024;
+  DescriptorAllocator allocator;
+  allocator.Initialize(kCapacity, kFrameCount);
+
+  std::mt19937 engine(12345);
+  std::vector<DescriptorHandle> live;
+  std::vector<DescriptorHandle> freed;
+  // 番号ごとの、解放した時のフレーム番号（まだならUINT32_MAX）
+  std::vector<uint32_t> freedFrame(kCapacity, UINT32_MAX);
+  std::vector<bool> isLive(kCapacity, false);
+  bool isConsistent = true;
+  for (uint32_t frame = 0; frame < 2000; ++frame) {
+    allocator.BeginFrame(frame % kFrameCount);
+    uint32_t operationCount = engine() % 64;
+    for (uint32_t i = 0; i < operationCount; ++i) {
+      // 埋まっているほど解放を多めにする（半分ほどで釣り合う）
+      if (engine() % kCapacity >= live.size()) {
+        DescriptorHandle handle = allocator.Allocate();
+        isConsistent = isConsistent && !isLive[handle.index];
+        if (freedFrame[handle.index] != UINT32_MAX) {
+          // 解放したのと同じスロットを少なくとも一周した後
+          isConsistent = isConsistent &&
+                         frame >= freedFrame[handle.index] + kFrameCount;
+        }
+        isLive[handle.index] = true;
+        live.push_back(handle);
+      } else if (!live.empty()) {
+        size_t pick = engine() % live.size();
+        DescriptorHandle handle = live[pick];
+        live[pick] = live.back();
+        live.pop_back();
+        allocator.Free(handle);
+        isLive[handle.index] = false;
+        freedFrame[handle.index] = frame;
+        freed.push_back(handle);
+      }
+    }
+    isConsistent =
+        isConsistent && allocator.GetPersistentUsedCount() == live.size();
+  }
+  CHECK(isConsistent);
+  CHECK(!freed.empty());
+
+  // 生きているハンドルは全部有効、解放したハンドルは全部無効
+  bool isLiveValid = true;
+  for (const DescriptorHandle &handle : live) {
+    isLiveValid = isLiveValid && allocator.IsValid(handle);
+  }
+  bool isFreedInvalid = true;
+  for (const DescriptorHandle &handle : freed) {
+    isFreedInvalid = isFreedInvalid && !allocator.IsValid(handle);
+  }
+  CHECK(isLiveValid);
+  CHECK(isFreedInvalid);
+}
+} // namespace
+
+int main() {
+  TestDeferredReuse();
+  TestGeneration();
+  TestRandomized();
+  return Test::Finish();
+}
@@ -5,6 +5,8 @@
 #include "externals/imgui/imgui_impl_dx12.h"
 #include "externals/imgui/imgui_impl_win32.h"
 #include "Logger.h"
+#include "TextureStaging.h"
+#include <algorithm>
 #include <cassert>
 #include <thread>
 using namespace StringUtility;
@@ -23,12 +25,85 @@ using namespace Microsoft::WRL;
 
 const uint32_t DirectXCommon::kMaxSRVCount = 512;
 
-void DirectXCommon::Initialize(WinApp *winApp) {
+namespace {
+// FrameRingからコマンドキューへSignalを送る
+struct CommandQueueSignaler {
+  ID3D12CommandQueue *commandQueue;
+  ID3D12Fence *fence;
+
+  void Signal(uint64_t value) { commandQueue->Signal(fence, value); }
+};
+
+// FrameRingからフェンスの完了を待つ
+struct FenceWaiter {
+  ID3D12Fence *fence;
+  HANDLE fenceEvent;
+
+  uint64_t GetCompletedValue() const { return fence->GetCompletedValue(); }
+  void Wait(uint64_t value) {
+    // 指定したSignalにたどりついていないので、たどり着くまで待つようにイベントを設定する
+    fence->SetEventOnCompletion(value, fenceEvent);
+    // イベント待つ
+    WaitForSingleObject(fenceEvent, INFINITE);
+  }
+};
+
+// GpuProfilerの区間の前後にタイムスタンプを積む
+struct TimestampRecorder {
+  ID3D12GraphicsCommandList *commandList;
+  ID3D12QueryHeap *queryHeap;
+
+  void EndQuery(uint32_t timestampIndex) {
+    commandList->EndQuery(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP,
+                          timestampIndex);
+  }
+};
+
+// GetClockCalibrationと同じ時計（QueryPerformanceCounter）の今の値
+uint64_t GetCpuTimestamp() {
+  LARGE_INTEGER counter;
+  QueryPerformanceCounter(&counter);
+  return static_cast<uint64_t>(counter.QuadPart);
+}
+
+// ResourceStateTrackerのバリアをまとめてコマンドリストへ積む
+struct CommandListBarrierRecorder {
+  ID3D12GraphicsCommandList *commandList;
+  // 1回に積む数の上限（超えたら分けて積む）
+  static const uint32_t kMaxBarriers = 16;
+
+  void ResourceBarrier(const ResourceStateTracker::Barrier *barriers,
+                       uint32_t count) {
+    D3D12_RESOURCE_BARRIER descs[kMaxBarriers];
+    for (uint32_t first = 0; first < count; first += kMaxBarriers) {
+      uint32_t batchCount = (std::min)(count - first, kMaxBarriers);
+      for (uint32_t i = 0; i < batchCount; ++i) {
+        const ResourceStateTracker::Barrier &barrier = barriers[first + i];
+        D3D12_RESOURCE_BARRIER &desc = descs[i];
+        desc.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        desc.Flags = static_cast<D3D12_RESOURCE_BARRIER_FLAGS>(barrier.flag);
+        desc.Transition.pResource =
+            static_cast<ID3D12Resource *>(barrier.resource);
+        desc.Transition.Subresource = barrier.subresource;
+        desc.Transition.StateBefore =
+            static_cast<D3D12_RESOURCE_STATES>(barrier.stateBefore);
+        desc.Transition.StateAfter =
+            static_cast<D3D12_RESOURCE_STATES>(barrier.stateAfter);
+      }
+      commandList->ResourceBarrier(batchCount, descs);
+    }
+  }
+};
+} // namespace
+
+void DirectXCommon::Initialize(WinApp *winApp, uint32_t frameCount) {
   // FPS固定初期化
   InitializeFixFPS();
 
   // NULL検出
   assert(winApp);
+  assert(frameCount >= 1 && frameCount <= kMaxFramesInFlight);
+  frameRing.Initialize(frameCount);
 
   // メンバ変数に記録
   this->winApp = winApp;
@@ -37,6 +112,10 @@ void DirectXCommon::Initialize(WinApp *winApp) {
 
   CreateCommandQueue();
 
+  CreateCopyCommandQueue();
+
+  InitializeParallelRecording();
+
   CreateSwapChain();
 
   CreateDepthBuffer();
@@ -49,6 +128,10 @@ void DirectXCommon::Initialize(WinApp *winApp) {
 
   CreateFence();
 
+  CreateProfiler();
+
+  InitializeUploadAllocator();
+
   InitializeViewport();
 
   InitializeScissorRect();
@@ -156,16 +239,106 @@ void DirectXCommon::CreateCommandQueue() {
   // コマンドキューの生成がうまくいかなかったので起動できない
   assert(SUCCEEDED(hr));
 
-  hr = device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT,
-                                      IID_PPV_ARGS(&commandAllocator));
-  // コマンドアロケータの生成がうまくいかなかったので起動できない
-  assert(SUCCEEDED(hr));
+  // フレームスロットの数だけアロケータを用意する
+  for (uint32_t i = 0; i < frameRing.GetFrameCount(); ++i) {
+    hr = device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT,
+                                        IID_PPV_ARGS(&commandAllocators[i]));
+    // コマンドアロケータの生成がうまくいかなかったので起動できない
+    assert(SUCCEEDED(hr));
+  }
 
   hr = device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT,
-                                 commandAllocator.Get(), nullptr,
-                                 IID_PPV_ARGS(&commandList));
+                                 commandAllocators[GetFrameIndex()].Get(),
+                                 nullptr, IID_PPV_ARGS(&commandList));
   // コマンドリストの生成がうまくいかなかったので起動できない
   assert(SUCCEEDED(hr));
+  currentCommandList = commandList.Get();
+}
+
+void DirectXCommon::InitializeParallelRecording() {
+  // 記録スレッド数は後から変えられるので、ワーカーは最大数だけ用意しておく
+  recordThreadPool.Initialize();
+  parallelRecorder.Initialize(frameRing.GetFrameCount(),
+                              [this]() { return CreateCommandContext(); });
+  // 既定ではハードウェアのスレッド数だけ使う（ワーカーの数＋1で頭打ち）
+  SetRecordThreadCount(std::thread::hardware_concurrency());
+}
+
+uint32_t DirectXCommon::CreateCommandContext() {
+  CommandContext context;
+  HRESULT hr = device->CreateCommandAllocator(
+      D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&context.allocator));
+  assert(SUCCEEDED(hr));
+  hr = device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT,
+                                 context.allocator.Get(), nullptr,
+                                 IID_PPV_ARGS(&context.commandList));
+  assert(SUCCEEDED(hr));
+  // 記録を始めるときにResetするので閉じておく
+  hr = context.commandList->Close();
+  assert(SUCCEEDED(hr));
+
+  commandContexts.push_back(context);
+  return static_cast<uint32_t>(commandContexts.size() - 1);
+}
+
+void DirectXCommon::CommandContextBackend::Begin(uint32_t contextIndex) {
+  // 同じスロットの前回分はGPUが使い終わっている
+  CommandContext &context = dxCommon->commandContexts[contextIndex];
+  HRESULT hr = context.allocator->Reset();
+  assert(SUCCEEDED(hr));
+  hr = context.commandList->Reset(context.allocator.Get(), nullptr);
+  assert(SUCCEEDED(hr));
+  dxCommon->SetupRenderTarget(context.commandList.Get());
+}
+
+void DirectXCommon::CommandContextBackend::End(uint32_t contextIndex) {
+  HRESULT hr = dxCommon->commandContexts[contextIndex].commandList->Close();
+  assert(SUCCEEDED(hr));
+}
+
+void DirectXCommon::CommandContextBackend::ExecuteCommandLists(
+    const uint32_t *contextIndices, uint32_t count) {
+  std::vector<ID3D12CommandList *> commandLists;
+  commandLists.reserve(count + 1);
+  commandLists.push_back(dxCommon->commandList.Get());
+  for (uint32_t i = 0; i < count; ++i) {
+    commandLists.push_back(
+        dxCommon->commandContexts[contextIndices[i]].commandList.Get());
+  }
+  dxCommon->commandQueue->ExecuteCommandLists(
+      static_cast<UINT>(commandLists.size()), commandLists.data());
+}
+
+void DirectXCommon::CreateCopyCommandQueue() {
+  HRESULT hr;
+
+  // テクスチャの転送は描画と別のコピーキューで行う
+  D3D12_COMMAND_QUEUE_DESC commandQueueDesc{};
+  commandQueueDesc.Type = D3D12_COMMAND_LIST_TYPE_COPY;
+  hr = device->CreateCommandQueue(&commandQueueDesc,
+                                  IID_PPV_ARGS(&copyCommandQueue));
+  assert(SUCCEEDED(hr));
+
+  // 転送を続けて積んでも前回分の完了を待たずに済むよう、アロケータを複数持つ
+  for (Microsoft::WRL::ComPtr<ID3D12CommandAllocator> &allocator :
+       copyCommandAllocators) {
+    hr = device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_COPY,
+                                        IID_PPV_ARGS(&allocator));
+    assert(SUCCEEDED(hr));
+  }
+  copyRing.Initialize(kCopyAllocatorCount);
+
+  hr = device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_COPY,
+                                 copyCommandAllocators[0].Get(), nullptr,
+                                 IID_PPV_ARGS(&copyCommandList));
+  assert(SUCCEEDED(hr));
+  // 転送を積むときに開き直すので、閉じておく
+  hr = copyCommandList->Close();
+  assert(SUCCEEDED(hr));
+
+  hr = device->CreateFence(copyRing.GetLastFenceValue(),
+                           D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&copyFence));
+  assert(SUCCEEDED(hr));
 }
 
 void DirectXCommon::CreateSwapChain() {
@@ -217,6 +390,8 @@ void DirectXCommon::CreateDepthBuffer() {
       &depthClearValue,                 // Clear最適値
       IID_PPV_ARGS(&depthStencilResource));
   assert(SUCCEEDED(hr));
+  stateTracker.Register(depthStencilResource.Get(), 1,
+                        D3D12_RESOURCE_STATE_DEPTH_WRITE);
 }
 
 void DirectXCommon::CreateDescriptorHeapRTVDSV() {
@@ -231,9 +406,11 @@ void DirectXCommon::CreateDescriptorHeapRTVDSV() {
   rtvDescriptorHeap =
       CreateDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_RTV, 2, false);
 
-  // SRV用のヒープでデイスクリプタの数は128。SRVはShader内で触るものなので、ShaderVIsibleはture
+  // SRV用のヒープ。SRVはShader内で触るものなので、ShaderVIsibleはture
+  descriptorAllocator.Initialize(kMaxSRVCount, frameRing.GetFrameCount());
   srvDescriptorHeap =
-      CreateDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, kMaxSRVCount, true);
+      CreateDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV,
+                           descriptorAllocator.GetHeapSize(), true);
 }
 
 Microsoft::WRL::ComPtr<ID3D12DescriptorHeap>
@@ -261,6 +438,10 @@ void DirectXCommon::CreateRenderTargetViews() {
   assert(SUCCEEDED(hr));
   hr = swapChain->GetBuffer(1, IID_PPV_ARGS(&swapChainResources[1]));
   assert(SUCCEEDED(hr));
+  // バックバッファはPresentの状態から始まる
+  for (const ComPtr<ID3D12Resource> &resource : swapChainResources) {
+    stateTracker.Register(resource.Get(), 1, D3D12_RESOURCE_STATE_PRESENT);
+  }
 
   rtvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
   rtvDesc.ViewDimension = D3D12_RTV_DIMENSION_TEXTURE2D;
@@ -292,6 +473,16 @@ DirectXCommon::GetSRVGPUDescriptorHandle(uint32_t index) {
   return GetGPUDescriptorHandle(srvDescriptorHeap, descriptorSizeSRV, index);
 }
 
+D3D12_CPU_DESCRIPTOR_HANDLE
+DirectXCommon::GetSRVCPUDescriptorHandle(DescriptorHandle handle) {
+  return GetSRVCPUDescriptorHandle(descriptorAllocator.GetIndex(handle));
+}
+
+D3D12_GPU_DESCRIPTOR_HANDLE
+DirectXCommon::GetSRVGPUDescriptorHandle(DescriptorHandle handle) {
+  return GetSRVGPUDescriptorHandle(descriptorAllocator.GetIndex(handle));
+}
+
 void DirectXCommon::CreateDepthStencilView() {
 
   // DSVの設定
@@ -307,8 +498,8 @@ void DirectXCommon::CreateDepthStencilView() {
 void DirectXCommon::CreateFence() {
   HRESULT hr;
 
-  hr = device->CreateFence(fenceValue, D3D12_FENCE_FLAG_NONE,
-                           IID_PPV_ARGS(&fence));
+  hr = device->CreateFence(frameRing.GetLastFenceValue(),
+                           D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence));
   assert(SUCCEEDED(hr));
 
   // FenceのSignalを待つためのイベントを作成する
@@ -316,6 +507,81 @@ void DirectXCommon::CreateFence() {
   assert(fenceEvent != nullptr);
 }
 
+void DirectXCommon::CreateProfiler() {
+  HRESULT hr;
+
+  profiler.Initialize(frameRing.GetFrameCount(), kMaxProfileScopes);
+
+  // フレームスロットごとに別の範囲へ書き込むので、スロット数分まとめて作る
+  D3D12_QUERY_HEAP_DESC queryHeapDesc{};
+  queryHeapDesc.Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+  queryHeapDesc.Count = profiler.GetTimestampCount();
+  hr = device->CreateQueryHeap(&queryHeapDesc,
+                               IID_PPV_ARGS(&timestampQueryHeap));
+  assert(SUCCEEDED(hr));
+
+  // 読み出し先はCPUから読めるReadbackヒープ
+  D3D12_HEAP_PROPERTIES heapProperties{};
+  heapProperties.Type = D3D12_HEAP_TYPE_READBACK;
+  D3D12_RESOURCE_DESC resourceDesc{};
+  resourceDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+  resourceDesc.Width = sizeof(uint64_t) * profiler.GetTimestampCount();
+  resourceDesc.Height = 1;
+  resourceDesc.DepthOrArraySize = 1;
+  resourceDesc.MipLevels = 1;
+  resourceDesc.SampleDesc.Count = 1;
+  resourceDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+  hr = device->CreateCommittedResource(
+      &heapProperties, D3D12_HEAP_FLAG_NONE, &resourceDesc,
+      D3D12_RESOURCE_STATE_COPY_DEST, nullptr,
+      IID_PPV_ARGS(&timestampReadback));
+  assert(SUCCEEDED(hr));
+  // 読むのは書き込みの終わったスロットの範囲だけなので、Mapしたままにする
+  hr = timestampReadback->Map(0, nullptr,
+                              reinterpret_cast<void **>(&timestampData));
+  assert(SUCCEEDED(hr));
+
+  hr = commandQueue->GetTimestampFrequency(&timestampFrequency);
+  assert(SUCCEEDED(hr));
+  LARGE_INTEGER frequency;
+  QueryPerformanceFrequency(&frequency);
+  cpuTimestampFrequency = static_cast<uint64_t>(frequency.QuadPart);
+
+  // 最初のフレームのコマンドリストは作った時点で開いている
+  BeginProfileFrame();
+}
+
+void DirectXCommon::BeginProfileFrame() {
+  profiler.BeginFrame(GetFrameIndex(), GetCpuTimestamp());
+  frameProfileScope = BeginProfileScope("Frame");
+}
+
+uint32_t DirectXCommon::BeginProfileScope(const char *name) {
+  TimestampRecorder recorder{currentCommandList, timestampQueryHeap.Get()};
+  return profiler.BeginScope(recorder, name, GetCpuTimestamp());
+}
+
+void DirectXCommon::EndProfileScope(uint32_t scope) {
+  TimestampRecorder recorder{currentCommandList, timestampQueryHeap.Get()};
+  profiler.EndScope(recorder, scope, GetCpuTimestamp());
+}
+
+void DirectXCommon::InitializeUploadAllocator() {
+  // ページが足りなくなったらアップロードバッファを作ってMapしたまま渡す
+  uploadAllocator.Initialize(
+      frameRing.GetFrameCount(), kUploadPageSize, [this](size_t sizeInBytes) {
+        Microsoft::WRL::ComPtr<ID3D12Resource> resource =
+            CreateBufferResource(sizeInBytes);
+        UploadRingAllocator::Page page;
+        resource->Map(0, nullptr, reinterpret_cast<void **>(&page.cpuBase));
+        page.gpuBase = resource->GetGPUVirtualAddress();
+        page.size = sizeInBytes;
+        uploadPages.push_back(resource);
+        return page;
+      });
+  uploadAllocator.BeginFrame(GetFrameIndex(), fence->GetCompletedValue());
+}
+
 void DirectXCommon::InitializeViewport() {
   // ビューボート
 
@@ -355,33 +621,25 @@ void DirectXCommon::InitializeImGui() {
   ImGui::CreateContext();
   ImGui::StyleColorsDark();
   ImGui_ImplWin32_Init(winApp->GetHwnd());
-  ImGui_ImplDX12_Init(device.Get(), swapChainDesc.BufferCount, rtvDesc.Format,
+  // フォントテクスチャのSRVも他と同じく確保する
+  imguiSrvHandle = descriptorAllocator.Allocate();
+  ImGui_ImplDX12_Init(device.Get(), frameRing.GetFrameCount(), rtvDesc.Format,
                       srvDescriptorHeap.Get(),
-                      srvDescriptorHeap->GetCPUDescriptorHandleForHeapStart(),
-                      srvDescriptorHeap->GetGPUDescriptorHandleForHeapStart());
+                      GetSRVCPUDescriptorHandle(imguiSrvHandle),
+                      GetSRVGPUDescriptorHandle(imguiSrvHandle));
 }
 
 void DirectXCommon::PreDraw() {
 
+  uint32_t clearScope = BeginProfileScope("Clear");
+
   // これから書き込むバックバッファのインデックスを取得
-  UINT backBufferIndex = swapChain->GetCurrentBackBufferIndex();
-
-  // 今回のバリアはTransition
-  barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-  // Noneにしておく
-  barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
-  // バリアを張る対象のリソース。現在のバックバッファに対して行う
-  barrier.Transition.pResource = swapChainResources[backBufferIndex].Get();
-  // 遷移前（現在）のResourceState
-  barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_PRESENT;
-  // 遷移後のResourceState
-  barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_RENDER_TARGET;
-  // TransitionBarrierを張る
-  commandList->ResourceBarrier(1, &barrier);
-
-  // 描画先のRTVとDSVを設定する
-  D3D12_CPU_DESCRIPTOR_HANDLE dsvHandle =
-      GetCPUDescriptorHandle(dsvDescriptorHeap, descriptorSizeDSV, 0);
+  backBufferIndex = swapChain->GetCurrentBackBufferIndex();
+
+  // 現在のバックバッファを描画先にする（遷移前の状態はトラッカーが覚えている）
+  stateTracker.Transition(swapChainResources[backBufferIndex].Get(),
+                          D3D12_RESOURCE_STATE_RENDER_TARGET);
+  FlushBarriers();
 
   // 描画先のRTVを設定する
   commandList->OMSetRenderTargets(1, &rtvHandles[backBufferIndex], false,
@@ -392,20 +650,72 @@ void DirectXCommon::PreDraw() {
   commandList->ClearRenderTargetView(rtvHandles[backBufferIndex], clearColor, 0,
                                      nullptr);
 
-  commandList->OMSetRenderTargets(1, &rtvHandles[backBufferIndex], false,
-                                  &dsvHandle);
-
   // 指定した深度で画面全体をクリアする
+  D3D12_CPU_DESCRIPTOR_HANDLE dsvHandle =
+      GetCPUDescriptorHandle(dsvDescriptorHeap, descriptorSizeDSV, 0);
   commandList->ClearDepthStencilView(dsvHandle, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0,
                                      0, nullptr);
 
+  SetupRenderTarget(commandList.Get());
+
+  EndProfileScope(clearScope);
+}
+
+void DirectXCommon::SetupRenderTarget(ID3D12GraphicsCommandList *targetList) {
+  // 記録スレッドからも呼ばれるので、スワップチェーンには触らない
+  D3D12_CPU_DESCRIPTOR_HANDLE dsvHandle =
+      GetCPUDescriptorHandle(dsvDescriptorHeap, descriptorSizeDSV, 0);
+  targetList->OMSetRenderTargets(1, &rtvHandles[backBufferIndex], false,
+                                 &dsvHandle);
+
   // 描画用のDescriptorHeapの設定
   ID3D12DescriptorHeap *descriptorHeaps[] = {srvDescriptorHeap.Get()};
-  commandList->SetDescriptorHeaps(1, descriptorHeaps);
+  targetList->SetDescriptorHeaps(1, descriptorHeaps);
 
   // コマンドを積む
-  commandList->RSSetViewports(1, &viewport);       // Viewportを設定
-  commandList->RSSetScissorRects(1, &scissorRect); // Scissorを設定
+  targetList->RSSetViewports(1, &viewport);       // Viewportを設定
+  targetList->RSSetScissorRects(1, &scissorRect); // Scissorを設定
+}
+
+void DirectXCommon::RecordParallel(uint32_t count, uint32_t minCountPerList,
+                                   const RecordFunc &record) {
+  std::vector<ParallelCommandRecorder::Chunk> chunks =
+      ParallelCommandRecorder::Partition(count, recordThreadCount,
+                                         minCountPerList);
+  // 分けるほどの量が無ければ今のコマンドリストにそのまま積む
+  if (chunks.size() <= 1) {
+    if (count > 0) {
+      record(currentCommandList, 0, count);
+    }
+    return;
+  }
+
+  // ここまでの分は閉じて先に提出する側に回す。溜まったバリアも出しておく
+  FlushBarriers();
+  HRESULT hr = currentCommandList->Close();
+  assert(SUCCEEDED(hr));
+
+  CommandContextBackend backend{this};
+  parallelRecorder.Record(
+      &recordThreadPool, chunks, backend,
+      [&](uint32_t contextIndex, const ParallelCommandRecorder::Chunk &chunk) {
+        record(commandContexts[contextIndex].commandList.Get(), chunk.first,
+               chunk.count);
+      });
+
+  // 続きは新しいコマンドリストに積む
+  uint32_t contextIndex = parallelRecorder.Acquire();
+  backend.Begin(contextIndex);
+  currentCommandList = commandContexts[contextIndex].commandList.Get();
+}
+
+void DirectXCommon::SetRecordThreadCount(uint32_t threadCount) {
+  recordThreadCount = std::clamp(threadCount, 1u, GetMaxRecordThreadCount());
+}
+
+void DirectXCommon::FlushBarriers() {
+  CommandListBarrierRecorder recorder{currentCommandList};
+  stateTracker.Flush(recorder);
 }
 
 void DirectXCommon::PostDraw() {
@@ -413,53 +723,90 @@ void DirectXCommon::PostDraw() {
 
   UINT bbIndex = swapChain->GetCurrentBackBufferIndex();
 
+  // フレーム全体の計測を閉じ、このフレームのタイムスタンプを読み出し先へ送る
+  EndProfileScope(frameProfileScope);
+  uint32_t timestampOffset = profiler.GetFrameTimestampOffset();
+  currentCommandList->ResolveQueryData(
+      timestampQueryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, timestampOffset,
+      profiler.GetFrameTimestampCount(), timestampReadback.Get(),
+      sizeof(uint64_t) * timestampOffset);
+
   // 画面表示できるようにする
 
   // 画面に描く処理はすべて終わり、画面に映すので、状態を遷移
-  // 今回はRenderTargetからPresentにする
-  barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
-  barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_PRESENT;
-  // TransitionBarrierを張る
-  commandList->ResourceBarrier(1, &barrier);
+  // 今回はRenderTargetからPresentにする。描画中に溜まったバリアと一緒に出す
+  stateTracker.Transition(swapChainResources[bbIndex].Get(),
+                          D3D12_RESOURCE_STATE_PRESENT);
+  FlushBarriers();
 
   // CommandListを閉じる
 
   // コマンドリストの内容を確定させる。すべてのコマンドを積んでからCloseすること
-  hr = commandList->Close();
+  hr = currentCommandList->Close();
   assert(SUCCEEDED(hr));
 
   // コマンドをキックする
 
+  // このフレームで積んだテクスチャ転送を先に流し、描画キューに待たせる
+  FlushTextureUploads();
+
   // GPUにコマンドリストの実行を行わせる
-  ID3D12CommandList *commandLists[] = {commandList.Get()};
-  commandQueue->ExecuteCommandLists(1, commandLists);
+  // 並列に記録したリストも積んだ順に並べて1回で提出する
+  // GPUの時刻をCPUの時刻に換算できるよう、同じ瞬間の値を記録しておく
+  uint64_t gpuTimestamp = 0;
+  uint64_t cpuTimestamp = 0;
+  hr = commandQueue->GetClockCalibration(&gpuTimestamp, &cpuTimestamp);
+  assert(SUCCEEDED(hr));
+  profiler.SetCalibration(gpuTimestamp, cpuTimestamp);
+  CommandContextBackend backend{this};
+  parallelRecorder.Submit(backend);
+  submittedCommandListCount = 1 + parallelRecorder.GetUsedCount();
   // GPUとOSに画面の交換を行うよう通知する
   swapChain->Present(1, 0);
 
-  // GPUにSignalを送る
-
-  // Fenceの値を更新
-  fenceValue++;
-  // GPUがここまでたどり着いたときに、Fenceの値を指定した値に代入するようにSignalを送る
-  commandQueue->Signal(fence.Get(), fenceValue);
-
-  // Fenceの値が指定したSignal値にたどり着いているか確認する
-  // GetCompletedValueの初期値はFence作成時に渡した初期値
-  if (fence->GetCompletedValue() < fenceValue) {
-    // 指定したSignalにたどりついていないので、たどり着くまで待つようにイベントを設定する
-    fence->SetEventOnCompletion(fenceValue, fenceEvent);
-    // イベント待つ
-    WaitForSingleObject(fenceEvent, INFINITE);
-  }
+  // GPUにSignalを送って次のスロットへ進む
+  // 待つのは次に使うスロットの前回分が終わっていない時だけ
+  CommandQueueSignaler signaler{commandQueue.Get(), fence.Get()};
+  FenceWaiter waiter{fence.Get(), fenceEvent};
+  frameRing.EndFrame(signaler, waiter);
+
+  // 送り出したフレームのアップロード領域はそのフェンス値まで使用中
+  // 次のスロットは待ち終わっているので巻き戻して使える
+  uploadAllocator.EndFrame(frameRing.GetLastFenceValue());
+  uploadAllocator.BeginFrame(GetFrameIndex(), fence->GetCompletedValue());
+  // デスクリプタも同じく、次のスロットの解放待ちを片付ける
+  descriptorAllocator.BeginFrame(GetFrameIndex());
+  ReleaseRetiredResources();
+  // 並列記録用のコマンドリストも次のスロットの分を使い直す
+  parallelRecorder.BeginFrame(GetFrameIndex());
+  // 次のスロットの前回分のタイムスタンプは書き込みが終わっている
+  profiler.Collect(GetFrameIndex(),
+                   timestampData +
+                       profiler.GetSlotTimestampOffset(GetFrameIndex()),
+                   timestampFrequency, cpuTimestampFrequency);
 
   // FPS固定
   UpdateFixFPS();
 
   // 次のフレーム用のコマンドリストを準備
+  ID3D12CommandAllocator *commandAllocator =
+      commandAllocators[GetFrameIndex()].Get();
   hr = commandAllocator->Reset();
   assert(SUCCEEDED(hr));
-  hr = commandList->Reset(commandAllocator.Get(), nullptr);
+  hr = commandList->Reset(commandAllocator, nullptr);
   assert(SUCCEEDED(hr));
+  currentCommandList = commandList.Get();
+  BeginProfileFrame();
+}
+
+void DirectXCommon::WaitForGPU() {
+  // 描画キューは転送を待つので、描画の完了で転送も終わっている
+  FlushTextureUploads();
+  CommandQueueSignaler signaler{commandQueue.Get(), fence.Get()};
+  FenceWaiter waiter{fence.Get(), fenceEvent};
+  frameRing.Flush(signaler, waiter);
+  ReleaseStagingBuffers();
+  ReleaseRetiredResources();
 }
 
 Microsoft::WRL::ComPtr<IDxcBlob>
@@ -566,22 +913,20 @@ DirectXCommon::CreateTextureResource(const DirectX::TexMetadata &metadata) {
   resourceDesc.SampleDesc.Count = 1;     // サンプリングカウント。１固定
   resourceDesc.Dimension = D3D12_RESOURCE_DIMENSION(
       metadata.dimension); // Textureの次元数。普段使っているのは２次元
-  // ２.利用するHeapの設定
+  // ２.利用するHeapの設定。GPUから一番速く読めるVRAMに置く
   D3D12_HEAP_PROPERTIES heapProperties{};
-  heapProperties.Type = D3D12_HEAP_TYPE_CUSTOM; // 細かい設定を行う
-  heapProperties.CPUPageProperty =
-      D3D12_CPU_PAGE_PROPERTY_WRITE_BACK; // WriteBackポリシーでCPUアクセス可能
-  heapProperties.MemoryPoolPreference =
-      D3D12_MEMORY_POOL_L0; // プロセッサの近くに配置
+  heapProperties.Type = D3D12_HEAP_TYPE_DEFAULT;
   // ３.Resourceを生成する
+  // COMMONで作ると、コピーキューではCOPY_DESTに、描画では
+  // PIXEL_SHADER_RESOURCEに暗黙で遷移するのでバリアが要らない
   Microsoft::WRL::ComPtr<ID3D12Resource> resource = nullptr;
   HRESULT hr = device->CreateCommittedResource(
-      &heapProperties,                   // Heapの設定
-      D3D12_HEAP_FLAG_NONE,              // Heapの特殊な設定。特になし
-      &resourceDesc,                     // Resourceの設定
-      D3D12_RESOURCE_STATE_GENERIC_READ, // 初回のResourceState。Textureは基本読むだけ
-      nullptr,                           // Clear最適値。使わないのでnullptr
-      IID_PPV_ARGS(&resource));          // 作成するResourceポインタへのポインタ
+      &heapProperties,              // Heapの設定
+      D3D12_HEAP_FLAG_NONE,         // Heapの特殊な設定。特になし
+      &resourceDesc,                // Resourceの設定
+      D3D12_RESOURCE_STATE_COMMON,  // 初回のResourceState
+      nullptr,                      // Clear最適値。使わないのでnullptr
+      IID_PPV_ARGS(&resource));     // 作成するResourceポインタへのポインタ
   assert(SUCCEEDED(hr));
   return resource;
 }
@@ -591,20 +936,149 @@ void DirectXCommon::UploadTextureData(
     const DirectX::ScratchImage &mipImages) {
   // Meta情報を取得
   const DirectX::TexMetadata &metadata = mipImages.GetMetadata();
-  // 全MipMapについて
-  for (size_t mipLevel = 0; mipLevel < metadata.mipLevels; ++mipLevel) {
-    // MipMapLevelを指定して各Imageを取得
-    const DirectX::Image *img = mipImages.GetImage(mipLevel, 0, 0);
-    // Textureに転送
-    HRESULT hr =
-        texture->WriteToSubresource(UINT(mipLevel),
-                                    nullptr,              // 全領域へコピー
-                                    img->pixels,          // 元データアドレス
-                                    UINT(img->rowPitch),  // １ラインサイズ
-                                    UINT(img->slicePitch) // １枚サイズ
-        );
-    assert(SUCCEEDED(hr));
+  uint32_t subresourceCount = UINT(metadata.mipLevels * metadata.arraySize);
+
+  // サブリソースの大きさを並べる（並びはD3D12のサブリソース番号の順）
+  bool isCompressed = DirectX::IsCompressed(metadata.format);
+  uint32_t bitsPerPixel = UINT(DirectX::BitsPerPixel(metadata.format));
+  std::vector<TextureStaging::SubresourceDesc> descs(subresourceCount);
+  for (size_t item = 0; item < metadata.arraySize; ++item) {
+    for (size_t mipLevel = 0; mipLevel < metadata.mipLevels; ++mipLevel) {
+      TextureStaging::SubresourceDesc &desc =
+          descs[item * metadata.mipLevels + mipLevel];
+      desc.width = (std::max)(1u, UINT(metadata.width) >> mipLevel);
+      desc.height = (std::max)(1u, UINT(metadata.height) >> mipLevel);
+      // BC圧縮は4x4ピクセルで1ブロック
+      desc.blockSize = isCompressed ? 4 : 1;
+      desc.bytesPerBlock = bitsPerPixel * desc.blockSize * desc.blockSize / 8;
+    }
+  }
+  std::vector<TextureStaging::Footprint> footprints(subresourceCount);
+  uint64_t stagingSize = TextureStaging::ComputeFootprints(
+      descs.data(), subresourceCount, 0, footprints.data());
+
+#ifdef _DEBUG
+  // D3D12の計算と同じ配置になっているか
+  D3D12_RESOURCE_DESC textureDesc = texture->GetDesc();
+  std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> layouts(subresourceCount);
+  std::vector<UINT> rowCounts(subresourceCount);
+  device->GetCopyableFootprints(&textureDesc, 0, subresourceCount, 0,
+                                layouts.data(), rowCounts.data(), nullptr,
+                                nullptr);
+  for (uint32_t i = 0; i < subresourceCount; ++i) {
+    assert(layouts[i].Offset == footprints[i].offset);
+    assert(layouts[i].Footprint.RowPitch == footprints[i].rowPitch);
+    assert(rowCounts[i] == footprints[i].rowCount);
+  }
+#endif
+
+  // ステージングバッファに全サブリソースを詰める
+  Microsoft::WRL::ComPtr<ID3D12Resource> stagingBuffer =
+      CreateBufferResource(size_t(stagingSize));
+  uint8_t *stagingData = nullptr;
+  HRESULT hr =
+      stagingBuffer->Map(0, nullptr, reinterpret_cast<void **>(&stagingData));
+  assert(SUCCEEDED(hr));
+  for (size_t item = 0; item < metadata.arraySize; ++item) {
+    for (size_t mipLevel = 0; mipLevel < metadata.mipLevels; ++mipLevel) {
+      const DirectX::Image *img = mipImages.GetImage(mipLevel, item, 0);
+      TextureStaging::PackSubresource(
+          stagingData, footprints[item * metadata.mipLevels + mipLevel],
+          img->pixels, img->rowPitch);
+    }
+  }
+  stagingBuffer->Unmap(0, nullptr);
+
+  // サブリソースごとにコピーを積む。実行はまとめてFlushTextureUploadsで
+  BeginCopyRecording();
+  for (uint32_t i = 0; i < subresourceCount; ++i) {
+    D3D12_TEXTURE_COPY_LOCATION destination{};
+    destination.pResource = texture.Get();
+    destination.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+    destination.SubresourceIndex = i;
+
+    D3D12_TEXTURE_COPY_LOCATION source{};
+    source.pResource = stagingBuffer.Get();
+    source.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+    source.PlacedFootprint.Offset = footprints[i].offset;
+    source.PlacedFootprint.Footprint.Format = metadata.format;
+    source.PlacedFootprint.Footprint.Width = footprints[i].width;
+    source.PlacedFootprint.Footprint.Height = footprints[i].height;
+    source.PlacedFootprint.Footprint.Depth = 1;
+    source.PlacedFootprint.Footprint.RowPitch = footprints[i].rowPitch;
+
+    copyCommandList->CopyTextureRegion(&destination, 0, 0, 0, &source,
+                                       nullptr);
   }
+  // 次にSignalする値まで使用中
+  stagingBuffers.push_back({stagingBuffer, copyRing.GetLastFenceValue() + 1});
+}
+
+void DirectXCommon::FlushTextureUploads() {
+  ReleaseStagingBuffers();
+  if (!isCopyRecording) {
+    return;
+  }
+
+  HRESULT hr = copyCommandList->Close();
+  assert(SUCCEEDED(hr));
+  ID3D12CommandList *commandLists[] = {copyCommandList.Get()};
+  copyCommandQueue->ExecuteCommandLists(1, commandLists);
+  // 使ったアロケータにフェンス値を紐づけて、次のアロケータへ進む
+  // 進んだ先を待つのは次にBeginCopyRecordingで使う時
+  uint64_t fenceValue = copyRing.IssueFenceValue();
+  copyCommandQueue->Signal(copyFence.Get(), fenceValue);
+  copyRing.Advance();
+  isCopyRecording = false;
+
+  // 描画キューは転送が終わるまでGPU上で待つ（CPUは待たない）
+  commandQueue->Wait(copyFence.Get(), fenceValue);
+}
+
+void DirectXCommon::BeginCopyRecording() {
+  if (isCopyRecording) {
+    return;
+  }
+  // このアロケータで前回積んだ転送が終わっていなければ待つ
+  // （アロケータの数より多く転送が重なった時だけ）
+  uint32_t allocatorIndex = copyRing.GetFrameIndex();
+  ID3D12CommandAllocator *allocator =
+      copyCommandAllocators[allocatorIndex].Get();
+  if (!copyRing.IsSlotReusable(allocatorIndex,
+                               copyFence->GetCompletedValue())) {
+    FenceWaiter waiter{copyFence.Get(), fenceEvent};
+    waiter.Wait(copyRing.GetSlotFenceValue(allocatorIndex));
+  }
+  HRESULT hr = allocator->Reset();
+  assert(SUCCEEDED(hr));
+  hr = copyCommandList->Reset(allocator, nullptr);
+  assert(SUCCEEDED(hr));
+  isCopyRecording = true;
+}
+
+void DirectXCommon::ReleaseStagingBuffers() {
+  uint64_t completedValue = copyFence->GetCompletedValue();
+  std::erase_if(stagingBuffers, [completedValue](const StagingBuffer &buffer) {
+    return buffer.fenceValue <= completedValue;
+  });
+}
+
+void DirectXCommon::ReleaseResource(
+    Microsoft::WRL::ComPtr<ID3D12Resource> resource) {
+  if (!resource) {
+    return;
+  }
+  // 今のフレームを送り出すときにSignalする値まで使用中
+  retiredResources.push_back(
+      {std::move(resource), frameRing.GetLastFenceValue() + 1});
+}
+
+void DirectXCommon::ReleaseRetiredResources() {
+  uint64_t completedValue = fence->GetCompletedValue();
+  std::erase_if(retiredResources,
+                [completedValue](const RetiredResource &retired) {
+                  return retired.fenceValue <= completedValue;
+                });
 }
 
 DirectX::ScratchImage DirectXCommon::LoadTexture(const std::string &filePath) {
@@ -1,6 +1,12 @@
 ﻿#pragma once
 #include "externals/DirectXTex/DirectXTex.h"
 #include "externals/DirectXTex/d3dx12.h"
+#include "DescriptorAllocator.h"
+#include "FrameRing.h"
+#include "GpuProfiler.h"
+#include "ParallelCommandRecorder.h"
+#include "ResourceStateTracker.h"
+#include "UploadRingAllocator.h"
 #include <Windows.h>
 #include <array>
 #include <chrono>
@@ -8,20 +14,24 @@
 #include <d3d12.h>
 #include <dxcapi.h>
 #include <dxgi1_6.h>
+#include <functional>
 #include <string>
+#include <vector>
 #include <wrl.h>
 
 class WinApp;
 
 class DirectXCommon {
 public:
-  // 初期化処理
-  void Initialize(WinApp *winApp);
+  // 初期化処理。frameCountは同時に積んでおけるフレーム数（1～kMaxFramesInFlight）
+  void Initialize(WinApp *winApp, uint32_t frameCount = kDefaultFramesInFlight);
 
   void CreateDevice();
 
   void CreateCommandQueue();
 
+  void CreateCopyCommandQueue();
+
   void CreateSwapChain();
 
   void CreateDepthBuffer();
@@ -38,11 +48,27 @@ public:
   D3D12_CPU_DESCRIPTOR_HANDLE GetSRVCPUDescriptorHandle(uint32_t index);
   // SRVの指定指定番号のGPUデスクリプタハンドルを取得する
   D3D12_GPU_DESCRIPTOR_HANDLE GetSRVGPUDescriptorHandle(uint32_t index);
+  // 確保したSRVのCPU/GPUデスクリプタハンドルを取得する（解放済みならassert）
+  D3D12_CPU_DESCRIPTOR_HANDLE GetSRVCPUDescriptorHandle(DescriptorHandle handle);
+  D3D12_GPU_DESCRIPTOR_HANDLE GetSRVGPUDescriptorHandle(DescriptorHandle handle);
+
+  // SRVを1つ確保する。解放するまで番号は変わらない
+  DescriptorHandle AllocateSRV() { return descriptorAllocator.Allocate(); }
+  // SRVを解放する。GPUが使い終わるまで番号は再利用されない
+  void FreeSRV(DescriptorHandle handle) { descriptorAllocator.Free(handle); }
+  // リソースを手放す。今記録しているフレームまでのコマンドが参照していても
+  // よく、GPUが使い終わってから解放される
+  void ReleaseResource(Microsoft::WRL::ComPtr<ID3D12Resource> resource);
+  const DescriptorAllocator &GetDescriptorAllocator() const {
+    return descriptorAllocator;
+  }
 
   void CreateDepthStencilView();
 
   void CreateFence();
 
+  void CreateProfiler();
+
   void InitializeViewport();
 
   void InitializeScissorRect();
@@ -56,11 +82,61 @@ public:
   // 描画後処理
   void PostDraw();
 
+  // GPUの処理が全て終わるまで待つ（終了処理の前に呼ぶ）
+  void WaitForGPU();
+
+  // 同時に積んでおけるフレーム数
+  uint32_t GetFrameCount() const { return frameRing.GetFrameCount(); }
+  // 現在記録中のフレームスロット
+  uint32_t GetFrameIndex() const { return frameRing.GetFrameIndex(); }
+
+  // このフレームだけ使うアップロード領域を切り出す（定数・動的な頂点など）
+  // 次に同じスロットを使うフレームの開始時にまとめて解放される
+  UploadAllocation AllocateUpload(
+      size_t sizeInBytes,
+      size_t alignment = UploadRingAllocator::kDefaultAlignment) {
+    return uploadAllocator.Allocate(sizeInBytes, alignment);
+  }
+
   ID3D12Device *GetDevice() const { return device.Get(); }
 
+  // 今記録しているコマンドリスト（RecordParallelの後は続きを積むリストに替わる）
   ID3D12GraphicsCommandList *GetCommandList() const {
-    return commandList.Get();
+    return currentCommandList;
+  }
+
+  // 並列記録で範囲ごとに呼ばれる処理。(コマンドリスト, 先頭, 個数)
+  using RecordFunc =
+      std::function<void(ID3D12GraphicsCommandList *, uint32_t, uint32_t)>;
+  // count個の描画を記録スレッド数の分だけ別のコマンドリストに分けて並列に記録する
+  // 描画先・デスクリプタヒープ・ビューポートは設定済みで渡すので、
+  // ルートシグネチャ以降の設定はrecordの中で行うこと
+  // 記録したリストはPostDrawで積んだ順に1回で提出する
+  void RecordParallel(uint32_t count, uint32_t minCountPerList,
+                      const RecordFunc &record);
+  // 並列に記録するスレッド数（呼んだスレッドを含む。1なら分けずに記録する）
+  // 既定はハードウェアのスレッド数。Settingsパネルからも変えられる
+  void SetRecordThreadCount(uint32_t threadCount);
+  uint32_t GetRecordThreadCount() const { return recordThreadCount; }
+  // 設定できる記録スレッド数の上限
+  uint32_t GetMaxRecordThreadCount() const {
+    return recordThreadPool.GetThreadCount() + 1;
   }
+  // 直近のPostDrawで提出したコマンドリストの数
+  uint32_t GetCommandListCount() const { return submittedCommandListCount; }
+
+  // 名前付き区間の計測を始める。戻り値をEndProfileScopeに渡す
+  // GPUの時刻は今記録しているコマンドリストにタイムスタンプを積んで測る
+  // nameは文字列リテラルなど、結果を読むまで残るものを渡す
+  uint32_t BeginProfileScope(const char *name);
+  void EndProfileScope(uint32_t scope);
+  // 区間ごとの計測結果（フレームスロットの数だけ遅れて届く）
+  const GpuProfiler &GetProfiler() const { return profiler; }
+
+  // リソースの状態の記録。Transitionで要求したバリアはFlushBarriersでまとめて出す
+  ResourceStateTracker &GetStateTracker() { return stateTracker; }
+  // 溜めたバリアを1回のResourceBarrierで出す
+  void FlushBarriers();
 
   // シェーダ－コンパイル----------------------------------
   Microsoft::WRL::ComPtr<IDxcBlob> CompileShader(const std::wstring &filePath,
@@ -72,14 +148,31 @@ public:
   Microsoft::WRL::ComPtr<ID3D12Resource>
   CreateTextureResource(const DirectX::TexMetadata &metadata);
 
+  // テクスチャへの転送をコピーキュー用のコマンドリストに積む
+  // 実行はFlushTextureUploads（PostDrawで自動で呼ばれる）
   void UploadTextureData(const Microsoft::WRL::ComPtr<ID3D12Resource> &texture,
                          const DirectX::ScratchImage &mipImages);
+  // 積んだテクスチャ転送をコピーキューで実行し、描画キューに完了を待たせる
+  void FlushTextureUploads();
 
   static DirectX::ScratchImage LoadTexture(const std::string &filePath);
 
-  // 最大SRV数（最大テクスチャ枚数）
+  // 最大SRV数（永続的に確保できる数。ImGuiと仮テクスチャを含む）
   static const uint32_t kMaxSRVCount;
 
+  // 1フレームで計測できる区間の数
+  static const uint32_t kMaxProfileScopes = 64;
+
+  // 同時に積んでおけるフレーム数の既定値と上限
+  static const uint32_t kDefaultFramesInFlight = 2;
+  static const uint32_t kMaxFramesInFlight = 3;
+
+  // フレームスロット1つ分のアップロードページの初期サイズ
+  static const size_t kUploadPageSize = 2 * 1024 * 1024;
+
+  // テクスチャ転送用のコマンドアロケータの数（転送を何回分重ねられるか）
+  static const uint32_t kCopyAllocatorCount = 3;
+
 private:
   // DirectX12デバイス
   Microsoft::WRL::ComPtr<ID3D12Device> device;
@@ -90,11 +183,92 @@ private:
   // コマンドキューを生成する
   Microsoft::WRL::ComPtr<ID3D12CommandQueue> commandQueue = nullptr;
 
-  // コマンドアロケータを生成する
-  Microsoft::WRL::ComPtr<ID3D12CommandAllocator> commandAllocator = nullptr;
+  // コマンドアロケータを生成する。フレームスロットごとに持つ
+  std::array<Microsoft::WRL::ComPtr<ID3D12CommandAllocator>, kMaxFramesInFlight>
+      commandAllocators;
 
   // コマンドリストを生成する
   Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList = nullptr;
+  // 今記録しているコマンドリスト（commandListか並列記録用のもの）
+  ID3D12GraphicsCommandList *currentCommandList = nullptr;
+
+  // 並列記録用のコマンドリストとアロケータ
+  struct CommandContext {
+    Microsoft::WRL::ComPtr<ID3D12CommandAllocator> allocator;
+    Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList;
+  };
+  // ParallelCommandRecorderからコマンドリストを開く・閉じる・提出する
+  struct CommandContextBackend {
+    DirectXCommon *dxCommon;
+
+    void Begin(uint32_t contextIndex);
+    void End(uint32_t contextIndex);
+    // メインのコマンドリストを先頭にして1回で提出する
+    void ExecuteCommandLists(const uint32_t *contextIndices, uint32_t count);
+  };
+  std::vector<CommandContext> commandContexts;
+  ParallelCommandRecorder parallelRecorder;
+  ThreadPool recordThreadPool;
+  uint32_t recordThreadCount = 1;
+  uint32_t submittedCommandListCount = 1;
+
+  void InitializeParallelRecording();
+
+  // GPUのタイムスタンプとCPUの時刻で区間を計測する
+  GpuProfiler profiler;
+  Microsoft::WRL::ComPtr<ID3D12QueryHeap> timestampQueryHeap;
+  // タイムスタンプの読み出し先（Mapしたまま持ち続ける）
+  Microsoft::WRL::ComPtr<ID3D12Resource> timestampReadback;
+  const uint64_t *timestampData = nullptr;
+  // 1秒あたりのタイムスタンプ・QueryPerformanceCounterの数
+  uint64_t timestampFrequency = 0;
+  uint64_t cpuTimestampFrequency = 0;
+  // フレーム全体の区間
+  uint32_t frameProfileScope = GpuProfiler::kInvalidScope;
+  // 今のフレームスロットで計測を始める（コマンドリストを開いた後に呼ぶ）
+  void BeginProfileFrame();
+  // 並列記録用のコマンドリストを作る（閉じた状態で返す）
+  uint32_t CreateCommandContext();
+  // 描画先・デスクリプタヒープ・ビューポートを設定する
+  void SetupRenderTarget(ID3D12GraphicsCommandList *targetList);
+
+  // テクスチャ転送用のコピーキューとコマンドリスト
+  // アロケータはリングで使い回し、同じアロケータに戻った時だけ前回分を待つ
+  Microsoft::WRL::ComPtr<ID3D12CommandQueue> copyCommandQueue = nullptr;
+  std::array<Microsoft::WRL::ComPtr<ID3D12CommandAllocator>,
+             kCopyAllocatorCount>
+      copyCommandAllocators;
+  Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> copyCommandList = nullptr;
+  // コピーキューの完了を知るフェンス
+  Microsoft::WRL::ComPtr<ID3D12Fence> copyFence = nullptr;
+  // アロケータごとの最後にSignalしたフェンス値（スロット＝アロケータ）
+  FrameRing copyRing;
+  // コピーを積んでいる途中か
+  bool isCopyRecording = false;
+
+  // 転送が終わるまで持っておくステージングバッファ
+  struct StagingBuffer {
+    Microsoft::WRL::ComPtr<ID3D12Resource> resource;
+    // このコピーフェンス値まで使用中
+    uint64_t fenceValue;
+  };
+  std::vector<StagingBuffer> stagingBuffers;
+
+  // GPUが使い終わるまで持っておく、手放したリソース
+  struct RetiredResource {
+    Microsoft::WRL::ComPtr<ID3D12Resource> resource;
+    // この描画フェンス値まで使用中
+    uint64_t fenceValue;
+  };
+  std::vector<RetiredResource> retiredResources;
+
+  // コピー用のコマンドリストを開く
+  // （次のアロケータの前回分が終わっていなければ待つ）
+  void BeginCopyRecording();
+  // 転送の終わったステージングバッファを解放する
+  void ReleaseStagingBuffers();
+  // GPUが使い終わった、手放したリソースを解放する
+  void ReleaseRetiredResources();
 
   // スワップチェーンを生成する
   Microsoft::WRL::ComPtr<IDXGISwapChain4> swapChain = nullptr;
@@ -109,6 +283,11 @@ private:
   Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> srvDescriptorHeap;
   Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> dsvDescriptorHeap;
 
+  // SRVヒープの番号の割り当て
+  DescriptorAllocator descriptorAllocator;
+  // ImGuiのフォントテクスチャ用のSRV
+  DescriptorHandle imguiSrvHandle;
+
   // 指定番号のCPUデスクリプタハンドルを取得する
   static D3D12_CPU_DESCRIPTOR_HANDLE GetCPUDescriptorHandle(
       const Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> &descriptorHeap,
@@ -127,8 +306,15 @@ private:
 
   // 初期値0でFenceを作る
   Microsoft::WRL::ComPtr<ID3D12Fence> fence = nullptr;
-  // フェンス値
-  uint64_t fenceValue = 0;
+  // フレームスロットとフェンス値
+  FrameRing frameRing;
+
+  // フレームごとのアップロード領域
+  UploadRingAllocator uploadAllocator;
+  // アップロード領域のページ（Mapしたまま持ち続ける）
+  std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> uploadPages;
+
+  void InitializeUploadAllocator();
 
   HANDLE fenceEvent;
 
@@ -149,9 +335,11 @@ private:
 
   // RTVを2つ作るのでディスクリプタを2つ用意
   D3D12_CPU_DESCRIPTOR_HANDLE rtvHandles[2];
+  // このフレームで書き込むバックバッファ（PreDrawで取得）
+  UINT backBufferIndex = 0;
 
-  // TransitionBarrierの設定
-  D3D12_RESOURCE_BARRIER barrier{};
+  // リソースの状態とまだ出していないバリア
+  ResourceStateTracker stateTracker;
 
   ////FPS固定初期化
   void InitializeFixFPS();
@@ -0,0 +1,27 @@
+﻿#include "FrameRing.h"
+#include <cassert>
+
+void FrameRing::Initialize(uint32_t frameCount) {
+  assert(frameCount > 0);
+  slotFenceValues.assign(frameCount, 0);
+  lastFenceValue = 0;
+  frameIndex = 0;
+}
+
+uint64_t FrameRing::IssueFenceValue() {
+  // フェンス値は単調増加させ、今のスロットに紐づける
+  lastFenceValue++;
+  slotFenceValues[frameIndex] = lastFenceValue;
+  return lastFenceValue;
+}
+
+uint64_t FrameRing::Advance() {
+  frameIndex = (frameIndex + 1) % GetFrameCount();
+  // まだ一度も使っていないスロットは0なので待たない
+  return slotFenceValues[frameIndex];
+}
+
+bool FrameRing::IsSlotReusable(uint32_t slot, uint64_t completedValue) const {
+  assert(slot < GetFrameCount());
+  return slotFenceValues[slot] <= completedValue;
+}
@@ -0,0 +1,58 @@
+﻿#pragma once
+#include <cstdint>
+#include <vector>
+
+// フレームスロットとフェンス値の管理（D3D12に依存しない部分）
+// スロットごとに最後にSignalしたフェンス値を覚えておき、
+// そのスロットを再利用する直前だけGPUの完了を待つ
+class FrameRing {
+public:
+  // 初期化。frameCountは同時に積んでおけるフレーム数
+  void Initialize(uint32_t frameCount);
+
+  // 現在のフレームを送り出すときにSignalする値を発行する
+  uint64_t IssueFenceValue();
+
+  // 次のスロットへ進む。戻り値はそのスロットを使う前に待つべきフェンス値
+  uint64_t Advance();
+
+  // スロットが再利用できるか（GPUが使い終わっているか）
+  bool IsSlotReusable(uint32_t slot, uint64_t completedValue) const;
+  // スロットで最後にSignalしたフェンス値（再利用する前に待つ値）
+  uint64_t GetSlotFenceValue(uint32_t slot) const {
+    return slotFenceValues[slot];
+  }
+
+  // フレームの終わり。Signalして次のスロットへ進み、必要な分だけ待つ
+  // QueueはSignal(value)、FenceはGetCompletedValue()とWait(value)を持つこと
+  template <class Queue, class Fence> void EndFrame(Queue &queue, Fence &fence) {
+    queue.Signal(IssueFenceValue());
+    uint64_t waitValue = Advance();
+    if (fence.GetCompletedValue() < waitValue) {
+      fence.Wait(waitValue);
+    }
+  }
+
+  // GPUが全て終わるまで待つ
+  template <class Queue, class Fence> void Flush(Queue &queue, Fence &fence) {
+    uint64_t value = IssueFenceValue();
+    queue.Signal(value);
+    if (fence.GetCompletedValue() < value) {
+      fence.Wait(value);
+    }
+  }
+
+  uint32_t GetFrameCount() const {
+    return static_cast<uint32_t>(slotFenceValues.size());
+  }
+  uint32_t GetFrameIndex() const { return frameIndex; }
+  uint64_t GetLastFenceValue() const { return lastFenceValue; }
+
+private:
+  // スロットごとの最後にSignalしたフェンス値
+  std::vector<uint64_t> slotFenceValues;
+  // 最後に発行したフェンス値
+  uint64_t lastFenceValue = 0;
+  // 現在のスロット
+  uint32_t frameIndex = 0;
+};
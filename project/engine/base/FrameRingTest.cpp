@@ -0,0 +1,104 @@
+﻿#include "Check.h"
+#include "FrameRing.h"
+#include <deque>
+
+namespace {
+// GPUの代わり。Signalされた値を順に、指定した数だけ遅れて完了させる
+struct FakeGpu {
+  std::deque<uint64_t> pending;
+  uint64_t completedValue = 0;
+  // 完了させずに抱えておけるSignalの数（GPUの遅さ）
+  size_t lag = 0;
+  uint32_t waitCount = 0;
+
+  void Signal(uint64_t value) {
+    pending.push_back(value);
+    while (pending.size() > lag) {
+      Complete();
+    }
+  }
+  void Complete() {
+    completedValue = pending.front();
+    pending.pop_front();
+  }
+};
+
+struct FakeQueue {
+  FakeGpu *gpu;
+  void Signal(uint64_t value) { gpu->Signal(value); }
+};
+
+struct FakeFence {
+  FakeGpu *gpu;
+  uint64_t GetCompletedValue() const { return gpu->completedValue; }
+  void Wait(uint64_t value) {
+    // 待つと、その値まではGPUが進む
+    gpu->waitCount++;
+    while (gpu->completedValue < value) {
+      gpu->Complete();
+    }
+  }
+};
+
+// frameCount個のスロットをframes回まわし、使う直前のスロットが
+// GPUの完了済みであることを毎フレーム確かめる
+uint32_t RunFrames(uint32_t frameCount, size_t lag, uint32_t frames) {
+  FrameRing ring;
+  ring.Initialize(frameCount);
+  FakeGpu gpu;
+  gpu.lag = lag;
+  FakeQueue queue{&gpu};
+  FakeFence fence{&gpu};
+
+  for (uint32_t i = 0; i < frames; ++i) {
+    // 記録を始めるスロットは前回の分をGPUが使い終わっている
+    CHECK(ring.IsSlotReusable(ring.GetFrameIndex(), gpu.completedValue));
+    CHECK(ring.GetFrameIndex() == i % frameCount);
+    ring.EndFrame(queue, fence);
+  }
+  uint32_t waitCount = gpu.waitCount;
+
+  // Flushの後は全部終わっている
+  ring.Flush(queue, fence);
+  CHECK(gpu.completedValue == ring.GetLastFenceValue());
+  for (uint32_t slot = 0; slot < frameCount; ++slot) {
+    CHECK(ring.IsSlotReusable(slot, gpu.completedValue));
+  }
+  return waitCount;
+}
+
+void TestFenceValuesIncreasePerSlot() {
+  FrameRing ring;
+  ring.Initialize(3);
+  CHECK(ring.IssueFenceValue() == 1);
+  CHECK(ring.Advance() == 0); // 未使用のスロットは待たない
+  CHECK(ring.IssueFenceValue() == 2);
+  CHECK(ring.Advance() == 0);
+  CHECK(ring.IssueFenceValue() == 3);
+  // 一周してスロット0に戻ると、その前回分の値を待つ
+  CHECK(ring.Advance() == 1);
+  CHECK(!ring.IsSlotReusable(0, 0));
+  CHECK(ring.IsSlotReusable(0, 1));
+  CHECK(ring.GetSlotFenceValue(0) == 1);
+  CHECK(ring.GetSlotFenceValue(1) == 2);
+  CHECK(ring.GetSlotFenceValue(2) == 3);
+}
+
+void TestNoSlotReusedBeforeFence() {
+  // GPUが十分速ければ待たない
+  CHECK(RunFrames(2, 0, 100) == 0);
+  CHECK(RunFrames(3, 0, 100) == 0);
+  // スロット数より遅れが少なければ待たない
+  CHECK(RunFrames(3, 1, 100) == 0);
+  // 遅れがスロット数以上なら、毎フレーム待つことになる
+  CHECK(RunFrames(1, 1, 100) == 100);
+  CHECK(RunFrames(2, 4, 100) > 0);
+  CHECK(RunFrames(3, 8, 100) > 0);
+}
+} // namespace
+
+int main() {
+  TestFenceValuesIncreasePerSlot();
+  TestNoSlotReusedBeforeFence();
+  return Test::Finish();
+}
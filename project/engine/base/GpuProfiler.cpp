@@ -0,0 +1,141 @@
+﻿#include "GpuProfiler.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+void GpuProfiler::History::Add(double value) {
+  if (samples.size() < kHistoryCount) {
+    samples.push_back(value);
+    return;
+  }
+  // 埋まったら古いものから上書きする
+  samples[next] = value;
+  next = (next + 1) % kHistoryCount;
+}
+
+GpuProfiler::Statistics GpuProfiler::History::Compute() const {
+  Statistics statistics{};
+  if (samples.empty()) {
+    return statistics;
+  }
+  std::vector<double> sorted = samples;
+  std::sort(sorted.begin(), sorted.end());
+
+  double sum = 0.0;
+  for (double value : sorted) {
+    sum += value;
+  }
+  auto percentile = [&sorted](double ratio) {
+    size_t rank = static_cast<size_t>(std::ceil(ratio * sorted.size()));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+  };
+  statistics.min = sorted.front();
+  statistics.average = sum / sorted.size();
+  statistics.max = sorted.back();
+  statistics.median = percentile(0.5);
+  statistics.p95 = percentile(0.95);
+  statistics.p99 = percentile(0.99);
+  return statistics;
+}
+
+void GpuProfiler::Initialize(uint32_t frameCount, uint32_t maxScopesPerFrame) {
+  assert(frameCount > 0);
+  assert(maxScopesPerFrame > 0);
+  this->maxScopesPerFrame = maxScopesPerFrame;
+  slots.clear();
+  slots.resize(frameCount);
+  for (FrameSlot &slot : slots) {
+    slot.scopes.reserve(maxScopesPerFrame);
+  }
+  frameIndex = 0;
+  openScopes.clear();
+}
+
+void GpuProfiler::BeginFrame(uint32_t frameIndex, uint64_t cpuTimestamp) {
+  assert(frameIndex < slots.size());
+  // 前のフレームで閉じ忘れた区間がある
+  assert(openScopes.empty());
+  FrameSlot &slot = slots[frameIndex];
+  // 読んでいない結果を上書きしようとしている
+  assert(!slot.isPending);
+
+  this->frameIndex = frameIndex;
+  slot.scopes.clear();
+  slot.cpuFrameBegin = cpuTimestamp;
+  slot.calibrationGpu = 0;
+  slot.calibrationCpu = cpuTimestamp;
+  slot.isPending = true;
+}
+
+void GpuProfiler::SetCalibration(uint64_t gpuTimestamp, uint64_t cpuTimestamp) {
+  FrameSlot &slot = slots[frameIndex];
+  slot.calibrationGpu = gpuTimestamp;
+  slot.calibrationCpu = cpuTimestamp;
+}
+
+void GpuProfiler::Collect(uint32_t frameIndex, const uint64_t *timestamps,
+                          uint64_t gpuFrequency, uint64_t cpuFrequency) {
+  assert(frameIndex < slots.size());
+  FrameSlot &slot = slots[frameIndex];
+  if (!slot.isPending) {
+    return;
+  }
+  slot.isPending = false;
+
+  // 時刻はフレームのCPUの開始からのミリ秒にそろえる
+  double cpuToMs = 1000.0 / static_cast<double>(cpuFrequency);
+  double gpuToMs = 1000.0 / static_cast<double>(gpuFrequency);
+  auto cpuTime = [&](uint64_t timestamp) {
+    return static_cast<double>(static_cast<int64_t>(timestamp -
+                                                    slot.cpuFrameBegin)) *
+           cpuToMs;
+  };
+  // GPUの時刻は対応を取った瞬間からの差でCPUの時刻に換算する
+  double calibrationTime = cpuTime(slot.calibrationCpu);
+  auto gpuTime = [&](uint64_t timestamp) {
+    return calibrationTime +
+           static_cast<double>(
+               static_cast<int64_t>(timestamp - slot.calibrationGpu)) *
+               gpuToMs;
+  };
+
+  results.clear();
+  for (size_t i = 0; i < slot.scopes.size(); ++i) {
+    const ScopeRecord &record = slot.scopes[i];
+    uint64_t gpuBegin = timestamps[i * 2];
+    uint64_t gpuEnd = timestamps[i * 2 + 1];
+
+    ScopeResult result;
+    result.name = record.name;
+    result.depth = record.depth;
+    result.cpuBegin = cpuTime(record.cpuBegin);
+    result.cpuDuration =
+        static_cast<double>(record.cpuEnd - record.cpuBegin) * cpuToMs;
+    result.gpuBegin = gpuTime(gpuBegin);
+    result.gpuDuration =
+        gpuEnd > gpuBegin ? static_cast<double>(gpuEnd - gpuBegin) * gpuToMs
+                          : 0.0;
+    result.historyIndex = FindHistory(record.name);
+
+    ScopeHistory &history = histories[result.historyIndex];
+    history.cpu.Add(result.cpuDuration);
+    history.gpu.Add(result.gpuDuration);
+    results.push_back(result);
+  }
+}
+
+void GpuProfiler::PopScope(uint32_t scope) {
+  // 開いた順と逆に閉じていない
+  assert(!openScopes.empty() && openScopes.back() == scope);
+  (void)scope;
+  openScopes.pop_back();
+}
+
+uint32_t GpuProfiler::FindHistory(const char *name) {
+  auto [it, isInserted] = historyIndices.try_emplace(
+      name, static_cast<uint32_t>(histories.size()));
+  if (isInserted) {
+    histories.emplace_back();
+  }
+  return it->second;
+}
@@ -0,0 +1,161 @@
+﻿#pragma once
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// 名前付きの区間をGPUのタイムスタンプとCPUの時刻で計測する
+// （D3D12に依存しない部分）
+// 区間ごとにタイムスタンプを2つ（開始・終了）使い、フレームスロットごとに
+// 別の範囲へ書き込む。結果はそのスロットを次に使う前（GPUが終えた後）に読む
+class GpuProfiler {
+public:
+  // 統計（ミリ秒）
+  struct Statistics {
+    double min;
+    double average;
+    double max;
+    double median;
+    double p95;
+    double p99;
+  };
+
+  // 直近kHistoryCount個の値（ミリ秒）
+  class History {
+  public:
+    void Add(double value);
+    // 百分位は小さい方から数えた順位で取る（nearest-rank）
+    Statistics Compute() const;
+    size_t GetCount() const { return samples.size(); }
+
+  private:
+    std::vector<double> samples;
+    size_t next = 0;
+  };
+
+  // 計測した区間1つ分（時刻はフレームのCPUの開始からのミリ秒）
+  struct ScopeResult {
+    const char *name;
+    // 入れ子の深さ（一番外が0）
+    uint32_t depth;
+    double cpuBegin;
+    double cpuDuration;
+    // GPUの時刻はCPUの時刻に換算してある
+    double gpuBegin;
+    double gpuDuration;
+    // GetCpuHistory・GetGpuHistoryの番号
+    uint32_t historyIndex;
+  };
+
+  // 計測しない区間（1フレームの区間数を超えたとき）
+  static constexpr uint32_t kInvalidScope = UINT32_MAX;
+  // 統計に使うフレーム数
+  static constexpr uint32_t kHistoryCount = 240;
+
+  // 初期化。タイムスタンプは frameCount * maxScopesPerFrame * 2 個使う
+  void Initialize(uint32_t frameCount, uint32_t maxScopesPerFrame);
+
+  // frameIndexのスロットで計測を始める（そのスロットの前回分はCollect済みのこと）
+  void BeginFrame(uint32_t frameIndex, uint64_t cpuTimestamp);
+
+  // 区間の開始。nameは結果を読むまで残る文字列（リテラルなど）を渡す
+  // RecorderはEndQuery(uint32_t timestampIndex)を持つこと
+  template <class Recorder>
+  uint32_t BeginScope(Recorder &recorder, const char *name,
+                      uint64_t cpuTimestamp) {
+    FrameSlot &slot = slots[frameIndex];
+    if (slot.scopes.size() == maxScopesPerFrame) {
+      // 入りきらない区間は数えないが、入れ子の対応は崩さない
+      openScopes.push_back(kInvalidScope);
+      return kInvalidScope;
+    }
+    uint32_t scope = static_cast<uint32_t>(slot.scopes.size());
+    slot.scopes.push_back({name, static_cast<uint32_t>(openScopes.size()),
+                           cpuTimestamp, cpuTimestamp});
+    openScopes.push_back(scope);
+    recorder.EndQuery(GetTimestampIndex(scope, false));
+    return scope;
+  }
+
+  // 区間の終わり。入れ子の内側から順に閉じること
+  template <class Recorder>
+  void EndScope(Recorder &recorder, uint32_t scope, uint64_t cpuTimestamp) {
+    PopScope(scope);
+    if (scope == kInvalidScope) {
+      return;
+    }
+    slots[frameIndex].scopes[scope].cpuEnd = cpuTimestamp;
+    recorder.EndQuery(GetTimestampIndex(scope, true));
+  }
+
+  // GPUとCPUの時計の対応（同じ瞬間の値）。フレームを送り出す前に設定する
+  void SetCalibration(uint64_t gpuTimestamp, uint64_t cpuTimestamp);
+
+  // 今のフレームで書き込んだタイムスタンプの範囲（まとめて読み出す用）
+  uint32_t GetFrameTimestampOffset() const {
+    return GetSlotTimestampOffset(frameIndex);
+  }
+  uint32_t GetFrameTimestampCount() const {
+    return static_cast<uint32_t>(slots[frameIndex].scopes.size()) * 2;
+  }
+  // スロットの先頭のタイムスタンプ番号
+  uint32_t GetSlotTimestampOffset(uint32_t frameIndex) const {
+    return frameIndex * maxScopesPerFrame * 2;
+  }
+  // 使うタイムスタンプの総数
+  uint32_t GetTimestampCount() const {
+    return static_cast<uint32_t>(slots.size()) * maxScopesPerFrame * 2;
+  }
+
+  // frameIndexのスロットの結果を読む（GPUがそのスロットを使い終わってから）
+  // timestampsはスロットの先頭からのタイムスタンプ。周波数は1秒あたりの数
+  void Collect(uint32_t frameIndex, const uint64_t *timestamps,
+               uint64_t gpuFrequency, uint64_t cpuFrequency);
+
+  // 直近にCollectしたフレームの結果（開始した順）
+  const std::vector<ScopeResult> &GetResults() const { return results; }
+  const History &GetCpuHistory(uint32_t historyIndex) const {
+    return histories[historyIndex].cpu;
+  }
+  const History &GetGpuHistory(uint32_t historyIndex) const {
+    return histories[historyIndex].gpu;
+  }
+
+private:
+  // 記録中の区間（時刻は生の値）
+  struct ScopeRecord {
+    const char *name;
+    uint32_t depth;
+    uint64_t cpuBegin;
+    uint64_t cpuEnd;
+  };
+  struct FrameSlot {
+    std::vector<ScopeRecord> scopes;
+    uint64_t cpuFrameBegin = 0;
+    uint64_t calibrationGpu = 0;
+    uint64_t calibrationCpu = 0;
+    // 記録したがまだCollectしていない
+    bool isPending = false;
+  };
+  struct ScopeHistory {
+    History cpu;
+    History gpu;
+  };
+
+  uint32_t GetTimestampIndex(uint32_t scope, bool isEnd) const {
+    return GetFrameTimestampOffset() + scope * 2 + (isEnd ? 1 : 0);
+  }
+  void PopScope(uint32_t scope);
+  uint32_t FindHistory(const char *name);
+
+  std::vector<FrameSlot> slots;
+  uint32_t frameIndex = 0;
+  uint32_t maxScopesPerFrame = 0;
+  // 開いている区間（入れ子の外側から）
+  std::vector<uint32_t> openScopes;
+
+  std::vector<ScopeResult> results;
+  std::vector<ScopeHistory> histories;
+  // 区間の名前から履歴の番号を引く
+  std::unordered_map<std::string_view, uint32_t> historyIndices;
+};
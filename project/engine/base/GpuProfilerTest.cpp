@@ -0,0 +1,227 @@
+﻿#include "Check.h"
+#include "GpuProfiler.h"
+#include <string>
+#include <vector>
+
+namespace {
+// コマンドリストの代わり。EndQueryで書き込む番号を覚えておく
+struct FakeRecorder {
+  std::vector<uint32_t> queries;
+  void EndQuery(uint32_t timestampIndex) { queries.push_back(timestampIndex); }
+};
+
+// GPUは1秒に1000万（10MHz）、CPUは1秒に100万（1MHz）数える
+constexpr uint64_t kGpuFrequency = 10000000;
+constexpr uint64_t kCpuFrequency = 1000000;
+constexpr double kTolerance = 1e-9;
+
+// 書き込まれた番号に合わせて、スロットの先頭からのタイムスタンプを作る
+std::vector<uint64_t> MakeSlotTimestamps(const GpuProfiler &profiler,
+                                         uint32_t frameIndex,
+                                         const FakeRecorder &recorder,
+                                         const std::vector<uint64_t> &values) {
+  std::vector<uint64_t> timestamps(profiler.GetTimestampCount(), 0);
+  uint32_t offset = profiler.GetSlotTimestampOffset(frameIndex);
+  for (size_t i = 0; i < recorder.queries.size(); ++i) {
+    timestamps[recorder.queries[i] - offset] = values[i];
+  }
+  return timestamps;
+}
+
+// タイムスタンプの番号はスロットごとに別の範囲で、開始・終了の順に並ぶ
+void TestTimestampIndices() {
+  GpuProfiler profiler;
+  profiler.Initialize(3, 4);
+  CHECK(profiler.GetTimestampCount() == 24);
+  CHECK(profiler.GetSlotTimestampOffset(0) == 0);
+  CHECK(profiler.GetSlotTimestampOffset(1) == 8);
+  CHECK(profiler.GetSlotTimestampOffset(2) == 16);
+
+  FakeRecorder recorder;
+  profiler.BeginFrame(1, 0);
+  uint32_t outer = profiler.BeginScope(recorder, "Outer", 0);
+  uint32_t inner = profiler.BeginScope(recorder, "Inner", 0);
+  profiler.EndScope(recorder, inner, 0);
+  profiler.EndScope(recorder, outer, 0);
+  CHECK(outer == 0 && inner == 1);
+  CHECK(profiler.GetFrameTimestampOffset() == 8);
+  CHECK(profiler.GetFrameTimestampCount() == 4);
+  CHECK((recorder.queries == std::vector<uint32_t>{8, 10, 11, 9}));
+}
+
+// 合成したタイムスタンプから、区間の時刻と長さをミリ秒で出す
+void TestCollect() {
+  GpuProfiler profiler;
+  profiler.Initialize(2, 8);
+  FakeRecorder recorder;
+
+  // CPUはフレームの開始を5000とする（1MHzなので1目盛り1マイクロ秒）
+  profiler.BeginFrame(0, 5000);
+  uint32_t frame = profiler.BeginScope(recorder, "Frame", 5100);
+  uint32_t shadow = profiler.BeginScope(recorder, "Shadow", 5200);
+  profiler.EndScope(recorder, shadow, 5700);
+  uint32_t main = profiler.BeginScope(recorder, "Main", 5800);
+  profiler.EndScope(recorder, main, 6800);
+  profiler.EndScope(recorder, frame, 7000);
+  // GPUの1000000はCPUの6000と同じ瞬間
+  profiler.SetCalibration(1000000, 6000);
+
+  // GPUは開始から3ms後に始まり、Shadowに0.5ms、Mainに2ms
+  // 書き込み順：Frame開始, Shadow開始, Shadow終了, Main開始, Main終了, Frame終了
+  std::vector<uint64_t> timestamps = MakeSlotTimestamps(
+      profiler, 0, recorder,
+      {1020000, 1020000, 1025000, 1025000, 1045000, 1046000});
+  profiler.Collect(0, timestamps.data(), kGpuFrequency, kCpuFrequency);
+
+  const std::vector<GpuProfiler::ScopeResult> &results = profiler.GetResults();
+  CHECK(results.size() == 3);
+  if (results.size() != 3) {
+    return;
+  }
+  // 開始した順で、入れ子の深さが付く
+  CHECK(std::string(results[0].name) == "Frame" && results[0].depth == 0);
+  CHECK(std::string(results[1].name) == "Shadow" && results[1].depth == 1);
+  CHECK(std::string(results[2].name) == "Main" && results[2].depth == 1);
+
+  CHECK_NEAR(results[0].cpuBegin, 0.1, kTolerance);
+  CHECK_NEAR(results[0].cpuDuration, 1.9, kTolerance);
+  CHECK_NEAR(results[1].cpuBegin, 0.2, kTolerance);
+  CHECK_NEAR(results[1].cpuDuration, 0.5, kTolerance);
+  CHECK_NEAR(results[2].cpuDuration, 1.0, kTolerance);
+
+  // GPUの時刻は対応を取った瞬間（CPUで1ms）からの差で換算する
+  CHECK_NEAR(results[0].gpuBegin, 3.0, kTolerance);
+  CHECK_NEAR(results[0].gpuDuration, 2.6, kTolerance);
+  CHECK_NEAR(results[1].gpuBegin, 3.0, kTolerance);
+  CHECK_NEAR(results[1].gpuDuration, 0.5, kTolerance);
+  CHECK_NEAR(results[2].gpuBegin, 3.5, kTolerance);
+  CHECK_NEAR(results[2].gpuDuration, 2.0, kTolerance);
+
+  // 対応を取った瞬間より前のGPUの時刻は負になる
+  profiler.BeginFrame(1, 10000);
+  recorder = {};
+  uint32_t early = profiler.BeginScope(recorder, "Early", 10000);
+  profiler.EndScope(recorder, early, 10100);
+  profiler.SetCalibration(2000000, 12000);
+  timestamps = MakeSlotTimestamps(profiler, 1, recorder, {1990000, 1995000});
+  profiler.Collect(1, timestamps.data(), kGpuFrequency, kCpuFrequency);
+  CHECK(profiler.GetResults().size() == 1);
+  CHECK_NEAR(profiler.GetResults()[0].gpuBegin, 1.0, kTolerance);
+  CHECK_NEAR(profiler.GetResults()[0].gpuDuration, 0.5, kTolerance);
+
+  // 終了が開始より前（未完了など）なら長さは0
+  profiler.BeginFrame(0, 0);
+  recorder = {};
+  uint32_t broken = profiler.BeginScope(recorder, "Broken", 0);
+  profiler.EndScope(recorder, broken, 10);
+  timestamps = MakeSlotTimestamps(profiler, 0, recorder, {500, 100});
+  profiler.Collect(0, timestamps.data(), kGpuFrequency, kCpuFrequency);
+  CHECK(profiler.GetResults()[0].gpuDuration == 0.0);
+
+  // 読み終えたスロットをもう一度Collectしても結果は変わらない
+  timestamps.assign(timestamps.size(), 0);
+  profiler.Collect(0, timestamps.data(), kGpuFrequency, kCpuFrequency);
+  CHECK(profiler.GetResults().size() == 1);
+  CHECK(std::string(profiler.GetResults()[0].name) == "Broken");
+}
+
+// 1フレームの区間数を超えた分は数えないが、入れ子は崩さない
+void TestScopeOverflow() {
+  GpuProfiler profiler;
+  profiler.Initialize(1, 2);
+  FakeRecorder recorder;
+
+  profiler.BeginFrame(0, 0);
+  uint32_t a = profiler.BeginScope(recorder, "A", 0);
+  uint32_t b = profiler.BeginScope(recorder, "B", 10);
+  uint32_t c = profiler.BeginScope(recorder, "C", 20);
+  profiler.EndScope(recorder, c, 30);
+  profiler.EndScope(recorder, b, 40);
+  uint32_t d = profiler.BeginScope(recorder, "D", 50);
+  profiler.EndScope(recorder, d, 60);
+  profiler.EndScope(recorder, a, 70);
+  CHECK(a == 0 && b == 1);
+  CHECK(c == GpuProfiler::kInvalidScope && d == GpuProfiler::kInvalidScope);
+  CHECK(recorder.queries.size() == 4);
+  CHECK(profiler.GetFrameTimestampCount() == 4);
+
+  std::vector<uint64_t> timestamps =
+      MakeSlotTimestamps(profiler, 0, recorder, {0, 100, 200, 300});
+  profiler.Collect(0, timestamps.data(), kGpuFrequency, kCpuFrequency);
+  CHECK(profiler.GetResults().size() == 2);
+
+  // 次のフレームも同じように始められる（開いた区間が残っていない）
+  profiler.BeginFrame(0, 100);
+  recorder = {};
+  uint32_t e = profiler.BeginScope(recorder, "E", 100);
+  profiler.EndScope(recorder, e, 110);
+  CHECK(e == 0);
+}
+
+// 同じ名前の区間は同じ履歴に溜まり、統計は直近kHistoryCount個から出す
+void TestHistory() {
+  GpuProfiler profiler;
+  profiler.Initialize(2, 4);
+
+  // 名前は文字列の中身で比べる（ポインタが違っても同じ履歴）
+  std::string pass = "Pass";
+  const uint32_t kFrameCount = GpuProfiler::kHistoryCount + 10;
+  uint32_t historyIndex = 0;
+  bool isSameHistory = true;
+  for (uint32_t frame = 0; frame < kFrameCount; ++frame) {
+    uint32_t slot = frame % 2;
+    FakeRecorder recorder;
+    profiler.BeginFrame(slot, 0);
+    const char *name = (frame % 3 == 0) ? "Pass" : pass.c_str();
+    uint32_t scope = profiler.BeginScope(recorder, name, 0);
+    // CPUは(frame+1)マイクロ秒、GPUは(frame+1)*2マイクロ秒
+    profiler.EndScope(recorder, scope, frame + 1);
+    std::vector<uint64_t> timestamps =
+        MakeSlotTimestamps(profiler, slot, recorder, {0, (frame + 1) * 20});
+    profiler.Collect(slot, timestamps.data(), kGpuFrequency, kCpuFrequency);
+    if (frame == 0) {
+      historyIndex = profiler.GetResults()[0].historyIndex;
+    }
+    isSameHistory =
+        isSameHistory && profiler.GetResults()[0].historyIndex == historyIndex;
+  }
+  CHECK(isSameHistory);
+
+  // 古い10フレーム分は上書きされ、11〜250マイクロ秒が残る
+  const GpuProfiler::History &cpu = profiler.GetCpuHistory(historyIndex);
+  CHECK(cpu.GetCount() == GpuProfiler::kHistoryCount);
+  GpuProfiler::Statistics statistics = cpu.Compute();
+  CHECK_NEAR(statistics.min, 0.011, kTolerance);
+  CHECK_NEAR(statistics.max, 0.250, kTolerance);
+  CHECK_NEAR(statistics.average, 0.1305, kTolerance);
+  // nearest-rank：240個の50%は120番目、95%は228番目、99%は238番目
+  CHECK_NEAR(statistics.median, 0.130, kTolerance);
+  CHECK_NEAR(statistics.p95, 0.238, kTolerance);
+  CHECK_NEAR(statistics.p99, 0.248, kTolerance);
+
+  statistics = profiler.GetGpuHistory(historyIndex).Compute();
+  CHECK_NEAR(statistics.min, 0.022, kTolerance);
+  CHECK_NEAR(statistics.max, 0.500, kTolerance);
+
+  // 空の履歴は全部0
+  GpuProfiler::History empty;
+  statistics = empty.Compute();
+  CHECK(statistics.min == 0.0 && statistics.max == 0.0 &&
+        statistics.p99 == 0.0);
+
+  // 1個だけなら全部その値
+  GpuProfiler::History single;
+  single.Add(3.0);
+  statistics = single.Compute();
+  CHECK(statistics.min == 3.0 && statistics.median == 3.0 &&
+        statistics.p99 == 3.0);
+}
+} // namespace
+
+int main() {
+  TestTimestampIndices();
+  TestCollect();
+  TestScopeOverflow();
+  TestHistory();
+  return Test::Finish();
+}
@@ -0,0 +1,115 @@
+﻿#include "MappedFile.h"
+#ifdef _WIN32
+#include "StringUtility.h"
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() { Close(); }
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::string &filePath) {
+  Close();
+
+  std::wstring filePathW = StringUtility::ConvertString(filePath);
+  HANDLE file = CreateFileW(filePathW.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            nullptr, OPEN_EXISTING,
+                            FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  fileHandle = file;
+
+  LARGE_INTEGER fileSize{};
+  if (!GetFileSizeEx(file, &fileSize)) {
+    Close();
+    return false;
+  }
+  size = static_cast<size_t>(fileSize.QuadPart);
+  // 空のファイルはマップできないので中身なしとして扱う
+  if (size == 0) {
+    return true;
+  }
+
+  mappingHandle =
+      CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (mappingHandle == nullptr) {
+    Close();
+    return false;
+  }
+  data = static_cast<const char *>(
+      MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+  if (data == nullptr) {
+    Close();
+    return false;
+  }
+  return true;
+}
+
+void MappedFile::Close() {
+  if (data) {
+    UnmapViewOfFile(data);
+  }
+  if (mappingHandle) {
+    CloseHandle(mappingHandle);
+  }
+  if (fileHandle) {
+    CloseHandle(fileHandle);
+  }
+  data = nullptr;
+  size = 0;
+  mappingHandle = nullptr;
+  fileHandle = nullptr;
+}
+
+#else
+
+bool MappedFile::Open(const std::string &filePath) {
+  Close();
+
+  fileDescriptor = open(filePath.c_str(), O_RDONLY);
+  if (fileDescriptor < 0) {
+    return false;
+  }
+
+  struct stat status {};
+  if (fstat(fileDescriptor, &status) != 0) {
+    Close();
+    return false;
+  }
+  size = static_cast<size_t>(status.st_size);
+  // 空のファイルはマップできないので中身なしとして扱う
+  if (size == 0) {
+    return true;
+  }
+
+  void *address =
+      mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+  if (address == MAP_FAILED) {
+    Close();
+    return false;
+  }
+  // 先頭から順に読むことを伝えておく
+  madvise(address, size, MADV_SEQUENTIAL);
+  data = static_cast<const char *>(address);
+  return true;
+}
+
+void MappedFile::Close() {
+  if (data) {
+    munmap(const_cast<char *>(data), size);
+  }
+  if (fileDescriptor >= 0) {
+    close(fileDescriptor);
+  }
+  data = nullptr;
+  size = 0;
+  fileDescriptor = -1;
+}
+
+#endif
@@ -0,0 +1,33 @@
+﻿#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// 読み取り専用でメモリにマップしたファイル
+class MappedFile {
+public:
+  MappedFile() = default;
+  ~MappedFile();
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  // ファイルを開いてマップする。失敗したらfalse
+  bool Open(const std::string &filePath);
+  // マップを解除して閉じる
+  void Close();
+
+  const char *GetData() const { return data; }
+  size_t GetSize() const { return size; }
+  // 中身を文字列として見る
+  std::string_view GetText() const { return std::string_view(data, size); }
+
+private:
+  const char *data = nullptr;
+  size_t size = 0;
+#ifdef _WIN32
+  void *fileHandle = nullptr;
+  void *mappingHandle = nullptr;
+#else
+  int fileDescriptor = -1;
+#endif
+};
\ No newline at end of file
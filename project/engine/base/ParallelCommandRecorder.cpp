@@ -0,0 +1,59 @@
+﻿#include "ParallelCommandRecorder.h"
+#include <algorithm>
+#include <cassert>
+
+std::vector<ParallelCommandRecorder::Chunk>
+ParallelCommandRecorder::Partition(uint32_t count, uint32_t chunkCount,
+                                   uint32_t minChunkSize) {
+  std::vector<Chunk> chunks;
+  if (count == 0) {
+    return chunks;
+  }
+  // 細かく分けすぎると記録の準備の方が重くなる
+  uint32_t maxChunkCount = (std::max)(count / (std::max)(minChunkSize, 1u), 1u);
+  chunkCount = std::clamp(chunkCount, 1u, maxChunkCount);
+
+  // 余りは先頭から1つずつ配る
+  uint32_t baseSize = count / chunkCount;
+  uint32_t remainder = count % chunkCount;
+  uint32_t first = 0;
+  chunks.reserve(chunkCount);
+  for (uint32_t i = 0; i < chunkCount; ++i) {
+    uint32_t size = baseSize + (i < remainder ? 1 : 0);
+    chunks.push_back({first, size});
+    first += size;
+  }
+  return chunks;
+}
+
+void ParallelCommandRecorder::Initialize(uint32_t frameCount,
+                                         ContextProvider provider) {
+  assert(frameCount > 0);
+  assert(provider);
+  this->provider = provider;
+  slots.clear();
+  slots.resize(frameCount);
+  frameIndex = 0;
+}
+
+void ParallelCommandRecorder::BeginFrame(uint32_t frameIndex) {
+  assert(frameIndex < slots.size());
+  this->frameIndex = frameIndex;
+  slots[frameIndex].usedCount = 0;
+}
+
+uint32_t ParallelCommandRecorder::Acquire() {
+  FrameSlot &slot = slots[frameIndex];
+  if (slot.usedCount == slot.contexts.size()) {
+    slot.contexts.push_back(provider());
+  }
+  return slot.contexts[slot.usedCount++];
+}
+
+uint32_t ParallelCommandRecorder::GetContextCount() const {
+  size_t count = 0;
+  for (const FrameSlot &slot : slots) {
+    count += slot.contexts.size();
+  }
+  return static_cast<uint32_t>(count);
+}
@@ -0,0 +1,97 @@
+﻿#pragma once
+#include "ThreadPool.h"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// 描画コマンドを複数のコマンドリストへ分けて並列に記録し、
+// 取り出した順に1回で提出する（D3D12に依存しない部分）
+// コマンドリスト（とアロケータ）は番号で扱い、フレームスロットごとに使い回す
+class ParallelCommandRecorder {
+public:
+  // 1つのコマンドリストに記録する範囲
+  struct Chunk {
+    uint32_t first;
+    uint32_t count;
+  };
+
+  // 新しいコマンドリストを作って番号を返す
+  using ContextProvider = std::function<uint32_t()>;
+
+  // count個をchunkCount個以下の範囲に均等に分ける
+  // 1つの範囲がminChunkSize個を下回るほど細かくはしない
+  static std::vector<Chunk> Partition(uint32_t count, uint32_t chunkCount,
+                                      uint32_t minChunkSize);
+
+  // 初期化。frameCountは同時に積んでおけるフレーム数
+  void Initialize(uint32_t frameCount, ContextProvider provider);
+
+  // フレームスロットの開始（そのスロットをGPUが使い終わってから呼ぶ）
+  // 前回このスロットで使ったコマンドリストを先頭から使い直す
+  void BeginFrame(uint32_t frameIndex);
+
+  // 今のスロットから空いているコマンドリストを取り出す。無ければ作る
+  // 取り出した順がそのまま提出順になる（呼んでよいのは記録を指示するスレッドだけ）
+  uint32_t Acquire();
+
+  // chunksを1つずつ別のコマンドリストに記録する
+  // 最後の範囲は呼んだスレッドで、残りはthreadPoolで記録し、全部終わるまで待つ
+  // ContextはBegin(context)・End(context)を持ち、recordは(context, chunk)で呼ぶ
+  template <class Context, class RecordFunc>
+  void Record(ThreadPool *threadPool, const std::vector<Chunk> &chunks,
+              Context &context, RecordFunc record) {
+    if (chunks.empty()) {
+      return;
+    }
+    // コマンドリストの取り出しは並列にせず、範囲の順に行う
+    recordingContexts.clear();
+    for (size_t i = 0; i < chunks.size(); ++i) {
+      recordingContexts.push_back(Acquire());
+    }
+
+    auto recordChunk = [&](size_t i) {
+      uint32_t contextIndex = recordingContexts[i];
+      context.Begin(contextIndex);
+      record(contextIndex, chunks[i]);
+      context.End(contextIndex);
+    };
+    size_t last = chunks.size() - 1;
+    for (size_t i = 0; i < last; ++i) {
+      if (threadPool) {
+        threadPool->Enqueue([&recordChunk, i]() { recordChunk(i); });
+      } else {
+        recordChunk(i);
+      }
+    }
+    recordChunk(last);
+    if (threadPool) {
+      threadPool->WaitIdle();
+    }
+  }
+
+  // このフレームで取り出したコマンドリストを取り出した順に1回で提出する
+  // QueueはExecuteCommandLists(const uint32_t *contexts, uint32_t count)を持つこと
+  template <class Queue> void Submit(Queue &queue) const {
+    const FrameSlot &slot = slots[frameIndex];
+    queue.ExecuteCommandLists(slot.contexts.data(), slot.usedCount);
+  }
+
+  // このフレームで取り出したコマンドリストの数
+  uint32_t GetUsedCount() const { return slots[frameIndex].usedCount; }
+  // 全スロットで作ったコマンドリストの数
+  uint32_t GetContextCount() const;
+
+private:
+  struct FrameSlot {
+    // このスロットで作ったコマンドリスト
+    std::vector<uint32_t> contexts;
+    // このフレームで取り出した数
+    uint32_t usedCount = 0;
+  };
+
+  std::vector<FrameSlot> slots;
+  uint32_t frameIndex = 0;
+  ContextProvider provider;
+  // Recordで範囲ごとに取り出したコマンドリスト
+  std::vector<uint32_t> recordingContexts;
+};
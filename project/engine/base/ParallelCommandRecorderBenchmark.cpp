@@ -0,0 +1,108 @@
+﻿#include "Benchmark.h"
+#include "ParallelCommandRecorder.h"
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+// DirectXCommon::RecordParallelと同じ形で、記録するスレッドの数ごとに
+// 全描画の記録にかかる時間を測る
+// （コマンドの記録は、1描画ごとの行列計算とコマンドの書き込みで代用する）
+namespace {
+// 1描画分のコマンド（ルート定数とDrawの引数くらいの大きさ）
+struct Command {
+  float matrix[16];
+  uint32_t drawArgs[4];
+};
+
+// コマンドリストの代わり。記録したコマンドを溜めるだけ
+struct FakeContexts {
+  std::vector<std::vector<Command>> lists;
+
+  ParallelCommandRecorder::ContextProvider GetProvider() {
+    return [this]() {
+      lists.emplace_back();
+      return static_cast<uint32_t>(lists.size() - 1);
+    };
+  }
+  // Recordに渡すContext（Resetの代わりに空にする）
+  void Begin(uint32_t context) { lists[context].clear(); }
+  void End(uint32_t) {}
+};
+
+// 1描画分の記録
+void RecordItem(uint32_t item, std::vector<Command> &commands) {
+  Command command;
+  float angle = static_cast<float>(item) * 0.001f;
+  for (uint32_t i = 0; i < 16; ++i) {
+    command.matrix[i] = angle * static_cast<float>(i + 1);
+  }
+  // 定数バッファの中身を作る程度の計算
+  for (uint32_t step = 0; step < 8; ++step) {
+    for (uint32_t i = 0; i < 16; ++i) {
+      command.matrix[i] = command.matrix[i] * 0.999f + command.matrix[15 - i];
+    }
+  }
+  command.drawArgs[0] = 6;
+  command.drawArgs[1] = 1;
+  command.drawArgs[2] = item * 6;
+  command.drawArgs[3] = 0;
+  commands.push_back(command);
+}
+} // namespace
+
+int main() {
+  const uint32_t kItemCount = 100000;
+  const uint32_t kMinCountPerList = 256;
+  const uint32_t kRepeatCount = 5;
+
+  std::printf("%u draws, %u hardware threads\n", kItemCount,
+              std::thread::hardware_concurrency());
+  std::printf("%8s %8s %12s\n", "threads", "lists", "record ms");
+
+  // 基準：1本のコマンドリストに全部積む
+  {
+    FakeContexts contexts;
+    ParallelCommandRecorder recorder;
+    recorder.Initialize(1, contexts.GetProvider());
+    double ms = Benchmark::MeasureBestMs(kRepeatCount, [&]() {
+      recorder.BeginFrame(0);
+      uint32_t context = recorder.Acquire();
+      contexts.Begin(context);
+      for (uint32_t i = 0; i < kItemCount; ++i) {
+        RecordItem(i, contexts.lists[context]);
+      }
+      contexts.End(context);
+      Benchmark::Consume(contexts.lists[context].size());
+    });
+    std::printf("%8s %8u %12.2f\n", "single", 1u, ms);
+  }
+
+  for (uint32_t threadCount : {1u, 2u, 4u, 8u}) {
+    // 呼んだスレッドも最後の範囲を記録するので、ワーカーは1つ少なくてよい
+    ThreadPool threadPool;
+    threadPool.Initialize((std::max)(threadCount - 1, 1u));
+
+    FakeContexts contexts;
+    ParallelCommandRecorder recorder;
+    recorder.Initialize(1, contexts.GetProvider());
+    std::vector<ParallelCommandRecorder::Chunk> chunks =
+        ParallelCommandRecorder::Partition(kItemCount, threadCount,
+                                           kMinCountPerList);
+    double ms = Benchmark::MeasureBestMs(kRepeatCount, [&]() {
+      recorder.BeginFrame(0);
+      recorder.Record(threadCount > 1 ? &threadPool : nullptr, chunks,
+                      contexts,
+                      [&](uint32_t context,
+                          const ParallelCommandRecorder::Chunk &chunk) {
+                        for (uint32_t i = 0; i < chunk.count; ++i) {
+                          RecordItem(chunk.first + i, contexts.lists[context]);
+                        }
+                      });
+      Benchmark::Consume(recorder.GetUsedCount());
+    });
+    threadPool.Finalize();
+    std::printf("%8u %8zu %12.2f\n", threadCount, chunks.size(), ms);
+  }
+  return 0;
+}
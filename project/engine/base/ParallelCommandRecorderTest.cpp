@@ -0,0 +1,225 @@
+﻿#include "Check.h"
+#include "ParallelCommandRecorder.h"
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using Chunk = ParallelCommandRecorder::Chunk;
+
+namespace {
+// 範囲が先頭から隙間なく並び、count個をちょうど覆っているか
+bool IsContiguous(const std::vector<Chunk> &chunks, uint32_t count) {
+  uint32_t next = 0;
+  for (const Chunk &chunk : chunks) {
+    if (chunk.first != next || chunk.count == 0) {
+      return false;
+    }
+    next += chunk.count;
+  }
+  return next == count;
+}
+
+// コマンドリストの代わり。番号ごとに記録した内容と開閉を覚えておく
+struct FakeContexts {
+  struct List {
+    bool isOpen = false;
+    uint32_t beginCount = 0;
+    std::vector<uint32_t> items;
+    std::thread::id thread;
+  };
+  std::vector<List> lists;
+  bool isValid = true;
+  std::mutex mutex;
+
+  ParallelCommandRecorder::ContextProvider GetProvider() {
+    return [this]() {
+      lists.emplace_back();
+      return static_cast<uint32_t>(lists.size() - 1);
+    };
+  }
+  // Recordに渡すContext
+  void Begin(uint32_t context) {
+    std::lock_guard<std::mutex> lock(mutex);
+    isValid = isValid && !lists[context].isOpen;
+    lists[context].isOpen = true;
+    lists[context].beginCount++;
+    lists[context].items.clear();
+    lists[context].thread = std::this_thread::get_id();
+  }
+  void End(uint32_t context) {
+    std::lock_guard<std::mutex> lock(mutex);
+    isValid = isValid && lists[context].isOpen;
+    lists[context].isOpen = false;
+  }
+};
+
+// 提出されたコマンドリストの番号を順に覚える
+struct FakeQueue {
+  std::vector<std::vector<uint32_t>> submissions;
+  void ExecuteCommandLists(const uint32_t *contexts, uint32_t count) {
+    submissions.emplace_back(contexts, contexts + count);
+  }
+};
+
+void TestPartition() {
+  CHECK(ParallelCommandRecorder::Partition(0, 4, 1).empty());
+
+  // 余りは先頭から配る
+  std::vector<Chunk> chunks = ParallelCommandRecorder::Partition(10, 3, 1);
+  CHECK(chunks.size() == 3);
+  CHECK(IsContiguous(chunks, 10));
+  CHECK(chunks[0].count == 4 && chunks[1].count == 3 && chunks[2].count == 3);
+
+  // 最小の大きさを下回るほど細かくしない
+  chunks = ParallelCommandRecorder::Partition(100, 8, 64);
+  CHECK(chunks.size() == 1 && chunks[0].count == 100);
+  chunks = ParallelCommandRecorder::Partition(100, 8, 30);
+  CHECK(chunks.size() == 3);
+  CHECK(IsContiguous(chunks, 100));
+  chunks = ParallelCommandRecorder::Partition(10, 8, 100);
+  CHECK(chunks.size() == 1 && chunks[0].count == 10);
+
+  // 分ける数が0でも1つ、個数より多ければ1個ずつ
+  chunks = ParallelCommandRecorder::Partition(5, 0, 1);
+  CHECK(chunks.size() == 1 && chunks[0].count == 5);
+  chunks = ParallelCommandRecorder::Partition(5, 16, 0);
+  CHECK(chunks.size() == 5);
+  CHECK(IsContiguous(chunks, 5));
+
+  // いろいろな組み合わせで、隙間なく覆い大きさの差は1以下
+  bool isValid = true;
+  for (uint32_t count = 1; count < 300; count += 7) {
+    for (uint32_t chunkCount = 1; chunkCount <= 12; ++chunkCount) {
+      for (uint32_t minChunkSize : {1u, 8u, 50u}) {
+        chunks =
+            ParallelCommandRecorder::Partition(count, chunkCount, minChunkSize);
+        uint32_t smallest = UINT32_MAX;
+        uint32_t largest = 0;
+        for (const Chunk &chunk : chunks) {
+          smallest = (std::min)(smallest, chunk.count);
+          largest = (std::max)(largest, chunk.count);
+        }
+        isValid = isValid && IsContiguous(chunks, count) &&
+                  chunks.size() <= chunkCount && largest - smallest <= 1 &&
+                  (chunks.size() == 1 || smallest >= minChunkSize);
+      }
+    }
+  }
+  CHECK(isValid);
+}
+
+// コマンドリストはスロットごとに作り、同じスロットに戻ったら使い直す
+void TestSlotReuse() {
+  FakeContexts contexts;
+  ParallelCommandRecorder recorder;
+  recorder.Initialize(2, contexts.GetProvider());
+
+  recorder.BeginFrame(0);
+  CHECK(recorder.Acquire() == 0);
+  CHECK(recorder.Acquire() == 1);
+  CHECK(recorder.Acquire() == 2);
+  CHECK(recorder.GetUsedCount() == 3);
+
+  // 別のスロットは別のコマンドリスト（GPUがまだ使っているかもしれない）
+  recorder.BeginFrame(1);
+  CHECK(recorder.GetUsedCount() == 0);
+  CHECK(recorder.Acquire() == 3);
+  CHECK(recorder.Acquire() == 4);
+
+  // スロット0に戻ると前回の分を先頭から使い、足りない分だけ作る
+  recorder.BeginFrame(0);
+  CHECK(recorder.Acquire() == 0);
+  CHECK(recorder.Acquire() == 1);
+  CHECK(recorder.Acquire() == 2);
+  CHECK(recorder.Acquire() == 5);
+  CHECK(recorder.GetContextCount() == 6);
+
+  // 少なく使うフレームでも作り直さない
+  recorder.BeginFrame(1);
+  CHECK(recorder.Acquire() == 3);
+  CHECK(recorder.GetContextCount() == 6);
+  CHECK(contexts.lists.size() == 6);
+}
+
+// 範囲ごとに取り出したコマンドリストへ記録し、取り出した順に提出する
+void CheckRecord(ThreadPool *threadPool) {
+  const uint32_t kItemCount = 1000;
+  FakeContexts contexts;
+  ParallelCommandRecorder recorder;
+  recorder.Initialize(2, contexts.GetProvider());
+  FakeQueue queue;
+
+  for (uint32_t frame = 0; frame < 4; ++frame) {
+    recorder.BeginFrame(frame % 2);
+    // Recordの前に取り出した分（メインのコマンドリスト）が先頭
+    uint32_t mainContext = recorder.Acquire();
+    std::vector<Chunk> chunks =
+        ParallelCommandRecorder::Partition(kItemCount, 4, 16);
+    recorder.Record(threadPool, chunks, contexts,
+                    [&](uint32_t context, const Chunk &chunk) {
+                      for (uint32_t i = 0; i < chunk.count; ++i) {
+                        contexts.lists[context].items.push_back(chunk.first +
+                                                                i);
+                      }
+                    });
+    // 続きを積むコマンドリストが最後
+    uint32_t tailContext = recorder.Acquire();
+    recorder.Submit(queue);
+
+    const std::vector<uint32_t> &submitted = queue.submissions.back();
+    CHECK(submitted.size() == 6);
+    CHECK(recorder.GetUsedCount() == 6);
+    if (submitted.size() != 6) {
+      continue;
+    }
+    CHECK(submitted.front() == mainContext);
+    CHECK(submitted.back() == tailContext);
+    // 提出順に並べると項目が元の順に並ぶ
+    std::vector<uint32_t> items;
+    for (size_t i = 1; i + 1 < submitted.size(); ++i) {
+      const std::vector<uint32_t> &listItems =
+          contexts.lists[submitted[i]].items;
+      items.insert(items.end(), listItems.begin(), listItems.end());
+    }
+    bool isInOrder = items.size() == kItemCount;
+    for (uint32_t i = 0; isInOrder && i < kItemCount; ++i) {
+      isInOrder = items[i] == i;
+    }
+    CHECK(isInOrder);
+  }
+  CHECK(contexts.isValid);
+  // 2スロット × 6本
+  CHECK(recorder.GetContextCount() == 12);
+  // 各コマンドリストは2回ずつ開いた（スロットごとに2フレーム）
+  bool isReused = true;
+  for (const FakeContexts::List &list : contexts.lists) {
+    isReused = isReused && (list.beginCount == 2 || list.beginCount == 0) &&
+               !list.isOpen;
+  }
+  CHECK(isReused);
+
+  // 範囲が無ければ何も取り出さない
+  recorder.BeginFrame(0);
+  recorder.Record(threadPool, {}, contexts,
+                  [](uint32_t, const Chunk &) {});
+  CHECK(recorder.GetUsedCount() == 0);
+}
+
+void TestRecord() {
+  // スレッド無し（全部呼んだスレッドで記録）
+  CheckRecord(nullptr);
+  // ワーカー3つ
+  ThreadPool threadPool;
+  threadPool.Initialize(3);
+  CheckRecord(&threadPool);
+  threadPool.Finalize();
+}
+} // namespace
+
+int main() {
+  TestPartition();
+  TestSlotReuse();
+  TestRecord();
+  return Test::Finish();
+}
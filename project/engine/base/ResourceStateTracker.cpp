@@ -0,0 +1,154 @@
+﻿#include "ResourceStateTracker.h"
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+void ResourceStateTracker::Register(ResourceId resource,
+                                    uint32_t subresourceCount,
+                                    uint32_t initialState) {
+  assert(subresourceCount > 0);
+  ResourceState &state = resources[resource];
+  state.subresourceStates.assign(subresourceCount, initialState);
+  state.splitStates.assign(subresourceCount, kNoSplit);
+  state.isUniform = true;
+}
+
+void ResourceStateTracker::Unregister(ResourceId resource) {
+  resources.erase(resource);
+  // 破棄するリソースへのバリアは出さない
+  std::erase_if(pendingBarriers, [resource](const Barrier &barrier) {
+    return barrier.resource == resource;
+  });
+}
+
+void ResourceStateTracker::Transition(ResourceId resource, uint32_t state,
+                                      uint32_t subresource) {
+  auto it = resources.find(resource);
+  // 登録していないリソース
+  assert(it != resources.end());
+  ResourceState &resourceState = it->second;
+  std::vector<uint32_t> &states = resourceState.subresourceStates;
+  std::vector<uint32_t> &splits = resourceState.splitStates;
+
+  // 全体がそろっていれば1つのバリアで済ませる
+  if (subresource == kAllSubresources && resourceState.isUniform &&
+      std::all_of(splits.begin(), splits.end(),
+                  [&](uint32_t split) { return split == splits[0]; })) {
+    if (splits[0] != kNoSplit) {
+      // 開始済みの分割バリアを終える
+      assert(splits[0] == state);
+      AddBarrier(resource, kAllSubresources, states[0], state,
+                 BarrierFlag::EndOnly);
+    } else if (!IsSatisfied(states[0], state)) {
+      AddBarrier(resource, kAllSubresources, states[0], state,
+                 BarrierFlag::None);
+    } else {
+      return;
+    }
+    std::fill(states.begin(), states.end(), state);
+    std::fill(splits.begin(), splits.end(), kNoSplit);
+    return;
+  }
+
+  // サブリソースごとに要るものだけ出す
+  uint32_t first = subresource == kAllSubresources ? 0 : subresource;
+  uint32_t last = subresource == kAllSubresources
+                      ? static_cast<uint32_t>(states.size())
+                      : subresource + 1;
+  assert(last <= states.size());
+  for (uint32_t i = first; i < last; ++i) {
+    if (splits[i] != kNoSplit) {
+      assert(splits[i] == state);
+      AddBarrier(resource, i, states[i], state, BarrierFlag::EndOnly);
+      splits[i] = kNoSplit;
+    } else if (!IsSatisfied(states[i], state)) {
+      AddBarrier(resource, i, states[i], state, BarrierFlag::None);
+    } else {
+      continue;
+    }
+    states[i] = state;
+  }
+  resourceState.isUniform =
+      std::all_of(states.begin(), states.end(),
+                  [&](uint32_t value) { return value == states[0]; });
+}
+
+void ResourceStateTracker::BeginTransition(ResourceId resource, uint32_t state,
+                                           uint32_t subresource) {
+  auto it = resources.find(resource);
+  assert(it != resources.end());
+  ResourceState &resourceState = it->second;
+  std::vector<uint32_t> &states = resourceState.subresourceStates;
+  std::vector<uint32_t> &splits = resourceState.splitStates;
+
+  uint32_t first = subresource == kAllSubresources ? 0 : subresource;
+  uint32_t last = subresource == kAllSubresources
+                      ? static_cast<uint32_t>(states.size())
+                      : subresource + 1;
+  assert(last <= states.size());
+  bool isWhole = subresource == kAllSubresources && resourceState.isUniform;
+  bool isAdded = false;
+  for (uint32_t i = first; i < last; ++i) {
+    // 二重に開始している
+    assert(splits[i] == kNoSplit);
+    if (IsSatisfied(states[i], state)) {
+      continue;
+    }
+    splits[i] = state;
+    if (!isWhole) {
+      AddBarrier(resource, i, states[i], state, BarrierFlag::BeginOnly);
+    } else if (!isAdded) {
+      AddBarrier(resource, kAllSubresources, states[i], state,
+                 BarrierFlag::BeginOnly);
+      isAdded = true;
+    }
+  }
+}
+
+uint32_t ResourceStateTracker::GetState(ResourceId resource,
+                                        uint32_t subresource) const {
+  auto it = resources.find(resource);
+  assert(it != resources.end());
+  assert(subresource < it->second.subresourceStates.size());
+  return it->second.subresourceStates[subresource];
+}
+
+void ResourceStateTracker::AddBarrier(ResourceId resource, uint32_t subresource,
+                                      uint32_t stateBefore, uint32_t stateAfter,
+                                      BarrierFlag flag) {
+  // 同じパスで同じサブリソースを遷移済みなら、1つのバリアにまとめる
+  // まとめてよいのは、そのサブリソースに最後に溜めたバリアだけ
+  // （分割バリアや全体へのバリアを挟んでいたら、その後ろに足す）
+  if (flag == BarrierFlag::None) {
+    for (auto it = pendingBarriers.rbegin(); it != pendingBarriers.rend();
+         ++it) {
+      if (it->resource != resource ||
+          (it->subresource != subresource &&
+           it->subresource != kAllSubresources &&
+           subresource != kAllSubresources)) {
+        continue;
+      }
+      if (it->subresource != subresource || it->flag != BarrierFlag::None) {
+        break;
+      }
+      assert(it->stateAfter == stateBefore);
+      if (it->stateBefore == stateAfter) {
+        // 行って戻っただけなら何も要らない
+        pendingBarriers.erase(std::next(it).base());
+      } else {
+        it->stateAfter = stateAfter;
+      }
+      return;
+    }
+  }
+  pendingBarriers.push_back(
+      {resource, subresource, stateBefore, stateAfter, flag});
+}
+
+bool ResourceStateTracker::IsSatisfied(uint32_t current, uint32_t requested) {
+  if (current == requested) {
+    return true;
+  }
+  // COMMONはほかの状態に含まれない。読み取り状態の組み合わせは含んでいればよい
+  return requested != kStateCommon && (current & requested) == requested;
+}
@@ -0,0 +1,89 @@
+﻿#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// リソースの状態を覚えておき、要求された遷移をまとめてバリアにする
+// （D3D12に依存しない部分。状態はD3D12_RESOURCE_STATESの値をそのまま使う）
+// パスの間に要求された遷移は同じサブリソースごとに1つにまとめ、
+// Flushで1回のResourceBarrierとして出す
+class ResourceStateTracker {
+public:
+  // リソースの識別子（ID3D12Resource*）
+  using ResourceId = void *;
+
+  // 全サブリソース（D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES）
+  static constexpr uint32_t kAllSubresources = UINT32_MAX;
+  // D3D12_RESOURCE_STATE_COMMON
+  static constexpr uint32_t kStateCommon = 0;
+
+  // 分割バリアの区別（D3D12_RESOURCE_BARRIER_FLAGS）
+  enum class BarrierFlag : uint32_t {
+    None = 0,
+    BeginOnly = 1,
+    EndOnly = 2,
+  };
+
+  // 遷移バリア1つ分
+  struct Barrier {
+    ResourceId resource;
+    uint32_t subresource;
+    uint32_t stateBefore;
+    uint32_t stateAfter;
+    BarrierFlag flag;
+  };
+
+  // リソースを登録する。状態は全サブリソースinitialStateから始まる
+  void Register(ResourceId resource, uint32_t subresourceCount,
+                uint32_t initialState);
+  // 登録を外す（リソースを破棄する前に呼ぶ）
+  void Unregister(ResourceId resource);
+
+  // stateにしてほしいと要求する。バリアはFlushまで溜めておき、
+  // 同じサブリソースへの遷移は1つにまとめる
+  void Transition(ResourceId resource, uint32_t state,
+                  uint32_t subresource = kAllSubresources);
+  // 分割バリアの開始。次のFlushで開始だけ出し、
+  // 同じ状態へのTransitionで終わりを出す（その間にGPUが他の仕事をできる）
+  void BeginTransition(ResourceId resource, uint32_t state,
+                       uint32_t subresource = kAllSubresources);
+
+  // 溜めたバリアを1回で出す
+  // CommandListは ResourceBarrier(const Barrier *, uint32_t) を持つこと
+  template <class CommandList> void Flush(CommandList &commandList) {
+    if (pendingBarriers.empty()) {
+      return;
+    }
+    commandList.ResourceBarrier(pendingBarriers.data(),
+                                static_cast<uint32_t>(pendingBarriers.size()));
+    pendingBarriers.clear();
+  }
+
+  // 今の（溜めたバリアを出した後の）状態
+  uint32_t GetState(ResourceId resource, uint32_t subresource = 0) const;
+  // 出していないバリア
+  const std::vector<Barrier> &GetPendingBarriers() const {
+    return pendingBarriers;
+  }
+
+private:
+  struct ResourceState {
+    // サブリソースごとの状態
+    std::vector<uint32_t> subresourceStates;
+    // 分割バリアの開始済みで終わっていない遷移先（サブリソースごと）
+    std::vector<uint32_t> splitStates;
+    // 全サブリソースが同じ状態か
+    bool isUniform = true;
+  };
+  // 分割バリアが進行中でないときの値
+  static constexpr uint32_t kNoSplit = UINT32_MAX;
+
+  // 1つのサブリソース（または全体）の遷移を溜める
+  void AddBarrier(ResourceId resource, uint32_t subresource,
+                  uint32_t stateBefore, uint32_t stateAfter, BarrierFlag flag);
+  // 遷移が要らないか（同じ状態、または読み取り状態を含んでいる）
+  static bool IsSatisfied(uint32_t current, uint32_t requested);
+
+  std::unordered_map<ResourceId, ResourceState> resources;
+  std::vector<Barrier> pendingBarriers;
+};
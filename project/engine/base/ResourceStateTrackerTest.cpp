@@ -0,0 +1,333 @@
+﻿#include "Check.h"
+#include "ResourceStateTracker.h"
+#include <map>
+#include <random>
+#include <vector>
+
+using Tracker = ResourceStateTracker;
+using Barrier = ResourceStateTracker::Barrier;
+using BarrierFlag = ResourceStateTracker::BarrierFlag;
+
+namespace {
+// D3D12_RESOURCE_STATESの値
+const uint32_t kCommon = 0x0;
+const uint32_t kRenderTarget = 0x4;
+const uint32_t kUnorderedAccess = 0x8;
+const uint32_t kPixelShaderResource = 0x80;
+const uint32_t kNonPixelShaderResource = 0x40;
+const uint32_t kAllShaderResource = 0xC0;
+const uint32_t kCopyDest = 0x400;
+const uint32_t kCopySource = 0x800;
+
+// コマンドリストの代わり。受け取ったバリアを順に記録し、
+// GPUから見た状態を再現して、前の状態の食い違いや分割バリアの対応を確かめる
+struct RecordingCommandList {
+  struct Subresources {
+    std::vector<uint32_t> states;
+    // 開始済みの分割バリアの遷移先（なければkNoSplit）
+    std::vector<uint32_t> splits;
+  };
+  static constexpr uint32_t kNoSplit = UINT32_MAX;
+
+  std::vector<Barrier> barriers;
+  uint32_t callCount = 0;
+  std::map<Tracker::ResourceId, Subresources> resources;
+  bool isValid = true;
+
+  void Register(Tracker::ResourceId resource, uint32_t subresourceCount,
+                uint32_t initialState) {
+    resources[resource] = {
+        std::vector<uint32_t>(subresourceCount, initialState),
+        std::vector<uint32_t>(subresourceCount, kNoSplit)};
+  }
+
+  void ResourceBarrier(const Barrier *newBarriers, uint32_t count) {
+    callCount++;
+    for (uint32_t i = 0; i < count; ++i) {
+      const Barrier &barrier = newBarriers[i];
+      barriers.push_back(barrier);
+      Subresources &target = resources.at(barrier.resource);
+      uint32_t first = barrier.subresource == Tracker::kAllSubresources
+                           ? 0
+                           : barrier.subresource;
+      uint32_t last = barrier.subresource == Tracker::kAllSubresources
+                          ? static_cast<uint32_t>(target.states.size())
+                          : barrier.subresource + 1;
+      for (uint32_t s = first; s < last; ++s) {
+        isValid = isValid && target.states[s] == barrier.stateBefore &&
+                  barrier.stateBefore != barrier.stateAfter;
+        switch (barrier.flag) {
+        case BarrierFlag::None:
+          isValid = isValid && target.splits[s] == kNoSplit;
+          target.states[s] = barrier.stateAfter;
+          break;
+        case BarrierFlag::BeginOnly:
+          isValid = isValid && target.splits[s] == kNoSplit;
+          target.splits[s] = barrier.stateAfter;
+          break;
+        case BarrierFlag::EndOnly:
+          isValid = isValid && target.splits[s] == barrier.stateAfter;
+          target.splits[s] = kNoSplit;
+          target.states[s] = barrier.stateAfter;
+          break;
+        }
+      }
+    }
+  }
+};
+
+bool IsBarrier(const Barrier &barrier, Tracker::ResourceId resource,
+               uint32_t subresource, uint32_t stateBefore, uint32_t stateAfter,
+               BarrierFlag flag) {
+  return barrier.resource == resource && barrier.subresource == subresource &&
+         barrier.stateBefore == stateBefore &&
+         barrier.stateAfter == stateAfter && barrier.flag == flag;
+}
+
+int resourceA = 0;
+int resourceB = 0;
+
+// 同じパスの遷移は1つにまとめ、行って戻ったものは消す
+void TestMerge() {
+  Tracker tracker;
+  RecordingCommandList commandList;
+  tracker.Register(&resourceA, 1, kCommon);
+  commandList.Register(&resourceA, 1, kCommon);
+
+  tracker.Transition(&resourceA, kRenderTarget);
+  tracker.Transition(&resourceA, kPixelShaderResource);
+  CHECK(tracker.GetPendingBarriers().size() == 1);
+  tracker.Flush(commandList);
+  CHECK(commandList.barriers.size() == 1);
+  CHECK(IsBarrier(commandList.barriers[0], &resourceA, Tracker::kAllSubresources,
+                  kCommon, kPixelShaderResource, BarrierFlag::None));
+  CHECK(tracker.GetState(&resourceA) == kPixelShaderResource);
+
+  // 行って戻っただけ
+  tracker.Transition(&resourceA, kCopyDest);
+  tracker.Transition(&resourceA, kPixelShaderResource);
+  CHECK(tracker.GetPendingBarriers().empty());
+  // 何も無ければResourceBarrierを呼ばない
+  tracker.Flush(commandList);
+  CHECK(commandList.callCount == 1);
+
+  // 読み取り状態を含んでいれば遷移しない（COMMONへは必ず遷移する）
+  tracker.Transition(&resourceA, kAllShaderResource);
+  tracker.Flush(commandList);
+  tracker.Transition(&resourceA, kNonPixelShaderResource);
+  CHECK(tracker.GetPendingBarriers().empty());
+  tracker.Transition(&resourceA, kCommon);
+  CHECK(tracker.GetPendingBarriers().size() == 1);
+  tracker.Flush(commandList);
+  CHECK(commandList.isValid);
+}
+
+// 分割バリアを挟むと、その前のバリアとはまとめない
+// Transition(S1), BeginTransition(S2), Transition(S2), Transition(S3) を
+// Flushせずに続けると、S3への遷移は最後に別のバリアとして出る
+void TestNoMergeAcrossSplit() {
+  Tracker tracker;
+  RecordingCommandList commandList;
+  tracker.Register(&resourceA, 1, kCommon);
+  commandList.Register(&resourceA, 1, kCommon);
+
+  tracker.Transition(&resourceA, kRenderTarget);
+  tracker.BeginTransition(&resourceA, kPixelShaderResource);
+  tracker.Transition(&resourceA, kPixelShaderResource);
+  tracker.Transition(&resourceA, kCopySource);
+  tracker.Flush(commandList);
+
+  const uint32_t all = Tracker::kAllSubresources;
+  CHECK(commandList.barriers.size() == 4);
+  if (commandList.barriers.size() == 4) {
+    CHECK(IsBarrier(commandList.barriers[0], &resourceA, all, kCommon,
+                    kRenderTarget, BarrierFlag::None));
+    CHECK(IsBarrier(commandList.barriers[1], &resourceA, all, kRenderTarget,
+                    kPixelShaderResource, BarrierFlag::BeginOnly));
+    CHECK(IsBarrier(commandList.barriers[2], &resourceA, all, kRenderTarget,
+                    kPixelShaderResource, BarrierFlag::EndOnly));
+    CHECK(IsBarrier(commandList.barriers[3], &resourceA, all,
+                    kPixelShaderResource, kCopySource, BarrierFlag::None));
+  }
+  CHECK(commandList.isValid);
+  CHECK(tracker.GetState(&resourceA) == kCopySource);
+
+  // 分割バリアの後ろの通常のバリア同士はまとめてよい
+  tracker.Transition(&resourceA, kRenderTarget);
+  tracker.BeginTransition(&resourceA, kCopyDest);
+  tracker.Transition(&resourceA, kCopyDest);
+  tracker.Transition(&resourceA, kUnorderedAccess);
+  tracker.Transition(&resourceA, kPixelShaderResource);
+  CHECK(tracker.GetPendingBarriers().size() == 4);
+  tracker.Flush(commandList);
+  CHECK(commandList.isValid);
+  CHECK(IsBarrier(commandList.barriers.back(), &resourceA, all, kCopyDest,
+                  kPixelShaderResource, BarrierFlag::None));
+}
+
+// 分割バリアはFlushをまたいで開始と終わりを出す
+void TestSplitAcrossFlush() {
+  Tracker tracker;
+  RecordingCommandList commandList;
+  tracker.Register(&resourceA, 1, kRenderTarget);
+  commandList.Register(&resourceA, 1, kRenderTarget);
+
+  tracker.BeginTransition(&resourceA, kPixelShaderResource);
+  // 終わるまで状態は変わらない
+  CHECK(tracker.GetState(&resourceA) == kRenderTarget);
+  tracker.Flush(commandList);
+  CHECK(commandList.barriers.size() == 1);
+  CHECK(commandList.barriers[0].flag == BarrierFlag::BeginOnly);
+
+  tracker.Transition(&resourceA, kPixelShaderResource);
+  tracker.Flush(commandList);
+  CHECK(commandList.barriers.size() == 2);
+  CHECK(commandList.barriers[1].flag == BarrierFlag::EndOnly);
+  CHECK(tracker.GetState(&resourceA) == kPixelShaderResource);
+  CHECK(commandList.isValid);
+
+  // 既にその状態なら分割バリアも出さない
+  tracker.BeginTransition(&resourceA, kPixelShaderResource);
+  CHECK(tracker.GetPendingBarriers().empty());
+}
+
+// サブリソースごとの遷移と、全体への遷移が混ざる場合
+void TestSubresources() {
+  Tracker tracker;
+  RecordingCommandList commandList;
+  tracker.Register(&resourceB, 4, kCommon);
+  commandList.Register(&resourceB, 4, kCommon);
+
+  // そろっていれば全体で1つ
+  tracker.Transition(&resourceB, kCopyDest);
+  CHECK(tracker.GetPendingBarriers().size() == 1);
+  // ミップ1つだけ別の状態へ。全体のバリアとはまとめない
+  tracker.Transition(&resourceB, kCopySource, 1);
+  CHECK(tracker.GetPendingBarriers().size() == 2);
+  CHECK(tracker.GetState(&resourceB, 0) == kCopyDest);
+  CHECK(tracker.GetState(&resourceB, 1) == kCopySource);
+  // そろっていなければサブリソースごと（1番は2つ目のバリアにまとまる）
+  tracker.Transition(&resourceB, kPixelShaderResource);
+  CHECK(tracker.GetPendingBarriers().size() == 5);
+  tracker.Flush(commandList);
+  CHECK(commandList.isValid);
+
+  // 1番だけ遷移 -> 全体へ遷移（全体の1つ）-> 1番だけ遷移
+  // 最後の遷移は、全体のバリアより前の1番のバリアとまとめてはいけない
+  tracker.Transition(&resourceB, kCopyDest, 1);
+  tracker.Transition(&resourceB, kPixelShaderResource, 1);
+  CHECK(tracker.GetPendingBarriers().empty());
+  tracker.Transition(&resourceB, kCopyDest, 1);
+  tracker.Transition(&resourceB, kCopyDest);
+  tracker.Transition(&resourceB, kRenderTarget);
+  tracker.Transition(&resourceB, kCopySource, 1);
+  tracker.Flush(commandList);
+  CHECK(commandList.isValid);
+  CHECK(tracker.GetState(&resourceB, 0) == kRenderTarget);
+  CHECK(tracker.GetState(&resourceB, 1) == kCopySource);
+  CHECK(commandList.resources[&resourceB].states[1] == kCopySource);
+}
+
+// 登録を外したリソースへの溜めたバリアは出さない
+void TestUnregister() {
+  Tracker tracker;
+  RecordingCommandList commandList;
+  tracker.Register(&resourceA, 1, kCommon);
+  tracker.Register(&resourceB, 1, kCommon);
+  commandList.Register(&resourceB, 1, kCommon);
+  tracker.Transition(&resourceA, kRenderTarget);
+  tracker.Transition(&resourceB, kRenderTarget);
+  tracker.Unregister(&resourceA);
+  tracker.Flush(commandList);
+  CHECK(commandList.barriers.size() == 1);
+  CHECK(commandList.barriers[0].resource == &resourceB);
+  CHECK(commandList.isValid);
+}
+
+// 乱数で遷移・分割バリア・Flushを並べ、出たバリアを再現した状態が
+// 食い違わないこと、最後にトラッカーの状態と一致することを確かめる
+void TestRandomized() {
+  const uint32_t kStates[] = {kCommon,           kRenderTarget,
+                              kUnorderedAccess,  kPixelShaderResource,
+                              kAllShaderResource, kCopyDest,
+                              kCopySource};
+  const uint32_t kSubresourceCount = 4;
+  const uint32_t kNoSplit = RecordingCommandList::kNoSplit;
+  std::mt19937 engine(12345);
+
+  Tracker tracker;
+  RecordingCommandList commandList;
+  tracker.Register(&resourceA, kSubresourceCount, kCommon);
+  commandList.Register(&resourceA, kSubresourceCount, kCommon);
+  // トラッカーの中で開始済みの分割バリア（呼び出しの前提を守るため）
+  std::vector<uint32_t> splits(kSubresourceCount, kNoSplit);
+
+  for (uint32_t step = 0; step < 20000; ++step) {
+    if (engine() % 8 == 0) {
+      tracker.Flush(commandList);
+    }
+    uint32_t subresource = engine() % (kSubresourceCount + 1);
+    uint32_t first = subresource == kSubresourceCount ? 0 : subresource;
+    uint32_t last =
+        subresource == kSubresourceCount ? kSubresourceCount : subresource + 1;
+    if (subresource == kSubresourceCount) {
+      subresource = Tracker::kAllSubresources;
+    }
+    // 範囲内の開始済みの分割バリアがそろっていなければ1つずつにする
+    uint32_t split = splits[first];
+    bool isSame = true;
+    for (uint32_t i = first; i < last; ++i) {
+      isSame = isSame && splits[i] == split;
+    }
+    if (!isSame) {
+      subresource = first;
+      last = first + 1;
+    }
+
+    uint32_t state = kStates[engine() % std::size(kStates)];
+    if (split != kNoSplit) {
+      // 開始済みなら同じ状態への遷移で終える
+      tracker.Transition(&resourceA, split, subresource);
+      for (uint32_t i = first; i < last; ++i) {
+        splits[i] = kNoSplit;
+      }
+    } else if (engine() % 4 == 0) {
+      tracker.BeginTransition(&resourceA, state, subresource);
+      for (uint32_t i = first; i < last; ++i) {
+        uint32_t current = tracker.GetState(&resourceA, i);
+        bool isSatisfied = current == state ||
+                           (state != kCommon && (current & state) == state);
+        splits[i] = isSatisfied ? kNoSplit : state;
+      }
+    } else {
+      tracker.Transition(&resourceA, state, subresource);
+    }
+  }
+  // 開始したままの分割バリアを終えてから出す
+  for (uint32_t i = 0; i < kSubresourceCount; ++i) {
+    if (splits[i] != kNoSplit) {
+      tracker.Transition(&resourceA, splits[i], i);
+    }
+  }
+  tracker.Flush(commandList);
+
+  CHECK(commandList.isValid);
+  CHECK(commandList.barriers.size() > 1000);
+  const RecordingCommandList::Subresources &replayed =
+      commandList.resources[&resourceA];
+  for (uint32_t i = 0; i < kSubresourceCount; ++i) {
+    CHECK(replayed.states[i] == tracker.GetState(&resourceA, i));
+    CHECK(replayed.splits[i] == kNoSplit);
+  }
+}
+} // namespace
+
+int main() {
+  TestMerge();
+  TestNoMergeAcrossSplit();
+  TestSplitAcrossFlush();
+  TestSubresources();
+  TestUnregister();
+  TestRandomized();
+  return Test::Finish();
+}
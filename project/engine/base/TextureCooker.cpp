@@ -0,0 +1,106 @@
+﻿#include "TextureCooker.h"
+#include "TextureDecoder.h"
+#include <chrono>
+#include <cstdio>
+
+namespace {
+// 圧縮後のフォーマット。元がsRGBならsRGBのまま
+DXGI_FORMAT GetCompressedFormat(TextureCooker::Compression compression,
+                                DXGI_FORMAT format) {
+  bool isSRGB = DirectX::IsSRGB(format);
+  switch (compression) {
+  case TextureCooker::Compression::BC1:
+    return isSRGB ? DXGI_FORMAT_BC1_UNORM_SRGB : DXGI_FORMAT_BC1_UNORM;
+  case TextureCooker::Compression::BC3:
+    return isSRGB ? DXGI_FORMAT_BC3_UNORM_SRGB : DXGI_FORMAT_BC3_UNORM;
+  case TextureCooker::Compression::BC7:
+    return isSRGB ? DXGI_FORMAT_BC7_UNORM_SRGB : DXGI_FORMAT_BC7_UNORM;
+  default:
+    return format;
+  }
+}
+
+// 経過時間（ミリ秒）
+double ElapsedMilliseconds(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+// 失敗した工程とHRESULTを返す
+bool Fail(const char *step, HRESULT hr, std::string *errorMessage) {
+  if (errorMessage) {
+    // <format>の無いコンパイラでもビルドできるようにsnprintfで組み立てる
+    char buffer[128];
+    std::snprintf(buffer, sizeof(buffer), "%s failed (0x%08X)", step,
+                  static_cast<uint32_t>(hr));
+    *errorMessage = buffer;
+  }
+  return false;
+}
+} // namespace
+
+namespace TextureCooker {
+
+bool CookFile(const std::filesystem::path &filePath, Compression compression,
+              Timings *timings, std::string *errorMessage) {
+  Timings localTimings{};
+
+  // デコード
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  DirectX::ScratchImage image{};
+  HRESULT hr = TextureDecoder::LoadImageFile(filePath.wstring(), image);
+  if (FAILED(hr)) {
+    return Fail("decode", hr, errorMessage);
+  }
+  localTimings.decode = ElapsedMilliseconds(start);
+
+  // ミップマップ生成
+  start = std::chrono::steady_clock::now();
+  DirectX::ScratchImage mipImages{};
+  hr = TextureDecoder::GenerateMips(image, mipImages);
+  if (FAILED(hr)) {
+    return Fail("mip", hr, errorMessage);
+  }
+  localTimings.mip = ElapsedMilliseconds(start);
+
+  // ブロック圧縮。4の倍数でない大きさや圧縮済みのものはそのまま
+  start = std::chrono::steady_clock::now();
+  const DirectX::TexMetadata &metadata = mipImages.GetMetadata();
+  DirectX::ScratchImage compressedImages{};
+  const DirectX::ScratchImage *outputImages = &mipImages;
+  if (compression != Compression::None &&
+      !DirectX::IsCompressed(metadata.format) && metadata.width % 4 == 0 &&
+      metadata.height % 4 == 0) {
+    hr = DirectX::Compress(mipImages.GetImages(), mipImages.GetImageCount(),
+                           metadata,
+                           GetCompressedFormat(compression, metadata.format),
+                           DirectX::TEX_COMPRESS_DEFAULT,
+                           DirectX::TEX_THRESHOLD_DEFAULT, compressedImages);
+    if (FAILED(hr)) {
+      return Fail("compress", hr, errorMessage);
+    }
+    outputImages = &compressedImages;
+  }
+  localTimings.compress = ElapsedMilliseconds(start);
+
+  // 保存
+  start = std::chrono::steady_clock::now();
+  std::filesystem::path cookedPath = TextureDecoder::GetCookedFilePath(filePath);
+  hr = DirectX::SaveToDDSFile(
+      outputImages->GetImages(), outputImages->GetImageCount(),
+      outputImages->GetMetadata(), DirectX::DDS_FLAGS_NONE,
+      cookedPath.wstring().c_str());
+  if (FAILED(hr)) {
+    return Fail("save", hr, errorMessage);
+  }
+  localTimings.save = ElapsedMilliseconds(start);
+
+  if (timings) {
+    *timings = localTimings;
+  }
+  return true;
+}
+
+} // namespace TextureCooker
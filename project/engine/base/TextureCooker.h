@@ -0,0 +1,31 @@
+﻿#pragma once
+#include <filesystem>
+#include <string>
+
+// テクスチャをミップマップ付き（必要なら圧縮済み）の.ddsに変換する
+// 読み込み・ミップマップ生成は実行時のTextureDecoderと同じものを、
+// 圧縮・保存はDirectXTexを使う（どの環境でも同じコード）
+namespace TextureCooker {
+
+// ブロック圧縮の種類
+enum class Compression {
+  None,
+  BC1, // RGB + 1bitアルファ
+  BC3, // RGBA
+  BC7, // RGBA（高品質・低速）
+};
+
+// 各工程にかかった時間（ミリ秒）
+struct Timings {
+  double decode = 0.0;
+  double mip = 0.0;
+  double compress = 0.0;
+  double save = 0.0;
+};
+
+// 1ファイル変換する。出力先はTextureDecoder::GetCookedFilePath
+// 失敗したらfalseを返し、errorMessageに理由を入れる
+bool CookFile(const std::filesystem::path &filePath, Compression compression,
+              Timings *timings = nullptr, std::string *errorMessage = nullptr);
+
+} // namespace TextureCooker
\ No newline at end of file
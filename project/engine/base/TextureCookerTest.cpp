@@ -0,0 +1,204 @@
+﻿#include "Check.h"
+#include "TextureCooker.h"
+#include "TextureDecoder.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#ifdef TEXTURE_DECODER_HAS_LIBPNG
+#include <png.h>
+#endif
+
+namespace {
+// 変換済みの.ddsを読む
+bool LoadCookedFile(const std::filesystem::path &source,
+                    DirectX::ScratchImage &image) {
+  std::filesystem::path cookedPath = TextureDecoder::GetCookedFilePath(source);
+  return SUCCEEDED(DirectX::LoadFromDDSFile(cookedPath.wstring().c_str(),
+                                            DirectX::DDS_FLAGS_NONE, nullptr,
+                                            image));
+}
+
+// 1段分のRGBA8の画素を詰めて取り出す
+std::vector<uint8_t> GetPixels(const DirectX::Image &image) {
+  std::vector<uint8_t> pixels;
+  for (size_t y = 0; y < image.height; ++y) {
+    const uint8_t *row = image.pixels + y * image.rowPitch;
+    pixels.insert(pixels.end(), row, row + image.width * 4);
+  }
+  return pixels;
+}
+
+#ifdef TEXTURE_DECODER_HAS_LIBPNG
+bool WritePng(const std::filesystem::path &filePath, uint32_t width,
+              uint32_t height, const std::vector<uint8_t> &pixels) {
+  png_image png{};
+  png.version = PNG_IMAGE_VERSION;
+  png.width = width;
+  png.height = height;
+  png.format = PNG_FORMAT_RGBA;
+  return png_image_write_to_file(&png, filePath.string().c_str(), 0,
+                                 pixels.data(), 0, nullptr) != 0;
+}
+
+// pngも実行時と同じ読み込み・ミップマップ生成を通る
+void TestCookPng(const std::filesystem::path &directory) {
+  // 左の2x2は白黒の市松、右の2x2は一色
+  const uint8_t kBlack[4] = {0, 0, 0, 255};
+  const uint8_t kWhite[4] = {255, 255, 255, 255};
+  const uint8_t kColor[4] = {10, 120, 240, 128};
+  const uint8_t *layout[2][4] = {{kBlack, kWhite, kColor, kColor},
+                                 {kWhite, kBlack, kColor, kColor}};
+  std::vector<uint8_t> pixels;
+  for (auto &row : layout) {
+    for (const uint8_t *pixel : row) {
+      pixels.insert(pixels.end(), pixel, pixel + 4);
+    }
+  }
+  std::filesystem::path source = directory / "checker.png";
+  CHECK(WritePng(source, 4, 2, pixels));
+
+  // 高さが4の倍数でないので、BC7を指定しても非圧縮で書き出す
+  TextureCooker::Timings timings{};
+  std::string errorMessage;
+  CHECK(TextureCooker::CookFile(source, TextureCooker::Compression::BC7,
+                                &timings, &errorMessage));
+  CHECK(errorMessage.empty());
+  CHECK(TextureDecoder::IsCookedFileFresh(source));
+
+  // 4x2, 2x1, 1x1の3段。libpngはsRGBチャンクを書くのでsRGBとして読まれる
+  DirectX::ScratchImage cooked;
+  CHECK(LoadCookedFile(source, cooked));
+  const DirectX::TexMetadata &metadata = cooked.GetMetadata();
+  CHECK(metadata.width == 4 && metadata.height == 2);
+  CHECK(metadata.mipLevels == 3);
+  CHECK(metadata.format == DXGI_FORMAT_R8G8B8A8_UNORM_SRGB);
+  if (metadata.mipLevels != 3) {
+    return;
+  }
+  CHECK(GetPixels(*cooked.GetImage(0, 0, 0)) == pixels);
+
+  // 白黒の平均は線形で0.5、sRGBで188になる
+  std::vector<uint8_t> level1 = GetPixels(*cooked.GetImage(1, 0, 0));
+  CHECK(level1[0] == 188 && level1[1] == 188 && level1[2] == 188);
+  CHECK(level1[3] == 255);
+  // 一色のところは変わらない
+  CHECK(std::memcmp(level1.data() + 4, kColor, 4) == 0);
+
+  // 実行時の読み込み（TextureDecoder::DecodeFile）は変換済みの方を使う
+  DirectX::ScratchImage decoded;
+  CHECK(SUCCEEDED(TextureDecoder::DecodeFile(source.wstring(), decoded)));
+  CHECK(decoded.GetMetadata().mipLevels == 3);
+}
+#endif
+
+// 4x4のブロックごとに一色の8x8をtgaで書く
+std::vector<uint8_t> WriteBlockTga(const std::filesystem::path &filePath) {
+  const uint8_t kColors[4][4] = {{200, 30, 30, 255},
+                                 {30, 200, 30, 255},
+                                 {30, 30, 200, 255},
+                                 {240, 240, 240, 255}};
+  DirectX::ScratchImage image;
+  image.Initialize2D(DXGI_FORMAT_R8G8B8A8_UNORM, 8, 8, 1, 1);
+  const DirectX::Image *pixels = image.GetImage(0, 0, 0);
+  for (size_t y = 0; y < 8; ++y) {
+    for (size_t x = 0; x < 8; ++x) {
+      const uint8_t *color = kColors[(y / 4) * 2 + x / 4];
+      std::memcpy(pixels->pixels + y * pixels->rowPitch + x * 4, color, 4);
+    }
+  }
+  CHECK(SUCCEEDED(DirectX::SaveToTGAFile(*pixels, filePath.wstring().c_str())));
+  return GetPixels(*pixels);
+}
+
+// ブロック圧縮した結果を展開すると元の色に近い
+void TestCompress(const std::filesystem::path &directory) {
+  struct Case {
+    TextureCooker::Compression compression;
+    DXGI_FORMAT format;
+    int tolerance;
+  };
+  // BC1/BC3の色は565に丸められる
+  const Case kCases[] = {
+      {TextureCooker::Compression::BC1, DXGI_FORMAT_BC1_UNORM, 8},
+      {TextureCooker::Compression::BC3, DXGI_FORMAT_BC3_UNORM, 8},
+      {TextureCooker::Compression::BC7, DXGI_FORMAT_BC7_UNORM, 2},
+  };
+  std::filesystem::path source = directory / "blocks.tga";
+  std::vector<uint8_t> pixels = WriteBlockTga(source);
+
+  for (const Case &c : kCases) {
+    TextureCooker::Timings timings{};
+    std::string errorMessage;
+    CHECK(TextureCooker::CookFile(source, c.compression, &timings,
+                                  &errorMessage));
+    CHECK(errorMessage.empty());
+    CHECK(timings.compress > 0.0);
+
+    // 8x8, 4x4, 2x2, 1x1の4段
+    DirectX::ScratchImage cooked;
+    CHECK(LoadCookedFile(source, cooked));
+    const DirectX::TexMetadata &metadata = cooked.GetMetadata();
+    CHECK(metadata.format == c.format);
+    CHECK(metadata.mipLevels == TextureDecoder::kMipLevels);
+
+    DirectX::ScratchImage decompressed;
+    CHECK(SUCCEEDED(DirectX::Decompress(*cooked.GetImage(0, 0, 0),
+                                        DXGI_FORMAT_R8G8B8A8_UNORM,
+                                        decompressed)));
+    if (decompressed.GetImageCount() == 0) {
+      continue;
+    }
+    std::vector<uint8_t> result = GetPixels(*decompressed.GetImage(0, 0, 0));
+    int maxError = 0;
+    for (size_t i = 0; i < pixels.size() && i < result.size(); ++i) {
+      maxError = (std::max)(maxError, std::abs(int(result[i]) - pixels[i]));
+    }
+    CHECK(result.size() == pixels.size());
+    CHECK(maxError <= c.tolerance);
+  }
+
+  // 圧縮しなければ元の画素のまま
+  CHECK(TextureCooker::CookFile(source, TextureCooker::Compression::None));
+  DirectX::ScratchImage cooked;
+  CHECK(LoadCookedFile(source, cooked));
+  CHECK(cooked.GetMetadata().format == DXGI_FORMAT_R8G8B8A8_UNORM);
+  CHECK(GetPixels(*cooked.GetImage(0, 0, 0)) == pixels);
+}
+
+void TestUnsupportedFiles(const std::filesystem::path &directory) {
+  std::string errorMessage;
+  // 壊れたtga
+  std::filesystem::path tga = directory / "image.tga";
+  std::ofstream(tga, std::ios::binary) << "not an image";
+  CHECK(!TextureCooker::CookFile(tga, TextureCooker::Compression::None,
+                                 nullptr, &errorMessage));
+  CHECK(!errorMessage.empty());
+
+  // 壊れたpng
+  errorMessage.clear();
+  std::filesystem::path broken = directory / "broken.png";
+  std::ofstream(broken, std::ios::binary) << "not a png";
+  CHECK(!TextureCooker::CookFile(broken, TextureCooker::Compression::None,
+                                 nullptr, &errorMessage));
+  CHECK(!errorMessage.empty());
+  CHECK(!std::filesystem::exists(TextureDecoder::GetCookedFilePath(broken)));
+}
+} // namespace
+
+int main() {
+  std::filesystem::path directory =
+      std::filesystem::temp_directory_path() / "TextureCookerTest";
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+
+#ifdef TEXTURE_DECODER_HAS_LIBPNG
+  TestCookPng(directory);
+#endif
+  TestCompress(directory);
+  TestUnsupportedFiles(directory);
+
+  std::filesystem::remove_all(directory);
+  return Test::Finish();
+}
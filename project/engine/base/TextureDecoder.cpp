@@ -0,0 +1,170 @@
+﻿#include "TextureDecoder.h"
+#include <algorithm>
+#include <cwctype>
+#if !defined(_WIN32) && defined(TEXTURE_DECODER_HAS_LIBPNG)
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <png.h>
+#include <vector>
+#endif
+
+namespace {
+// 拡張子を小文字で取り出す
+std::wstring GetExtension(const std::wstring &filePath) {
+  size_t dot = filePath.find_last_of(L'.');
+  if (dot == std::wstring::npos) {
+    return L"";
+  }
+  std::wstring extension = filePath.substr(dot);
+  std::transform(extension.begin(), extension.end(), extension.begin(),
+                 [](wchar_t c) { return static_cast<wchar_t>(std::towlower(c)); });
+  return extension;
+}
+
+#ifdef _WIN32
+// WICはスレッドごとにCOMの初期化が要る
+struct ComInitializer {
+  ComInitializer() { CoInitializeEx(nullptr, COINIT_MULTITHREADED); }
+  ~ComInitializer() { CoUninitialize(); }
+};
+#elif defined(TEXTURE_DECODER_HAS_LIBPNG)
+// pngがsRGBか。WICでの読み込み（DirectXTexのLoadFromWICFile）と同じく、
+// sRGBチャンクがあるか、gAMAが1/2.2ならsRGBとみなす
+bool IsPngSrgb(const std::vector<uint8_t> &data) {
+  const size_t kSignatureSize = 8;
+  size_t offset = kSignatureSize;
+  while (offset + 8 <= data.size()) {
+    uint32_t length = (uint32_t(data[offset]) << 24) |
+                      (uint32_t(data[offset + 1]) << 16) |
+                      (uint32_t(data[offset + 2]) << 8) | data[offset + 3];
+    const uint8_t *type = &data[offset + 4];
+    if (std::memcmp(type, "sRGB", 4) == 0) {
+      return true;
+    }
+    if (std::memcmp(type, "gAMA", 4) == 0 && length == 4 &&
+        offset + 12 <= data.size()) {
+      const uint8_t *value = &data[offset + 8];
+      uint32_t gamma = (uint32_t(value[0]) << 24) | (uint32_t(value[1]) << 16) |
+                       (uint32_t(value[2]) << 8) | value[3];
+      return gamma == 45455;
+    }
+    // 色空間のチャンクは画像データより前にしか無い
+    if (std::memcmp(type, "IDAT", 4) == 0) {
+      break;
+    }
+    offset += size_t(length) + 12;
+  }
+  return false;
+}
+
+// WICの無い環境でのpngの読み込み。WIC_FLAGS_FORCE_RGBと同じくRGBA8にする
+HRESULT LoadPngFile(const std::wstring &filePath,
+                    DirectX::ScratchImage &image) {
+  std::ifstream file(std::filesystem::path(filePath), std::ios::binary);
+  if (!file) {
+    return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+  }
+  std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)),
+                            std::istreambuf_iterator<char>());
+
+  png_image png{};
+  png.version = PNG_IMAGE_VERSION;
+  if (!png_image_begin_read_from_memory(&png, data.data(), data.size())) {
+    return E_FAIL;
+  }
+  png.format = PNG_FORMAT_RGBA;
+  DXGI_FORMAT format = IsPngSrgb(data) ? DXGI_FORMAT_R8G8B8A8_UNORM_SRGB
+                                       : DXGI_FORMAT_R8G8B8A8_UNORM;
+  HRESULT hr = image.Initialize2D(format, png.width, png.height, 1, 1);
+  if (FAILED(hr)) {
+    png_image_free(&png);
+    return hr;
+  }
+  const DirectX::Image *pixels = image.GetImage(0, 0, 0);
+  if (!png_image_finish_read(&png, nullptr, pixels->pixels,
+                             static_cast<png_int_32>(pixels->rowPitch),
+                             nullptr)) {
+    image.Release();
+    return E_FAIL;
+  }
+  return S_OK;
+}
+#endif
+} // namespace
+
+namespace TextureDecoder {
+
+HRESULT DecodeFile(const std::wstring &filePath,
+                   DirectX::ScratchImage &mipImages) {
+  DirectX::ScratchImage image{};
+  HRESULT hr = E_FAIL;
+
+  // 変換済みの.ddsがあればデコードもミップマップ生成も省く
+  if (GetExtension(filePath) != L".dds" && IsCookedFileFresh(filePath)) {
+    hr = LoadImageFile(GetCookedFilePath(filePath).wstring(), image);
+  } else {
+    hr = LoadImageFile(filePath, image);
+  }
+  if (FAILED(hr)) {
+    return hr;
+  }
+
+  return GenerateMips(image, mipImages);
+}
+
+HRESULT LoadImageFile(const std::wstring &filePath,
+                      DirectX::ScratchImage &image) {
+  HRESULT hr = E_FAIL;
+
+  std::wstring extension = GetExtension(filePath);
+  if (extension == L".dds") {
+    hr = DirectX::LoadFromDDSFile(filePath.c_str(), DirectX::DDS_FLAGS_NONE,
+                                  nullptr, image);
+  } else if (extension == L".tga") {
+    hr = DirectX::LoadFromTGAFile(filePath.c_str(), nullptr, image);
+  } else if (extension == L".hdr") {
+    hr = DirectX::LoadFromHDRFile(filePath.c_str(), nullptr, image);
+  } else {
+#ifdef _WIN32
+    thread_local ComInitializer comInitializer;
+    hr = DirectX::LoadFromWICFile(filePath.c_str(),
+                                  DirectX::WIC_FLAGS_FORCE_RGB, nullptr, image);
+#elif defined(TEXTURE_DECODER_HAS_LIBPNG)
+    // WICの無い環境ではpngだけlibpngで読む
+    if (extension == L".png") {
+      hr = LoadPngFile(filePath, image);
+    } else {
+      hr = E_NOTIMPL;
+    }
+#else
+    // WICの無い環境ではpng等は読めない
+    hr = E_NOTIMPL;
+#endif
+  }
+  return hr;
+}
+
+HRESULT GenerateMips(DirectX::ScratchImage &image,
+                     DirectX::ScratchImage &mipImages) {
+  const DirectX::TexMetadata &metadata = image.GetMetadata();
+  // 元からミップマップを持っている、または縮めようがないならそのまま使う
+  if (metadata.mipLevels > 1 || (metadata.width == 1 && metadata.height == 1) ||
+      DirectX::IsCompressed(metadata.format)) {
+    mipImages = std::move(image);
+    return S_OK;
+  }
+
+  // 作れる段数を超えないようにする
+  size_t levels = 1;
+  for (size_t size = (std::max)(metadata.width, metadata.height);
+       size > 1 && levels < kMipLevels; size /= 2) {
+    levels++;
+  }
+  return DirectX::GenerateMipMaps(image.GetImages(), image.GetImageCount(),
+                                  metadata, DirectX::TEX_FILTER_SRGB, levels,
+                                  mipImages);
+}
+
+} // namespace TextureDecoder
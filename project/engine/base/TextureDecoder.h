@@ -0,0 +1,25 @@
+﻿#pragma once
+#include "TextureDecoderCommon.h"
+#include "externals/DirectXTex/DirectXTex.h"
+#include <string>
+
+// テクスチャファイルのデコードとミップマップ生成（D3D12に依存しない部分）
+// ワーカースレッドから呼んでよい
+namespace TextureDecoder {
+
+// ファイルを読み込んでミップマップ付きのイメージを作る
+// 元ファイルより新しい変換済みの.ddsがあれば、そちらをそのまま使う
+HRESULT DecodeFile(const std::wstring &filePath,
+                   DirectX::ScratchImage &mipImages);
+
+// ファイルをそのまま読み込む（ミップマップは作らない）
+// .dds/.tga/.hdrはDirectXTexの移植可能な読み込みを使い、それ以外はWICを使う
+// （WICの無い環境では、libpngがあればpngだけ読める）
+HRESULT LoadImageFile(const std::wstring &filePath,
+                      DirectX::ScratchImage &image);
+
+// 読み込み済みのイメージからミップマップを作る。元から持っていればそのまま
+HRESULT GenerateMips(DirectX::ScratchImage &image,
+                     DirectX::ScratchImage &mipImages);
+
+} // namespace TextureDecoder
\ No newline at end of file
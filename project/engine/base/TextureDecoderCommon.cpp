@@ -0,0 +1,34 @@
+﻿#include "TextureDecoderCommon.h"
+
+namespace TextureDecoder {
+
+std::filesystem::path GetCookedFilePath(const std::filesystem::path &filePath) {
+  std::filesystem::path cookedPath = filePath;
+  cookedPath.replace_extension(".dds");
+  return cookedPath;
+}
+
+bool IsCookedFileFresh(const std::filesystem::path &filePath) {
+  std::error_code ec;
+  std::filesystem::path cookedPath = GetCookedFilePath(filePath);
+  if (!std::filesystem::exists(cookedPath, ec)) {
+    return false;
+  }
+  // 元ファイルが無ければ変換済みのものだけで動かす
+  if (!std::filesystem::exists(filePath, ec)) {
+    return true;
+  }
+  std::filesystem::file_time_type cookedTime =
+      std::filesystem::last_write_time(cookedPath, ec);
+  if (ec) {
+    return false;
+  }
+  std::filesystem::file_time_type sourceTime =
+      std::filesystem::last_write_time(filePath, ec);
+  if (ec) {
+    return false;
+  }
+  return cookedTime >= sourceTime;
+}
+
+} // namespace TextureDecoder
@@ -0,0 +1,17 @@
+﻿#pragma once
+#include <cstddef>
+#include <filesystem>
+
+// TextureDecoderのうちDirectXTexに依存しない部分
+namespace TextureDecoder {
+
+// 生成するミップマップの段数
+const size_t kMipLevels = 4;
+
+// 変換済みの.ddsのパス（拡張子を.ddsに置き換えたもの）
+std::filesystem::path GetCookedFilePath(const std::filesystem::path &filePath);
+
+// 変換済みの.ddsが元ファイルと同じか新しいか
+bool IsCookedFileFresh(const std::filesystem::path &filePath);
+
+} // namespace TextureDecoder
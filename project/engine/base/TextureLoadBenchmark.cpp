@@ -0,0 +1,113 @@
+﻿#include "Benchmark.h"
+#include "TextureDecoder.h"
+#include "ThreadPool.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// TextureManager::LoadTextureAsyncと同じ形で、ワーカーの数ごとに
+// 全テクスチャの読み込み（TextureDecoder::DecodeFile）が終わるまでの時間を測る
+// 読むのはDirectXTexの移植可能な読み込み（.tga/.dds）で書いたミップ無しの
+// ファイルなので、どのファイルもGenerateMipsでミップマップを作る
+namespace {
+// 読み終わったテクスチャ
+struct DecodedTexture {
+  uint32_t textureIndex;
+  DirectX::ScratchImage mipImages;
+};
+
+// 半分を.tga、半分を.ddsで書き出す
+std::vector<std::wstring> WriteTextureFiles(
+    const std::filesystem::path &directory, uint32_t count, uint32_t size) {
+  std::vector<std::wstring> filePaths;
+  DirectX::ScratchImage image;
+  image.Initialize2D(DXGI_FORMAT_R8G8B8A8_UNORM, size, size, 1, 1);
+  const DirectX::Image *pixels = image.GetImage(0, 0, 0);
+  for (uint32_t i = 0; i < count; ++i) {
+    // 1枚ごとに違う模様にする
+    uint32_t seed = i * 2654435761u + 1;
+    for (size_t offset = 0; offset < pixels->slicePitch; offset += 4) {
+      seed ^= seed << 13;
+      seed ^= seed >> 17;
+      seed ^= seed << 5;
+      std::memcpy(pixels->pixels + offset, &seed, 4);
+    }
+
+    char name[32];
+    std::snprintf(name, sizeof(name), "texture%03u.%s", i,
+                  (i % 2 == 0) ? "tga" : "dds");
+    std::wstring filePath = (directory / name).wstring();
+    HRESULT hr = (i % 2 == 0)
+                     ? DirectX::SaveToTGAFile(*pixels, filePath.c_str())
+                     : DirectX::SaveToDDSFile(*pixels, DirectX::DDS_FLAGS_NONE,
+                                              filePath.c_str());
+    if (FAILED(hr)) {
+      std::printf("failed to write %s (0x%08X)\n", name,
+                  static_cast<uint32_t>(hr));
+      return {};
+    }
+    filePaths.push_back(filePath);
+  }
+  return filePaths;
+}
+} // namespace
+
+int main() {
+  const uint32_t kTextureCount = 256;
+  const uint32_t kTextureSize = 256;
+  const uint32_t kRepeatCount = 3;
+
+  std::filesystem::path directory =
+      std::filesystem::temp_directory_path() / "TextureLoadBenchmark";
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+  std::vector<std::wstring> filePaths =
+      WriteTextureFiles(directory, kTextureCount, kTextureSize);
+  if (filePaths.empty()) {
+    return 1;
+  }
+
+  std::printf("%u textures of %ux%u (tga/dds, %u mips), %u hardware threads\n",
+              kTextureCount, kTextureSize, kTextureSize,
+              TextureDecoder::kMipLevels, std::thread::hardware_concurrency());
+  std::printf("%8s %12s %12s\n", "threads", "load ms", "ms/texture");
+  for (uint32_t threadCount : {1u, 2u, 4u, 8u}) {
+    ThreadPool threadPool;
+    threadPool.Initialize(threadCount);
+
+    std::vector<DecodedTexture> decodedTextures;
+    std::mutex decodedMutex;
+    uint32_t failedCount = 0;
+    double ms = Benchmark::MeasureBestMs(kRepeatCount, [&]() {
+      decodedTextures.clear();
+      for (uint32_t i = 0; i < kTextureCount; ++i) {
+        threadPool.Enqueue([&, i]() {
+          DecodedTexture texture{i, {}};
+          HRESULT hr =
+              TextureDecoder::DecodeFile(filePaths[i], texture.mipImages);
+
+          std::lock_guard<std::mutex> lock(decodedMutex);
+          if (FAILED(hr)) {
+            ++failedCount;
+            return;
+          }
+          decodedTextures.push_back(std::move(texture));
+        });
+      }
+      threadPool.WaitIdle();
+      Benchmark::Consume(decodedTextures.size());
+    });
+    threadPool.Finalize();
+    if (failedCount > 0) {
+      std::printf("%u textures failed to decode\n", failedCount);
+      return 1;
+    }
+    std::printf("%8u %12.2f %12.3f\n", threadCount, ms, ms / kTextureCount);
+  }
+
+  std::filesystem::remove_all(directory);
+  return 0;
+}
@@ -1,14 +1,16 @@
 ﻿#include "TextureManager.h"
 #include "DirectXCommon.h"
+#include "Logger.h"
 #include "StringUtility.h"
+#include "TextureDecoder.h"
+#include <cstring>
+#include <format>
+#include <latch>
 
 using namespace StringUtility;
 
 TextureManager *TextureManager::instance = nullptr;
 
-// ImGuiで0番を使用するため、1番から使用
-uint32_t TextureManager::kSRVIndexTop = 1;
-
 TextureManager *TextureManager::GetInstance() {
   if (instance == nullptr) {
     instance = new TextureManager;
@@ -22,66 +24,267 @@ void TextureManager::Initialize(DirectXCommon *dxCommon) {
 
   // SRVの数と同数
   textureDatas.reserve(DirectXCommon::kMaxSRVCount);
+
+  CreatePlaceholderTexture();
+
+  // デコード用のスレッドを立てる
+  threadPool.Initialize();
 }
 
 void TextureManager::Finalize() {
+  // ワーカーが積み終わるのを待ってから破棄する
+  instance->threadPool.Finalize();
   delete instance;
   instance = nullptr;
 }
 
-void TextureManager::LoadTexture(const std::string &filePath) {
+void TextureManager::Update() {
+  // 読み終わった分を受け取る
+  std::vector<DecodedTexture> textures;
+  {
+    std::lock_guard<std::mutex> lock(decodedMutex);
+    textures.swap(decodedTextures);
+  }
 
-  // テクスチャファイルを読んでプログラムで扱えるようにする
-  DirectX::ScratchImage image{};
-  auto it = std::find_if(textureDatas.begin(), textureDatas.end(),
-                         [&](TextureData &textureData) {
-                           return textureData.filePath == filePath;
-                         });
-  if (it != textureDatas.end()) {
-    // 読み込み済みなら早期return
-    return;
+  for (DecodedTexture &texture : textures) {
+    pendingCount--;
+    if (texture.loadGeneration !=
+        textureDatas[texture.textureIndex].loadGeneration) {
+      // 読み込み中に解放（または読み直し）されたので捨てる
+      continue;
+    }
+    if (FAILED(texture.hr)) {
+      // 読めなかったテクスチャは仮テクスチャのまま使い続ける
+      Logger::Log(std::format("Failed to load texture : {} (hr = 0x{:08X})\n",
+                              textureDatas[texture.textureIndex].filePath,
+                              static_cast<uint32_t>(texture.hr)));
+      continue;
+    }
+    FinalizeTexture(texture.textureIndex, texture.mipImages);
   }
+}
 
-  // テクスチャ枚数上限チェック
-  assert(textureDatas.size() + kSRVIndexTop < DirectXCommon::kMaxSRVCount);
+void TextureManager::LoadTexture(std::string_view filePath) {
 
-  std::wstring filePathW = ConvertString(filePath);
-  HRESULT hr = DirectX::LoadFromWICFile(
-      filePathW.c_str(), DirectX::WIC_FLAGS_FORCE_RGB, nullptr, image);
-  assert(SUCCEEDED(hr));
+  uint32_t textureIndex = 0;
+  if (!PrepareTextureData(filePath, textureIndex)) {
+    // 読み込み済み（または読み込み中）なら早期return
+    return;
+  }
 
-  // ミップマップの作成
+  // テクスチャファイルを読んでプログラムで扱えるようにする
   DirectX::ScratchImage mipImages{};
-  hr = DirectX::GenerateMipMaps(image.GetImages(), image.GetImageCount(),
-                                image.GetMetadata(), DirectX::TEX_FILTER_SRGB,
-                                4, mipImages);
+  HRESULT hr = TextureDecoder::DecodeFile(ConvertString(std::string(filePath)),
+                                          mipImages);
   assert(SUCCEEDED(hr));
 
-  // テクスチャデータを追加
-  textureDatas.resize(textureDatas.size() + 1);
-  // 追加したテクスチャデータの参照を取得する
-  TextureData &textureData = textureDatas.back();
-  textureData.filePath = filePath;
-  textureData.metadata = mipImages.GetMetadata();
-  textureData.resource = dxCommon->CreateTextureResource(textureData.metadata);
-  // テクスチャデータの要素数番号をSRVのインデックスを計算する
-  uint32_t srvIndex =
-      static_cast<uint32_t>(textureDatas.size() - 1) + kSRVIndexTop;
+  // 転送
+  FinalizeTexture(textureIndex, mipImages);
+}
 
-  textureData.srvHandleCPU = dxCommon->GetSRVCPUDescriptorHandle(srvIndex);
-  textureData.srvHandleGPU = dxCommon->GetSRVGPUDescriptorHandle(srvIndex);
-  // metaDataを基にSRVの設定
-  D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
-  srvDesc.Format = textureData.metadata.format;
-  srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-  srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D; // ２Dテクスチャ
-  srvDesc.Texture2D.MipLevels = UINT(textureData.metadata.mipLevels);
+uint32_t TextureManager::LoadTextureAsync(std::string_view filePath) {
 
-  // SRVの生成
-  dxCommon->GetDevice()->CreateShaderResourceView(
-      textureData.resource.Get(), &srvDesc, textureData.srvHandleCPU);
+  uint32_t textureIndex = 0;
+  if (!PrepareTextureData(filePath, textureIndex)) {
+    // 読み込み済み（または読み込み中）ならその番号
+    return textureIndex;
+  }
 
-  dxCommon->UploadTextureData(textureData.resource, mipImages);
+  // 番号だけ先に振る。転送されるまでは仮テクスチャが使われる
+  TextureData &textureData = textureDatas[textureIndex];
+  uint32_t loadGeneration = textureData.loadGeneration;
+  pendingCount++;
+
+  // デコードとミップマップ生成はワーカーで行う
+  std::wstring filePathW = ConvertString(textureData.filePath);
+  threadPool.Enqueue([this, textureIndex, loadGeneration, filePathW]() {
+    DecodedTexture texture{textureIndex, loadGeneration, S_OK, {}};
+    texture.hr = TextureDecoder::DecodeFile(filePathW, texture.mipImages);
+
+    std::lock_guard<std::mutex> lock(decodedMutex);
+    decodedTextures.push_back(std::move(texture));
+  });
+
+  return textureIndex;
+}
+
+void TextureManager::WaitForAllTextures() {
+  threadPool.WaitIdle();
+  Update();
+}
+
+void TextureManager::UnloadTexture(std::string_view filePath) {
+  uint32_t textureIndex = registry.Find(filePath);
+  if (textureIndex == TextureRegistry::kInvalidHandle) {
+    return;
+  }
+  TextureData &textureData = textureDatas[textureIndex];
+  if (textureData.srvHandle.IsNull()) {
+    // 解放済み
+    return;
+  }
+
+  // 読み込み中の結果はUpdateで捨てる
+  textureData.loadGeneration++;
+  textureData.isReady = false;
+  // このフレームの描画が参照していてもよいように、どちらも後で解放される
+  dxCommon->FreeSRV(textureData.srvHandle);
+  textureData.srvHandle = {};
+  dxCommon->ReleaseResource(std::move(textureData.resource));
+  textureData.metadata = {};
+}
+
+uint32_t TextureManager::LoadTextureAtlas(
+    std::string_view atlasName, const std::vector<std::string> &filePaths,
+    uint32_t pageSize) {
+  // 全ファイルをワーカーで読み、ページに並べる形式（RGBA8）に揃える
+  // 終わるのはlatchで待つ（非同期読み込みの結果はUpdateに任せたまま）
+  std::vector<DirectX::ScratchImage> images(filePaths.size());
+  std::vector<HRESULT> results(filePaths.size(), S_OK);
+  std::latch decoded(static_cast<std::ptrdiff_t>(filePaths.size()));
+  for (size_t i = 0; i < filePaths.size(); ++i) {
+    threadPool.Enqueue([&, i]() {
+      DirectX::ScratchImage image{};
+      results[i] =
+          TextureDecoder::LoadImageFile(ConvertString(filePaths[i]), image);
+      if (SUCCEEDED(results[i])) {
+        results[i] = ConvertToAtlasFormat(image, images[i]);
+      }
+      decoded.count_down();
+    });
+  }
+  decoded.wait();
+
+  // 読めなかったファイルは大きさ0のまま（詰められずkInvalidPageになる）
+  std::vector<AtlasPacker::Size> sizes(filePaths.size(), {0, 0});
+  for (size_t i = 0; i < filePaths.size(); ++i) {
+    if (FAILED(results[i])) {
+      Logger::Log(std::format("Failed to load texture : {} (hr = 0x{:08X})\n",
+                              filePaths[i],
+                              static_cast<uint32_t>(results[i])));
+      continue;
+    }
+    const DirectX::TexMetadata &metadata = images[i].GetMetadata();
+    sizes[i] = {static_cast<uint32_t>(metadata.width),
+                static_cast<uint32_t>(metadata.height)};
+  }
+
+  // ミップマップの一番小さい段でも隣のイメージと混ざらない余白にする
+  AtlasPacker packer;
+  packer.Initialize(pageSize, pageSize, kAtlasPadding);
+  std::vector<AtlasPacker::Placement> placements = packer.Pack(sizes);
+
+  // ページのイメージに書き写す（余白は透明な黒のまま）
+  std::vector<DirectX::ScratchImage> pageImages(packer.GetPageCount());
+  std::vector<HRESULT> pageResults(pageImages.size(), S_OK);
+  for (size_t page = 0; page < pageImages.size(); ++page) {
+    pageResults[page] =
+        pageImages[page].Initialize2D(kAtlasFormat, pageSize, pageSize, 1, 1);
+    if (SUCCEEDED(pageResults[page])) {
+      std::memset(pageImages[page].GetPixels(), 0,
+                  pageImages[page].GetPixelsSize());
+    }
+  }
+  for (size_t i = 0; i < filePaths.size(); ++i) {
+    const AtlasPacker::Placement &placement = placements[i];
+    if (placement.page == AtlasPacker::kInvalidPage) {
+      // ページに入らない大きさのイメージはアトラスに入れられない
+      if (SUCCEEDED(results[i])) {
+        Logger::Log(std::format(
+            "Texture is too large for atlas page : {} ({}x{}, page {}x{})\n",
+            filePaths[i], sizes[i].width, sizes[i].height, pageSize,
+            pageSize));
+      }
+      continue;
+    }
+    if (FAILED(pageResults[placement.page])) {
+      continue;
+    }
+    const DirectX::Image *source = images[i].GetImage(0, 0, 0);
+    const DirectX::Image *destination =
+        pageImages[placement.page].GetImage(0, 0, 0);
+    size_t rowSize = size_t(placement.rect.width) * 4;
+    for (uint32_t y = 0; y < placement.rect.height; ++y) {
+      std::memcpy(destination->pixels +
+                      (placement.rect.y + y) * destination->rowPitch +
+                      size_t(placement.rect.x) * 4,
+                  source->pixels + y * source->rowPitch, rowSize);
+    }
+  }
+
+  // ページごとのミップマップもワーカーで作る
+  std::vector<DirectX::ScratchImage> pageMipImages(pageImages.size());
+  std::latch mipmapped(static_cast<std::ptrdiff_t>(pageImages.size()));
+  for (size_t page = 0; page < pageImages.size(); ++page) {
+    threadPool.Enqueue([&, page]() {
+      if (SUCCEEDED(pageResults[page])) {
+        pageResults[page] = TextureDecoder::GenerateMips(pageImages[page],
+                                                         pageMipImages[page]);
+      }
+      mipmapped.count_down();
+    });
+  }
+  mipmapped.wait();
+
+  // テクスチャにする（GPUへの転送はこのスレッドで行う）
+  std::vector<uint32_t> pageTextureIndices(pageImages.size());
+  for (size_t page = 0; page < pageImages.size(); ++page) {
+    std::string pageName =
+        std::string(atlasName) + "#" + std::to_string(page);
+    AddTextureData(pageName);
+    pageTextureIndices[page] = static_cast<uint32_t>(textureDatas.size() - 1);
+    if (FAILED(pageResults[page])) {
+      // 作れなかったページは仮テクスチャのまま使い続ける
+      Logger::Log(
+          std::format("Failed to create atlas page : {} (hr = 0x{:08X})\n",
+                      pageName, static_cast<uint32_t>(pageResults[page])));
+      continue;
+    }
+    FinalizeTexture(pageTextureIndices[page], pageMipImages[page]);
+  }
+
+  // ファイルパスから場所を引けるようにする
+  for (size_t i = 0; i < filePaths.size(); ++i) {
+    AtlasRegion region{};
+    if (placements[i].page != AtlasPacker::kInvalidPage) {
+      const AtlasPacker::Rect &rect = placements[i].rect;
+      region = {pageTextureIndices[placements[i].page],
+                {float(rect.x), float(rect.y)},
+                {float(rect.width), float(rect.height)}};
+    } else {
+      // 入れられなかったファイルは、読み込み済みならそのテクスチャ全体を、
+      // 無ければLoadTextureAsyncで読めなかったときと同じく
+      // 転送されない番号にして仮テクスチャを使う
+      uint32_t textureIndex = registry.Find(filePaths[i]);
+      if (textureIndex == TextureRegistry::kInvalidHandle) {
+        AddTextureData(filePaths[i]);
+        textureIndex = static_cast<uint32_t>(textureDatas.size() - 1);
+      }
+      const DirectX::TexMetadata &metadata = GetMetaData(textureIndex);
+      region = {textureIndex,
+                {0.0f, 0.0f},
+                {float(metadata.width), float(metadata.height)}};
+    }
+    bool isInserted = false;
+    uint32_t handle = atlasRegistry.Register(filePaths[i], &isInserted);
+    if (isInserted) {
+      atlasRegions.push_back(region);
+    } else {
+      // 別のアトラスに入れ直したら新しいほうを使う
+      atlasRegions[handle] = region;
+    }
+  }
+
+  return packer.GetPageCount();
+}
+
+const TextureManager::AtlasRegion *
+TextureManager::FindAtlasRegion(std::string_view filePath) const {
+  uint32_t handle = atlasRegistry.Find(filePath);
+  if (handle == TextureRegistry::kInvalidHandle) {
+    return nullptr;
+  }
+  return &atlasRegions[handle];
 }
 
 D3D12_GPU_DESCRIPTOR_HANDLE
@@ -91,6 +294,10 @@ TextureManager::GetSrvHandleGPU(uint32_t textureIndex) {
   assert(textureIndex < textureDatas.size());
 
   TextureData &textureData = textureDatas[textureIndex];
+  // 読み込み中は仮テクスチャ
+  if (!textureData.isReady) {
+    return placeholder.srvHandleGPU;
+  }
   return textureData.srvHandleGPU;
 }
 
@@ -100,23 +307,148 @@ const DirectX::TexMetadata &TextureManager::GetMetaData(uint32_t textureIndex) {
   assert(textureIndex < textureDatas.size());
 
   TextureData &textureData = textureDatas[textureIndex];
+  // 読み込み中は仮テクスチャ
+  if (!textureData.isReady) {
+    return placeholder.metadata;
+  }
   return textureData.metadata;
 }
 
+bool TextureManager::IsTextureReady(uint32_t textureIndex) const {
+
+  // 範囲外指定違反チェック
+  assert(textureIndex < textureDatas.size());
+
+  return textureDatas[textureIndex].isReady;
+}
+
 uint32_t
-TextureManager::GetTextureIndexByFilePath(const std::string &filePath) {
+TextureManager::GetTextureIndexByFilePath(std::string_view filePath) {
   // 読み込み済みテクスチャを検索
-  auto it = std::find_if(textureDatas.begin(), textureDatas.end(),
-                         [&](TextureData &textureData) {
-                           return textureData.filePath == filePath;
-                         });
-  if (it != textureDatas.end()) {
+  uint32_t textureIndex = registry.Find(filePath);
+  if (textureIndex != TextureRegistry::kInvalidHandle) {
     // 読み込み済みなら要素番号を返す
-    uint32_t textureIndex =
-        static_cast<uint32_t>(std::distance(textureDatas.begin(), it));
     return textureIndex;
   }
 
   assert(0);
   return 0;
 }
+
+TextureManager::TextureData &
+TextureManager::AddTextureData(std::string_view filePath) {
+
+  // テクスチャデータを追加。登録番号と要素番号は一致させる
+  uint32_t textureIndex = registry.Register(filePath);
+  assert(textureIndex == textureDatas.size());
+  textureDatas.resize(textureDatas.size() + 1);
+  // 追加したテクスチャデータの参照を取得する
+  TextureData &textureData = textureDatas.back();
+  textureData.filePath = filePath;
+  AllocateTextureSrv(textureData);
+  return textureData;
+}
+
+bool TextureManager::PrepareTextureData(std::string_view filePath,
+                                        uint32_t &textureIndex) {
+  textureIndex = registry.Find(filePath);
+  if (textureIndex == TextureRegistry::kInvalidHandle) {
+    AddTextureData(filePath);
+    textureIndex = static_cast<uint32_t>(textureDatas.size() - 1);
+    return true;
+  }
+  TextureData &textureData = textureDatas[textureIndex];
+  if (!textureData.srvHandle.IsNull()) {
+    return false;
+  }
+  // 解放済みなら同じ番号で読み直す
+  AllocateTextureSrv(textureData);
+  textureData.loadGeneration++;
+  return true;
+}
+
+void TextureManager::AllocateTextureSrv(TextureData &textureData) {
+  // SRVは空いている番号を確保する（上限はDirectXCommon側でチェック）
+  textureData.srvHandle = dxCommon->AllocateSRV();
+  textureData.srvHandleCPU =
+      dxCommon->GetSRVCPUDescriptorHandle(textureData.srvHandle);
+  textureData.srvHandleGPU =
+      dxCommon->GetSRVGPUDescriptorHandle(textureData.srvHandle);
+}
+
+void TextureManager::FinalizeTexture(uint32_t textureIndex,
+                                     const DirectX::ScratchImage &mipImages) {
+  TextureData &textureData = textureDatas[textureIndex];
+  textureData.metadata = mipImages.GetMetadata();
+  textureData.resource = dxCommon->CreateTextureResource(textureData.metadata);
+
+  // metaDataを基にSRVの設定
+  D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
+  srvDesc.Format = textureData.metadata.format;
+  srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+  srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D; // ２Dテクスチャ
+  srvDesc.Texture2D.MipLevels = UINT(textureData.metadata.mipLevels);
+
+  // SRVの生成。まだ誰も参照していないスロットなので描画中でも書き込める
+  dxCommon->GetDevice()->CreateShaderResourceView(
+      textureData.resource.Get(), &srvDesc, textureData.srvHandleCPU);
+
+  dxCommon->UploadTextureData(textureData.resource, mipImages);
+
+  textureData.isReady = true;
+}
+
+HRESULT TextureManager::ConvertToAtlasFormat(DirectX::ScratchImage &image,
+                                             DirectX::ScratchImage &converted) {
+  HRESULT hr = S_OK;
+  // 圧縮されていれば先に戻す
+  if (DirectX::IsCompressed(image.GetMetadata().format)) {
+    DirectX::ScratchImage decompressed{};
+    hr = DirectX::Decompress(*image.GetImage(0, 0, 0), DXGI_FORMAT_UNKNOWN,
+                             decompressed);
+    if (FAILED(hr)) {
+      return hr;
+    }
+    image = std::move(decompressed);
+  }
+
+  // RGBA8ならsRGBかどうかに関わらずそのまま使う（読み込みと同じ扱い）
+  DXGI_FORMAT format = image.GetMetadata().format;
+  if (format == DXGI_FORMAT_R8G8B8A8_UNORM ||
+      format == DXGI_FORMAT_R8G8B8A8_UNORM_SRGB) {
+    return converted.InitializeFromImage(*image.GetImage(0, 0, 0));
+  }
+  return DirectX::Convert(*image.GetImage(0, 0, 0), DXGI_FORMAT_R8G8B8A8_UNORM,
+                          DirectX::TEX_FILTER_DEFAULT,
+                          DirectX::TEX_THRESHOLD_DEFAULT, converted);
+}
+
+void TextureManager::CreatePlaceholderTexture() {
+  // 白1ピクセルの仮テクスチャ
+  DirectX::ScratchImage image{};
+  HRESULT hr =
+      image.Initialize2D(DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, 1, 1, 1, 1);
+  assert(SUCCEEDED(hr));
+  uint32_t white = 0xFFFFFFFF;
+  std::memcpy(image.GetPixels(), &white, sizeof(white));
+
+  placeholder.filePath = "placeholder";
+  placeholder.metadata = image.GetMetadata();
+  placeholder.resource = dxCommon->CreateTextureResource(placeholder.metadata);
+  placeholder.srvHandle = dxCommon->AllocateSRV();
+  placeholder.srvHandleCPU =
+      dxCommon->GetSRVCPUDescriptorHandle(placeholder.srvHandle);
+  placeholder.srvHandleGPU =
+      dxCommon->GetSRVGPUDescriptorHandle(placeholder.srvHandle);
+
+  D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
+  srvDesc.Format = placeholder.metadata.format;
+  srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+  srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+  srvDesc.Texture2D.MipLevels = 1;
+  dxCommon->GetDevice()->CreateShaderResourceView(
+      placeholder.resource.Get(), &srvDesc, placeholder.srvHandleCPU);
+
+  dxCommon->UploadTextureData(placeholder.resource, image);
+  placeholder.isReady = true;
+}
@@ -1,12 +1,19 @@
 ﻿#pragma once
+#include "AtlasPacker.h"
 #include "DirectXCommon.h"
 #include "Sprite.h"
+#include "TextureDecoderCommon.h"
+#include "TextureRegistry.h"
+#include "ThreadPool.h"
 #include "externals/DirectXTex/DirectXTex.h"
 #include <algorithm>
 #include <cassert>
 #include <d3d12.h>
 #include <dxgi1_6.h>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <vector>
 #include <wrl.h>
 
 class DirectXCommon;
@@ -20,20 +27,64 @@ public:
   void Initialize(DirectXCommon *dxCommon);
   // 終了
   void Finalize();
+  // 更新。読み込みの終わったテクスチャをGPUに転送してSRVを作る（描画スレッドで呼ぶ）
+  void Update();
   // SRVインデックスの開始番号
-  uint32_t GetTextureIndexByFilePath(const std::string &filePath);
+  uint32_t GetTextureIndexByFilePath(std::string_view filePath);
   // テクスチャファイルの読み込み
-  void LoadTexture(const std::string &filePath);
+  void LoadTexture(std::string_view filePath);
+  // テクスチャファイルの非同期読み込み。番号はすぐ返し、
+  // 読み込みが終わるまでは仮テクスチャが使われる（読めなければそのまま）
+  uint32_t LoadTextureAsync(std::string_view filePath);
+  // 非同期読み込みが全部終わるまで待ってUpdateする
+  void WaitForAllTextures();
+  // テクスチャを解放する。番号はそのまま使え、以降は仮テクスチャになる
+  // （もう一度LoadTexture/LoadTextureAsyncすれば同じ番号で読み直す）
+  // SRVの番号とリソースはGPUが使い終わってから再利用・解放される
+  void UnloadTexture(std::string_view filePath);
+
+  // アトラスの中の1枚分の場所
+  struct AtlasRegion {
+    // ページのテクスチャ番号
+    uint32_t textureIndex;
+    // ページ内の左上座標と大きさ（ピクセル）
+    MyMath::Vector2 leftTop;
+    MyMath::Vector2 size;
+  };
+  // 複数のファイルを読んでページに詰め、ページごとに1枚のテクスチャにする
+  // 各ファイルのパスはFindAtlasRegionで引ける。戻り値はページ数
+  // 読めない・ページに入らないファイルはログを出し、仮テクスチャの場所にする
+  // デコードとミップマップ生成はワーカーで並べて行い、終わるまで待つ
+  uint32_t LoadTextureAtlas(std::string_view atlasName,
+                            const std::vector<std::string> &filePaths,
+                            uint32_t pageSize = kAtlasPageSize);
+  // アトラスに入っているファイルならその場所、なければnullptr
+  const AtlasRegion *FindAtlasRegion(std::string_view filePath) const;
 
   // テクスチャ番号からGPUハンドルを取得
   D3D12_GPU_DESCRIPTOR_HANDLE GetSrvHandleGPU(uint32_t textureIndex);
 
+  // 仮テクスチャ（白1ピクセル）のGPUハンドルを取得
+  D3D12_GPU_DESCRIPTOR_HANDLE GetPlaceholderSrvHandleGPU() const {
+    return placeholder.srvHandleGPU;
+  }
+
   // メタデータを取得
   const DirectX::TexMetadata &GetMetaData(uint32_t textureIndex);
 
+  // 読み込みが終わって使える状態か
+  bool IsTextureReady(uint32_t textureIndex) const;
+  // 読み込み待ちのテクスチャ数
+  uint32_t GetPendingTextureCount() const { return pendingCount; }
+
 private:
-  // SRVインデックスの開始信号
-  static uint32_t kSRVIndexTop;
+  // アトラスのページの大きさの既定値
+  static const uint32_t kAtlasPageSize = 2048;
+  // アトラスのイメージ間の余白。ミップマップの一番小さい段の1テクセル分
+  // （2^(段数-1)ピクセル）あれば、縮めても隣のイメージと混ざらない
+  static const uint32_t kAtlasPadding = 1u << (TextureDecoder::kMipLevels - 1);
+  // アトラスのページの形式（WICで読んだpngと同じ扱いにする）
+  static const DXGI_FORMAT kAtlasFormat = DXGI_FORMAT_R8G8B8A8_UNORM;
 
   DirectXCommon *dxCommon = nullptr;
 
@@ -48,10 +99,59 @@ private:
     std::string filePath;
     DirectX::TexMetadata metadata;
     Microsoft::WRL::ComPtr<ID3D12Resource> resource;
+    // DirectXCommonから確保したSRV
+    DescriptorHandle srvHandle;
     D3D12_CPU_DESCRIPTOR_HANDLE srvHandleCPU;
     D3D12_GPU_DESCRIPTOR_HANDLE srvHandleGPU;
+    // GPUに転送済みか
+    bool isReady = false;
+    // 読み込みを始めるたび・解放するたびに進める（古い読み込み結果を捨てる）
+    uint32_t loadGeneration = 0;
+  };
+
+  // ワーカースレッドで読み終わったテクスチャ
+  struct DecodedTexture {
+    uint32_t textureIndex;
+    // 読み込みを始めた時のloadGeneration
+    uint32_t loadGeneration;
+    HRESULT hr;
+    DirectX::ScratchImage mipImages;
   };
 
+  // 番号を振ってテクスチャデータを追加する
+  TextureData &AddTextureData(std::string_view filePath);
+  // 読み込むテクスチャの番号。未登録なら追加し、解放済みならSRVを取り直す
+  // 読み込み済み（または読み込み中）ならfalse
+  bool PrepareTextureData(std::string_view filePath, uint32_t &textureIndex);
+  // テクスチャデータにSRVを確保する
+  void AllocateTextureSrv(TextureData &textureData);
+  // 読み込んだイメージをGPUに転送してSRVを作る
+  void FinalizeTexture(uint32_t textureIndex,
+                       const DirectX::ScratchImage &mipImages);
+  // 仮テクスチャの作成
+  void CreatePlaceholderTexture();
+  // アトラスに並べる形式（ミップ0のRGBA8）に揃える
+  static HRESULT ConvertToAtlasFormat(DirectX::ScratchImage &image,
+                                      DirectX::ScratchImage &converted);
+
   // テクスチャデータ
   std::vector<TextureData> textureDatas;
+  // ファイルパスからtextureDatasの要素番号を引く表
+  TextureRegistry registry;
+
+  // アトラスに入れたファイルの場所
+  std::vector<AtlasRegion> atlasRegions;
+  // ファイルパスからatlasRegionsの要素番号を引く表
+  TextureRegistry atlasRegistry;
+
+  // 読み込み待ちの間に使う仮テクスチャ
+  TextureData placeholder;
+
+  // ワーカーから描画スレッドへ渡す、読み終わったテクスチャ
+  std::vector<DecodedTexture> decodedTextures;
+  std::mutex decodedMutex;
+  uint32_t pendingCount = 0;
+
+  // デコード用のスレッド（最後に宣言して最初に止める）
+  ThreadPool threadPool;
 };
\ No newline at end of file
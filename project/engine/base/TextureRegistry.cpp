@@ -0,0 +1,121 @@
+﻿#include "TextureRegistry.h"
+#include <cassert>
+
+namespace {
+// 区切り文字と大文字小文字を揃える
+char NormalizeChar(char c) {
+  if (c == '\\') {
+    return '/';
+  }
+  if (c >= 'A' && c <= 'Z') {
+    return static_cast<char>(c - 'A' + 'a');
+  }
+  return c;
+}
+
+// 最初の表の大きさ
+const size_t kInitialCapacity = 64;
+} // namespace
+
+uint32_t TextureRegistry::Register(std::string_view filePath,
+                                   bool *isInserted) {
+  // 埋まりが半分を超えないように広げる
+  if ((paths.size() + 1) * 2 > slots.size()) {
+    Rehash(slots.empty() ? kInitialCapacity : slots.size() * 2);
+  }
+
+  uint64_t hash = Hash(filePath);
+  Slot &slot = slots[Probe(hash, filePath)];
+  if (slot.handle != kInvalidHandle) {
+    // 登録済み
+    if (isInserted) {
+      *isInserted = false;
+    }
+    return slot.handle;
+  }
+
+  // 正規化したパスを保存して番号を振る
+  std::string normalizedPath(filePath.size(), '\0');
+  for (size_t i = 0; i < filePath.size(); ++i) {
+    normalizedPath[i] = NormalizeChar(filePath[i]);
+  }
+  slot.hash = hash;
+  slot.handle = static_cast<uint32_t>(paths.size());
+  paths.push_back(std::move(normalizedPath));
+
+  if (isInserted) {
+    *isInserted = true;
+  }
+  return slot.handle;
+}
+
+uint32_t TextureRegistry::Find(std::string_view filePath) const {
+  if (slots.empty()) {
+    return kInvalidHandle;
+  }
+  return slots[Probe(Hash(filePath), filePath)].handle;
+}
+
+const std::string &TextureRegistry::GetPath(uint32_t handle) const {
+  // 範囲外指定違反チェック
+  assert(handle < paths.size());
+  return paths[handle];
+}
+
+void TextureRegistry::Clear() {
+  paths.clear();
+  slots.clear();
+}
+
+uint64_t TextureRegistry::Hash(std::string_view filePath) {
+  // FNV-1a
+  uint64_t hash = 14695981039346656037ull;
+  for (char c : filePath) {
+    hash ^= static_cast<uint8_t>(NormalizeChar(c));
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+bool TextureRegistry::IsSamePath(std::string_view normalizedPath,
+                                 std::string_view filePath) {
+  if (normalizedPath.size() != filePath.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < filePath.size(); ++i) {
+    if (normalizedPath[i] != NormalizeChar(filePath[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+size_t TextureRegistry::Probe(uint64_t hash, std::string_view filePath) const {
+  size_t mask = slots.size() - 1;
+  size_t index = static_cast<size_t>(hash) & mask;
+  // 線形探索。半分以上は空いているので必ず止まる
+  while (slots[index].handle != kInvalidHandle) {
+    const Slot &slot = slots[index];
+    if (slot.hash == hash && IsSamePath(paths[slot.handle], filePath)) {
+      break;
+    }
+    index = (index + 1) & mask;
+  }
+  return index;
+}
+
+void TextureRegistry::Rehash(size_t capacity) {
+  std::vector<Slot> oldSlots = std::move(slots);
+  slots.assign(capacity, Slot{});
+  size_t mask = capacity - 1;
+  for (const Slot &slot : oldSlots) {
+    if (slot.handle == kInvalidHandle) {
+      continue;
+    }
+    size_t index = static_cast<size_t>(slot.hash) & mask;
+    while (slots[index].handle != kInvalidHandle) {
+      index = (index + 1) & mask;
+    }
+    slots[index] = slot;
+  }
+}
@@ -0,0 +1,51 @@
+﻿#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// テクスチャのファイルパスから番号を引く表（D3D12に依存しない部分）
+// パスは区切り文字と大文字小文字を揃えて1回だけ保存し、
+// オープンアドレス法のハッシュ表で番号を引く。番号は登録順で変わらない
+class TextureRegistry {
+public:
+  // 見つからなかったときの番号
+  static const uint32_t kInvalidHandle = UINT32_MAX;
+
+  // 登録済みならその番号、なければ登録して新しい番号を返す
+  // isInsertedには新しく登録したかどうかを返す
+  uint32_t Register(std::string_view filePath, bool *isInserted = nullptr);
+
+  // 登録済みの番号を返す。なければkInvalidHandle
+  uint32_t Find(std::string_view filePath) const;
+
+  // 番号から正規化済みのパスを取得
+  const std::string &GetPath(uint32_t handle) const;
+
+  // 登録数
+  uint32_t GetCount() const { return static_cast<uint32_t>(paths.size()); }
+
+  // 空にする
+  void Clear();
+
+private:
+  struct Slot {
+    uint64_t hash = 0;
+    uint32_t handle = kInvalidHandle;
+  };
+
+  // 正規化しながらハッシュを計算する（文字列は作らない）
+  static uint64_t Hash(std::string_view filePath);
+  // 正規化した上で同じパスか
+  static bool IsSamePath(std::string_view normalizedPath,
+                         std::string_view filePath);
+  // 登録済みのパスが入っているスロット、なければ入れるべき空きスロット
+  size_t Probe(uint64_t hash, std::string_view filePath) const;
+  // 表を広げて入れ直す
+  void Rehash(size_t capacity);
+
+  // 番号ごとの正規化済みパス
+  std::vector<std::string> paths;
+  // ハッシュ表（大きさは2の累乗）
+  std::vector<Slot> slots;
+};
\ No newline at end of file
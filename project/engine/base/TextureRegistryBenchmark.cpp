@@ -0,0 +1,43 @@
+﻿#include "Benchmark.h"
+#include "TextureRegistry.h"
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// 4096枚登録した状態で、パスから番号を引く時間を比べる
+// 以前のTextureManagerは配列を先頭から見て文字列を比べていた
+int main() {
+  const uint32_t kTextureCount = 4096;
+  const uint32_t kRepeatCount = 5;
+
+  std::vector<std::string> paths;
+  for (uint32_t i = 0; i < kTextureCount; ++i) {
+    paths.push_back("resources/textures/texture_" + std::to_string(i) +
+                    ".png");
+  }
+  TextureRegistry registry;
+  for (const std::string &path : paths) {
+    registry.Register(path);
+  }
+
+  // 全部のパスを1回ずつ引く
+  double linearMs = Benchmark::MeasureBestMs(kRepeatCount, [&]() {
+    for (const std::string &path : paths) {
+      auto it = std::find_if(paths.begin(), paths.end(),
+                             [&](const std::string &p) { return p == path; });
+      Benchmark::Consume(static_cast<uint64_t>(it - paths.begin()));
+    }
+  });
+  double registryMs = Benchmark::MeasureBestMs(kRepeatCount, [&]() {
+    for (const std::string &path : paths) {
+      Benchmark::Consume(registry.Find(path));
+    }
+  });
+
+  double toNs = 1e6 / kTextureCount;
+  std::printf("%u textures\n", kTextureCount);
+  std::printf("linear scan : %10.1f ns/lookup\n", linearMs * toNs);
+  std::printf("registry    : %10.1f ns/lookup\n", registryMs * toNs);
+  return 0;
+}
@@ -0,0 +1,87 @@
+﻿#include "Check.h"
+#include "TextureRegistry.h"
+#include <string>
+
+namespace {
+// TextureRegistryと同じFNV-1a（正規化済みの文字列に対して）
+uint64_t HashNormalized(const std::string &path) {
+  uint64_t hash = 14695981039346656037ull;
+  for (char c : path) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+void TestNormalization() {
+  TextureRegistry registry;
+  bool isInserted = false;
+  uint32_t handle = registry.Register("Resources\\Tex\\UVChecker.PNG",
+                                      &isInserted);
+  CHECK(isInserted);
+  CHECK(handle == 0);
+  CHECK(registry.GetPath(handle) == "resources/tex/uvchecker.png");
+
+  // 区切り文字と大文字小文字が違っても同じテクスチャ
+  CHECK(registry.Find("resources/tex/uvchecker.png") == handle);
+  CHECK(registry.Find("RESOURCES/TEX/UVCHECKER.PNG") == handle);
+  CHECK(registry.Register("resources\\tex/uvChecker.png", &isInserted) ==
+        handle);
+  CHECK(!isInserted);
+  CHECK(registry.GetCount() == 1);
+
+  // 長さや中身が違えば別物
+  CHECK(registry.Find("resources/tex/uvchecker.pn") ==
+        TextureRegistry::kInvalidHandle);
+  CHECK(registry.Find("resources/tex/uvchecker.jpg") ==
+        TextureRegistry::kInvalidHandle);
+
+  // 空にすると見つからない
+  registry.Clear();
+  CHECK(registry.GetCount() == 0);
+  CHECK(registry.Find("resources/tex/uvchecker.png") ==
+        TextureRegistry::kInvalidHandle);
+}
+
+void TestCollisionProbing() {
+  // 最初の表（64スロット）で同じスロットに落ちるパスを集める
+  const uint64_t kMask = 63;
+  std::string first = "tex/0.png";
+  std::vector<std::string> colliding{first};
+  for (uint32_t i = 1; colliding.size() < 4; ++i) {
+    std::string path = "tex/" + std::to_string(i) + ".png";
+    if ((HashNormalized(path) & kMask) == (HashNormalized(first) & kMask)) {
+      colliding.push_back(path);
+    }
+  }
+
+  TextureRegistry registry;
+  for (uint32_t i = 0; i < colliding.size(); ++i) {
+    CHECK(registry.Register(colliding[i]) == i);
+  }
+  // 線形探索で押し出された先でも見つかる
+  for (uint32_t i = 0; i < colliding.size(); ++i) {
+    CHECK(registry.Find(colliding[i]) == i);
+    CHECK(registry.GetPath(i) == colliding[i]);
+  }
+
+  // 表を何度も広げても番号は登録順のまま
+  for (uint32_t i = 0; i < 4096; ++i) {
+    registry.Register("grow/" + std::to_string(i) + ".png");
+  }
+  for (uint32_t i = 0; i < colliding.size(); ++i) {
+    CHECK(registry.Find(colliding[i]) == i);
+  }
+  uint32_t base = static_cast<uint32_t>(colliding.size());
+  for (uint32_t i = 0; i < 4096; ++i) {
+    CHECK(registry.Find("GROW\\" + std::to_string(i) + ".png") == base + i);
+  }
+  CHECK(registry.Find("grow/4096.png") == TextureRegistry::kInvalidHandle);
+}
+} // namespace
+
+int main() {
+  TestNormalization();
+  TestCollisionProbing();
+  return Test::Finish();
+}
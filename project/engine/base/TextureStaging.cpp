@@ -0,0 +1,54 @@
+﻿#include "TextureStaging.h"
+#include <cassert>
+#include <cstring>
+
+namespace {
+// valueをalignment（2の累乗）の倍数に切り上げる
+uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+  return (value + alignment - 1) & ~(alignment - 1);
+}
+} // namespace
+
+namespace TextureStaging {
+
+uint64_t ComputeFootprints(const SubresourceDesc *descs, uint32_t count,
+                           uint64_t baseOffset, Footprint *footprints) {
+  uint64_t offset = baseOffset;
+  for (uint32_t i = 0; i < count; ++i) {
+    const SubresourceDesc &desc = descs[i];
+    assert(desc.blockSize == 1 || desc.blockSize == 4);
+    // 圧縮形式は4x4ブロック単位で行を数える
+    uint32_t blockColumns = (desc.width + desc.blockSize - 1) / desc.blockSize;
+    uint32_t blockRows = (desc.height + desc.blockSize - 1) / desc.blockSize;
+
+    Footprint &footprint = footprints[i];
+    offset = AlignUp(offset, kPlacementAlignment);
+    footprint.offset = offset;
+    footprint.width = blockColumns * desc.blockSize;
+    footprint.height = blockRows * desc.blockSize;
+    footprint.rowSizeInBytes = blockColumns * desc.bytesPerBlock;
+    footprint.rowPitch = static_cast<uint32_t>(
+        AlignUp(footprint.rowSizeInBytes, kRowPitchAlignment));
+    footprint.rowCount = blockRows;
+
+    offset += uint64_t(footprint.rowPitch) * footprint.rowCount;
+  }
+  return offset - baseOffset;
+}
+
+void PackSubresource(uint8_t *stagingBase, const Footprint &footprint,
+                     const uint8_t *source, size_t sourceRowPitch) {
+  uint8_t *destination = stagingBase + footprint.offset;
+  // ピッチが同じなら1回で写せる
+  if (sourceRowPitch == footprint.rowPitch) {
+    std::memcpy(destination, source,
+                size_t(footprint.rowPitch) * footprint.rowCount);
+    return;
+  }
+  for (uint32_t row = 0; row < footprint.rowCount; ++row) {
+    std::memcpy(destination + size_t(row) * footprint.rowPitch,
+                source + row * sourceRowPitch, footprint.rowSizeInBytes);
+  }
+}
+
+} // namespace TextureStaging
@@ -0,0 +1,49 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// テクスチャをステージングバッファに詰めるための配置計算（D3D12に依存しない部分）
+// CopyTextureRegionが要求する行ピッチ（256バイト）と
+// サブリソースの先頭（512バイト）の境界に合わせて並べる
+namespace TextureStaging {
+
+// 行ピッチの境界（D3D12_TEXTURE_DATA_PITCH_ALIGNMENT）
+const uint32_t kRowPitchAlignment = 256;
+// サブリソースの先頭の境界（D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT）
+const uint32_t kPlacementAlignment = 512;
+
+// サブリソース1つ分の大きさ
+struct SubresourceDesc {
+  uint32_t width;
+  uint32_t height;
+  // 1ブロックのバイト数。非圧縮なら1ピクセルのバイト数
+  uint32_t bytesPerBlock;
+  // ブロックの一辺のピクセル数。非圧縮なら1、BC圧縮なら4
+  uint32_t blockSize;
+};
+
+// ステージングバッファ内のサブリソースの配置
+struct Footprint {
+  // バッファ先頭からの位置
+  uint64_t offset;
+  // 大きさ（圧縮形式はブロックの倍数に切り上げる）
+  uint32_t width;
+  uint32_t height;
+  // 境界に合わせた行ピッチ
+  uint32_t rowPitch;
+  // 行（ブロック行）の数と、1行の実データのバイト数
+  uint32_t rowCount;
+  uint32_t rowSizeInBytes;
+};
+
+// サブリソースを順に並べたときの配置を計算する。戻り値は必要な合計バイト数
+uint64_t ComputeFootprints(const SubresourceDesc *descs, uint32_t count,
+                           uint64_t baseOffset, Footprint *footprints);
+
+// 1つのサブリソースをステージングバッファに写す
+// sourceRowPitchは元データの1行（ブロック行）のバイト数
+void PackSubresource(uint8_t *stagingBase, const Footprint &footprint,
+                     const uint8_t *source, size_t sourceRowPitch);
+
+} // namespace TextureStaging
@@ -0,0 +1,195 @@
+﻿#include "Check.h"
+#include "TextureStaging.h"
+#include <algorithm>
+#include <vector>
+
+using namespace TextureStaging;
+
+namespace {
+// ミップマップの連なりの大きさを作る（幅・高さは半分ずつ、最小1）
+std::vector<SubresourceDesc> MakeMipChain(uint32_t width, uint32_t height,
+                                          uint32_t mipLevels,
+                                          uint32_t bytesPerBlock,
+                                          uint32_t blockSize) {
+  std::vector<SubresourceDesc> descs(mipLevels);
+  for (uint32_t i = 0; i < mipLevels; ++i) {
+    descs[i] = {(std::max)(1u, width >> i), (std::max)(1u, height >> i),
+                bytesPerBlock, blockSize};
+  }
+  return descs;
+}
+
+// RGBA8 256x256の9段。GetCopyableFootprintsと同じ値を手で並べたもの
+void TestUncompressedMipChain() {
+  std::vector<SubresourceDesc> descs = MakeMipChain(256, 256, 9, 4, 1);
+  std::vector<Footprint> footprints(descs.size());
+  uint64_t size = ComputeFootprints(descs.data(), 9, 0, footprints.data());
+
+  const uint64_t offsets[] = {0,      262144, 327680, 344064, 352256,
+                              356352, 358400, 359424, 359936};
+  const uint32_t rowPitches[] = {1024, 512, 256, 256, 256, 256, 256, 256, 256};
+  for (uint32_t i = 0; i < 9; ++i) {
+    CHECK(footprints[i].offset == offsets[i]);
+    CHECK(footprints[i].rowPitch == rowPitches[i]);
+    CHECK(footprints[i].width == descs[i].width);
+    CHECK(footprints[i].height == descs[i].height);
+    CHECK(footprints[i].rowCount == descs[i].height);
+    CHECK(footprints[i].rowSizeInBytes == descs[i].width * 4);
+    // サブリソースの先頭と行ピッチは境界にそろう
+    CHECK(footprints[i].offset % kPlacementAlignment == 0);
+    CHECK(footprints[i].rowPitch % kRowPitchAlignment == 0);
+  }
+  // 最後の1x1も1行分（256バイト）を使う
+  CHECK(size == 359936 + 256);
+}
+
+// BC圧縮は4x4ブロック単位。半端な大きさはブロックの倍数に切り上げる
+void TestCompressed() {
+  // BC1（8バイト/ブロック）100x60
+  std::vector<SubresourceDesc> descs = MakeMipChain(100, 60, 7, 8, 4);
+  std::vector<Footprint> footprints(descs.size());
+  uint64_t size = ComputeFootprints(descs.data(), 7, 0, footprints.data());
+
+  // 100x60 -> 25x15ブロック
+  CHECK(footprints[0].width == 100 && footprints[0].height == 60);
+  CHECK(footprints[0].rowCount == 15);
+  CHECK(footprints[0].rowSizeInBytes == 200);
+  CHECK(footprints[0].rowPitch == 256);
+  // 50x30 -> 13x8ブロック（52x32）
+  CHECK(footprints[1].width == 52 && footprints[1].height == 32);
+  CHECK(footprints[1].rowCount == 8);
+  CHECK(footprints[1].rowSizeInBytes == 104);
+  CHECK(footprints[1].offset == 15 * 256 + 256); // 3840を512に切り上げ
+  // 1x1も1ブロック（4x4）
+  CHECK(footprints[6].width == 4 && footprints[6].height == 4);
+  CHECK(footprints[6].rowCount == 1);
+  CHECK(footprints[6].rowSizeInBytes == 8);
+  CHECK(size == footprints[6].offset + 256);
+
+  // BC7（16バイト/ブロック）64x64。1行が256バイトちょうど
+  SubresourceDesc bc7 = {64, 64, 16, 4};
+  Footprint footprint;
+  CHECK(ComputeFootprints(&bc7, 1, 0, &footprint) == 16 * 256);
+  CHECK(footprint.rowSizeInBytes == 256 && footprint.rowPitch == 256);
+}
+
+// 先頭の位置がずれていても、各サブリソースは512の境界から置く
+// 戻り値は先頭の位置からの合計
+void TestBaseOffset() {
+  std::vector<SubresourceDesc> descs = MakeMipChain(16, 16, 2, 4, 1);
+  std::vector<Footprint> footprints(2);
+  uint64_t size = ComputeFootprints(descs.data(), 2, 1000, footprints.data());
+  CHECK(footprints[0].offset == 1024);
+  CHECK(footprints[1].offset == 1024 + 16 * 256);
+  CHECK(size == footprints[1].offset + 8 * 256 - 1000);
+
+  // 境界ちょうどならずらさない
+  ComputeFootprints(descs.data(), 2, 2048, footprints.data());
+  CHECK(footprints[0].offset == 2048);
+}
+
+// 詰めた結果。実データは元と一致し、行の余り（パディング）には書かない
+void CheckPacked(const std::vector<uint8_t> &staging,
+                 const Footprint &footprint, const std::vector<uint8_t> &source,
+                 size_t sourceRowPitch, bool checkPadding) {
+  bool isDataEqual = true;
+  bool isPaddingUntouched = true;
+  for (uint32_t row = 0; row < footprint.rowCount; ++row) {
+    const uint8_t *destination =
+        staging.data() + footprint.offset + size_t(row) * footprint.rowPitch;
+    for (uint32_t x = 0; x < footprint.rowPitch; ++x) {
+      if (x < footprint.rowSizeInBytes) {
+        isDataEqual =
+            isDataEqual && destination[x] == source[row * sourceRowPitch + x];
+      } else {
+        isPaddingUntouched = isPaddingUntouched && destination[x] == 0xCD;
+      }
+    }
+  }
+  CHECK(isDataEqual);
+  if (checkPadding) {
+    CHECK(isPaddingUntouched);
+  }
+  // サブリソースの前は触らない
+  bool isBeforeUntouched = true;
+  for (uint64_t i = 0; i < footprint.offset; ++i) {
+    isBeforeUntouched = isBeforeUntouched && staging[i] == 0xCD;
+  }
+  CHECK(isBeforeUntouched);
+}
+
+std::vector<uint8_t> MakeSource(size_t size) {
+  std::vector<uint8_t> source(size);
+  for (size_t i = 0; i < size; ++i) {
+    source[i] = static_cast<uint8_t>(i * 7 + i / 251);
+  }
+  return source;
+}
+
+void TestPackSubresource() {
+  // 行が詰まった元データ（RGBA8 30x5 = 120バイト/行）
+  SubresourceDesc desc = {30, 5, 4, 1};
+  Footprint footprint;
+  uint64_t size = ComputeFootprints(&desc, 1, 600, &footprint);
+  std::vector<uint8_t> staging(600 + size, 0xCD);
+  std::vector<uint8_t> source = MakeSource(120 * 5);
+  PackSubresource(staging.data(), footprint, source.data(), 120);
+  CheckPacked(staging, footprint, source, 120, true);
+
+  // 元の行ピッチが実データより広い（元の余りは写さない）
+  std::fill(staging.begin(), staging.end(), uint8_t(0xCD));
+  source = MakeSource(160 * 5);
+  PackSubresource(staging.data(), footprint, source.data(), 160);
+  CheckPacked(staging, footprint, source, 160, true);
+
+  // 行ピッチが同じなら1回で写す（行の余りも元のまま写る）
+  desc = {30, 8, 4, 1};
+  ComputeFootprints(&desc, 1, 0, &footprint);
+  CHECK(footprint.rowPitch == 256 && footprint.rowSizeInBytes == 120);
+  staging.assign(footprint.rowPitch * footprint.rowCount, 0xCD);
+  source = MakeSource(256 * 8);
+  PackSubresource(staging.data(), footprint, source.data(), 256);
+  CheckPacked(staging, footprint, source, 256, false);
+  CHECK(staging == source);
+}
+
+// ミップマップ全段を1つのバッファに詰めても重ならない
+void TestPackMipChain() {
+  std::vector<SubresourceDesc> descs = MakeMipChain(100, 60, 7, 4, 1);
+  std::vector<Footprint> footprints(descs.size());
+  uint64_t size = ComputeFootprints(descs.data(), 7, 0, footprints.data());
+  std::vector<uint8_t> staging(size, 0xCD);
+  std::vector<std::vector<uint8_t>> sources;
+  for (uint32_t i = 0; i < 7; ++i) {
+    size_t rowPitch = descs[i].width * 4;
+    sources.push_back(MakeSource(rowPitch * descs[i].height));
+    // 段ごとに値を変えて取り違えを見つける
+    for (uint8_t &value : sources.back()) {
+      value = static_cast<uint8_t>(value + i * 31);
+    }
+    PackSubresource(staging.data(), footprints[i], sources.back().data(),
+                    rowPitch);
+  }
+  for (uint32_t i = 0; i < 7; ++i) {
+    const Footprint &footprint = footprints[i];
+    bool isEqual = true;
+    for (uint32_t row = 0; row < footprint.rowCount; ++row) {
+      for (uint32_t x = 0; x < footprint.rowSizeInBytes; ++x) {
+        isEqual = isEqual &&
+                  staging[footprint.offset + row * footprint.rowPitch + x] ==
+                      sources[i][row * footprint.rowSizeInBytes + x];
+      }
+    }
+    CHECK(isEqual);
+  }
+}
+} // namespace
+
+int main() {
+  TestUncompressedMipChain();
+  TestCompressed();
+  TestBaseOffset();
+  TestPackSubresource();
+  TestPackMipChain();
+  return Test::Finish();
+}
@@ -0,0 +1,72 @@
+﻿#include "ThreadPool.h"
+#include <cassert>
+
+ThreadPool::~ThreadPool() { Finalize(); }
+
+void ThreadPool::Initialize(uint32_t threadCount) {
+  assert(workers.empty());
+  if (threadCount == 0) {
+    // メインスレッドの分を1つ残す
+    uint32_t hardwareCount = std::thread::hardware_concurrency();
+    threadCount = hardwareCount > 1 ? hardwareCount - 1 : 1;
+  }
+
+  isStopping = false;
+  workers.reserve(threadCount);
+  for (uint32_t i = 0; i < threadCount; ++i) {
+    workers.emplace_back([this]() { WorkerMain(); });
+  }
+}
+
+void ThreadPool::Finalize() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    isStopping = true;
+  }
+  jobAvailable.notify_all();
+  for (std::thread &worker : workers) {
+    worker.join();
+  }
+  workers.clear();
+}
+
+void ThreadPool::Enqueue(std::function<void()> job) {
+  assert(!workers.empty());
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    jobs.push_back(std::move(job));
+  }
+  jobAvailable.notify_one();
+}
+
+void ThreadPool::WaitIdle() {
+  std::unique_lock<std::mutex> lock(mutex);
+  idle.wait(lock, [this]() { return jobs.empty() && runningCount == 0; });
+}
+
+void ThreadPool::WorkerMain() {
+  while (true) {
+    std::function<void()> job;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      jobAvailable.wait(lock, [this]() { return isStopping || !jobs.empty(); });
+      // 終了指示があっても積まれている分は片付ける
+      if (jobs.empty()) {
+        return;
+      }
+      job = std::move(jobs.front());
+      jobs.pop_front();
+      runningCount++;
+    }
+
+    job();
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      runningCount--;
+      if (jobs.empty() && runningCount == 0) {
+        idle.notify_all();
+      }
+    }
+  }
+}
@@ -0,0 +1,45 @@
+﻿#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 固定数のワーカースレッドで仕事を順に処理するプール
+class ThreadPool {
+public:
+  ~ThreadPool();
+
+  // 初期化。threadCountが0ならハードウェアのスレッド数から決める
+  void Initialize(uint32_t threadCount = 0);
+
+  // 終了。積まれている仕事を全部終えてからスレッドを止める
+  void Finalize();
+
+  // 仕事を積む
+  void Enqueue(std::function<void()> job);
+
+  // 積んだ仕事が全部終わるまで待つ
+  void WaitIdle();
+
+  uint32_t GetThreadCount() const {
+    return static_cast<uint32_t>(workers.size());
+  }
+
+private:
+  // ワーカースレッドの本体
+  void WorkerMain();
+
+  std::vector<std::thread> workers;
+  std::deque<std::function<void()>> jobs;
+  std::mutex mutex;
+  // 仕事が積まれた・終了を知らせる
+  std::condition_variable jobAvailable;
+  // 全部終わったことを知らせる
+  std::condition_variable idle;
+  // 実行中の仕事の数
+  uint32_t runningCount = 0;
+  bool isStopping = false;
+};
\ No newline at end of file
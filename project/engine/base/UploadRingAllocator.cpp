@@ -0,0 +1,98 @@
+﻿#include "UploadRingAllocator.h"
+#include <algorithm>
+#include <cassert>
+
+namespace {
+// valueをalignment（2の累乗）の倍数に切り上げる
+size_t AlignUp(size_t value, size_t alignment) {
+  return (value + alignment - 1) & ~(alignment - 1);
+}
+} // namespace
+
+void UploadRingAllocator::Initialize(uint32_t frameCount, size_t pageSize,
+                                     PageProvider provider) {
+  assert(frameCount > 0);
+  assert(provider);
+  this->pageSize = pageSize;
+  this->provider = provider;
+
+  slots.clear();
+  slots.resize(frameCount);
+  for (FrameSlot &slot : slots) {
+    AddPage(slot, pageSize);
+  }
+  frameIndex = 0;
+}
+
+void UploadRingAllocator::BeginFrame(uint32_t frameIndex,
+                                     uint64_t completedFenceValue) {
+  assert(frameIndex < slots.size());
+  FrameSlot &slot = slots[frameIndex];
+  // GPUがまだ読んでいるかもしれない領域は巻き戻さない
+  assert(IsSlotReusable(frameIndex, completedFenceValue));
+  (void)completedFenceValue;
+
+  this->frameIndex = frameIndex;
+  // ページは残したまま先頭から使い直す
+  slot.pageIndex = 0;
+  slot.offset = 0;
+}
+
+void UploadRingAllocator::EndFrame(uint64_t fenceValue) {
+  slots[frameIndex].fenceValue = fenceValue;
+}
+
+bool UploadRingAllocator::IsSlotReusable(uint32_t frameIndex,
+                                         uint64_t completedFenceValue) const {
+  assert(frameIndex < slots.size());
+  return slots[frameIndex].fenceValue <= completedFenceValue;
+}
+
+UploadAllocation UploadRingAllocator::Allocate(size_t sizeInBytes,
+                                               size_t alignment) {
+  assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+  FrameSlot &slot = slots[frameIndex];
+
+  size_t offset = AlignUp(slot.offset, alignment);
+  // 今のページに入らなければ次のページへ。無ければ足す
+  while (offset + sizeInBytes > slot.pages[slot.pageIndex].size) {
+    slot.pageIndex++;
+    if (slot.pageIndex == slot.pages.size()) {
+      AddPage(slot, sizeInBytes + alignment);
+    }
+    offset = 0;
+  }
+
+  const Page &page = slot.pages[slot.pageIndex];
+  slot.offset = offset + sizeInBytes;
+
+  UploadAllocation allocation;
+  allocation.cpuAddress = page.cpuBase + offset;
+  allocation.gpuAddress = page.gpuBase + offset;
+  return allocation;
+}
+
+size_t UploadRingAllocator::GetUsedSize() const {
+  const FrameSlot &slot = slots[frameIndex];
+  size_t used = slot.offset;
+  for (size_t i = 0; i < slot.pageIndex; ++i) {
+    used += slot.pages[i].size;
+  }
+  return used;
+}
+
+size_t UploadRingAllocator::GetReservedSize() const {
+  size_t reserved = 0;
+  for (const FrameSlot &slot : slots) {
+    for (const Page &page : slot.pages) {
+      reserved += page.size;
+    }
+  }
+  return reserved;
+}
+
+void UploadRingAllocator::AddPage(FrameSlot &slot, size_t minimumSize) {
+  Page page = provider(std::max(pageSize, minimumSize));
+  assert(page.cpuBase != nullptr);
+  slot.pages.push_back(page);
+}
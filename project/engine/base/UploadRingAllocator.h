@@ -0,0 +1,70 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// アップロードバッファから切り出した領域
+struct UploadAllocation {
+  // CPUから書き込むアドレス
+  void *cpuAddress = nullptr;
+  // GPUから読むアドレス
+  uint64_t gpuAddress = 0;
+};
+
+// フレームスロットごとの線形アロケータ（D3D12に依存しない部分）
+// 大きなアップロードバッファ（ページ）から境界を揃えて先頭から順に切り出し、
+// スロットを再利用するときにまとめて巻き戻す
+class UploadRingAllocator {
+public:
+  // Map済みのバッファ1枚
+  struct Page {
+    uint8_t *cpuBase = nullptr;
+    uint64_t gpuBase = 0;
+    size_t size = 0;
+  };
+  // 指定サイズ以上のページを用意する関数
+  using PageProvider = std::function<Page(size_t sizeInBytes)>;
+
+  // 定数バッファの配置境界
+  static const size_t kDefaultAlignment = 256;
+
+  // 初期化。各スロットにpageSizeのページを1枚ずつ用意する
+  void Initialize(uint32_t frameCount, size_t pageSize, PageProvider provider);
+
+  // スロットの使用開始。前回そのスロットで積んだ分をGPUが終えていること
+  void BeginFrame(uint32_t frameIndex, uint64_t completedFenceValue);
+
+  // スロットの使用終了。このフレームを送り出したときのフェンス値を記録する
+  void EndFrame(uint64_t fenceValue);
+
+  // スロットを巻き戻してよいか（前回送り出した分をGPUが終えているか）
+  bool IsSlotReusable(uint32_t frameIndex, uint64_t completedFenceValue) const;
+
+  // 領域を切り出す。alignmentは2の累乗
+  UploadAllocation Allocate(size_t sizeInBytes,
+                            size_t alignment = kDefaultAlignment);
+
+  // 今のスロットで使ったバイト数（境界合わせの隙間を含む）
+  size_t GetUsedSize() const;
+  // 全スロットのページの合計サイズ
+  size_t GetReservedSize() const;
+
+private:
+  struct FrameSlot {
+    std::vector<Page> pages;
+    // 使用中のページと、その中の次の切り出し位置
+    size_t pageIndex = 0;
+    size_t offset = 0;
+    // このスロットを最後に送り出したときのフェンス値
+    uint64_t fenceValue = 0;
+  };
+
+  // ページを足す（あふれた時）
+  void AddPage(FrameSlot &slot, size_t minimumSize);
+
+  std::vector<FrameSlot> slots;
+  uint32_t frameIndex = 0;
+  size_t pageSize = 0;
+  PageProvider provider;
+};
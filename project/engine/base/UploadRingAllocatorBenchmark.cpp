@@ -0,0 +1,72 @@
+﻿#include "Benchmark.h"
+#include "UploadRingAllocator.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+// 定数バッファ1つ分（行列2つ）
+struct Constants {
+  float wvp[16];
+  float world[16];
+};
+
+// D3D12のバッファは64KB境界で配置されるので、1つずつ作るとこの大きさになる
+const size_t kResourceAlignment = 64 * 1024;
+} // namespace
+
+// オブジェクトごとにバッファを作る場合と、
+// フレームごとのアップロード領域から切り出す場合を比べる
+// （バッファの作成はCPUのメモリ確保で代用する）
+int main() {
+  const uint32_t kFrameCount = 2;
+  const uint32_t kRepeatCount = 20;
+  Constants constants{};
+
+  std::printf("%10s %16s %16s %14s %14s\n", "objects", "per-object ms",
+              "ring ms", "per-object MB", "ring MB");
+  for (uint32_t objectCount : {1000u, 10000u, 100000u}) {
+    // オブジェクトごと：作って書き込んで捨てる
+    std::vector<void *> buffers(objectCount);
+    double perObjectMs = Benchmark::MeasureBestMs(kRepeatCount, [&]() {
+      for (uint32_t i = 0; i < objectCount; ++i) {
+        buffers[i] = std::malloc(kResourceAlignment);
+        std::memcpy(buffers[i], &constants, sizeof(Constants));
+      }
+      for (void *buffer : buffers) {
+        std::free(buffer);
+      }
+    });
+
+    // アップロード領域から切り出す（ページは使い回す）
+    std::vector<std::vector<uint8_t>> pages;
+    UploadRingAllocator allocator;
+    allocator.Initialize(kFrameCount, 2 * 1024 * 1024, [&](size_t size) {
+      pages.emplace_back(size);
+      UploadRingAllocator::Page page;
+      page.cpuBase = pages.back().data();
+      page.gpuBase = 0x100000000ull * pages.size();
+      page.size = size;
+      return page;
+    });
+    uint64_t fenceValue = 0;
+    double ringMs = Benchmark::MeasureBestMs(kRepeatCount, [&]() {
+      uint32_t frameIndex = static_cast<uint32_t>(fenceValue % kFrameCount);
+      allocator.BeginFrame(frameIndex, fenceValue);
+      for (uint32_t i = 0; i < objectCount; ++i) {
+        UploadAllocation allocation = allocator.Allocate(sizeof(Constants));
+        std::memcpy(allocation.cpuAddress, &constants, sizeof(Constants));
+        Benchmark::Consume(allocation.gpuAddress);
+      }
+      allocator.EndFrame(++fenceValue);
+    });
+
+    double perObjectMb = double(objectCount) * kResourceAlignment * kFrameCount /
+                         (1024.0 * 1024.0);
+    double ringMb = double(allocator.GetReservedSize()) / (1024.0 * 1024.0);
+    std::printf("%10u %16.3f %16.3f %14.1f %14.1f\n", objectCount, perObjectMs,
+                ringMs, perObjectMb, ringMb);
+  }
+  return 0;
+}
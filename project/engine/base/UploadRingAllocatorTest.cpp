@@ -0,0 +1,130 @@
+﻿#include "Check.h"
+#include "UploadRingAllocator.h"
+#include <memory>
+#include <vector>
+
+namespace {
+// アップロードバッファの代わりにCPUのメモリをページとして渡す
+struct FakePages {
+  std::vector<std::unique_ptr<uint8_t[]>> memories;
+  std::vector<size_t> requestedSizes;
+
+  UploadRingAllocator::PageProvider GetProvider() {
+    return [this](size_t sizeInBytes) {
+      memories.push_back(std::make_unique<uint8_t[]>(sizeInBytes));
+      requestedSizes.push_back(sizeInBytes);
+      UploadRingAllocator::Page page;
+      page.cpuBase = memories.back().get();
+      // GPUアドレスはページごとに離れた値にしておく
+      page.gpuBase = 0x100000000ull * memories.size();
+      page.size = sizeInBytes;
+      return page;
+    };
+  }
+};
+
+bool IsAligned(uint64_t value, size_t alignment) {
+  return value % alignment == 0;
+}
+
+void TestAlignment() {
+  FakePages pages;
+  UploadRingAllocator allocator;
+  allocator.Initialize(2, 4096, pages.GetProvider());
+  allocator.BeginFrame(0, 0);
+
+  UploadAllocation a = allocator.Allocate(10);
+  UploadAllocation b = allocator.Allocate(10);
+  // 定数バッファの境界（256）にそろう
+  CHECK(IsAligned(a.gpuAddress, 256) && IsAligned(b.gpuAddress, 256));
+  CHECK(b.gpuAddress - a.gpuAddress == 256);
+  // CPUとGPUのアドレスは同じだけずれる
+  CHECK(static_cast<uint8_t *>(b.cpuAddress) -
+            static_cast<uint8_t *>(a.cpuAddress) ==
+        256);
+
+  // 小さい境界を指定すれば詰めて切り出す（bの10バイトの直後から）
+  UploadAllocation c = allocator.Allocate(3, 4);
+  UploadAllocation d = allocator.Allocate(8, 16);
+  CHECK(c.gpuAddress == b.gpuAddress + 12);
+  CHECK(IsAligned(d.gpuAddress, 16) && d.gpuAddress == b.gpuAddress + 16);
+  CHECK(allocator.GetUsedSize() == 256 + 16 + 8);
+}
+
+void TestPageRollover() {
+  FakePages pages;
+  UploadRingAllocator allocator;
+  allocator.Initialize(1, 1024, pages.GetProvider());
+  allocator.BeginFrame(0, 0);
+
+  // 1ページに256バイトが4つ。5つ目は次のページの先頭
+  uint64_t firstPage = 0;
+  for (uint32_t i = 0; i < 4; ++i) {
+    UploadAllocation allocation = allocator.Allocate(256);
+    if (i == 0) {
+      firstPage = allocation.gpuAddress;
+    }
+    CHECK(allocation.gpuAddress == firstPage + 256 * i);
+  }
+  UploadAllocation next = allocator.Allocate(256);
+  CHECK(pages.memories.size() == 2);
+  CHECK(next.gpuAddress == 0x100000000ull * 2);
+  CHECK(allocator.GetReservedSize() == 2048);
+}
+
+void TestGrowthForOversizeRequest() {
+  FakePages pages;
+  UploadRingAllocator allocator;
+  allocator.Initialize(1, 1024, pages.GetProvider());
+  allocator.BeginFrame(0, 0);
+
+  // ページより大きい要求は、その大きさのページを足して収める
+  UploadAllocation big = allocator.Allocate(5000);
+  CHECK(pages.memories.size() == 2);
+  CHECK(pages.requestedSizes[1] >= 5000);
+  CHECK(big.gpuAddress == 0x100000000ull * 2);
+  // 書き込んでも範囲内に収まっている
+  std::fill_n(static_cast<uint8_t *>(big.cpuAddress), 5000, uint8_t(0xcd));
+  CHECK(allocator.GetUsedSize() == 1024 + 5000);
+}
+
+void TestFenceGuardedReuse() {
+  FakePages pages;
+  UploadRingAllocator allocator;
+  allocator.Initialize(2, 1024, pages.GetProvider());
+
+  // フレーム1（スロット0）
+  allocator.BeginFrame(0, 0);
+  UploadAllocation frame1 = allocator.Allocate(256);
+  allocator.Allocate(5000); // ページを足す
+  allocator.EndFrame(1);
+
+  // フレーム2（スロット1）。スロット0の領域とは重ならない
+  allocator.BeginFrame(1, 0);
+  UploadAllocation frame2 = allocator.Allocate(256);
+  CHECK(frame2.gpuAddress != frame1.gpuAddress);
+  allocator.EndFrame(2);
+
+  // スロット0はフェンス1が終わるまで巻き戻せない
+  CHECK(!allocator.IsSlotReusable(0, 0));
+  CHECK(allocator.IsSlotReusable(0, 1));
+  CHECK(!allocator.IsSlotReusable(1, 1));
+
+  // 巻き戻すと先頭から使い直し、足したページも作り直さない
+  size_t pageCount = pages.memories.size();
+  allocator.BeginFrame(0, 1);
+  CHECK(allocator.GetUsedSize() == 0);
+  UploadAllocation frame3 = allocator.Allocate(256);
+  CHECK(frame3.gpuAddress == frame1.gpuAddress);
+  allocator.Allocate(5000);
+  CHECK(pages.memories.size() == pageCount);
+}
+} // namespace
+
+int main() {
+  TestAlignment();
+  TestPageRollover();
+  TestGrowthForOversizeRequest();
+  TestFenceGuardedReuse();
+  return Test::Finish();
+}
@@ -0,0 +1,29 @@
+﻿#pragma once
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+// ベンチマーク用の計測（D3D12に依存しない部分のベンチマークで使う）
+namespace Benchmark {
+
+// 最適化で計算が消されないように結果を流し込む先
+inline volatile uint64_t sink = 0;
+
+inline void Consume(uint64_t value) { sink = sink + value; }
+
+// funcをrepeatCount回実行し、一番速かった回のミリ秒を返す
+template <class Func> double MeasureBestMs(uint32_t repeatCount, Func func) {
+  double best = 0.0;
+  for (uint32_t i = 0; i < repeatCount; ++i) {
+    auto begin = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(end - begin).count();
+    if (i == 0 || ms < best) {
+      best = ms;
+    }
+  }
+  return best;
+}
+
+} // namespace Benchmark
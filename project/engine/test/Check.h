@@ -0,0 +1,53 @@
+﻿#pragma once
+#include <cmath>
+#include <cstdio>
+
+// テスト用の確認マクロ（D3D12に依存しない部分のテストで使う）
+// 失敗しても止めずに続け、最後にTest::Finishで失敗数を返す
+namespace Test {
+
+inline int &GetFailureCount() {
+  static int count = 0;
+  return count;
+}
+
+inline void Fail(const char *file, int line, const char *expression) {
+  std::printf("%s(%d): failed: %s\n", file, line, expression);
+  GetFailureCount()++;
+}
+
+inline void FailNear(const char *file, int line, const char *expression,
+                     double a, double b, double tolerance) {
+  std::printf("%s(%d): failed: %s (%.9g vs %.9g, tolerance %.3g)\n", file,
+              line, expression, a, b, tolerance);
+  GetFailureCount()++;
+}
+
+// mainの最後に呼ぶ。失敗が無ければ0を返す
+inline int Finish() {
+  if (GetFailureCount() == 0) {
+    std::printf("all checks passed\n");
+    return 0;
+  }
+  std::printf("%d checks failed\n", GetFailureCount());
+  return 1;
+}
+
+} // namespace Test
+
+#define CHECK(expression)                                                      \
+  do {                                                                         \
+    if (!(expression)) {                                                       \
+      Test::Fail(__FILE__, __LINE__, #expression);                             \
+    }                                                                          \
+  } while (false)
+
+#define CHECK_NEAR(a, b, tolerance)                                            \
+  do {                                                                         \
+    double checkA = static_cast<double>(a);                                    \
+    double checkB = static_cast<double>(b);                                    \
+    if (!(std::fabs(checkA - checkB) <= static_cast<double>(tolerance))) {     \
+      Test::FailNear(__FILE__, __LINE__, #a " ~= " #b, checkA, checkB,         \
+                     static_cast<double>(tolerance));                          \
+    }                                                                          \
+  } while (false)
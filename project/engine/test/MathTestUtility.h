@@ -0,0 +1,87 @@
+﻿#pragma once
+#include "Mymath.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+// 数学ライブラリのテストとベンチマークで使う乱数と比較
+namespace MathTest {
+
+// 種を固定した乱数（毎回同じ入力になる）
+class Random {
+public:
+  explicit Random(uint32_t seed = 12345) : engine(seed) {}
+
+  float Range(float min, float max) {
+    return std::uniform_real_distribution<float>(min, max)(engine);
+  }
+  MyMath::Vector3 Vector3(float min, float max) {
+    return {Range(min, max), Range(min, max), Range(min, max)};
+  }
+  MyMath::Vector4 Vector4(float min, float max) {
+    return {Range(min, max), Range(min, max), Range(min, max),
+            Range(min, max)};
+  }
+  MyMath::Matrix4x4 Matrix(float min, float max) {
+    MyMath::Matrix4x4 result;
+    for (auto &row : result.m) {
+      for (float &value : row) {
+        value = Range(min, max);
+      }
+    }
+    return result;
+  }
+  // 正規化したクォータニオン
+  MyMath::Quaternion Rotation() {
+    MyMath::Quaternion q = {Range(-1.0f, 1.0f), Range(-1.0f, 1.0f),
+                            Range(-1.0f, 1.0f), Range(-1.0f, 1.0f)};
+    return MyMath::Math::Normalize(q);
+  }
+
+private:
+  std::mt19937 engine;
+};
+
+// 大きさに応じた誤差（|b|が1より大きければ相対誤差）
+inline float Difference(float a, float b) {
+  return std::fabs(a - b) / (std::max)(1.0f, std::fabs(b));
+}
+
+inline float MaxDifference(const MyMath::Matrix4x4 &a,
+                           const MyMath::Matrix4x4 &b) {
+  float result = 0.0f;
+  for (int row = 0; row < 4; ++row) {
+    for (int column = 0; column < 4; ++column) {
+      result = (std::max)(result, Difference(a.m[row][column],
+                                             b.m[row][column]));
+    }
+  }
+  return result;
+}
+
+inline float MaxDifference(const MyMath::Vector4 &a, const MyMath::Vector4 &b) {
+  return (std::max)({Difference(a.x, b.x), Difference(a.y, b.y),
+                     Difference(a.z, b.z), Difference(a.w, b.w)});
+}
+
+inline float MaxDifference(const MyMath::Vector3 &a, const MyMath::Vector3 &b) {
+  return (std::max)(
+      {Difference(a.x, b.x), Difference(a.y, b.y), Difference(a.z, b.z)});
+}
+
+// 行列全体の大きさに対する差（小さい要素の相対誤差で落ちないように）
+inline float NormwiseDifference(const MyMath::Matrix4x4 &a,
+                                const MyMath::Matrix4x4 &b) {
+  float difference = 0.0f;
+  float norm = 0.0f;
+  for (int row = 0; row < 4; ++row) {
+    for (int column = 0; column < 4; ++column) {
+      difference = (std::max)(difference,
+                              std::fabs(a.m[row][column] - b.m[row][column]));
+      norm = (std::max)(norm, std::fabs(b.m[row][column]));
+    }
+  }
+  return difference / norm;
+}
+
+} // namespace MathTest
@@ -0,0 +1,121 @@
+﻿#pragma once
+#include "ModelData.h"
+#include <cstdio>
+#include <istream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// ObjParserのテストとベンチマークで使う、OBJの生成と以前の読み込み
+namespace ObjTest {
+
+// quadCount x quadCountの格子（三角形は2 * quadCount^2）のOBJを作る
+// 位置・UV・法線はそれぞれ別の番号で参照する
+inline std::string GenerateGridObj(uint32_t quadCount) {
+  std::string text;
+  char line[96];
+  uint32_t side = quadCount + 1;
+  for (uint32_t y = 0; y < side; ++y) {
+    for (uint32_t x = 0; x < side; ++x) {
+      // 高さは適当に揺らして、いろいろな桁の小数にする
+      float height = float((x * 7919u + y * 104729u) % 1000u) * 0.00137f - 0.5f;
+      std::snprintf(line, sizeof(line), "v %.6f %.6f %.6f\n",
+                    float(x) * 0.25f - 10.0f, height, float(y) * -0.125f);
+      text += line;
+    }
+  }
+  for (uint32_t y = 0; y < side; ++y) {
+    for (uint32_t x = 0; x < side; ++x) {
+      std::snprintf(line, sizeof(line), "vt %.6f %.6f\n",
+                    float(x) / float(quadCount), float(y) / float(quadCount));
+      text += line;
+    }
+  }
+  text += "vn 0.000000 1.000000 0.000000\n";
+  text += "vn 0.000000 0.707107 0.707107\n";
+  for (uint32_t y = 0; y < quadCount; ++y) {
+    for (uint32_t x = 0; x < quadCount; ++x) {
+      uint32_t a = y * side + x + 1;
+      uint32_t b = a + 1;
+      uint32_t c = a + side;
+      uint32_t d = c + 1;
+      uint32_t n = (x + y) % 2 + 1;
+      std::snprintf(line, sizeof(line), "f %u/%u/%u %u/%u/%u %u/%u/%u\n", a, a,
+                    n, b, b, n, d, d, n);
+      text += line;
+      std::snprintf(line, sizeof(line), "f %u/%u/%u %u/%u/%u %u/%u/%u\n", a, a,
+                    n, d, d, n, c, c, n);
+      text += line;
+    }
+  }
+  return text;
+}
+
+// 以前のmain.cppのLoadObjFile（istringstreamで1行ずつ読む）
+// インデックスを使わず、三角形ごとに頂点を3つ並べる
+inline std::vector<VertexData> LoadObjLegacy(std::istream &file) {
+  std::vector<VertexData> vertices;
+  std::vector<MyMath::Vector4> positions; // 位置
+  std::vector<MyMath::Vector3> normals;   // 法線
+  std::vector<MyMath::Vector2> texcoords; // テクスチャ座標
+  std::string line;
+
+  while (std::getline(file, line)) {
+    std::string identifier;
+    std::istringstream s(line);
+    s >> identifier;
+
+    if (identifier == "v") {
+      MyMath::Vector4 position;
+      s >> position.x >> position.y >> position.z;
+      position.w = 1.0f;
+      position.x *= -1.0f;
+      positions.push_back(position);
+    } else if (identifier == "vt") {
+      MyMath::Vector2 texcoord;
+      s >> texcoord.x >> texcoord.y;
+      texcoords.push_back(texcoord);
+    } else if (identifier == "vn") {
+      MyMath::Vector3 normal;
+      s >> normal.x >> normal.y >> normal.z;
+      normal.x *= -1.0f;
+      normals.push_back(normal);
+    } else if (identifier == "f") {
+      VertexData triangle[3];
+      for (int32_t faceVertex = 0; faceVertex < 3; ++faceVertex) {
+        std::string vertexDefinition;
+        s >> vertexDefinition;
+        std::istringstream v(vertexDefinition);
+        uint32_t elementIndices[3];
+        for (int32_t element = 0; element < 3; ++element) {
+          std::string index;
+          std::getline(v, index, '/');
+          elementIndices[element] = std::stoi(index);
+        }
+        MyMath::Vector4 position = positions[elementIndices[0] - 1];
+        position.x *= -1.0f;
+        MyMath::Vector2 texcoord = texcoords[elementIndices[1] - 1];
+        texcoord.y = 1.0f - texcoord.y;
+        MyMath::Vector3 normal = normals[elementIndices[2] - 1];
+        (void)normal;
+        triangle[faceVertex] = {position, texcoord};
+      }
+      vertices.push_back(triangle[2]);
+      vertices.push_back(triangle[1]);
+      vertices.push_back(triangle[0]);
+    }
+  }
+  return vertices;
+}
+
+// インデックスを展開して、三角形ごとに頂点を3つ並べる
+inline std::vector<VertexData> ExpandIndices(const ModelData &modelData) {
+  std::vector<VertexData> vertices;
+  vertices.reserve(modelData.indices.size());
+  for (uint32_t index : modelData.indices) {
+    vertices.push_back(modelData.vertices[index]);
+  }
+  return vertices;
+}
+
+} // namespace ObjTest
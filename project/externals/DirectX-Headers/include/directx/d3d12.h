@@ -0,0 +1,20 @@
+//-------------------------------------------------------------------------------------
+// d3d12.h
+//
+// Minimal Direct3D 12 definitions for non-Windows builds.
+// Only the resource size limits that DirectXTex's portable sources validate against
+// are defined. __d3d12_h__ is deliberately not defined, so DirectXTex does not
+// declare its D3D12 helpers.
+//-------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "dxgiformat.h"
+#include "../wsl/winadapter.h"
+
+#define D3D12_REQ_MIP_LEVELS (15)
+#define D3D12_REQ_TEXTURE1D_ARRAY_AXIS_DIMENSION (2048)
+#define D3D12_REQ_TEXTURE1D_U_DIMENSION (16384)
+#define D3D12_REQ_TEXTURE2D_ARRAY_AXIS_DIMENSION (2048)
+#define D3D12_REQ_TEXTURE2D_U_OR_V_DIMENSION (16384)
+#define D3D12_REQ_TEXTURE3D_U_V_OR_W_DIMENSION (2048)
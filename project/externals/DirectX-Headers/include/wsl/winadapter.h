@@ -0,0 +1,111 @@
+//-------------------------------------------------------------------------------------
+// winadapter.h
+//
+// Minimal Win32 type and HRESULT definitions for non-Windows builds.
+// Covers what DirectXTex's portable sources (DDS/TGA/HDR I/O, conversion, mipmaps
+// and BC compression) need; it is not a general replacement for windows.h.
+//-------------------------------------------------------------------------------------
+
+#pragma once
+
+#ifndef _WIN32
+
+#include <cfloat>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include <sal.h>
+
+#define __cdecl
+#define __stdcall
+#define WINAPI
+
+#define UNREFERENCED_PARAMETER(P) (void)(P)
+
+using BYTE = uint8_t;
+using WORD = uint16_t;
+using DWORD = uint32_t;
+using UINT = uint32_t;
+using INT = int32_t;
+using LONG = int32_t;
+using ULONG = uint32_t;
+using BOOL = int32_t;
+using HRESULT = int32_t;
+using HANDLE = void*;
+
+#ifndef TRUE
+#define TRUE 1
+#endif
+#ifndef FALSE
+#define FALSE 0
+#endif
+
+struct GUID
+{
+    uint32_t Data1;
+    uint16_t Data2;
+    uint16_t Data3;
+    uint8_t Data4[8];
+};
+
+inline bool operator==(const GUID& a, const GUID& b) noexcept { return std::memcmp(&a, &b, sizeof(GUID)) == 0; }
+inline bool operator!=(const GUID& a, const GUID& b) noexcept { return !(a == b); }
+
+using IID = GUID;
+using REFGUID = const GUID&;
+using REFIID = const IID&;
+
+#define SUCCEEDED(hr) (static_cast<HRESULT>(hr) >= 0)
+#define FAILED(hr) (static_cast<HRESULT>(hr) < 0)
+
+#define S_OK static_cast<HRESULT>(0L)
+#define S_FALSE static_cast<HRESULT>(1L)
+#define E_NOTIMPL static_cast<HRESULT>(0x80004001L)
+#define E_NOINTERFACE static_cast<HRESULT>(0x80004002L)
+#define E_POINTER static_cast<HRESULT>(0x80004003L)
+#define E_ABORT static_cast<HRESULT>(0x80004004L)
+#define E_FAIL static_cast<HRESULT>(0x80004005L)
+#define E_BOUNDS static_cast<HRESULT>(0x8000000BL)
+#define E_UNEXPECTED static_cast<HRESULT>(0x8000FFFFL)
+#define E_ACCESSDENIED static_cast<HRESULT>(0x80070005L)
+#define E_HANDLE static_cast<HRESULT>(0x80070006L)
+#define E_OUTOFMEMORY static_cast<HRESULT>(0x8007000EL)
+#define E_INVALIDARG static_cast<HRESULT>(0x80070057L)
+
+#define ERROR_FILE_NOT_FOUND 2L
+#define ERROR_INVALID_DATA 13L
+#define ERROR_HANDLE_EOF 38L
+#define ERROR_NOT_SUPPORTED 50L
+#define ERROR_CANNOT_MAKE 82L
+#define ERROR_INSUFFICIENT_BUFFER 122L
+#define ERROR_FILE_TOO_LARGE 223L
+#define ERROR_ARITHMETIC_OVERFLOW 534L
+
+constexpr HRESULT HRESULT_FROM_WIN32(unsigned long x) noexcept
+{
+    return static_cast<HRESULT>(x) <= 0
+        ? static_cast<HRESULT>(x)
+        : static_cast<HRESULT>((x & 0x0000FFFFu) | (7u << 16) | 0x80000000u);
+}
+
+#ifndef MAKEFOURCC
+#define MAKEFOURCC(ch0, ch1, ch2, ch3) \
+    (static_cast<uint32_t>(static_cast<uint8_t>(ch0)) \
+    | (static_cast<uint32_t>(static_cast<uint8_t>(ch1)) << 8) \
+    | (static_cast<uint32_t>(static_cast<uint8_t>(ch2)) << 16) \
+    | (static_cast<uint32_t>(static_cast<uint8_t>(ch3)) << 24))
+#endif
+
+#define DEFINE_ENUM_FLAG_OPERATORS(ENUMTYPE) \
+extern "C++" { \
+inline constexpr ENUMTYPE operator|(ENUMTYPE a, ENUMTYPE b) noexcept { return ENUMTYPE(static_cast<std::underlying_type_t<ENUMTYPE>>(a) | static_cast<std::underlying_type_t<ENUMTYPE>>(b)); } \
+inline ENUMTYPE& operator|=(ENUMTYPE& a, ENUMTYPE b) noexcept { return a = a | b; } \
+inline constexpr ENUMTYPE operator&(ENUMTYPE a, ENUMTYPE b) noexcept { return ENUMTYPE(static_cast<std::underlying_type_t<ENUMTYPE>>(a) & static_cast<std::underlying_type_t<ENUMTYPE>>(b)); } \
+inline ENUMTYPE& operator&=(ENUMTYPE& a, ENUMTYPE b) noexcept { return a = a & b; } \
+inline constexpr ENUMTYPE operator~(ENUMTYPE a) noexcept { return ENUMTYPE(~static_cast<std::underlying_type_t<ENUMTYPE>>(a)); } \
+inline constexpr ENUMTYPE operator^(ENUMTYPE a, ENUMTYPE b) noexcept { return ENUMTYPE(static_cast<std::underlying_type_t<ENUMTYPE>>(a) ^ static_cast<std::underlying_type_t<ENUMTYPE>>(b)); } \
+inline ENUMTYPE& operator^=(ENUMTYPE& a, ENUMTYPE b) noexcept { return a = a ^ b; } \
+}
+
+#endif
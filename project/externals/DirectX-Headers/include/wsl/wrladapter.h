@@ -0,0 +1,63 @@
+//-------------------------------------------------------------------------------------
+// wrladapter.h
+//
+// Minimal Microsoft::WRL::ComPtr for non-Windows builds.
+// DirectXTex's portable sources only name the type; nothing built here creates COM
+// objects, so this provides just the reference-counting basics.
+//-------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "winadapter.h"
+
+namespace Microsoft
+{
+    namespace WRL
+    {
+        template<class T>
+        class ComPtr
+        {
+        public:
+            ComPtr() noexcept = default;
+            ComPtr(T* other) noexcept : ptr(other) { AddRef(); }
+            ComPtr(const ComPtr& other) noexcept : ptr(other.ptr) { AddRef(); }
+            ComPtr(ComPtr&& other) noexcept : ptr(other.ptr) { other.ptr = nullptr; }
+            ~ComPtr() { Reset(); }
+
+            ComPtr& operator=(ComPtr other) noexcept
+            {
+                T* temp = ptr;
+                ptr = other.ptr;
+                other.ptr = temp;
+                return *this;
+            }
+
+            T* Get() const noexcept { return ptr; }
+            T* operator->() const noexcept { return ptr; }
+            explicit operator bool() const noexcept { return ptr != nullptr; }
+
+            T** GetAddressOf() noexcept { return &ptr; }
+            T** ReleaseAndGetAddressOf() noexcept { Reset(); return &ptr; }
+
+            void Reset() noexcept
+            {
+                if (ptr)
+                {
+                    ptr->Release();
+                    ptr = nullptr;
+                }
+            }
+
+        private:
+            void AddRef() noexcept
+            {
+                if (ptr)
+                {
+                    ptr->AddRef();
+                }
+            }
+
+            T* ptr = nullptr;
+        };
+    }
+}
@@ -0,0 +1,676 @@
+//-------------------------------------------------------------------------------------
+// DirectXMath.h
+//
+// Scalar subset of the DirectXMath API for non-Windows builds.
+// Provides the vector types, constants and functions that DirectXTex's portable
+// sources use, with the same semantics as DirectXMath's _XM_NO_INTRINSICS_ path.
+// Matrices, quaternions and the rest of the library are not included.
+//-------------------------------------------------------------------------------------
+
+#pragma once
+
+#ifndef _WIN32
+
+#include <sal.h>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <math.h>
+
+#define DIRECTX_MATH_VERSION 320
+
+#define XM_CALLCONV
+#define XM_ALIGNED_DATA(x) alignas(x)
+#define XM_ALIGNED_STRUCT(x) struct alignas(x)
+#define XMGLOBALCONST inline const
+
+namespace DirectX
+{
+    constexpr uint32_t XM_SELECT_0 = 0x00000000;
+    constexpr uint32_t XM_SELECT_1 = 0xFFFFFFFF;
+
+    constexpr uint32_t XM_PERMUTE_0X = 0;
+    constexpr uint32_t XM_PERMUTE_0Y = 1;
+    constexpr uint32_t XM_PERMUTE_0Z = 2;
+    constexpr uint32_t XM_PERMUTE_0W = 3;
+    constexpr uint32_t XM_PERMUTE_1X = 4;
+    constexpr uint32_t XM_PERMUTE_1Y = 5;
+    constexpr uint32_t XM_PERMUTE_1Z = 6;
+    constexpr uint32_t XM_PERMUTE_1W = 7;
+
+    constexpr uint32_t XM_SWIZZLE_X = 0;
+    constexpr uint32_t XM_SWIZZLE_Y = 1;
+    constexpr uint32_t XM_SWIZZLE_Z = 2;
+    constexpr uint32_t XM_SWIZZLE_W = 3;
+
+    //---------------------------------------------------------------------------------
+    // Vector types
+
+    struct alignas(16) __vector4
+    {
+        union
+        {
+            float vector4_f32[4];
+            uint32_t vector4_u32[4];
+        };
+    };
+
+    using XMVECTOR = __vector4;
+    using FXMVECTOR = const XMVECTOR&;
+    using GXMVECTOR = const XMVECTOR&;
+    using HXMVECTOR = const XMVECTOR&;
+    using CXMVECTOR = const XMVECTOR&;
+
+    struct alignas(16) XMVECTORF32
+    {
+        union
+        {
+            float f[4];
+            XMVECTOR v;
+        };
+
+        operator XMVECTOR() const noexcept { return v; }
+        operator const float* () const noexcept { return f; }
+    };
+
+    struct alignas(16) XMVECTORI32
+    {
+        union
+        {
+            int32_t i[4];
+            XMVECTOR v;
+        };
+
+        operator XMVECTOR() const noexcept { return v; }
+    };
+
+    struct alignas(16) XMVECTORU32
+    {
+        union
+        {
+            uint32_t u[4];
+            XMVECTOR v;
+        };
+
+        operator XMVECTOR() const noexcept { return v; }
+    };
+
+    //---------------------------------------------------------------------------------
+    // Storage types
+
+    struct XMFLOAT2
+    {
+        float x;
+        float y;
+
+        XMFLOAT2() = default;
+        constexpr XMFLOAT2(float _x, float _y) noexcept : x(_x), y(_y) {}
+    };
+
+    struct XMFLOAT3
+    {
+        float x;
+        float y;
+        float z;
+
+        XMFLOAT3() = default;
+        constexpr XMFLOAT3(float _x, float _y, float _z) noexcept : x(_x), y(_y), z(_z) {}
+    };
+
+    struct alignas(16) XMFLOAT3A : public XMFLOAT3
+    {
+        using XMFLOAT3::XMFLOAT3;
+        XMFLOAT3A() = default;
+    };
+
+    struct XMFLOAT4
+    {
+        float x;
+        float y;
+        float z;
+        float w;
+
+        XMFLOAT4() = default;
+        constexpr XMFLOAT4(float _x, float _y, float _z, float _w) noexcept : x(_x), y(_y), z(_z), w(_w) {}
+    };
+
+    struct alignas(16) XMFLOAT4A : public XMFLOAT4
+    {
+        using XMFLOAT4::XMFLOAT4;
+        XMFLOAT4A() = default;
+    };
+
+    struct XMINT2 { int32_t x; int32_t y; };
+    struct XMINT3 { int32_t x; int32_t y; int32_t z; };
+    struct XMINT4 { int32_t x; int32_t y; int32_t z; int32_t w; };
+    struct XMUINT2 { uint32_t x; uint32_t y; };
+    struct XMUINT3 { uint32_t x; uint32_t y; uint32_t z; };
+    struct XMUINT4 { uint32_t x; uint32_t y; uint32_t z; uint32_t w; };
+
+    //---------------------------------------------------------------------------------
+    // Initialization and element access
+
+    inline XMVECTOR XM_CALLCONV XMVectorZero() noexcept
+    {
+        XMVECTOR result;
+        result.vector4_f32[0] = result.vector4_f32[1] = result.vector4_f32[2] = result.vector4_f32[3] = 0.0f;
+        return result;
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVectorSet(float x, float y, float z, float w) noexcept
+    {
+        XMVECTOR result;
+        result.vector4_f32[0] = x;
+        result.vector4_f32[1] = y;
+        result.vector4_f32[2] = z;
+        result.vector4_f32[3] = w;
+        return result;
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVectorSetInt(uint32_t x, uint32_t y, uint32_t z, uint32_t w) noexcept
+    {
+        XMVECTOR result;
+        result.vector4_u32[0] = x;
+        result.vector4_u32[1] = y;
+        result.vector4_u32[2] = z;
+        result.vector4_u32[3] = w;
+        return result;
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVectorReplicate(float value) noexcept
+    {
+        return XMVectorSet(value, value, value, value);
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVectorSplatX(FXMVECTOR v) noexcept { return XMVectorReplicate(v.vector4_f32[0]); }
+    inline XMVECTOR XM_CALLCONV XMVectorSplatY(FXMVECTOR v) noexcept { return XMVectorReplicate(v.vector4_f32[1]); }
+    inline XMVECTOR XM_CALLCONV XMVectorSplatZ(FXMVECTOR v) noexcept { return XMVectorReplicate(v.vector4_f32[2]); }
+    inline XMVECTOR XM_CALLCONV XMVectorSplatW(FXMVECTOR v) noexcept { return XMVectorReplicate(v.vector4_f32[3]); }
+
+    inline float XM_CALLCONV XMVectorGetX(FXMVECTOR v) noexcept { return v.vector4_f32[0]; }
+    inline float XM_CALLCONV XMVectorGetY(FXMVECTOR v) noexcept { return v.vector4_f32[1]; }
+    inline float XM_CALLCONV XMVectorGetZ(FXMVECTOR v) noexcept { return v.vector4_f32[2]; }
+    inline float XM_CALLCONV XMVectorGetW(FXMVECTOR v) noexcept { return v.vector4_f32[3]; }
+
+    inline XMVECTOR XM_CALLCONV XMVectorSetW(FXMVECTOR v, float w) noexcept
+    {
+        XMVECTOR result = v;
+        result.vector4_f32[3] = w;
+        return result;
+    }
+
+    //---------------------------------------------------------------------------------
+    // Permutation and selection
+
+    inline XMVECTOR XM_CALLCONV XMVectorSwizzle(FXMVECTOR v, uint32_t e0, uint32_t e1, uint32_t e2, uint32_t e3) noexcept
+    {
+        return XMVectorSet(v.vector4_f32[e0 & 3], v.vector4_f32[e1 & 3], v.vector4_f32[e2 & 3], v.vector4_f32[e3 & 3]);
+    }
+
+    template<uint32_t SwizzleX, uint32_t SwizzleY, uint32_t SwizzleZ, uint32_t SwizzleW>
+    inline XMVECTOR XM_CALLCONV XMVectorSwizzle(FXMVECTOR v) noexcept
+    {
+        static_assert(SwizzleX <= 3 && SwizzleY <= 3 && SwizzleZ <= 3 && SwizzleW <= 3, "Swizzle template parameter out of range");
+        return XMVectorSwizzle(v, SwizzleX, SwizzleY, SwizzleZ, SwizzleW);
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVectorPermute(FXMVECTOR v1, FXMVECTOR v2,
+        uint32_t permuteX, uint32_t permuteY, uint32_t permuteZ, uint32_t permuteW) noexcept
+    {
+        const uint32_t* table[2] = { v1.vector4_u32, v2.vector4_u32 };
+        const uint32_t indices[4] = { permuteX & 7, permuteY & 7, permuteZ & 7, permuteW & 7 };
+        XMVECTOR result;
+        for (size_t i = 0; i < 4; ++i)
+        {
+            result.vector4_u32[i] = table[indices[i] >> 2][indices[i] & 3];
+        }
+        return result;
+    }
+
+    template<uint32_t PermuteX, uint32_t PermuteY, uint32_t PermuteZ, uint32_t PermuteW>
+    inline XMVECTOR XM_CALLCONV XMVectorPermute(FXMVECTOR v1, FXMVECTOR v2) noexcept
+    {
+        static_assert(PermuteX <= 7 && PermuteY <= 7 && PermuteZ <= 7 && PermuteW <= 7, "Permute template parameter out of range");
+        return XMVectorPermute(v1, v2, PermuteX, PermuteY, PermuteZ, PermuteW);
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVectorSelect(FXMVECTOR v1, FXMVECTOR v2, FXMVECTOR control) noexcept
+    {
+        XMVECTOR result;
+        for (size_t i = 0; i < 4; ++i)
+        {
+            result.vector4_u32[i] = (v1.vector4_u32[i] & ~control.vector4_u32[i]) | (v2.vector4_u32[i] & control.vector4_u32[i]);
+        }
+        return result;
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVectorMergeXY(FXMVECTOR v1, FXMVECTOR v2) noexcept
+    {
+        XMVECTOR result;
+        result.vector4_u32[0] = v1.vector4_u32[0];
+        result.vector4_u32[1] = v2.vector4_u32[0];
+        result.vector4_u32[2] = v1.vector4_u32[1];
+        result.vector4_u32[3] = v2.vector4_u32[1];
+        return result;
+    }
+
+    //---------------------------------------------------------------------------------
+    // Arithmetic
+
+    namespace Internal
+    {
+        // Round half to even, like DirectXMath's XMRound_Internal
+        inline float XMRound(float x) noexcept
+        {
+            const float i = std::floor(x);
+            const float fraction = x - i;
+            if (fraction < 0.5f)
+                return i;
+            if (fraction > 0.5f)
+                return i + 1.0f;
+            float integral;
+            (void)std::modf(i / 2.0f, &integral);
+            return (2.0f * integral == i) ? i : i + 1.0f;
+        }
+
+        template<class Func>
+        inline XMVECTOR XMMap(FXMVECTOR v, Func func) noexcept
+        {
+            XMVECTOR result;
+            for (size_t i = 0; i < 4; ++i)
+            {
+                result.vector4_f32[i] = func(v.vector4_f32[i]);
+            }
+            return result;
+        }
+
+        template<class Func>
+        inline XMVECTOR XMMap(FXMVECTOR v1, FXMVECTOR v2, Func func) noexcept
+        {
+            XMVECTOR result;
+            for (size_t i = 0; i < 4; ++i)
+            {
+                result.vector4_f32[i] = func(v1.vector4_f32[i], v2.vector4_f32[i]);
+            }
+            return result;
+        }
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVectorAdd(FXMVECTOR v1, FXMVECTOR v2) noexcept
+    {
+        return Internal::XMMap(v1, v2, [](float a, float b) { return a + b; });
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVectorSubtract(FXMVECTOR v1, FXMVECTOR v2) noexcept
+    {
+        return Internal::XMMap(v1, v2, [](float a, float b) { return a - b; });
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVectorMultiply(FXMVECTOR v1, FXMVECTOR v2) noexcept
+    {
+        return Internal::XMMap(v1, v2, [](float a, float b) { return a * b; });
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVectorDivide(FXMVECTOR v1, FXMVECTOR v2) noexcept
+    {
+        return Internal::XMMap(v1, v2, [](float a, float b) { return a / b; });
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVectorMultiplyAdd(FXMVECTOR v1, FXMVECTOR v2, FXMVECTOR v3) noexcept
+    {
+        XMVECTOR result;
+        for (size_t i = 0; i < 4; ++i)
+        {
+            result.vector4_f32[i] = v1.vector4_f32[i] * v2.vector4_f32[i] + v3.vector4_f32[i];
+        }
+        return result;
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVectorScale(FXMVECTOR v, float scaleFactor) noexcept
+    {
+        return Internal::XMMap(v, [scaleFactor](float a) { return a * scaleFactor; });
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVectorNegate(FXMVECTOR v) noexcept
+    {
+        return Internal::XMMap(v, [](float a) { return -a; });
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVectorMin(FXMVECTOR v1, FXMVECTOR v2) noexcept
+    {
+        return Internal::XMMap(v1, v2, [](float a, float b) { return (a < b) ? a : b; });
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVectorMax(FXMVECTOR v1, FXMVECTOR v2) noexcept
+    {
+        return Internal::XMMap(v1, v2, [](float a, float b) { return (a > b) ? a : b; });
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVectorClamp(FXMVECTOR v, FXMVECTOR min, FXMVECTOR max) noexcept
+    {
+        return XMVectorMin(max, XMVectorMax(min, v));
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVectorSaturate(FXMVECTOR v) noexcept
+    {
+        return XMVectorClamp(v, XMVectorZero(), XMVectorReplicate(1.0f));
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVectorRound(FXMVECTOR v) noexcept
+    {
+        return Internal::XMMap(v, [](float a) { return Internal::XMRound(a); });
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVectorTruncate(FXMVECTOR v) noexcept
+    {
+        return Internal::XMMap(v, [](float a) { return std::trunc(a); });
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVectorLerp(FXMVECTOR v0, FXMVECTOR v1, float t) noexcept
+    {
+        const XMVECTOR scale = XMVectorReplicate(t);
+        return XMVectorMultiplyAdd(XMVectorSubtract(v1, v0), scale, v0);
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVectorPow(FXMVECTOR v1, FXMVECTOR v2) noexcept
+    {
+        return Internal::XMMap(v1, v2, [](float a, float b) { return std::pow(a, b); });
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVectorSum(FXMVECTOR v) noexcept
+    {
+        return XMVectorReplicate(v.vector4_f32[0] + v.vector4_f32[1] + v.vector4_f32[2] + v.vector4_f32[3]);
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVector3Dot(FXMVECTOR v1, FXMVECTOR v2) noexcept
+    {
+        return XMVectorReplicate(v1.vector4_f32[0] * v2.vector4_f32[0]
+            + v1.vector4_f32[1] * v2.vector4_f32[1]
+            + v1.vector4_f32[2] * v2.vector4_f32[2]);
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVector4Dot(FXMVECTOR v1, FXMVECTOR v2) noexcept
+    {
+        return XMVectorReplicate(v1.vector4_f32[0] * v2.vector4_f32[0]
+            + v1.vector4_f32[1] * v2.vector4_f32[1]
+            + v1.vector4_f32[2] * v2.vector4_f32[2]
+            + v1.vector4_f32[3] * v2.vector4_f32[3]);
+    }
+
+    inline bool XM_CALLCONV XMVector4Less(FXMVECTOR v1, FXMVECTOR v2) noexcept
+    {
+        return v1.vector4_f32[0] < v2.vector4_f32[0] && v1.vector4_f32[1] < v2.vector4_f32[1]
+            && v1.vector4_f32[2] < v2.vector4_f32[2] && v1.vector4_f32[3] < v2.vector4_f32[3];
+    }
+
+    //---------------------------------------------------------------------------------
+    // Integer <-> float conversion
+
+    inline XMVECTOR XM_CALLCONV XMConvertVectorIntToFloat(FXMVECTOR vInt, uint32_t divExponent) noexcept
+    {
+        const float scale = 1.0f / static_cast<float>(1U << divExponent);
+        XMVECTOR result;
+        for (size_t i = 0; i < 4; ++i)
+        {
+            result.vector4_f32[i] = static_cast<float>(static_cast<int32_t>(vInt.vector4_u32[i])) * scale;
+        }
+        return result;
+    }
+
+    inline XMVECTOR XM_CALLCONV XMConvertVectorUIntToFloat(FXMVECTOR vUInt, uint32_t divExponent) noexcept
+    {
+        const float scale = 1.0f / static_cast<float>(1U << divExponent);
+        XMVECTOR result;
+        for (size_t i = 0; i < 4; ++i)
+        {
+            result.vector4_f32[i] = static_cast<float>(vUInt.vector4_u32[i]) * scale;
+        }
+        return result;
+    }
+
+    inline XMVECTOR XM_CALLCONV XMConvertVectorFloatToInt(FXMVECTOR vFloat, uint32_t mulExponent) noexcept
+    {
+        const auto scale = static_cast<float>(1U << mulExponent);
+        XMVECTOR result;
+        for (size_t i = 0; i < 4; ++i)
+        {
+            const float value = vFloat.vector4_f32[i] * scale;
+            int32_t converted;
+            if (std::isnan(value))
+                converted = 0;
+            else if (value <= -(65536.0f * 32768.0f))
+                converted = INT32_MIN;
+            else if (value > (65536.0f * 32768.0f) - 128.0f)
+                converted = INT32_MAX;
+            else
+                converted = static_cast<int32_t>(value);
+            result.vector4_u32[i] = static_cast<uint32_t>(converted);
+        }
+        return result;
+    }
+
+    inline XMVECTOR XM_CALLCONV XMConvertVectorFloatToUInt(FXMVECTOR vFloat, uint32_t mulExponent) noexcept
+    {
+        const auto scale = static_cast<float>(1U << mulExponent);
+        XMVECTOR result;
+        for (size_t i = 0; i < 4; ++i)
+        {
+            const float value = vFloat.vector4_f32[i] * scale;
+            uint32_t converted;
+            if (std::isnan(value) || value <= 0.0f)
+                converted = 0;
+            else if (value >= (65536.0f * 65536.0f))
+                converted = UINT32_MAX;
+            else
+                converted = static_cast<uint32_t>(value);
+            result.vector4_u32[i] = converted;
+        }
+        return result;
+    }
+
+    //---------------------------------------------------------------------------------
+    // Load and store
+
+    inline XMVECTOR XM_CALLCONV XMLoadInt(_In_ const uint32_t* pSource) noexcept
+    {
+        return XMVectorSetInt(*pSource, 0, 0, 0);
+    }
+
+    inline XMVECTOR XM_CALLCONV XMLoadFloat(_In_ const float* pSource) noexcept
+    {
+        return XMVectorSet(*pSource, 0.0f, 0.0f, 0.0f);
+    }
+
+    inline XMVECTOR XM_CALLCONV XMLoadFloat2(_In_ const XMFLOAT2* pSource) noexcept
+    {
+        return XMVectorSet(pSource->x, pSource->y, 0.0f, 0.0f);
+    }
+
+    inline XMVECTOR XM_CALLCONV XMLoadFloat3(_In_ const XMFLOAT3* pSource) noexcept
+    {
+        return XMVectorSet(pSource->x, pSource->y, pSource->z, 0.0f);
+    }
+
+    inline XMVECTOR XM_CALLCONV XMLoadFloat4(_In_ const XMFLOAT4* pSource) noexcept
+    {
+        return XMVectorSet(pSource->x, pSource->y, pSource->z, pSource->w);
+    }
+
+    inline XMVECTOR XM_CALLCONV XMLoadSInt2(_In_ const XMINT2* pSource) noexcept
+    {
+        return XMVectorSet(static_cast<float>(pSource->x), static_cast<float>(pSource->y), 0.0f, 0.0f);
+    }
+
+    inline XMVECTOR XM_CALLCONV XMLoadSInt3(_In_ const XMINT3* pSource) noexcept
+    {
+        return XMVectorSet(static_cast<float>(pSource->x), static_cast<float>(pSource->y),
+            static_cast<float>(pSource->z), 0.0f);
+    }
+
+    inline XMVECTOR XM_CALLCONV XMLoadSInt4(_In_ const XMINT4* pSource) noexcept
+    {
+        return XMVectorSet(static_cast<float>(pSource->x), static_cast<float>(pSource->y),
+            static_cast<float>(pSource->z), static_cast<float>(pSource->w));
+    }
+
+    inline XMVECTOR XM_CALLCONV XMLoadUInt2(_In_ const XMUINT2* pSource) noexcept
+    {
+        return XMVectorSet(static_cast<float>(pSource->x), static_cast<float>(pSource->y), 0.0f, 0.0f);
+    }
+
+    inline XMVECTOR XM_CALLCONV XMLoadUInt3(_In_ const XMUINT3* pSource) noexcept
+    {
+        return XMVectorSet(static_cast<float>(pSource->x), static_cast<float>(pSource->y),
+            static_cast<float>(pSource->z), 0.0f);
+    }
+
+    inline XMVECTOR XM_CALLCONV XMLoadUInt4(_In_ const XMUINT4* pSource) noexcept
+    {
+        return XMVectorSet(static_cast<float>(pSource->x), static_cast<float>(pSource->y),
+            static_cast<float>(pSource->z), static_cast<float>(pSource->w));
+    }
+
+    inline void XM_CALLCONV XMStoreInt(_Out_ uint32_t* pDestination, _In_ FXMVECTOR v) noexcept
+    {
+        *pDestination = v.vector4_u32[0];
+    }
+
+    inline void XM_CALLCONV XMStoreFloat(_Out_ float* pDestination, _In_ FXMVECTOR v) noexcept
+    {
+        *pDestination = v.vector4_f32[0];
+    }
+
+    inline void XM_CALLCONV XMStoreFloat2(_Out_ XMFLOAT2* pDestination, _In_ FXMVECTOR v) noexcept
+    {
+        pDestination->x = v.vector4_f32[0];
+        pDestination->y = v.vector4_f32[1];
+    }
+
+    inline void XM_CALLCONV XMStoreFloat3(_Out_ XMFLOAT3* pDestination, _In_ FXMVECTOR v) noexcept
+    {
+        pDestination->x = v.vector4_f32[0];
+        pDestination->y = v.vector4_f32[1];
+        pDestination->z = v.vector4_f32[2];
+    }
+
+    inline void XM_CALLCONV XMStoreFloat3A(_Out_ XMFLOAT3A* pDestination, _In_ FXMVECTOR v) noexcept
+    {
+        XMStoreFloat3(pDestination, v);
+    }
+
+    inline void XM_CALLCONV XMStoreFloat4(_Out_ XMFLOAT4* pDestination, _In_ FXMVECTOR v) noexcept
+    {
+        pDestination->x = v.vector4_f32[0];
+        pDestination->y = v.vector4_f32[1];
+        pDestination->z = v.vector4_f32[2];
+        pDestination->w = v.vector4_f32[3];
+    }
+
+    inline void XM_CALLCONV XMStoreFloat4A(_Out_ XMFLOAT4A* pDestination, _In_ FXMVECTOR v) noexcept
+    {
+        XMStoreFloat4(pDestination, v);
+    }
+
+    inline void XM_CALLCONV XMStoreSInt2(_Out_ XMINT2* pDestination, _In_ FXMVECTOR v) noexcept
+    {
+        const XMVECTOR n = XMConvertVectorFloatToInt(v, 0);
+        pDestination->x = static_cast<int32_t>(n.vector4_u32[0]);
+        pDestination->y = static_cast<int32_t>(n.vector4_u32[1]);
+    }
+
+    inline void XM_CALLCONV XMStoreSInt3(_Out_ XMINT3* pDestination, _In_ FXMVECTOR v) noexcept
+    {
+        const XMVECTOR n = XMConvertVectorFloatToInt(v, 0);
+        pDestination->x = static_cast<int32_t>(n.vector4_u32[0]);
+        pDestination->y = static_cast<int32_t>(n.vector4_u32[1]);
+        pDestination->z = static_cast<int32_t>(n.vector4_u32[2]);
+    }
+
+    inline void XM_CALLCONV XMStoreSInt4(_Out_ XMINT4* pDestination, _In_ FXMVECTOR v) noexcept
+    {
+        const XMVECTOR n = XMConvertVectorFloatToInt(v, 0);
+        pDestination->x = static_cast<int32_t>(n.vector4_u32[0]);
+        pDestination->y = static_cast<int32_t>(n.vector4_u32[1]);
+        pDestination->z = static_cast<int32_t>(n.vector4_u32[2]);
+        pDestination->w = static_cast<int32_t>(n.vector4_u32[3]);
+    }
+
+    inline void XM_CALLCONV XMStoreUInt2(_Out_ XMUINT2* pDestination, _In_ FXMVECTOR v) noexcept
+    {
+        const XMVECTOR n = XMConvertVectorFloatToUInt(v, 0);
+        pDestination->x = n.vector4_u32[0];
+        pDestination->y = n.vector4_u32[1];
+    }
+
+    inline void XM_CALLCONV XMStoreUInt3(_Out_ XMUINT3* pDestination, _In_ FXMVECTOR v) noexcept
+    {
+        const XMVECTOR n = XMConvertVectorFloatToUInt(v, 0);
+        pDestination->x = n.vector4_u32[0];
+        pDestination->y = n.vector4_u32[1];
+        pDestination->z = n.vector4_u32[2];
+    }
+
+    inline void XM_CALLCONV XMStoreUInt4(_Out_ XMUINT4* pDestination, _In_ FXMVECTOR v) noexcept
+    {
+        const XMVECTOR n = XMConvertVectorFloatToUInt(v, 0);
+        pDestination->x = n.vector4_u32[0];
+        pDestination->y = n.vector4_u32[1];
+        pDestination->z = n.vector4_u32[2];
+        pDestination->w = n.vector4_u32[3];
+    }
+
+    //---------------------------------------------------------------------------------
+    // Color
+
+    inline XMVECTOR XM_CALLCONV XMColorRGBToSRGB(FXMVECTOR rgb) noexcept
+    {
+        XMVECTOR result = rgb;
+        for (size_t i = 0; i < 3; ++i)
+        {
+            float value = rgb.vector4_f32[i];
+            value = (value < 0.0f) ? 0.0f : ((value > 1.0f) ? 1.0f : value);
+            result.vector4_f32[i] = (value < 0.0031308f)
+                ? value * 12.92f
+                : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+        }
+        return result;
+    }
+
+    inline XMVECTOR XM_CALLCONV XMColorSRGBToRGB(FXMVECTOR srgb) noexcept
+    {
+        XMVECTOR result = srgb;
+        for (size_t i = 0; i < 3; ++i)
+        {
+            float value = srgb.vector4_f32[i];
+            value = (value < 0.0f) ? 0.0f : ((value > 1.0f) ? 1.0f : value);
+            result.vector4_f32[i] = (value > 0.04045f)
+                ? std::pow((value + 0.055f) * (1.0f / 1.055f), 2.4f)
+                : value * (1.0f / 12.92f);
+        }
+        return result;
+    }
+
+    //---------------------------------------------------------------------------------
+    // Global constants
+
+    XMGLOBALCONST XMVECTORF32 g_XMZero = { { { 0.0f, 0.0f, 0.0f, 0.0f } } };
+    XMGLOBALCONST XMVECTORF32 g_XMOne = { { { 1.0f, 1.0f, 1.0f, 1.0f } } };
+    XMGLOBALCONST XMVECTORF32 g_XMTwo = { { { 2.0f, 2.0f, 2.0f, 2.0f } } };
+    XMGLOBALCONST XMVECTORF32 g_XMOneHalf = { { { 0.5f, 0.5f, 0.5f, 0.5f } } };
+    XMGLOBALCONST XMVECTORF32 g_XMNegativeOne = { { { -1.0f, -1.0f, -1.0f, -1.0f } } };
+    XMGLOBALCONST XMVECTORF32 g_XMIdentityR0 = { { { 1.0f, 0.0f, 0.0f, 0.0f } } };
+    XMGLOBALCONST XMVECTORF32 g_XMIdentityR1 = { { { 0.0f, 1.0f, 0.0f, 0.0f } } };
+    XMGLOBALCONST XMVECTORF32 g_XMIdentityR2 = { { { 0.0f, 0.0f, 1.0f, 0.0f } } };
+    XMGLOBALCONST XMVECTORF32 g_XMIdentityR3 = { { { 0.0f, 0.0f, 0.0f, 1.0f } } };
+    XMGLOBALCONST XMVECTORU32 g_XMMaskX = { { { 0xFFFFFFFF, 0x00000000, 0x00000000, 0x00000000 } } };
+    XMGLOBALCONST XMVECTORU32 g_XMMaskY = { { { 0x00000000, 0xFFFFFFFF, 0x00000000, 0x00000000 } } };
+    XMGLOBALCONST XMVECTORU32 g_XMMaskZ = { { { 0x00000000, 0x00000000, 0xFFFFFFFF, 0x00000000 } } };
+    XMGLOBALCONST XMVECTORU32 g_XMMaskW = { { { 0x00000000, 0x00000000, 0x00000000, 0xFFFFFFFF } } };
+    XMGLOBALCONST XMVECTORU32 g_XMSelect1000 = { { { XM_SELECT_1, XM_SELECT_0, XM_SELECT_0, XM_SELECT_0 } } };
+    XMGLOBALCONST XMVECTORU32 g_XMSelect1100 = { { { XM_SELECT_1, XM_SELECT_1, XM_SELECT_0, XM_SELECT_0 } } };
+    XMGLOBALCONST XMVECTORU32 g_XMSelect1110 = { { { XM_SELECT_1, XM_SELECT_1, XM_SELECT_1, XM_SELECT_0 } } };
+}
+
+#endif
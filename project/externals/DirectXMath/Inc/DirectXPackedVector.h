@@ -0,0 +1,773 @@
+//-------------------------------------------------------------------------------------
+// DirectXPackedVector.h
+//
+// Scalar subset of DirectXMath's packed vector types for non-Windows builds.
+// Only the formats DirectXTex's portable sources convert to and from are provided;
+// the conversions follow DirectXMath's _XM_NO_INTRINSICS_ path.
+//-------------------------------------------------------------------------------------
+
+#pragma once
+
+#ifndef _WIN32
+
+#include "DirectXMath.h"
+
+#ifdef __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#endif
+
+namespace DirectX
+{
+    namespace PackedVector
+    {
+        using HALF = uint16_t;
+
+        //-----------------------------------------------------------------------------
+        // Packed types
+
+        struct XMHALF2 { HALF x; HALF y; };
+        struct XMHALF4 { HALF x; HALF y; HALF z; HALF w; };
+
+        struct XMSHORTN2 { int16_t x; int16_t y; };
+        struct XMSHORT2 { int16_t x; int16_t y; };
+        struct XMUSHORTN2 { uint16_t x; uint16_t y; };
+        struct XMUSHORT2 { uint16_t x; uint16_t y; };
+        struct XMSHORTN4 { int16_t x; int16_t y; int16_t z; int16_t w; };
+        struct XMSHORT4 { int16_t x; int16_t y; int16_t z; int16_t w; };
+        struct XMUSHORTN4 { uint16_t x; uint16_t y; uint16_t z; uint16_t w; };
+        struct XMUSHORT4 { uint16_t x; uint16_t y; uint16_t z; uint16_t w; };
+
+        struct XMBYTEN2 { union { struct { int8_t x; int8_t y; }; uint16_t v; }; };
+        struct XMBYTE2 { union { struct { int8_t x; int8_t y; }; uint16_t v; }; };
+        struct XMUBYTEN2 { union { struct { uint8_t x; uint8_t y; }; uint16_t v; }; };
+        struct XMUBYTE2 { union { struct { uint8_t x; uint8_t y; }; uint16_t v; }; };
+        struct XMBYTEN4 { union { struct { int8_t x; int8_t y; int8_t z; int8_t w; }; uint32_t v; }; };
+        struct XMBYTE4 { union { struct { int8_t x; int8_t y; int8_t z; int8_t w; }; uint32_t v; }; };
+        struct XMUBYTEN4 { union { struct { uint8_t x; uint8_t y; uint8_t z; uint8_t w; }; uint32_t v; }; };
+        struct XMUBYTE4 { union { struct { uint8_t x; uint8_t y; uint8_t z; uint8_t w; }; uint32_t v; }; };
+
+        struct XMXDECN4 { union { struct { int32_t x : 10; int32_t y : 10; int32_t z : 10; uint32_t w : 2; }; uint32_t v; }; };
+        struct XMUDECN4 { union { struct { uint32_t x : 10; uint32_t y : 10; uint32_t z : 10; uint32_t w : 2; }; uint32_t v; }; };
+        struct XMUDEC4 { union { struct { uint32_t x : 10; uint32_t y : 10; uint32_t z : 10; uint32_t w : 2; }; uint32_t v; }; };
+
+        struct XMU565 { union { struct { uint16_t x : 5; uint16_t y : 6; uint16_t z : 5; }; uint16_t v; }; };
+        struct XMU555 { union { struct { uint16_t x : 5; uint16_t y : 5; uint16_t z : 5; uint16_t w : 1; }; uint16_t v; }; };
+        struct XMUNIBBLE4 { union { struct { uint16_t x : 4; uint16_t y : 4; uint16_t z : 4; uint16_t w : 4; }; uint16_t v; }; };
+
+        struct XMFLOAT3PK
+        {
+            union
+            {
+                struct
+                {
+                    uint32_t xm : 6;
+                    uint32_t xe : 5;
+                    uint32_t ym : 6;
+                    uint32_t ye : 5;
+                    uint32_t zm : 5;
+                    uint32_t ze : 5;
+                };
+                uint32_t v;
+            };
+        };
+
+        struct XMFLOAT3SE
+        {
+            union
+            {
+                struct
+                {
+                    uint32_t xm : 9;
+                    uint32_t ym : 9;
+                    uint32_t zm : 9;
+                    uint32_t e : 5;
+                };
+                uint32_t v;
+            };
+        };
+
+        //-----------------------------------------------------------------------------
+        // Half precision
+
+        inline float XMConvertHalfToFloat(HALF value) noexcept
+        {
+            auto mantissa = static_cast<uint32_t>(value & 0x03FF);
+            uint32_t exponent = (value & 0x7C00);
+            if (exponent == 0x7C00)
+            {
+                // INF/NAN
+                exponent = 0x8f;
+            }
+            else if (exponent != 0)
+            {
+                exponent = static_cast<uint32_t>((static_cast<int>(value) >> 10) & 0x1F);
+            }
+            else if (mantissa != 0)
+            {
+                // Denormalized: normalize it in the resulting float
+                exponent = 1;
+                do
+                {
+                    exponent--;
+                    mantissa <<= 1;
+                } while ((mantissa & 0x0400) == 0);
+                mantissa &= 0x03FF;
+            }
+            else
+            {
+                exponent = static_cast<uint32_t>(-112);
+            }
+
+            const uint32_t result = ((static_cast<uint32_t>(value) & 0x8000) << 16)
+                | ((exponent + 112) << 23)
+                | (mantissa << 13);
+            float f;
+            std::memcpy(&f, &result, sizeof(f));
+            return f;
+        }
+
+        inline HALF XMConvertFloatToHalf(float value) noexcept
+        {
+            uint32_t result;
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            const uint32_t sign = (bits & 0x80000000U) >> 16U;
+            bits = bits & 0x7FFFFFFFU;
+
+            if (bits >= 0x47800000 /*e+16*/)
+            {
+                // Too large for a half: infinity, or NaN keeping the upper mantissa bits
+                result = 0x7C00U | ((bits > 0x7F800000) ? (0x200 | ((bits >> 13U) & 0x3FFU)) : 0U);
+            }
+            else if (bits <= 0x33000000U /*e-25*/)
+            {
+                result = 0;
+            }
+            else if (bits < 0x38800000U /*e-14*/)
+            {
+                // Denormalized half, rounded to nearest even
+                const uint32_t shift = 125U - (bits >> 23U);
+                bits = 0x800000U | (bits & 0x7FFFFFU);
+                result = bits >> (shift + 1);
+                const uint32_t sticky = (bits & ((1U << shift) - 1)) != 0;
+                result += (result | sticky) & ((bits >> shift) & 1U);
+            }
+            else
+            {
+                // Rebias the exponent and round to nearest even
+                bits += 0xC8000000U;
+                result = ((bits + 0x0FFFU + ((bits >> 13U) & 1U)) >> 13U) & 0x7FFFU;
+            }
+            return static_cast<HALF>(result | sign);
+        }
+
+        inline float* XMConvertHalfToFloatStream(
+            _Out_writes_bytes_(sizeof(float) + outputStride * (halfCount - 1)) float* pOutputStream,
+            _In_ size_t outputStride,
+            _In_reads_bytes_(2 + inputStride * (halfCount - 1)) const HALF* pInputStream,
+            _In_ size_t inputStride,
+            _In_ size_t halfCount) noexcept
+        {
+            auto pHalf = reinterpret_cast<const uint8_t*>(pInputStream);
+            auto pFloat = reinterpret_cast<uint8_t*>(pOutputStream);
+            for (size_t i = 0; i < halfCount; ++i)
+            {
+                HALF h;
+                std::memcpy(&h, pHalf, sizeof(h));
+                const float f = XMConvertHalfToFloat(h);
+                std::memcpy(pFloat, &f, sizeof(f));
+                pHalf += inputStride;
+                pFloat += outputStride;
+            }
+            return pOutputStream;
+        }
+
+        inline HALF* XMConvertFloatToHalfStream(
+            _Out_writes_bytes_(2 + outputStride * (floatCount - 1)) HALF* pOutputStream,
+            _In_ size_t outputStride,
+            _In_reads_bytes_(sizeof(float) + inputStride * (floatCount - 1)) const float* pInputStream,
+            _In_ size_t inputStride,
+            _In_ size_t floatCount) noexcept
+        {
+            auto pFloat = reinterpret_cast<const uint8_t*>(pInputStream);
+            auto pHalf = reinterpret_cast<uint8_t*>(pOutputStream);
+            for (size_t i = 0; i < floatCount; ++i)
+            {
+                float f;
+                std::memcpy(&f, pFloat, sizeof(f));
+                const HALF h = XMConvertFloatToHalf(f);
+                std::memcpy(pHalf, &h, sizeof(h));
+                pFloat += inputStride;
+                pHalf += outputStride;
+            }
+            return pOutputStream;
+        }
+
+        //-----------------------------------------------------------------------------
+        // Internal helpers
+
+        namespace Internal
+        {
+            // Clamp to [min, max], then round half to even
+            inline XMVECTOR XMClampRound(FXMVECTOR v, FXMVECTOR min, FXMVECTOR max) noexcept
+            {
+                return XMVectorRound(XMVectorClamp(v, min, max));
+            }
+
+            // Clamp to [min, 1] after scaling, as the signed normalized loads do
+            inline float XMLoadSNorm(int32_t value, float scale) noexcept
+            {
+                const float f = static_cast<float>(value) * scale;
+                return (f < -1.0f) ? -1.0f : f;
+            }
+        }
+
+        //-----------------------------------------------------------------------------
+        // Loads
+
+        inline XMVECTOR XM_CALLCONV XMLoadHalf2(_In_ const XMHALF2* pSource) noexcept
+        {
+            return XMVectorSet(XMConvertHalfToFloat(pSource->x), XMConvertHalfToFloat(pSource->y), 0.0f, 0.0f);
+        }
+
+        inline XMVECTOR XM_CALLCONV XMLoadHalf4(_In_ const XMHALF4* pSource) noexcept
+        {
+            return XMVectorSet(XMConvertHalfToFloat(pSource->x), XMConvertHalfToFloat(pSource->y),
+                XMConvertHalfToFloat(pSource->z), XMConvertHalfToFloat(pSource->w));
+        }
+
+        inline XMVECTOR XM_CALLCONV XMLoadShortN2(_In_ const XMSHORTN2* pSource) noexcept
+        {
+            return XMVectorSet(Internal::XMLoadSNorm(pSource->x, 1.0f / 32767.0f),
+                Internal::XMLoadSNorm(pSource->y, 1.0f / 32767.0f), 0.0f, 0.0f);
+        }
+
+        inline XMVECTOR XM_CALLCONV XMLoadShort2(_In_ const XMSHORT2* pSource) noexcept
+        {
+            return XMVectorSet(static_cast<float>(pSource->x), static_cast<float>(pSource->y), 0.0f, 0.0f);
+        }
+
+        inline XMVECTOR XM_CALLCONV XMLoadUShortN2(_In_ const XMUSHORTN2* pSource) noexcept
+        {
+            return XMVectorSet(static_cast<float>(pSource->x) / 65535.0f,
+                static_cast<float>(pSource->y) / 65535.0f, 0.0f, 0.0f);
+        }
+
+        inline XMVECTOR XM_CALLCONV XMLoadUShort2(_In_ const XMUSHORT2* pSource) noexcept
+        {
+            return XMVectorSet(static_cast<float>(pSource->x), static_cast<float>(pSource->y), 0.0f, 0.0f);
+        }
+
+        inline XMVECTOR XM_CALLCONV XMLoadShortN4(_In_ const XMSHORTN4* pSource) noexcept
+        {
+            return XMVectorSet(Internal::XMLoadSNorm(pSource->x, 1.0f / 32767.0f),
+                Internal::XMLoadSNorm(pSource->y, 1.0f / 32767.0f),
+                Internal::XMLoadSNorm(pSource->z, 1.0f / 32767.0f),
+                Internal::XMLoadSNorm(pSource->w, 1.0f / 32767.0f));
+        }
+
+        inline XMVECTOR XM_CALLCONV XMLoadShort4(_In_ const XMSHORT4* pSource) noexcept
+        {
+            return XMVectorSet(static_cast<float>(pSource->x), static_cast<float>(pSource->y),
+                static_cast<float>(pSource->z), static_cast<float>(pSource->w));
+        }
+
+        inline XMVECTOR XM_CALLCONV XMLoadUShortN4(_In_ const XMUSHORTN4* pSource) noexcept
+        {
+            return XMVectorSet(static_cast<float>(pSource->x) / 65535.0f, static_cast<float>(pSource->y) / 65535.0f,
+                static_cast<float>(pSource->z) / 65535.0f, static_cast<float>(pSource->w) / 65535.0f);
+        }
+
+        inline XMVECTOR XM_CALLCONV XMLoadUShort4(_In_ const XMUSHORT4* pSource) noexcept
+        {
+            return XMVectorSet(static_cast<float>(pSource->x), static_cast<float>(pSource->y),
+                static_cast<float>(pSource->z), static_cast<float>(pSource->w));
+        }
+
+        inline XMVECTOR XM_CALLCONV XMLoadByteN2(_In_ const XMBYTEN2* pSource) noexcept
+        {
+            return XMVectorSet(Internal::XMLoadSNorm(pSource->x, 1.0f / 127.0f),
+                Internal::XMLoadSNorm(pSource->y, 1.0f / 127.0f), 0.0f, 0.0f);
+        }
+
+        inline XMVECTOR XM_CALLCONV XMLoadByte2(_In_ const XMBYTE2* pSource) noexcept
+        {
+            return XMVectorSet(static_cast<float>(pSource->x), static_cast<float>(pSource->y), 0.0f, 0.0f);
+        }
+
+        inline XMVECTOR XM_CALLCONV XMLoadUByteN2(_In_ const XMUBYTEN2* pSource) noexcept
+        {
+            return XMVectorSet(static_cast<float>(pSource->x) / 255.0f,
+                static_cast<float>(pSource->y) / 255.0f, 0.0f, 0.0f);
+        }
+
+        inline XMVECTOR XM_CALLCONV XMLoadUByte2(_In_ const XMUBYTE2* pSource) noexcept
+        {
+            return XMVectorSet(static_cast<float>(pSource->x), static_cast<float>(pSource->y), 0.0f, 0.0f);
+        }
+
+        inline XMVECTOR XM_CALLCONV XMLoadByteN4(_In_ const XMBYTEN4* pSource) noexcept
+        {
+            return XMVectorSet(Internal::XMLoadSNorm(pSource->x, 1.0f / 127.0f),
+                Internal::XMLoadSNorm(pSource->y, 1.0f / 127.0f),
+                Internal::XMLoadSNorm(pSource->z, 1.0f / 127.0f),
+                Internal::XMLoadSNorm(pSource->w, 1.0f / 127.0f));
+        }
+
+        inline XMVECTOR XM_CALLCONV XMLoadByte4(_In_ const XMBYTE4* pSource) noexcept
+        {
+            return XMVectorSet(static_cast<float>(pSource->x), static_cast<float>(pSource->y),
+                static_cast<float>(pSource->z), static_cast<float>(pSource->w));
+        }
+
+        inline XMVECTOR XM_CALLCONV XMLoadUByteN4(_In_ const XMUBYTEN4* pSource) noexcept
+        {
+            return XMVectorSet(static_cast<float>(pSource->x) / 255.0f, static_cast<float>(pSource->y) / 255.0f,
+                static_cast<float>(pSource->z) / 255.0f, static_cast<float>(pSource->w) / 255.0f);
+        }
+
+        inline XMVECTOR XM_CALLCONV XMLoadUByte4(_In_ const XMUBYTE4* pSource) noexcept
+        {
+            return XMVectorSet(static_cast<float>(pSource->x), static_cast<float>(pSource->y),
+                static_cast<float>(pSource->z), static_cast<float>(pSource->w));
+        }
+
+        inline XMVECTOR XM_CALLCONV XMLoadXDecN4(_In_ const XMXDECN4* pSource) noexcept
+        {
+            static const uint32_t signExtend[] = { 0x00000000, 0xFFFFFC00 };
+            const uint32_t elementX = pSource->v & 0x3FF;
+            const uint32_t elementY = (pSource->v >> 10) & 0x3FF;
+            const uint32_t elementZ = (pSource->v >> 20) & 0x3FF;
+            return XMVectorSet(
+                Internal::XMLoadSNorm(static_cast<int16_t>(elementX | signExtend[elementX >> 9]), 1.0f / 511.0f),
+                Internal::XMLoadSNorm(static_cast<int16_t>(elementY | signExtend[elementY >> 9]), 1.0f / 511.0f),
+                Internal::XMLoadSNorm(static_cast<int16_t>(elementZ | signExtend[elementZ >> 9]), 1.0f / 511.0f),
+                static_cast<float>(pSource->v >> 30) / 3.0f);
+        }
+
+        inline XMVECTOR XM_CALLCONV XMLoadUDecN4(_In_ const XMUDECN4* pSource) noexcept
+        {
+            const uint32_t v = pSource->v;
+            return XMVectorSet(static_cast<float>(v & 0x3FF) / 1023.0f,
+                static_cast<float>((v >> 10) & 0x3FF) / 1023.0f,
+                static_cast<float>((v >> 20) & 0x3FF) / 1023.0f,
+                static_cast<float>(v >> 30) / 3.0f);
+        }
+
+        inline XMVECTOR XM_CALLCONV XMLoadUDecN4_XR(_In_ const XMUDECN4* pSource) noexcept
+        {
+            const uint32_t v = pSource->v;
+            const auto elementX = static_cast<int32_t>(v & 0x3FF);
+            const auto elementY = static_cast<int32_t>((v >> 10) & 0x3FF);
+            const auto elementZ = static_cast<int32_t>((v >> 20) & 0x3FF);
+            return XMVectorSet(static_cast<float>(elementX - 0x180) / 510.0f,
+                static_cast<float>(elementY - 0x180) / 510.0f,
+                static_cast<float>(elementZ - 0x180) / 510.0f,
+                static_cast<float>(v >> 30) / 3.0f);
+        }
+
+        inline XMVECTOR XM_CALLCONV XMLoadUDec4(_In_ const XMUDEC4* pSource) noexcept
+        {
+            const uint32_t v = pSource->v;
+            return XMVectorSet(static_cast<float>(v & 0x3FF), static_cast<float>((v >> 10) & 0x3FF),
+                static_cast<float>((v >> 20) & 0x3FF), static_cast<float>(v >> 30));
+        }
+
+        inline XMVECTOR XM_CALLCONV XMLoadU565(_In_ const XMU565* pSource) noexcept
+        {
+            const uint32_t v = pSource->v;
+            return XMVectorSet(static_cast<float>(v & 0x1F), static_cast<float>((v >> 5) & 0x3F),
+                static_cast<float>((v >> 11) & 0x1F), 0.0f);
+        }
+
+        inline XMVECTOR XM_CALLCONV XMLoadU555(_In_ const XMU555* pSource) noexcept
+        {
+            const uint32_t v = pSource->v;
+            return XMVectorSet(static_cast<float>(v & 0x1F), static_cast<float>((v >> 5) & 0x1F),
+                static_cast<float>((v >> 10) & 0x1F), static_cast<float>((v >> 15) & 0x1));
+        }
+
+        inline XMVECTOR XM_CALLCONV XMLoadUNibble4(_In_ const XMUNIBBLE4* pSource) noexcept
+        {
+            const uint32_t v = pSource->v;
+            return XMVectorSet(static_cast<float>(v & 0xF), static_cast<float>((v >> 4) & 0xF),
+                static_cast<float>((v >> 8) & 0xF), static_cast<float>((v >> 12) & 0xF));
+        }
+
+        inline XMVECTOR XM_CALLCONV XMLoadFloat3PK(_In_ const XMFLOAT3PK* pSource) noexcept
+        {
+            const uint32_t v = pSource->v;
+            // Each channel: mantissa bits, exponent (5 bits), mantissa width
+            const uint32_t mantissas[3] = { v & 0x3F, (v >> 11) & 0x3F, (v >> 22) & 0x1F };
+            const uint32_t exponents[3] = { (v >> 6) & 0x1F, (v >> 17) & 0x1F, (v >> 27) & 0x1F };
+            const uint32_t widths[3] = { 6, 6, 5 };
+
+            uint32_t result[4] = {};
+            for (size_t i = 0; i < 3; ++i)
+            {
+                uint32_t mantissa = mantissas[i];
+                uint32_t exponent = exponents[i];
+                const uint32_t width = widths[i];
+                if (exponent == 0x1f)
+                {
+                    // INF or NAN
+                    result[i] = 0x7f800000 | (mantissa << (23 - width));
+                    continue;
+                }
+                if (exponent == 0)
+                {
+                    if (mantissa != 0)
+                    {
+                        // Denormalized: normalize it in the resulting float
+                        exponent = 1;
+                        do
+                        {
+                            exponent--;
+                            mantissa <<= 1;
+                        } while ((mantissa & (1U << width)) == 0);
+                        mantissa &= (1U << width) - 1;
+                    }
+                    else
+                    {
+                        exponent = static_cast<uint32_t>(-112);
+                    }
+                }
+                result[i] = ((exponent + 112) << 23) | (mantissa << (23 - width));
+            }
+
+            XMVECTOR out;
+            std::memcpy(out.vector4_u32, result, sizeof(result));
+            return out;
+        }
+
+        inline XMVECTOR XM_CALLCONV XMLoadFloat3SE(_In_ const XMFLOAT3SE* pSource) noexcept
+        {
+            const uint32_t v = pSource->v;
+            const uint32_t scaleBits = 0x33800000 + ((v >> 27) << 23);
+            float scale;
+            std::memcpy(&scale, &scaleBits, sizeof(scale));
+            return XMVectorSet(scale * static_cast<float>(v & 0x1FF),
+                scale * static_cast<float>((v >> 9) & 0x1FF),
+                scale * static_cast<float>((v >> 18) & 0x1FF),
+                1.0f);
+        }
+
+        //-----------------------------------------------------------------------------
+        // Stores
+
+        inline void XM_CALLCONV XMStoreHalf2(_Out_ XMHALF2* pDestination, _In_ FXMVECTOR v) noexcept
+        {
+            pDestination->x = XMConvertFloatToHalf(v.vector4_f32[0]);
+            pDestination->y = XMConvertFloatToHalf(v.vector4_f32[1]);
+        }
+
+        inline void XM_CALLCONV XMStoreHalf4(_Out_ XMHALF4* pDestination, _In_ FXMVECTOR v) noexcept
+        {
+            pDestination->x = XMConvertFloatToHalf(v.vector4_f32[0]);
+            pDestination->y = XMConvertFloatToHalf(v.vector4_f32[1]);
+            pDestination->z = XMConvertFloatToHalf(v.vector4_f32[2]);
+            pDestination->w = XMConvertFloatToHalf(v.vector4_f32[3]);
+        }
+
+        inline void XM_CALLCONV XMStoreShortN2(_Out_ XMSHORTN2* pDestination, _In_ FXMVECTOR v) noexcept
+        {
+            XMVECTOR n = XMVectorClamp(v, g_XMNegativeOne, g_XMOne);
+            n = XMVectorRound(XMVectorScale(n, 32767.0f));
+            pDestination->x = static_cast<int16_t>(n.vector4_f32[0]);
+            pDestination->y = static_cast<int16_t>(n.vector4_f32[1]);
+        }
+
+        inline void XM_CALLCONV XMStoreShort2(_Out_ XMSHORT2* pDestination, _In_ FXMVECTOR v) noexcept
+        {
+            const XMVECTOR n = Internal::XMClampRound(v, XMVectorReplicate(-32767.0f), XMVectorReplicate(32767.0f));
+            pDestination->x = static_cast<int16_t>(n.vector4_f32[0]);
+            pDestination->y = static_cast<int16_t>(n.vector4_f32[1]);
+        }
+
+        inline void XM_CALLCONV XMStoreUShortN2(_Out_ XMUSHORTN2* pDestination, _In_ FXMVECTOR v) noexcept
+        {
+            XMVECTOR n = XMVectorSaturate(v);
+            n = XMVectorTruncate(XMVectorMultiplyAdd(n, XMVectorReplicate(65535.0f), g_XMOneHalf));
+            pDestination->x = static_cast<uint16_t>(n.vector4_f32[0]);
+            pDestination->y = static_cast<uint16_t>(n.vector4_f32[1]);
+        }
+
+        inline void XM_CALLCONV XMStoreUShort2(_Out_ XMUSHORT2* pDestination, _In_ FXMVECTOR v) noexcept
+        {
+            const XMVECTOR n = Internal::XMClampRound(v, XMVectorZero(), XMVectorReplicate(65535.0f));
+            pDestination->x = static_cast<uint16_t>(n.vector4_f32[0]);
+            pDestination->y = static_cast<uint16_t>(n.vector4_f32[1]);
+        }
+
+        inline void XM_CALLCONV XMStoreShortN4(_Out_ XMSHORTN4* pDestination, _In_ FXMVECTOR v) noexcept
+        {
+            XMVECTOR n = XMVectorClamp(v, g_XMNegativeOne, g_XMOne);
+            n = XMVectorRound(XMVectorScale(n, 32767.0f));
+            pDestination->x = static_cast<int16_t>(n.vector4_f32[0]);
+            pDestination->y = static_cast<int16_t>(n.vector4_f32[1]);
+            pDestination->z = static_cast<int16_t>(n.vector4_f32[2]);
+            pDestination->w = static_cast<int16_t>(n.vector4_f32[3]);
+        }
+
+        inline void XM_CALLCONV XMStoreShort4(_Out_ XMSHORT4* pDestination, _In_ FXMVECTOR v) noexcept
+        {
+            const XMVECTOR n = Internal::XMClampRound(v, XMVectorReplicate(-32767.0f), XMVectorReplicate(32767.0f));
+            pDestination->x = static_cast<int16_t>(n.vector4_f32[0]);
+            pDestination->y = static_cast<int16_t>(n.vector4_f32[1]);
+            pDestination->z = static_cast<int16_t>(n.vector4_f32[2]);
+            pDestination->w = static_cast<int16_t>(n.vector4_f32[3]);
+        }
+
+        inline void XM_CALLCONV XMStoreUShortN4(_Out_ XMUSHORTN4* pDestination, _In_ FXMVECTOR v) noexcept
+        {
+            XMVECTOR n = XMVectorSaturate(v);
+            n = XMVectorTruncate(XMVectorMultiplyAdd(n, XMVectorReplicate(65535.0f), g_XMOneHalf));
+            pDestination->x = static_cast<uint16_t>(n.vector4_f32[0]);
+            pDestination->y = static_cast<uint16_t>(n.vector4_f32[1]);
+            pDestination->z = static_cast<uint16_t>(n.vector4_f32[2]);
+            pDestination->w = static_cast<uint16_t>(n.vector4_f32[3]);
+        }
+
+        inline void XM_CALLCONV XMStoreUShort4(_Out_ XMUSHORT4* pDestination, _In_ FXMVECTOR v) noexcept
+        {
+            const XMVECTOR n = Internal::XMClampRound(v, XMVectorZero(), XMVectorReplicate(65535.0f));
+            pDestination->x = static_cast<uint16_t>(n.vector4_f32[0]);
+            pDestination->y = static_cast<uint16_t>(n.vector4_f32[1]);
+            pDestination->z = static_cast<uint16_t>(n.vector4_f32[2]);
+            pDestination->w = static_cast<uint16_t>(n.vector4_f32[3]);
+        }
+
+        inline void XM_CALLCONV XMStoreByteN2(_Out_ XMBYTEN2* pDestination, _In_ FXMVECTOR v) noexcept
+        {
+            XMVECTOR n = XMVectorClamp(v, g_XMNegativeOne, g_XMOne);
+            n = XMVectorRound(XMVectorScale(n, 127.0f));
+            pDestination->x = static_cast<int8_t>(n.vector4_f32[0]);
+            pDestination->y = static_cast<int8_t>(n.vector4_f32[1]);
+        }
+
+        inline void XM_CALLCONV XMStoreByte2(_Out_ XMBYTE2* pDestination, _In_ FXMVECTOR v) noexcept
+        {
+            const XMVECTOR n = Internal::XMClampRound(v, XMVectorReplicate(-127.0f), XMVectorReplicate(127.0f));
+            pDestination->x = static_cast<int8_t>(n.vector4_f32[0]);
+            pDestination->y = static_cast<int8_t>(n.vector4_f32[1]);
+        }
+
+        inline void XM_CALLCONV XMStoreUByteN2(_Out_ XMUBYTEN2* pDestination, _In_ FXMVECTOR v) noexcept
+        {
+            XMVECTOR n = XMVectorSaturate(v);
+            n = XMVectorTruncate(XMVectorMultiplyAdd(n, XMVectorReplicate(255.0f), g_XMOneHalf));
+            pDestination->x = static_cast<uint8_t>(n.vector4_f32[0]);
+            pDestination->y = static_cast<uint8_t>(n.vector4_f32[1]);
+        }
+
+        inline void XM_CALLCONV XMStoreUByte2(_Out_ XMUBYTE2* pDestination, _In_ FXMVECTOR v) noexcept
+        {
+            const XMVECTOR n = Internal::XMClampRound(v, XMVectorZero(), XMVectorReplicate(255.0f));
+            pDestination->x = static_cast<uint8_t>(n.vector4_f32[0]);
+            pDestination->y = static_cast<uint8_t>(n.vector4_f32[1]);
+        }
+
+        inline void XM_CALLCONV XMStoreByteN4(_Out_ XMBYTEN4* pDestination, _In_ FXMVECTOR v) noexcept
+        {
+            XMVECTOR n = XMVectorClamp(v, g_XMNegativeOne, g_XMOne);
+            n = XMVectorRound(XMVectorScale(n, 127.0f));
+            pDestination->x = static_cast<int8_t>(n.vector4_f32[0]);
+            pDestination->y = static_cast<int8_t>(n.vector4_f32[1]);
+            pDestination->z = static_cast<int8_t>(n.vector4_f32[2]);
+            pDestination->w = static_cast<int8_t>(n.vector4_f32[3]);
+        }
+
+        inline void XM_CALLCONV XMStoreByte4(_Out_ XMBYTE4* pDestination, _In_ FXMVECTOR v) noexcept
+        {
+            const XMVECTOR n = Internal::XMClampRound(v, XMVectorReplicate(-127.0f), XMVectorReplicate(127.0f));
+            pDestination->x = static_cast<int8_t>(n.vector4_f32[0]);
+            pDestination->y = static_cast<int8_t>(n.vector4_f32[1]);
+            pDestination->z = static_cast<int8_t>(n.vector4_f32[2]);
+            pDestination->w = static_cast<int8_t>(n.vector4_f32[3]);
+        }
+
+        inline void XM_CALLCONV XMStoreUByteN4(_Out_ XMUBYTEN4* pDestination, _In_ FXMVECTOR v) noexcept
+        {
+            // Truncates like DirectXMath; callers such as DirectXTex add their own rounding bias
+            XMVECTOR n = XMVectorSaturate(v);
+            n = XMVectorTruncate(XMVectorScale(n, 255.0f));
+            pDestination->x = static_cast<uint8_t>(n.vector4_f32[0]);
+            pDestination->y = static_cast<uint8_t>(n.vector4_f32[1]);
+            pDestination->z = static_cast<uint8_t>(n.vector4_f32[2]);
+            pDestination->w = static_cast<uint8_t>(n.vector4_f32[3]);
+        }
+
+        inline void XM_CALLCONV XMStoreUByte4(_Out_ XMUBYTE4* pDestination, _In_ FXMVECTOR v) noexcept
+        {
+            const XMVECTOR n = Internal::XMClampRound(v, XMVectorZero(), XMVectorReplicate(255.0f));
+            pDestination->x = static_cast<uint8_t>(n.vector4_f32[0]);
+            pDestination->y = static_cast<uint8_t>(n.vector4_f32[1]);
+            pDestination->z = static_cast<uint8_t>(n.vector4_f32[2]);
+            pDestination->w = static_cast<uint8_t>(n.vector4_f32[3]);
+        }
+
+        inline void XM_CALLCONV XMStoreXDecN4(_Out_ XMXDECN4* pDestination, _In_ FXMVECTOR v) noexcept
+        {
+            XMVECTOR n = XMVectorClamp(v, XMVectorSet(-1.0f, -1.0f, -1.0f, 0.0f), g_XMOne);
+            n = XMVectorRound(XMVectorMultiply(n, XMVectorSet(511.0f, 511.0f, 511.0f, 3.0f)));
+            pDestination->v = ((static_cast<uint32_t>(n.vector4_f32[3]) & 0x3) << 30)
+                | ((static_cast<uint32_t>(static_cast<int32_t>(n.vector4_f32[2])) & 0x3FF) << 20)
+                | ((static_cast<uint32_t>(static_cast<int32_t>(n.vector4_f32[1])) & 0x3FF) << 10)
+                | (static_cast<uint32_t>(static_cast<int32_t>(n.vector4_f32[0])) & 0x3FF);
+        }
+
+        inline void XM_CALLCONV XMStoreUDecN4(_Out_ XMUDECN4* pDestination, _In_ FXMVECTOR v) noexcept
+        {
+            XMVECTOR n = XMVectorSaturate(v);
+            n = XMVectorRound(XMVectorMultiply(n, XMVectorSet(1023.0f, 1023.0f, 1023.0f, 3.0f)));
+            pDestination->v = ((static_cast<uint32_t>(n.vector4_f32[3]) & 0x3) << 30)
+                | ((static_cast<uint32_t>(n.vector4_f32[2]) & 0x3FF) << 20)
+                | ((static_cast<uint32_t>(n.vector4_f32[1]) & 0x3FF) << 10)
+                | (static_cast<uint32_t>(n.vector4_f32[0]) & 0x3FF);
+        }
+
+        inline void XM_CALLCONV XMStoreUDecN4_XR(_Out_ XMUDECN4* pDestination, _In_ FXMVECTOR v) noexcept
+        {
+            XMVECTOR n = XMVectorMultiplyAdd(v, XMVectorSet(510.0f, 510.0f, 510.0f, 3.0f),
+                XMVectorSet(384.0f, 384.0f, 384.0f, 0.0f));
+            n = Internal::XMClampRound(n, XMVectorZero(), XMVectorSet(1023.0f, 1023.0f, 1023.0f, 3.0f));
+            pDestination->v = ((static_cast<uint32_t>(n.vector4_f32[3]) & 0x3) << 30)
+                | ((static_cast<uint32_t>(n.vector4_f32[2]) & 0x3FF) << 20)
+                | ((static_cast<uint32_t>(n.vector4_f32[1]) & 0x3FF) << 10)
+                | (static_cast<uint32_t>(n.vector4_f32[0]) & 0x3FF);
+        }
+
+        inline void XM_CALLCONV XMStoreUDec4(_Out_ XMUDEC4* pDestination, _In_ FXMVECTOR v) noexcept
+        {
+            const XMVECTOR n = Internal::XMClampRound(v, XMVectorZero(), XMVectorSet(1023.0f, 1023.0f, 1023.0f, 3.0f));
+            pDestination->v = ((static_cast<uint32_t>(n.vector4_f32[3]) & 0x3) << 30)
+                | ((static_cast<uint32_t>(n.vector4_f32[2]) & 0x3FF) << 20)
+                | ((static_cast<uint32_t>(n.vector4_f32[1]) & 0x3FF) << 10)
+                | (static_cast<uint32_t>(n.vector4_f32[0]) & 0x3FF);
+        }
+
+        inline void XM_CALLCONV XMStoreU565(_Out_ XMU565* pDestination, _In_ FXMVECTOR v) noexcept
+        {
+            const XMVECTOR n = Internal::XMClampRound(v, XMVectorZero(), XMVectorSet(31.0f, 63.0f, 31.0f, 0.0f));
+            pDestination->v = static_cast<uint16_t>(
+                ((static_cast<uint32_t>(n.vector4_f32[2]) & 0x1F) << 11)
+                | ((static_cast<uint32_t>(n.vector4_f32[1]) & 0x3F) << 5)
+                | (static_cast<uint32_t>(n.vector4_f32[0]) & 0x1F));
+        }
+
+        inline void XM_CALLCONV XMStoreU555(_Out_ XMU555* pDestination, _In_ FXMVECTOR v) noexcept
+        {
+            const XMVECTOR n = Internal::XMClampRound(v, XMVectorZero(), XMVectorSet(31.0f, 31.0f, 31.0f, 1.0f));
+            pDestination->v = static_cast<uint16_t>(
+                ((n.vector4_f32[3] > 0.0f) ? 0x8000 : 0)
+                | ((static_cast<uint32_t>(n.vector4_f32[2]) & 0x1F) << 10)
+                | ((static_cast<uint32_t>(n.vector4_f32[1]) & 0x1F) << 5)
+                | (static_cast<uint32_t>(n.vector4_f32[0]) & 0x1F));
+        }
+
+        inline void XM_CALLCONV XMStoreUNibble4(_Out_ XMUNIBBLE4* pDestination, _In_ FXMVECTOR v) noexcept
+        {
+            const XMVECTOR n = Internal::XMClampRound(v, XMVectorZero(), XMVectorReplicate(15.0f));
+            pDestination->v = static_cast<uint16_t>(
+                ((static_cast<uint32_t>(n.vector4_f32[3]) & 0xF) << 12)
+                | ((static_cast<uint32_t>(n.vector4_f32[2]) & 0xF) << 8)
+                | ((static_cast<uint32_t>(n.vector4_f32[1]) & 0xF) << 4)
+                | (static_cast<uint32_t>(n.vector4_f32[0]) & 0xF));
+        }
+
+        inline void XM_CALLCONV XMStoreFloat3PK(_Out_ XMFLOAT3PK* pDestination, _In_ FXMVECTOR v) noexcept
+        {
+            uint32_t result[3];
+            for (size_t j = 0; j < 3; ++j)
+            {
+                // x and y have a 6-bit mantissa, z a 5-bit one (all with a 5-bit exponent)
+                const bool isZ = (j == 2);
+                const uint32_t sign = v.vector4_u32[j] & 0x80000000;
+                uint32_t i = v.vector4_u32[j] & 0x7FFFFFFF;
+
+                if ((i & 0x7F800000) == 0x7F800000)
+                {
+                    // INF or NAN
+                    result[j] = isZ ? 0x3E0 : 0x7C0;
+                    if ((i & 0x7FFFFF) != 0)
+                    {
+                        result[j] = isZ ? 0x3FF : 0x7FF;
+                    }
+                    else if (sign)
+                    {
+                        // -INF is clamped to 0 since 3PK is positive only
+                        result[j] = 0;
+                    }
+                }
+                else if (sign || i < (isZ ? 0x36000000U : 0x35800000U))
+                {
+                    // 3PK is positive only, so clamp to zero
+                    result[j] = 0;
+                }
+                else if (i > (isZ ? 0x477C0000U : 0x477E0000U))
+                {
+                    // The number is too large, so clamp to max
+                    result[j] = isZ ? 0x3DF : 0x7BF;
+                }
+                else
+                {
+                    if (i < 0x38800000U)
+                    {
+                        // The number is too small to be represented as a normalized float11/10
+                        const uint32_t shift = 113U - (i >> 23U);
+                        i = (0x800000U | (i & 0x7FFFFFU)) >> shift;
+                    }
+                    else
+                    {
+                        // Rebias the exponent
+                        i += 0xC8000000U;
+                    }
+                    result[j] = isZ
+                        ? ((i + 0x1FFFFU + ((i >> 18U) & 1U)) >> 18U) & 0x3ffU
+                        : ((i + 0xFFFFU + ((i >> 17U) & 1U)) >> 17U) & 0x7ffU;
+                }
+            }
+            pDestination->v = (result[0] & 0x7ff) | ((result[1] & 0x7ff) << 11) | ((result[2] & 0x3ff) << 22);
+        }
+
+        inline void XM_CALLCONV XMStoreFloat3SE(_Out_ XMFLOAT3SE* pDestination, _In_ FXMVECTOR v) noexcept
+        {
+            constexpr float maxf9 = float(0x1FF << 7);
+            constexpr float minf9 = float(1.f / (1 << 16));
+
+            float channels[3];
+            for (size_t i = 0; i < 3; ++i)
+            {
+                const float value = v.vector4_f32[i];
+                channels[i] = (value >= 0.f) ? ((value > maxf9) ? maxf9 : value) : 0.f;
+            }
+
+            const float maxXY = (channels[0] > channels[1]) ? channels[0] : channels[1];
+            const float maxXYZ = (maxXY > channels[2]) ? maxXY : channels[2];
+            const float maxColor = (maxXYZ > minf9) ? maxXYZ : minf9;
+
+            // Round up leaving 9 bits in the fraction (including the assumed 1)
+            uint32_t bits;
+            std::memcpy(&bits, &maxColor, sizeof(bits));
+            bits += 0x00004000;
+            const uint32_t exponent = bits >> 23;
+
+            const uint32_t scaleBits = 0x83000000 - (exponent << 23);
+            float scaleR;
+            std::memcpy(&scaleR, &scaleBits, sizeof(scaleR));
+
+            const auto xm = static_cast<uint32_t>(DirectX::Internal::XMRound(channels[0] * scaleR));
+            const auto ym = static_cast<uint32_t>(DirectX::Internal::XMRound(channels[1] * scaleR));
+            const auto zm = static_cast<uint32_t>(DirectX::Internal::XMRound(channels[2] * scaleR));
+            pDestination->v = (xm & 0x1FF) | ((ym & 0x1FF) << 9) | ((zm & 0x1FF) << 18)
+                | (((exponent - 0x6f) & 0x1F) << 27);
+        }
+    }
+}
+
+#ifdef __GNUC__
+#pragma GCC diagnostic pop
+#endif
+
+#endif
@@ -0,0 +1,40 @@
+//-------------------------------------------------------------------------------------
+// sal.h
+//
+// Minimal SAL annotation stubs for non-Windows builds.
+// Only the annotations used by DirectXTex and DirectXMath are defined, and all of
+// them expand to nothing (there is no static analyzer that reads them here).
+//-------------------------------------------------------------------------------------
+
+#pragma once
+
+#ifndef _WIN32
+
+#define _Analysis_assume_(expr)
+#define _Deref_out_
+#define _In_
+#define _In_count_(size)
+#define _In_opt_
+#define _In_range_(lb, ub)
+#define _In_reads_(size)
+#define _In_reads_bytes_(size)
+#define _In_reads_opt_(size)
+#define _In_z_
+#define _Inout_
+#define _Inout_opt_
+#define _Inout_updates_all_(size)
+#define _Inout_updates_all_opt_(size)
+#define _Inout_updates_bytes_(size)
+#define _Out_
+#define _Out_opt_
+#define _Out_writes_(size)
+#define _Out_writes_all_(size)
+#define _Out_writes_bytes_(size)
+#define _Out_writes_bytes_to_opt_(size, count)
+#define _Out_writes_opt_(size)
+#define _Outptr_
+#define _Success_(expr)
+#define _Use_decl_annotations_
+#define _When_(expr, annotes)
+
+#endif
@@ -5,6 +5,7 @@
 #include "externals/imgui/imgui_impl_dx12.h"
 #include "externals/imgui/imgui_impl_win32.h"
 #include <Windows.h>
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <d3d12.h>
@@ -12,12 +13,12 @@
 #include <dxgi1_6.h>
 #include <dxgidebug.h>
 #include <format>
-#include <fstream>
-#include <sstream>
 #include <string>
 #define DERECTINPUT_VERSION 0x0800
 #include "DirectXCommon.h"
+#include "MeshCache.h"
 #include "Sprite.h"
+#include "SpriteBatch.h"
 #include "SpriteCommon.h"
 #include "StringUtility.h"
 #include "TextureManager.h"
@@ -38,20 +39,6 @@ extern IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler(HWND hwnd,
 
 using namespace StringUtility;
 
-struct VertexData {
-  MyMath::Vector4 position;
-  MyMath::Vector2 texcoord;
-};
-
-struct MaterialData {
-  std::string textureFilePath;
-};
-
-struct ModelData {
-  std::vector<VertexData> vertices;
-  MaterialData material;
-};
-
 struct Material {
   MyMath::Vector4 color;
 };
@@ -61,6 +48,15 @@ struct TransformationMatrix {
   MyMath::Matrix4x4 World;
 };
 
+// サブメッシュ1つ分の描画に使うもの（記録の前にメインスレッドで用意する）
+struct SubMeshDraw {
+  D3D12_GPU_VIRTUAL_ADDRESS materialAddress;
+  D3D12_GPU_DESCRIPTOR_HANDLE textureSrvHandle;
+};
+
+// 1つのコマンドリストに記録する最少のサブメッシュ数
+const uint32_t kMinSubMeshesPerCommandList = 64;
+
 // DescriptorHeapの作成関数
 ID3D12DescriptorHeap *CreateDescriptorHeap(ID3D12Device *deveice,
                                            D3D12_DESCRIPTOR_HEAP_TYPE heapType,
@@ -104,118 +100,6 @@ ID3D12DescriptorHeap *CreateDescriptorHeap(ID3D12Device *deveice,
 //	return result;
 // }
 
-// MaterialData読み込み関数
-MaterialData LoadMaterialTemplateFile(const std::string &directoryPath,
-                                      const std::string &filename) {
-  // １．中で必要となる変数の宣言
-  MaterialData materialData; // 構築するMaterialData
-  std::string line;          // ファイルから読んだ１行を格納するもの
-
-  // ２．ファイルを開く
-  std::ifstream file(directoryPath + "/" + filename); // ファイルを開く
-  assert(file.is_open()); // とりあえず開けなかったら止める
-
-  // ３．実際にファイルを読み、MaterialDataを構築していく
-  while (std::getline(file, line)) {
-    std::string identifier;
-    std::istringstream s(line);
-    s >> identifier;
-
-    // identifierに応じた処理
-    if (identifier == "map_Kd") {
-      std::string textureFilename;
-      s >> textureFilename;
-      // 連結してファイルパスにする
-      materialData.textureFilePath = directoryPath + "/" + textureFilename;
-    }
-  }
-  // ４．MaterialDataを返す
-  return materialData;
-}
-
-// OBj読み込み関数
-ModelData LoadObjFile(const std::string &directoryPath,
-                      const std::string &filename) {
-  // １、中で必要となる変数の宣言
-  ModelData modelData;                  // 構築するModelData
-  std::vector<MyMath::Vector4> positions; // 位置
-  std::vector<MyMath::Vector3> normals;   // 法線
-  std::vector<MyMath::Vector2> texcoords; // テクスチャ座標
-  std::string line;                     // ファイルから読んで１行を格納するもの
-
-  // ２，ファイルを開く
-  std::ifstream file(directoryPath + "/" + filename); // ファイルを開く
-  assert(file.is_open()); // とりあえず開けなかったら止める
-
-  // ３，実際にファイルを読み、ModelDataを構築していく
-  while (std::getline(file, line)) {
-    std::string identifier;
-    std::istringstream s(line);
-    s >> identifier; // 先頭の識別子を読む
-
-    // identifierに応じた処理
-    if (identifier == "v") {
-      MyMath::Vector4 position;
-      s >> position.x >> position.y >> position.z;
-      position.w = 1.0f;
-      position.x *= -1.0f;
-      positions.push_back(position);
-    } else if (identifier == "vt") {
-      MyMath::Vector2 texcoord;
-      s >> texcoord.x >> texcoord.y;
-
-      texcoords.push_back(texcoord);
-    } else if (identifier == "vn") {
-      MyMath::Vector3 normal;
-      s >> normal.x >> normal.y >> normal.z;
-      normal.x *= -1.0f;
-      normals.push_back(normal);
-    } else if (identifier == "f") {
-      VertexData triangle[3];
-      // 面は三角形限定。その他は未対応
-      for (int32_t faceVertex = 0; faceVertex < 3; ++faceVertex) {
-        std::string vertexDefinition;
-        s >> vertexDefinition;
-        // 頂点の要素へのIndexは「位置/UV/法線」で格納されているので、分解してindexを取得する
-        std::istringstream v(vertexDefinition);
-        uint32_t elementIndices[3];
-        for (int32_t element = 0; element < 3; ++element) {
-          std::string index;
-          std::getline(v, index, '/'); // 区切りでインデックスを読んでいく
-          elementIndices[element] = std::stoi(index);
-        }
-        // 要素へのIndexから、実際の要素の値を所得して、頂点を構築する
-        MyMath::Vector4 position = positions[elementIndices[0] - 1];
-        position.x *= -1.0f;
-        MyMath::Vector2 texcoord = texcoords[elementIndices[1] - 1];
-        texcoord.y = 1.0f - texcoord.y;
-
-        MyMath::Vector3 normal = normals[elementIndices[2] - 1];
-        // normal.x *= -1.0f;
-        // VertexData vertex = { position,texcoord};
-        // VertexData vertex = { position,texcoord,normal };
-        // modelData.vertices.push_back(vertex);
-        triangle[faceVertex] = {position, texcoord};
-        // triangle[faceVertex] = { position,texcoord,normal };
-      }
-      // 頂点を逆順で登録することで、回り順を逆にする
-      modelData.vertices.push_back(triangle[2]);
-      modelData.vertices.push_back(triangle[1]);
-      modelData.vertices.push_back(triangle[0]);
-    } else if (identifier == "mtllib") {
-      // materialTemplateLibraryファイルの名前を取得する
-      std::string materialFilename;
-      s >> materialFilename;
-      // 基本的にobjファイルと同一階層にmtlは存在させるので、デイレクトリ名とファイル名を渡す
-      modelData.material =
-          LoadMaterialTemplateFile(directoryPath, materialFilename);
-    }
-  }
-
-  // ４，ModelDataを返す
-  return modelData;
-}
-
 // ウィンドウプロシージャ
 LRESULT CALLBACK WindowProc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam) {
   if (ImGui_ImplWin32_WndProcHandler(hwnd, msg, wparam, lparam)) {
@@ -293,9 +177,6 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
   // テクスチャマネージャーの初期化
   TextureManager::GetInstance()->Initialize(dxCommon);
 
-  TextureManager::GetInstance()->LoadTexture("resources/uvChecker.png");
-  TextureManager::GetInstance()->LoadTexture("resources/monsterball.png");
-
 #pragma region 基盤システムの初期化
 
   SpriteCommon *spriteCommon = nullptr;
@@ -303,6 +184,11 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
   spriteCommon = new SpriteCommon;
   spriteCommon->Initialize(dxCommon);
 
+  SpriteBatch *spriteBatch = nullptr;
+  // スプライトをまとめて描くバッチの初期化
+  spriteBatch = new SpriteBatch;
+  spriteBatch->Initialize(spriteCommon);
+
 #pragma endregion 基盤システムの初期化
 
 #pragma region 最初のシーンの初期化
@@ -314,6 +200,9 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 
   std::vector<std::string> textures = {"resources/uvChecker.png",
                                        "resources/monsterball.png"};
+  // スプライトの画像は1枚のアトラスにまとめ、テクスチャの切り替えを無くす
+  TextureManager::GetInstance()->LoadTextureAtlas("resources/sprites",
+                                                  textures);
 
   std::vector<Sprite *> sprites;
   for (uint32_t i = 0; i < 5; ++i) {
@@ -330,6 +219,9 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 
     sprites.push_back(sprite);
   }
+  // スプライトの視錐台カリング用
+  MyMath::BoundsBatch spriteBounds;
+  std::vector<uint32_t> visibleSpriteIndices;
 
   // RootSignature作成
   D3D12_ROOT_SIGNATURE_DESC descriptionRootSignature{};
@@ -484,23 +376,72 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 
   // モデル読み込み
   // ModelData modelData = LoadObjFile("resources", "plane.obj");
-  ModelData modelData = LoadObjFile("resources", "plane.obj");
+  // 変換済みのキャッシュをマップして、そのままアップロードする
+  // objの方が新しければ読み直してキャッシュを作り直す
+  MeshCache meshCache;
+  bool isMeshLoaded = meshCache.Open("resources", "plane.obj");
+  assert(isMeshLoaded);
+  (void)isMeshLoaded;
 
   ////三角形２個
   Microsoft::WRL::ComPtr<ID3D12Resource> vertexResource =
       dxCommon->CreateBufferResource(sizeof(VertexData) *
-                                     modelData.vertices.size());
+                                     meshCache.GetVertexCount());
 
   D3D12_VERTEX_BUFFER_VIEW vertexBufferView{};
   vertexBufferView.BufferLocation = vertexResource->GetGPUVirtualAddress();
   vertexBufferView.SizeInBytes =
-      UINT(sizeof(VertexData) * modelData.vertices.size());
+      UINT(sizeof(VertexData) * meshCache.GetVertexCount());
   vertexBufferView.StrideInBytes = sizeof(VertexData);
 
   VertexData *vertexData = nullptr;
   vertexResource->Map(0, nullptr, reinterpret_cast<void **>(&vertexData));
-  std::memcpy(vertexData, modelData.vertices.data(),
-              sizeof(VertexData) * modelData.vertices.size());
+  std::memcpy(vertexData, meshCache.GetVertices(),
+              sizeof(VertexData) * meshCache.GetVertexCount());
+
+  // インデックスリソース。キャッシュに入っている幅（16bit/32bit）のまま使う
+  size_t indexSize = meshCache.GetIndexSize();
+  UINT modelIndexCount = meshCache.GetIndexCount();
+  Microsoft::WRL::ComPtr<ID3D12Resource> indexResource =
+      dxCommon->CreateBufferResource(indexSize * modelIndexCount);
+
+  D3D12_INDEX_BUFFER_VIEW indexBufferView{};
+  indexBufferView.BufferLocation = indexResource->GetGPUVirtualAddress();
+  indexBufferView.SizeInBytes = UINT(indexSize * modelIndexCount);
+  indexBufferView.Format = indexSize == sizeof(uint16_t) ? DXGI_FORMAT_R16_UINT
+                                                         : DXGI_FORMAT_R32_UINT;
+
+  void *indexData = nullptr;
+  indexResource->Map(0, nullptr, &indexData);
+  std::memcpy(indexData, meshCache.GetIndices(), indexSize * modelIndexCount);
+
+  // 重複をまとめてどれだけ頂点が減ったか
+  Log(std::format("plane.obj : {} corners -> {} vertices ({:.1f}%)\n",
+                  modelIndexCount, meshCache.GetVertexCount(),
+                  100.0 * meshCache.GetVertexCount() /
+                      std::max<UINT>(modelIndexCount, 1)));
+
+  // マテリアルごとの描画範囲とマテリアルを取り出しておく
+  std::vector<SubMesh> modelSubMeshes(
+      meshCache.GetSubMeshes(),
+      meshCache.GetSubMeshes() + meshCache.GetSubMeshCount());
+  // 視錐台カリング用のモデル全体の範囲
+  MyMath::AABB modelBounds = {meshCache.GetBoundsMin(),
+                              meshCache.GetBoundsMax()};
+  std::vector<MaterialData> modelMaterials;
+  std::vector<uint32_t> modelTextureIndices;
+  for (uint32_t i = 0; i < meshCache.GetMaterialCount(); ++i) {
+    modelMaterials.push_back(meshCache.GetMaterialData(i));
+    // テクスチャの無いマテリアルは白の仮テクスチャで描く
+    const std::string &textureFilePath = modelMaterials.back().textureFilePath;
+    modelTextureIndices.push_back(
+        textureFilePath.empty()
+            ? TextureRegistry::kInvalidHandle
+            : TextureManager::GetInstance()->LoadTextureAsync(textureFilePath));
+  }
+  meshCache.Close();
+  std::vector<SubMeshDraw> subMeshDraws;
+  subMeshDraws.reserve(modelSubMeshes.size());
 
   ////頂点リソースにデータを書き込む
   // VertexData* vertexData = nullptr;
@@ -526,32 +467,17 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
   // vertexData[5].position = { 0.5f,-0.5f,-0.5f,1.0f };
   // vertexData[5].texcoord = { 1.0f,1.0f };
 
-  // マテリアル用のリソースを作る。今回はcolor１つ分のサイズを用意する
-  Microsoft::WRL::ComPtr<ID3D12Resource> materialResource =
-      dxCommon->CreateBufferResource(sizeof(Material));
-  // マテリアルにデータを書き込む
-  Material *materialData = nullptr;
-  // 書き込むためのアドレスを取得
-  materialResource->Map(0, nullptr, reinterpret_cast<void **>(&materialData));
+  // マテリアル・wvpは毎フレームDirectXCommonのアップロード領域から切り出す
   // 今回は白を書き込んでみる
-  materialData->color = MyMath::Vector4(1.0f, 1.0f, 1.0f, 1.0f);
-
-  // wvp用のリソースを作る。Matrix4x4 1つ分のサイズを用意する
-  Microsoft::WRL::ComPtr<ID3D12Resource> transfomationMatrixResource =
-      dxCommon->CreateBufferResource(sizeof(TransformationMatrix));
-  // データを書き込む
-  TransformationMatrix *transfomrationMatrixData = nullptr;
-  // 書き込むためのアドレスを取得
-  transfomationMatrixResource->Map(
-      0, nullptr, reinterpret_cast<void **>(&transfomrationMatrixData));
-  // 単位行列を書き込んでおく
-  transfomrationMatrixData->WVP = MyMath::Math::MakeIdentity4x4();
-  transfomrationMatrixData->World = MyMath::Math::MakeIdentity4x4();
+  Material material{};
+  material.color = MyMath::Vector4(1.0f, 1.0f, 1.0f, 1.0f);
 
   MyMath::Transform transform{
       {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}};
   MyMath::Transform cameraTransform{
       {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, -15.0f}};
+  MyMath::RotationCache rotationCache;
+  MyMath::RotationCache cameraRotationCache;
 
   // Textueを読んで転送する
   // DirectX::ScratchImage mipImages = LoadTexture("resources/uvChecker.png");
@@ -655,6 +581,12 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
     }
 #pragma endregion WindowAPIを利用したメッセージの受信と処理ここまで
 
+    // 更新処理の計測（GPUには何も積まないのでほぼCPUの時間だけ）
+    uint32_t updateScope = dxCommon->BeginProfileScope("Update");
+
+    // 読み込みの終わったテクスチャを使えるようにする
+    TextureManager::GetInstance()->Update();
+
     // フレームが始まる旨を告げる
     ImGui_ImplDX12_NewFrame();
     ImGui_ImplWin32_NewFrame();
@@ -673,29 +605,45 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 
     sprite->SetPosition(position);
 
-    for (Sprite *sprite : sprites) {
-      sprite->Update();
-    }
-
-    MyMath::Matrix4x4 worldMatrix = MyMath::Math::MakeAffineMatrix(
-        transform.scale, transform.rotate, transform.translate);
-    MyMath::Matrix4x4 cameraMatrix = MyMath::Math::MakeAffineMatrix(
-        cameraTransform.scale, cameraTransform.rotate,
-        cameraTransform.translate);
-    MyMath::Matrix4x4 viewMatrix = MyMath::Math::Inverse(cameraMatrix);
+    Sprite::UpdateAll(sprites);
+
+    // 回転はクォータニオンで持ち、角度が変わったときだけ作り直す
+    MyMath::Matrix4x4 worldMatrix =
+        MyMath::Math::MakeAffineMatrixFromQuaternion(
+            transform.scale, rotationCache.Get(transform.rotate),
+            transform.translate);
+    MyMath::Matrix4x4 cameraMatrix =
+        MyMath::Math::MakeAffineMatrixFromQuaternion(
+            cameraTransform.scale,
+            cameraRotationCache.Get(cameraTransform.rotate),
+            cameraTransform.translate);
+    // カメラは拡縮しないので転置だけで済む逆行列を使う
+    MyMath::Matrix4x4 viewMatrix = MyMath::Math::InverseRigid(cameraMatrix);
     MyMath::Matrix4x4 projectionMatrix = MyMath::Math::MakePerspectiveFovMatrix(
         0.45f, float(WinApp::kClientWidth) / float(WinApp::kClientHeight), 0.1f,
         100.0f);
-    MyMath::Matrix4x4 worldViewProjectionMatrix = MyMath::Math::Multiply(
-        worldMatrix, MyMath::Math::Multiply(viewMatrix, projectionMatrix));
-    transfomrationMatrixData->WVP = worldViewProjectionMatrix;
-    transfomrationMatrixData->World = worldMatrix;
+    MyMath::Matrix4x4 viewProjectionMatrix =
+        MyMath::Math::Multiply(viewMatrix, projectionMatrix);
+    MyMath::Matrix4x4 worldViewProjectionMatrix =
+        MyMath::Math::Multiply(worldMatrix, viewProjectionMatrix);
+    // 画面外ならモデルは描かない
+    bool isModelVisible = MyMath::Culling::IsVisible(
+        MyMath::Culling::MakeFrustum(viewProjectionMatrix),
+        MyMath::Culling::TransformAABB(modelBounds, worldMatrix));
+    // このフレームのアップロード領域に書き込む
+    UploadAllocation transformationMatrixAllocation =
+        dxCommon->AllocateUpload(sizeof(TransformationMatrix));
+    TransformationMatrix *transformationMatrixData =
+        static_cast<TransformationMatrix *>(
+            transformationMatrixAllocation.cpuAddress);
+    transformationMatrixData->WVP = worldViewProjectionMatrix;
+    transformationMatrixData->World = worldMatrix;
 
     // 開発用UIの処理。実際に開発用のUIを出す場合はここをゲーム固有の処理に置き換える
     ImGui::ShowDemoWindow();
 
     ImGui::Begin("Settings");
-    ImGui::ColorEdit4("material", &materialData->color.x); // RGBWの指定
+    ImGui::ColorEdit4("material", &material.color.x); // RGBWの指定
 
     ImGui::DragFloat3("rotate", &transform.rotate.x, 0.1f);
     ImGui::DragFloat3("scale", &transform.scale.x, 0.1f);
@@ -703,23 +651,103 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 
     ImGui::Separator();
 
+    ImGui::Text("sprite draw calls : %u / %u sprites (unsorted %u)",
+                spriteBatch->GetDrawCallCount(),
+                spriteBatch->GetInstanceCount(),
+                spriteBatch->GetUnsortedDrawCallCount());
+    ImGui::Text("visible sprites : %u / %u",
+                uint32_t(visibleSpriteIndices.size()),
+                uint32_t(sprites.size()));
+    ImGui::Text("model : %s", isModelVisible ? "visible" : "culled");
+    ImGui::Text("sprite upload : %zu bytes/sprite (shared quad %zu bytes)",
+                Sprite::kUploadSizePerDraw,
+                spriteCommon->GetQuadSizeInBytes());
+    int recordThreadCount = int(dxCommon->GetRecordThreadCount());
+    if (ImGui::SliderInt("record threads", &recordThreadCount, 1,
+                         int(dxCommon->GetMaxRecordThreadCount()))) {
+      dxCommon->SetRecordThreadCount(uint32_t(recordThreadCount));
+    }
+    ImGui::Text("command lists : %u", dxCommon->GetCommandListCount());
+    ImGui::Text("SRV : %u / %u",
+                dxCommon->GetDescriptorAllocator().GetPersistentUsedCount(),
+                DirectXCommon::kMaxSRVCount);
+    // モデルのテクスチャを解放して読み直す（画像を差し替えた時の確認用）
+    // 番号は変わらないので、modelTextureIndicesはそのまま使える
+    if (ImGui::Button("reload model textures")) {
+      for (const MaterialData &modelMaterial : modelMaterials) {
+        if (!modelMaterial.textureFilePath.empty()) {
+          TextureManager::GetInstance()->UnloadTexture(
+              modelMaterial.textureFilePath);
+          TextureManager::GetInstance()->LoadTextureAsync(
+              modelMaterial.textureFilePath);
+        }
+      }
+    }
+
+    ImGui::End();
+
+    // 区間ごとのGPUとCPUの時間。結果はフレームスロットの数だけ遅れて届く
+    // 開始時刻はどちらもフレームのCPUの開始からのミリ秒
+    ImGui::Begin("Profiler");
+    const GpuProfiler &profiler = dxCommon->GetProfiler();
+    if (ImGui::BeginTable("scopes", 6,
+                          ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+      ImGui::TableSetupColumn("scope");
+      ImGui::TableSetupColumn("start CPU / GPU");
+      ImGui::TableSetupColumn("GPU ms");
+      ImGui::TableSetupColumn("GPU avg / p95 / max");
+      ImGui::TableSetupColumn("CPU ms");
+      ImGui::TableSetupColumn("CPU avg / p95 / max");
+      ImGui::TableHeadersRow();
+      for (const GpuProfiler::ScopeResult &result : profiler.GetResults()) {
+        GpuProfiler::Statistics gpuStatistics =
+            profiler.GetGpuHistory(result.historyIndex).Compute();
+        GpuProfiler::Statistics cpuStatistics =
+            profiler.GetCpuHistory(result.historyIndex).Compute();
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::Text("%*s%s", int(result.depth * 2), "", result.name);
+        ImGui::TableNextColumn();
+        ImGui::Text("%.3f / %.3f", result.cpuBegin, result.gpuBegin);
+        ImGui::TableNextColumn();
+        ImGui::Text("%.3f", result.gpuDuration);
+        ImGui::TableNextColumn();
+        ImGui::Text("%.3f / %.3f / %.3f", gpuStatistics.average,
+                    gpuStatistics.p95, gpuStatistics.max);
+        ImGui::TableNextColumn();
+        ImGui::Text("%.3f", result.cpuDuration);
+        ImGui::TableNextColumn();
+        ImGui::Text("%.3f / %.3f / %.3f", cpuStatistics.average,
+                    cpuStatistics.p95, cpuStatistics.max);
+      }
+      ImGui::EndTable();
+    }
     ImGui::End();
 
     // transform.rotate.y += 0.03f;
 
     // ImGuiの内部コマンドを生成する
     ImGui::Render();
+    dxCommon->EndProfileScope(updateScope);
 
     // 更新処理をかく
     //  描画前処理
     dxCommon->PreDraw();
 
-    // Spriteの描画準備。Spriteの描画に共通のグラフィックスコマンドを積む
-    spriteCommon->SetupCommonDrawing();
-
+    // Spriteはバッチにまとめてテクスチャごとに1回で描く
+    // 画面外のスプライトはまとめて判定して積まない
+    uint32_t spriteScope = dxCommon->BeginProfileScope("Sprite");
+    spriteBounds.Clear();
     for (Sprite *sprite : sprites) {
-      sprite->Draw();
+      spriteBounds.Add(sprite->GetBounds());
+    }
+    spriteBounds.Cull(spriteCommon->GetFrustum(), visibleSpriteIndices);
+    spriteBatch->Begin();
+    for (uint32_t index : visibleSpriteIndices) {
+      spriteBatch->Draw(*sprites[index]);
     }
+    spriteBatch->End();
+    dxCommon->EndProfileScope(spriteScope);
 
     //// RootSignatureを設定。PSOに設定しているけど別途設定が必要
     // dxCommon->GetCommandList()->SetGraphicsRootSignature(rootSignature.Get());
@@ -749,15 +777,70 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
     // 描画!(DrawCall/ドローコル）。３頂点で一つのインスタンス。インスタンスについては今後
     // commandList->DrawInstanced(6, 1, 0, 0);
 
-    // モデル描画
-    dxCommon->GetCommandList()->DrawInstanced(UINT(modelData.vertices.size()),
-                                              1, 0, 0);
+    // モデル描画。マテリアルごとの範囲を1回ずつ描く
+    uint32_t modelScope = dxCommon->BeginProfileScope("Model");
+    if (isModelVisible) {
+      // アップロード領域は記録スレッドからは切り出せないので先に用意する
+      subMeshDraws.clear();
+      for (const SubMesh &subMesh : modelSubMeshes) {
+        const MaterialData &modelMaterial =
+            modelMaterials[subMesh.materialIndex];
+        uint32_t textureIndex = modelTextureIndices[subMesh.materialIndex];
+        bool hasTexture = textureIndex != TextureRegistry::kInvalidHandle;
+
+        // UIで編集した色にマテリアルの色を掛けてこのフレームのアップロード領域へ
+        // テクスチャがあればKdは掛けない（テクスチャの色をそのまま出す）
+        Material subMeshMaterial = material;
+        if (!hasTexture) {
+          subMeshMaterial.color.x *= modelMaterial.diffuseColor.x;
+          subMeshMaterial.color.y *= modelMaterial.diffuseColor.y;
+          subMeshMaterial.color.z *= modelMaterial.diffuseColor.z;
+        }
+        subMeshMaterial.color.w *= modelMaterial.alpha;
+        UploadAllocation materialAllocation =
+            dxCommon->AllocateUpload(sizeof(Material));
+        *static_cast<Material *>(materialAllocation.cpuAddress) =
+            subMeshMaterial;
+
+        subMeshDraws.push_back(
+            {materialAllocation.gpuAddress,
+             hasTexture ? TextureManager::GetInstance()->GetSrvHandleGPU(
+                              textureIndex)
+                        : TextureManager::GetInstance()
+                              ->GetPlaceholderSrvHandleGPU()});
+      }
+
+      // サブメッシュが多ければ記録スレッドで分担する
+      dxCommon->RecordParallel(
+          uint32_t(modelSubMeshes.size()), kMinSubMeshesPerCommandList,
+          [&](ID3D12GraphicsCommandList *commandList, uint32_t first,
+              uint32_t count) {
+            // バッチとはルートシグネチャが違うので設定し直す
+            spriteCommon->SetupCommonDrawing(commandList);
+            commandList->IASetVertexBuffers(0, 1, &vertexBufferView);
+            commandList->IASetIndexBuffer(&indexBufferView);
+            commandList->SetGraphicsRootConstantBufferView(
+                0, transformationMatrixAllocation.gpuAddress);
+            for (uint32_t i = first; i < first + count; ++i) {
+              const SubMesh &subMesh = modelSubMeshes[i];
+              commandList->SetGraphicsRootConstantBufferView(
+                  1, subMeshDraws[i].materialAddress);
+              commandList->SetGraphicsRootDescriptorTable(
+                  2, subMeshDraws[i].textureSrvHandle);
+              commandList->DrawIndexedInstanced(subMesh.indexCount, 1,
+                                                subMesh.indexOffset, 0, 0);
+            }
+          });
+    }
+    dxCommon->EndProfileScope(modelScope);
 
     //--------------------------------------
 
     // 実際のcommandListのImGuiの描画コマンドを積む
+    uint32_t imguiScope = dxCommon->BeginProfileScope("ImGui");
     ImGui_ImplDX12_RenderDrawData(ImGui::GetDrawData(),
                                   dxCommon->GetCommandList());
+    dxCommon->EndProfileScope(imguiScope);
 
     // 描画後処理
     dxCommon->PostDraw();
@@ -770,6 +853,9 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
     }
   }
 
+  // 積んだフレームを全てGPUが終えてからリソースを解放する
+  dxCommon->WaitForGPU();
+
   ImGui_ImplDX12_Shutdown();
   ImGui_ImplWin32_Shutdown();
   ImGui::DestroyContext();
@@ -825,6 +911,8 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 
   delete dxCommon;
 
+  delete spriteBatch;
+
   delete spriteCommon;
 
   delete sprite;
@@ -0,0 +1,34 @@
+#include "Sprite.hlsli"
+
+struct SpriteInstance
+{
+    float32_t4x4 WVP;
+    float32_t4 localRect;
+    float32_t4 uvRect;
+    float32_t4 color;
+    uint32_t textureIndex;
+    uint32_t3 padding;
+};
+StructuredBuffer<SpriteInstance> gInstances : register(t0);
+
+struct DrawConstants
+{
+    uint32_t instanceOffset;
+};
+ConstantBuffer<DrawConstants> gDrawConstants : register(b0);
+
+struct VertexShaderInput
+{
+    float32_t2 corner : POSITION0;
+};
+
+VertexShaderOutput main(VertexShaderInput input, uint32_t instanceId : SV_InstanceID)
+{
+    SpriteInstance instance = gInstances[gDrawConstants.instanceOffset + instanceId];
+    float32_t2 local = lerp(instance.localRect.xy, instance.localRect.zw, input.corner);
+    VertexShaderOutput output;
+    output.position = mul(float32_t4(local, 0.0f, 1.0f), instance.WVP);
+    output.texcoord = lerp(instance.uvRect.xy, instance.uvRect.zw, input.corner);
+    output.color = instance.color;
+    return output;
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+﻿#include "TextureCooker.h"
+#include "TextureDecoderCommon.h"
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+#ifdef _WIN32
+#include <objbase.h>
+#endif
+
+// 使い方
+// TextureCooker [--none|--bc1|--bc3|--bc7] [--force] <ディレクトリ>
+// ディレクトリ以下の.png/.jpg/.bmp/.tga/.hdrを、隣に同名の.ddsとして書き出す
+// 変換済みの.ddsが元ファイルより新しければ飛ばす（--forceで必ず変換）
+// Windows以外のビルドではWICが無いので、pngはlibpngで読む（jpg/bmpは読めない）
+
+namespace {
+// 変換対象の拡張子か
+bool IsSourceFile(const std::filesystem::path &filePath) {
+  std::string extension = filePath.extension().string();
+  for (char &c : extension) {
+    if (c >= 'A' && c <= 'Z') {
+      c = static_cast<char>(c - 'A' + 'a');
+    }
+  }
+  return extension == ".png" || extension == ".jpg" || extension == ".jpeg" ||
+         extension == ".bmp" || extension == ".tga" || extension == ".hdr";
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  TextureCooker::Compression compression = TextureCooker::Compression::BC7;
+  bool isForced = false;
+  std::filesystem::path directory = "resources";
+
+  for (int i = 1; i < argc; ++i) {
+    std::string argument = argv[i];
+    if (argument == "--none") {
+      compression = TextureCooker::Compression::None;
+    } else if (argument == "--bc1") {
+      compression = TextureCooker::Compression::BC1;
+    } else if (argument == "--bc3") {
+      compression = TextureCooker::Compression::BC3;
+    } else if (argument == "--bc7") {
+      compression = TextureCooker::Compression::BC7;
+    } else if (argument == "--force") {
+      isForced = true;
+    } else {
+      directory = argument;
+    }
+  }
+
+#ifdef _WIN32
+  // WICを使うためにCOMを初期化する
+  CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+#endif
+  // 変換対象を集める
+  std::vector<std::filesystem::path> filePaths;
+  std::error_code ec;
+  for (const std::filesystem::directory_entry &entry :
+       std::filesystem::recursive_directory_iterator(directory, ec)) {
+    if (entry.is_regular_file() && IsSourceFile(entry.path())) {
+      filePaths.push_back(entry.path());
+    }
+  }
+  if (ec) {
+    std::fprintf(stderr, "cannot open %s\n", directory.string().c_str());
+    return 1;
+  }
+
+  // ファイルごとの時間をCSVで出す
+  std::printf("file,decode_ms,mip_ms,compress_ms,save_ms\n");
+  TextureCooker::Timings total{};
+  int failedCount = 0;
+  for (const std::filesystem::path &filePath : filePaths) {
+    if (!isForced && TextureDecoder::IsCookedFileFresh(filePath)) {
+      continue;
+    }
+
+    TextureCooker::Timings timings{};
+    std::string errorMessage;
+    if (!TextureCooker::CookFile(filePath, compression, &timings,
+                                 &errorMessage)) {
+      std::fprintf(stderr, "failed %s (%s)\n", filePath.string().c_str(),
+                   errorMessage.c_str());
+      failedCount++;
+      continue;
+    }
+
+    std::printf("%s,%.3f,%.3f,%.3f,%.3f\n", filePath.string().c_str(),
+                timings.decode, timings.mip, timings.compress, timings.save);
+    total.decode += timings.decode;
+    total.mip += timings.mip;
+    total.compress += timings.compress;
+    total.save += timings.save;
+  }
+  std::printf("total,%.3f,%.3f,%.3f,%.3f\n", total.decode, total.mip,
+              total.compress, total.save);
+
+#ifdef _WIN32
+  CoUninitialize();
+#endif
+
+  return failedCount == 0 ? 0 : 1;
+}